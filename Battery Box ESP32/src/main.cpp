@@ -55,10 +55,12 @@ typedef struct struct_message
     float soc;
     float I;
     float resmAh;
+    uint16_t seq; // packet counter, lets the ESA count lost packets (older ESAs ignore it)
 } struct_message;
 
 // Create a structure object
 struct_message BMSData;
+uint16_t txSeq = 0; // incremented once per send period
 
 // Peer info
 esp_now_peer_info_t peerInfo;
@@ -406,6 +408,7 @@ void loop()
         BMSData.soc = input_soc;
         BMSData.I = input_I;
         BMSData.resmAh = input_resmAh;
+        BMSData.seq = txSeq++;
 
         // Send message to ESA via ESP-NOW
         Serial.println("-------------------------------------------------------------- Sending to ESA --------------------------------------------------------------");
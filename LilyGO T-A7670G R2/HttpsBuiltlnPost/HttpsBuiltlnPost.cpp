@@ -11,10 +11,32 @@
  */
 #define TINY_GSM_RX_BUFFER 1024 // Set RX buffer to 1Kb
 
+// 1: keep the modem's HTTP service, URL and headers set up between posts
+// 0: set them up and tear them down around every post, as the original example does
+#ifndef HTTPS_SESSION
+#define HTTPS_SESSION 1
+#endif
+
+// 1: send telemetry over MQTT (persistent connection, QoS 1, see mqttSendData()) instead of HTTPS POST
+#ifndef MQTT_TRANSPORT
+#define MQTT_TRANSPORT 0
+#endif
+
+// 1: send telemetry as CBOR (application/cbor, schema in telemetry_cbor.py) instead of JSON
+#ifndef CBOR_PAYLOAD
+#define CBOR_PAYLOAD 0
+#endif
+
 // See all AT commands, if wanted
 // #define DUMP_AT_COMMANDS
 
 #include "utilities.h"
+#include "uplink.h"
+#include "json_writer.h"
+#include "cbor_writer.h"
+#include "time_service.h"
+#include "telemetry_body.h"
+#include "report_policy.h"
 #include <TinyGsmClient.h>
 #include <driver/gpio.h>
 
@@ -75,7 +97,8 @@ const unsigned long stillTime = 5000; // seconds of stillness
 const int looptime = 1000;//every loop is 500ms for topple detection
 unsigned long printTime = 0;
 unsigned long postTime = 0;
-const unsigned long postInterval = 15000; // 15 seconds for each HTTP post
+unsigned long postInterval = 15000; // Set by the report policy every second, the MQTT "interval" command pins it
+unsigned long policyTime = 0;
 String pmaState = "Safe";
 
 //ESP-NOW
@@ -86,6 +109,14 @@ int previous_chg = -1;     // 0 = not charging, 1 = charging
 int input_chg = -1;        // to store user input
 float input_I = -1.0;      // Current in Amperes, +ve charge, -ve discharge
 float input_resmAh = -1.0; // Remaining capacity in mAh
+const int BATTERY_CRITICAL_SOC = 10;       // Raises the battery event while not charging
+const int BATTERY_CRITICAL_CLEAR_SOC = 15; // Cleared above this (or when charging), so it does not flap
+bool batteryCritical = false;                // loop() only
+// The latest good BMS read, handed from receiveCallback() (WiFi task) to loop(), which judges it
+int batteryReadSoc = -1;
+int batteryReadChg = -1;
+bool batteryReadPending = false;
+portMUX_TYPE batteryReadMux = portMUX_INITIALIZER_UNLOCKED;
 
 const char *current_status_msg = "";
 const char *previous_status_msg = "";
@@ -127,6 +158,8 @@ void statusMessage(int soc, int chg)
     }
 }
 
+TelemetrySnapshot takeSnapshot(); // With the uplink code below
+
 // Callback function that you want executed when data is received
 // The arguments of the callback function are fixed to be this three.
 unsigned long lastReceiveTime = 0;
@@ -171,6 +204,17 @@ void receiveCallback(const uint8_t *macAddr, const uint8_t *incomingData, int da
     input_I = BMSData.I;                 // +A charge, -A discharge
     input_resmAh = BMSData.resmAh;
 
+    // A failed BMS read sends SOC 0: only a good one is judged, the last verdict stands otherwise.
+    // loop() judges it and takes the snapshot, which reads gps and pmaState that other tasks write.
+    if (BMSData.bms_status)
+    {
+        portENTER_CRITICAL(&batteryReadMux);
+        batteryReadSoc = input_soc;
+        batteryReadChg = input_chg;
+        batteryReadPending = true;
+        portEXIT_CRITICAL(&batteryReadMux);
+    }
+
     if (millis() - lastReceiveTime > printInterval) 
     {
     Serial.print("Current SoC: ");
@@ -206,190 +250,250 @@ TinyGsm modem(debugger);
 TinyGsm modem(SerialAT);
 #endif
 
-String convertToUTC(String timeStr) {
-    // Example input: "25/10/24,15:22:34+32"
-    timeStr.trim();
-    timeStr.replace("\"", ""); // remove double quotes
-    int year   = timeStr.substring(0, 2).toInt();
-    int month  = timeStr.substring(3, 5).toInt();
-    int day    = timeStr.substring(6, 8).toInt();
-    int hour   = timeStr.substring(9, 11).toInt();
-    int minute = timeStr.substring(12, 14).toInt();
-    int second = timeStr.substring(15, 17).toInt();
-    Serial.println("Parsed Time - Y:" + String(year) + " M:" + String(month) + 
-                " D:" + String(day) + " H:" + String(hour) + 
-                " Min:" + String(minute) + " S:" + String(second));
-    year = 2000 + year; // make full year (e.g. 2025)
-    // Adjust timezone: Singapore (UTC+8) → UTC (minus 8 hours)
-    hour -= 8;
-    if (hour < 0) {
-        hour += 24;
-        day -= 1;
-        if (day <= 0) {// Handle day wrap-around (simple version)
-            month -= 1;
-            if (month <= 0) {
-                month = 12;
-                year -= 1;
-            }
-            // Get number of days in previous month
-            int daysInMonth;
-            if (month == 1 || month == 3 || month == 5 || month == 7 ||
-                month == 8 || month == 10 || month == 12) {
-                daysInMonth = 31;
-            } else if (month == 4 || month == 6 || month == 9 || month == 11) {
-                daysInMonth = 30;
-            } else { // February
-                daysInMonth = (year % 4 == 0) ? 29 : 28;
-            }
-            day = daysInMonth;
-        }
+// Sets the clock from the modem (NITZ), the fallback until GPS has a fix. One +CCLK? round trip,
+// so it only runs at start-up and in the uplink task while the clock is not set.
+bool syncTimeFromModem()
+{
+    char cclk[32] = "";
+    modem.sendAT("+CCLK?");
+    if (modem.waitResponse(1000, "+CCLK:") == 1)
+    {
+        const size_t n = modem.stream.readBytesUntil('\n', cclk, sizeof(cclk) - 1);
+        cclk[n] = '\0';
+        modem.waitResponse();
     }
-    // Reconstruct the new UTC time string
-    char buffer[36];
-    sprintf(buffer, "%04d-%02d-%02dT%02d:%02d:%02d+08:00",
-            year, month, day, hour, minute, second);
+    const int64_t at = timeMonotonicMs();
+    //Module time: "25/10/24,15:22:34+32"
+    Serial.printf("Module time: %s\n", cclk);
+    int64_t utc;
+    return timeParseCclk(cclk, utc) && timeSync(utc * 1000, at, TIME_NITZ);
+}
 
-    return String(buffer);
+// Sets the clock from a GPS time that has just been parsed. The time is that of the fix, which
+// the receiver sends a fraction of a second later, so the clock runs up to that much behind.
+void syncTimeFromGps()
+{
+    if (!gps.time.isUpdated() || !gps.time.isValid() || !gps.date.isValid())
+    {
+        return;
+    }
+    const int64_t utcMs = timeEpoch(gps.date.year(), gps.date.month(), gps.date.day(),
+                                    gps.time.hour(), gps.time.minute(), gps.time.second()) * 1000 +
+                          gps.time.centisecond() * 10;
+    timeSync(utcMs + gps.time.age(), timeMonotonicMs(), TIME_GPS);
 }
 
 // It depends on the operator whether to set up an APN. If some operators do not set up an APN,
 // they will be rejected when registering for the network. You need to ask the local operator for the specific APN.
 // APNs from other operators are welcome to submit PRs for filling.
 // #define NETWORK_APN     "CHN-CT"             //CHN-CT: China Telecom
-const char *server_url = "https://senditemalert-tg3jk3roea-as.a.run.app";
+#ifndef SERVER_URL
+#define SERVER_URL "https://senditemalert-tg3jk3roea-as.a.run.app"
+#endif
+const char *server_url = SERVER_URL; // -DSERVER_URL=\"http://<pc>:8080/\" to post to stub_endpoint.py
+
+#if MQTT_TRANSPORT
+#if !defined(TINY_GSM_MODEM_A7670) && !defined(TINY_GSM_MODEM_A7608)
+#error "MQTT_TRANSPORT uses TinyGsmMqttA76xx, which only the A7670 / A7608 modems have"
+#endif
+#ifndef MQTT_BROKER_HOST
+#define MQTT_BROKER_HOST "mqtt.example.com"   // Your broker, or stub_broker.py on a reachable PC
+#endif
+#ifndef MQTT_BROKER_PORT
+#define MQTT_BROKER_PORT 1883
+#endif
+#define MQTT_BROKER_TLS false
+#define MQTT_USERNAME NULL
+#define MQTT_PASSWORD NULL
+#define MQTT_CLIENT 0                       // Modem MQTT client index
+#define MQTT_CLIENT_ID "pma-0001"
+#define MQTT_KEEPALIVE_S 120                // The modem pings the broker by itself
+#define MQTT_TOPIC_TELEMETRY "pma/0001/telemetry"
+#define MQTT_TOPIC_STATUS "pma/0001/status" // "online" once connected, "offline" as the last will
+#define MQTT_TOPIC_CMD "pma/0001/cmd"       // Server commands, see mqttCommand()
+#endif
 
-void postData() 
+// Current readings for the uplink queue; runs in loop() and the event producers, no modem access
+TelemetrySnapshot takeSnapshot()
 {
-    float lat = gps.location.lat();
-    float lng = gps.location.lng();
-    float vel = gps.speed.kmph();
-    float spd = gps.speed.mps();
-    float accuracy = gps.satellites.value();
-    String HTTPtime = "";
-    // HTTPtime += String(gps.date.year());
-    // HTTPtime += "-";
-    // if (gps.date.month() < 10) HTTPtime += "0";
-    // HTTPtime += String(gps.date.month());
-    // HTTPtime += "-";
-    // if (gps.date.day() < 10) HTTPtime += "0";
-    // HTTPtime += String(gps.date.day());
-    // HTTPtime += "T";
-    // int sg_hour = gps.time.hour() + 0; // Singapore is UTC +8, change this according to your timezone
-    // if (sg_hour >= 24) sg_hour -= 24; // wrap around midnight
-    // if (sg_hour < 10) HTTPtime += "0";
-    // HTTPtime += String(sg_hour);
-    // // if (gps.time.hour() < 10) HTTPtime += "0";
-    // // HTTPtime += String(gps.time.hour());
-    // HTTPtime += ":";
-    // if (gps.time.minute() < 10) HTTPtime += "0";
-    // HTTPtime += String(gps.time.minute());
-    // HTTPtime += ":";
-    // if (gps.time.second() < 10) HTTPtime += "0";
-    // HTTPtime += String(gps.time.second());
-    // HTTPtime += "+08:00"; // add timezone info, change this according to your timezone
-    // Serial.println("Time: " + HTTPtime);
-
-    String modemTime;
-    modem.sendAT("+CCLK?");
-    if (modem.waitResponse(1000, "+CCLK:") == 1) {
-    modemTime = modem.stream.readStringUntil('\n');
-    timeStr.trim();
-    Serial.println("Module time: " + modemTime);
+    TelemetrySnapshot snap = {};
+    snap.sampledMs = millis();
+    snap.utc = timeUtcAt(snap.sampledMs);
+    snap.lat = gps.location.lat();
+    snap.lng = gps.location.lng();
+    snap.accuracy = gps.satellites.value();
+    snap.soc = input_soc;
+    snap.chg = input_chg;
+    strlcpy(snap.severity, pmaState.c_str(), sizeof(snap.severity));
+    return snap;
+}
+
+// What the report policy decides the interval from; runs in loop()
+ReportInputs readReportInputs()
+{
+    ReportInputs in = {};
+    in.speedValid = gps.speed.isValid() && gps.speed.age() < 5000;
+    in.speedKmph = gps.speed.kmph();
+    in.gyroDps = averageGyro;
+    in.soc = input_soc;
+    in.charging = input_chg == 1;
+    const UplinkStats s = uplinkGetStats();
+    in.linkDown = s.backlog > 0;
+    for (uint8_t t = 0; t < UPLINK_EVENT_COUNT; t++)
+    {
+        in.events += s.events[t].raised;
     }
-    //Module time: "25/10/24,15:22:34+32"
-    HTTPtime = convertToUTC(modemTime);
-    Serial.println("UTC time: " + HTTPtime);
-    // HTTPtime += "20";
-    // HTTPtime += timeStr.substring(1, 3);  // year "25"
-    // HTTPtime += "-";
-    // HTTPtime += timeStr.substring(4, 6);  // month "10"
-    // HTTPtime += "-";
-    // HTTPtime += timeStr.substring(7, 9);  // day "24"
-    // HTTPtime += "T";
-    // HTTPtime += timeStr.substring(10, 18); // "15:22:34"
-    // HTTPtime += "+08:00";                 // timezone
-    // Serial.println("Time: " + HTTPtime);
+    return in;
+}
+
+#if HTTPS_SESSION
+// Cold posts set the HTTP service up first, warm ones reuse it
+void printHttpsSessionStats()
+{
+    const HttpsSessionStats &s = modem.https_session_stats();
+    Serial.printf("HTTPS session: %lu set-ups (%lu stale), cold %lu posts avg %lu ms, warm %lu posts avg %lu ms, last %lu ms\n",
+                  (unsigned long)s.inits, (unsigned long)s.stale,
+                  (unsigned long)s.coldRequests, (unsigned long)(s.coldRequests ? s.coldMs / s.coldRequests : 0),
+                  (unsigned long)s.warmRequests, (unsigned long)(s.warmRequests ? s.warmMs / s.warmRequests : 0),
+                  (unsigned long)s.lastMs);
+}
+#endif
+
+// Body of the post in flight and the server's answer. Static so that posting every 15 s for days
+// never touches the heap; only the uplink task uses them, with the modem locked.
+static char uplinkBody[UPLINK_BATCH_MAX_BYTES + 1];
+static char uplinkReply[512];
+
+#if CBOR_PAYLOAD
+#define PAYLOAD_TYPE "application/cbor"
+#else
+#define PAYLOAD_TYPE "application/json"
+#endif
+
+// Debug print of a body, CBOR as hex
+void printBody(const char *title, const char *body, size_t length)
+{
+    Serial.println(title);
+#if CBOR_PAYLOAD
+    Serial.printf("%u bytes of CBOR: ", (unsigned)length);
+    for (size_t i = 0; i < length; i++)
+    {
+        Serial.printf("%02x", (uint8_t)body[i]);
+    }
+#else
+    Serial.write((const uint8_t *)body, length);
+#endif
+    Serial.println();
+    Serial.println("---------------------------");
+}
+
+// Runs in the uplink task with the modem locked, returns the HTTP status.
+// One snapshot is posted as a bare record, several as a JSON array of records, oldest first.
+int postData(const TelemetrySnapshot *snaps, uint8_t count, UplinkPost &post)
+{
+    // No registration: fail fast, the uplink keeps the snapshots for later
+    if (!modem.isNetworkConnected())
+    {
+        Serial.println("Not registered, post deferred.");
+        return 0;
+    }
+
+    if (!timeSynced())
+    {
+        syncTimeFromModem();    // No GPS fix and no NITZ yet, try again
+    }
+    char sendAt[24];
+    timeFormatIso(sendAt, sizeof(sendAt), timeUtcAt(millis()));
+    Serial.printf("UTC time: %s\n", sendAt);
 
     // // Initialize HTTPS
+#if HTTPS_SESSION
+    // Kept between posts, only what changed is sent to the modem again
+    modem.https_session_set_url(server_url);
+    modem.https_session_set_content_type(PAYLOAD_TYPE);
+    modem.https_session_set_accept_type("application/json");
+#else
     modem.https_begin();
 
     // Set GET URT
     if (!modem.https_set_url(server_url))
     {
         Serial.println("Failed to set the URL. Please check the validity of the URL!");
-        return;
+        return -1;
     }
 
     // Build the HTTPS POST request header (the below are just some random header examples)
     // modem.https_add_header("Accept-Language", "zh-CN,zh;q=0.9,en;q=0.8,en-GB;q=0.7,en-US;q=0.6");
     // modem.https_add_header("Accept-Encoding", "gzip, deflate, br");
-    modem.https_add_header("Content-Type", "application/json");
+    modem.https_add_header("Content-Type", PAYLOAD_TYPE);
     modem.https_add_header("Accept", "application/json");
+#endif
 
     // modem.https_set_user_agent("TinyGSM/LilyGo-A76XX");
 
     // Build the HTTPS POST request body
-    // String post_body = "This is post example!";
-    //String post_body = String("{\"itemId\":\"0009\",") + "\"location\":{\"lat\":1.35210,\"lng\":103.81980,\"accuracy\":12}," + "\"at\":\"2025-08-09T10:22:00+08:00\"," + "\"severity\":\"warning\"}";
-    // String post_body = String("{\"itemId\":\"0001\",") + "\"location\":{\"lat\":" + String(gps.location.lat(), 5) + ",\"lng\":" + String(gps.location.lng(), 5)+ ",\"accuracy\":" + String(gps.satellites.value())+ "}," + "\"at\":\"" + time + "\"," + "\"severity\":\"" + pmaState + "\"" + "}";
-    String post_body;
-    post_body.reserve(512);  // prevent repeated reallocations
-    post_body = "{\"itemId\":\"0001\",";
-    post_body += "\"location\":{\"lat\":";
-    post_body += String(lat, 5);
-    post_body += ",\"lng\":";
-    post_body += String(lng, 5);
-    post_body += ",\"accuracy\":";
-    post_body += String(accuracy);
-    post_body += "},\"at\":\"";
-    post_body += HTTPtime;
-    post_body += "\",\"severity\":\"";
-    post_body += pmaState;
-    post_body += "\",\"SOC\":\"";
-    post_body += input_soc;
-    post_body += "\",\"chargeState\":\"";
-    post_body += input_chg;
-    post_body += "\"}";
-
-    // char post_body[256];
-    // snprintf(post_body, sizeof(post_body),
-    // "{\"itemId\":\"0001\",\"location\":{\"lat\":%.5f,\"lng\":%.5f,\"accuracy\":%.0f},\"at\":\"%s\",\"severity\":\"%s\"}",
-    // lat, lng, accuracy, time.c_str(), pmaState.c_str());
-
-    Serial.println("---- POST body (debug) ----");
-    Serial.println(post_body);
-    Serial.println("---------------------------");
+#if CBOR_PAYLOAD
+    CborWriter cbor((uint8_t *)uplinkBody, sizeof(uplinkBody));
+    post.taken = writeBatch(cbor, appendCborRecord, snaps, count);
+    const char *body = uplinkBody;
+    size_t bodyLength = cbor.length();
+#else
+    JsonWriter json(uplinkBody, sizeof(uplinkBody));
+    post.taken = writeBatch(json, appendRecord, snaps, count);
+    const char *body = json.c_str();
+    size_t bodyLength = json.length();
+    if (post.taken == 1)
+    {
+        body++;             // A single record goes without the brackets
+        bodyLength -= 2;
+    }
+#endif
+    post.bodyBytes = bodyLength;
+
+    printBody("---- POST body (debug) ----", body, bodyLength);
 
     // .https_post transmits the HTTPS POST request and returns the HTTP status code (e.g. 200, 400, 500, etc.)
-    int httpCode = modem.https_post(post_body);
+#if HTTPS_SESSION
+    // Sets the session up again by itself when the modem dropped it
+    int httpCode = modem.https_session_post(body, bodyLength);
+#else
+    int httpCode = modem.https_post(body, bodyLength);
+#endif
     if (httpCode < 200 || httpCode >= 300)
     {
         Serial.print("HTTP post failed! status = ");
         Serial.println(httpCode);
         // Optionally print response to see error
+        const int replyLength = modem.https_body((uint8_t *)uplinkReply, sizeof(uplinkReply) - 1);
+        uplinkReply[replyLength] = '\0';
         Serial.print("HTTP body (error): ");
-        Serial.println(modem.https_body());
+        Serial.println(uplinkReply);
+#if !HTTPS_SESSION
         modem.https_end();
-        return;
+#endif
+        return httpCode;
     }
 
     // Get HTTPS response (response from the server) header information
-    String header = modem.https_header();
+    modem.https_header(uplinkReply, sizeof(uplinkReply));
     Serial.println("_______________________________________________");
     Serial.println("Response Header");
     Serial.println("_______________________________________________");
-    Serial.println(header);
+    Serial.println(uplinkReply);
 
-    // Get HTTPS response body information
-    String body = modem.https_body();
+    // Get HTTPS response body information, cut to the buffer
+    const int replyLength = modem.https_body((uint8_t *)uplinkReply, sizeof(uplinkReply) - 1);
+    uplinkReply[replyLength] = '\0';
     Serial.println("_______________________________________________");
     Serial.println("Response body : ");
     Serial.println("_______________________________________________");
-    Serial.println(body);
+    Serial.println(uplinkReply);
 
+#if !HTTPS_SESSION
     // Disconnect http server
     modem.https_end();
     delay(100);
+#endif
 
     Serial.println("***********************************************************************************************");
     Serial.println("End of HTTPS POST request and response");
@@ -399,8 +503,149 @@ void postData()
     // delay(100);
     // SerialGPS.begin(9600, SERIAL_8N1, BOARD_GPS_RX_PIN, BOARD_GPS_TX_PIN);
     //delay(postInterval); // wait 15 seconds
+    return httpCode;
+}
+
+#if MQTT_TRANSPORT
+bool mqttStarted = false;       // +CMQTTSTART done, mqtt_handle() may run
+bool mqttUp = false;            // Connected, subscribed and announced
+uint32_t mqttConnects = 0;
+
+// (Re)connects when needed: last will, command subscription, "online" status
+bool mqttConnect()
+{
+    if (mqttUp && modem.mqtt_connected(MQTT_CLIENT))
+    {
+        return true;
+    }
+    if (mqttStarted)
+    {
+        modem.mqtt_disconnect(MQTT_CLIENT, 60); // Also stops the modem's MQTT service
+        mqttStarted = false;
+    }
+    mqttUp = false;
+    if (!modem.mqtt_begin(MQTT_BROKER_TLS))
+    {
+        Serial.println("MQTT: cannot start the modem's MQTT service");
+        return false;
+    }
+    mqttStarted = true;
+    modem.setWillMessage(MQTT_TOPIC_STATUS, "offline", 1);
+    if (!modem.mqtt_connect(MQTT_CLIENT, MQTT_BROKER_HOST, MQTT_BROKER_PORT, MQTT_CLIENT_ID,
+                            MQTT_USERNAME, MQTT_PASSWORD, MQTT_KEEPALIVE_S))
+    {
+        Serial.println("MQTT: cannot connect to " MQTT_BROKER_HOST);
+        return false;
+    }
+    if (!modem.mqtt_subscribe(MQTT_CLIENT, MQTT_TOPIC_CMD, 1))
+    {
+        Serial.println("MQTT: cannot subscribe to " MQTT_TOPIC_CMD);
+        return false;
+    }
+    modem.mqtt_publish(MQTT_CLIENT, MQTT_TOPIC_STATUS, "online", 1);
+    mqttUp = true;
+    mqttConnects++;
+    return true;
 }
 
+// Runs in the uplink task with the modem locked, the MQTT counterpart of postData(). The batch
+// goes out as one QoS 1 publish of a JSON array (or the CBOR body of CBOR_PAYLOAD); 200 means the broker acknowledged it, 0 keeps
+// the snapshots for later.
+int mqttSendData(const TelemetrySnapshot *snaps, uint8_t count, UplinkPost &post)
+{
+    if (!modem.isNetworkConnected())
+    {
+        Serial.println("Not registered, publish deferred.");
+        return 0;
+    }
+    if (!mqttConnect())
+    {
+        return 0;
+    }
+
+    if (!timeSynced())
+    {
+        syncTimeFromModem();
+    }
+
+#if CBOR_PAYLOAD
+    CborWriter out((uint8_t *)uplinkBody, sizeof(uplinkBody));
+    post.taken = writeBatch(out, appendCborRecord, snaps, count);
+#else
+    JsonWriter out(uplinkBody, sizeof(uplinkBody));
+    post.taken = writeBatch(out, appendMqttRecord, snaps, count);
+#endif
+    // PUBLISH on the wire: fixed header, topic, packet id, payload (PUBACK adds 4 more)
+    post.bodyBytes = 2 + 2 + strlen(MQTT_TOPIC_TELEMETRY) + 2 + out.length();
+
+    printBody("---- MQTT payload (debug) ----", uplinkBody, out.length());
+
+    if (!modem.mqtt_publish(MQTT_CLIENT, MQTT_TOPIC_TELEMETRY, (const uint8_t *)uplinkBody, out.length(), 1, 60))
+    {
+        Serial.println("MQTT publish not acknowledged.");
+        mqttUp = false; // Reconnect before the next try
+        return 0;
+    }
+    return 200;
+}
+
+// Server commands on MQTT_TOPIC_CMD:
+//   "report"         post a snapshot right away
+//   "interval <s>"   take a snapshot every s seconds (5 to 3600) instead of the report policy's
+//   "interval auto"  back to the report policy
+// The modem's callback runs wherever its output is read: mqtt_handle() in loop(), or the uplink
+// task when a command arrives while mqtt_publish() waits for the PUBACK. So it only keeps the
+// command (a newer one replaces one not run yet) and loop() runs it with mqttRunCommand().
+static char mqttPendingCmd[32];
+static bool mqttCmdPending = false;
+static portMUX_TYPE mqttCmdMux = portMUX_INITIALIZER_UNLOCKED;
+
+void mqttCommand(const char *topic, const uint8_t *payload, uint32_t len)
+{
+    len = min(len, (uint32_t)sizeof(mqttPendingCmd) - 1);
+    portENTER_CRITICAL(&mqttCmdMux);
+    memcpy(mqttPendingCmd, payload, len);
+    mqttPendingCmd[len] = '\0';
+    mqttCmdPending = true;
+    portEXIT_CRITICAL(&mqttCmdMux);
+}
+
+// Runs in loop(): the command mqttCommand() kept, if any
+void mqttRunCommand()
+{
+    char cmd[sizeof(mqttPendingCmd)];
+    portENTER_CRITICAL(&mqttCmdMux);
+    const bool pending = mqttCmdPending;
+    memcpy(cmd, mqttPendingCmd, sizeof(cmd));
+    mqttCmdPending = false;
+    portEXIT_CRITICAL(&mqttCmdMux);
+    if (!pending)
+    {
+        return;
+    }
+    Serial.printf("MQTT command on %s: %s\n", MQTT_TOPIC_CMD, cmd);
+    if (strcmp(cmd, "report") == 0)
+    {
+        uplinkFlush();
+        uplinkEnqueue(takeSnapshot());
+        postTime = millis();
+    }
+    else if (strcmp(cmd, "interval auto") == 0)
+    {
+        reportPolicyPin(0);
+    }
+    else if (strncmp(cmd, "interval ", 9) == 0)
+    {
+        const unsigned long seconds = strtoul(cmd + 9, NULL, 10);
+        if (seconds >= 5 && seconds <= 3600)
+        {
+            reportPolicyPin(seconds * 1000);
+            postInterval = seconds * 1000;
+        }
+    }
+}
+#endif
+
 float check_angle(float chk_angle)
 {
   if (chk_angle > 180)
@@ -499,6 +744,14 @@ void displayInfo()
         //To check if the gps is actually working/updated
         Serial.println(gps.location.isValid() ? "GPS FIXED" : "NO FIX");
         Serial.println(gps.charsProcessed()); // shows how many characters TinyGPS++ has parsed
+        uplinkPrintStats();
+        timePrintStats();
+        reportPrintStats();
+#if MQTT_TRANSPORT
+        Serial.printf("MQTT: %s, %lu connect(s)\n", mqttUp ? "connected" : "not connected", (unsigned long)mqttConnects);
+#elif HTTPS_SESSION
+        printHttpsSessionStats();
+#endif
         Serial.println();
         if (millis() - lastCheck > 5000) 
         {
@@ -535,6 +788,7 @@ void gpsTask(void *parameter)
     //   char c = SerialGPS.read(); // debug to see if the gps is reading any raw nmea sentence, to check if gps is updating
     //   Serial.write(c);
     }
+    syncTimeFromGps();
     //Serial.println("gpsTask running..."); //debug to see if the task is running
     vTaskDelay(10 / portTICK_PERIOD_MS); // small delay to yield
   }
@@ -661,6 +915,11 @@ void alertTask(void* parameter) //rtos
 { 
     for (;;) {
         if (potentialFall){
+            pmaState = "Toppled";
+            if (uplinkAlarm(UPLINK_EVENT_TOPPLE, true))
+            {
+                uplinkRaise(UPLINK_EVENT_TOPPLE, takeSnapshot()); // Before the buzzer's second
+            }
             Serial.println("Alert sound!");
             int buzz = 0; //counter for buzzer loop
             for (buzz=0; buzz<3; buzz++) 
@@ -671,11 +930,11 @@ void alertTask(void* parameter) //rtos
                 delay(50);
             }
             //delay(100);
-            pmaState = "Toppled";
         }
         else
         {
             pmaState = "Safe";
+            uplinkAlarm(UPLINK_EVENT_TOPPLE, false);
         }
         vTaskDelay(200 / portTICK_PERIOD_MS); // wait 1 second
     }
@@ -1055,14 +1314,26 @@ void setup()
 //added
     lastUpdateTime = millis();
 
-    modem.sendAT("+CCLK?");
-    if (modem.waitResponse(1000, "+CCLK:") == 1) {
-    timeStr = modem.stream.readStringUntil('\n');
-    timeStr.trim();
-    Serial.println("Module time: " + timeStr);
+    // Let the network set the modem clock (NITZ), the time source until GPS has a fix
+    modem.sendAT("+CTZU=1");
+    modem.waitResponse();
+    syncTimeFromModem();
+
+#if HTTPS_SESSION
+    // After a longer gap (several failed batches) start over instead of trying the old session
+    modem.https_session_set_max_idle(10 * 60 * 1000UL);
+#endif
+
+    // From here on the modem belongs to the uplink task, loop() only queues snapshots
+#if MQTT_TRANSPORT
+    modem.mqtt_set_callback(mqttCommand);
+    if (!uplinkBegin(mqttSendData))
+#else
+    if (!uplinkBegin(postData))
+#endif
+    {
+        Serial.println("Failed to start the uplink task!");
     }
-    SerialAT.println("AT+CTZU?");  // check if automatic time zone update is on
-    SerialAT.println("AT+CTZU=1"); // enable NITZ auto update
 
     // xTaskCreate(
     // relayTask,       // Task function
@@ -1103,6 +1374,26 @@ void setup()
     delay(3000); // Wait for tasks to initialize
 }
 
+// Runs in loop(): the battery event from the latest good BMS read, if one came in
+void checkBattery()
+{
+    portENTER_CRITICAL(&batteryReadMux);
+    const bool pending = batteryReadPending;
+    const int soc = batteryReadSoc;
+    const int chg = batteryReadChg;
+    batteryReadPending = false;
+    portEXIT_CRITICAL(&batteryReadMux);
+    if (!pending)
+    {
+        return;
+    }
+    batteryCritical = !chg && soc >= 0 && soc <= (batteryCritical ? BATTERY_CRITICAL_CLEAR_SOC : BATTERY_CRITICAL_SOC);
+    if (uplinkAlarm(UPLINK_EVENT_BATTERY, batteryCritical))
+    {
+        uplinkRaise(UPLINK_EVENT_BATTERY, takeSnapshot()); // Posted at once, ahead of the routine queue
+    }
+}
+
 void loop()
 {
     //added
@@ -1113,23 +1404,47 @@ void loop()
     // }else{
     //     pmaState = "Safe";
     // }
+    if (millis() - policyTime >= 1000)
+    {
+        // A faster mode takes effect at once: the next check below is already past its interval
+        policyTime = millis();
+        postInterval = reportPolicyUpdate(readReportInputs(), policyTime);
+    }
+    checkBattery();
     if (millis() - postTime > postInterval)//call it once every interval
     { 
-        Serial.println("Posting data...");
-        postData(); //commented out to use rtos task instead
+        // Never blocks: the uplink task posts it when the modem is free
+        if (!uplinkEnqueue(takeSnapshot()))
+        {
+            Serial.println("Uplink not running, sample lost.");
+        }
         postTime = millis();
-        Serial.println("Post data done.");
     }
 
-    // Debug AT
-    if (SerialAT.available())
+#if MQTT_TRANSPORT
+    // Server commands arrive as URCs, so the modem's output is for mqtt_handle() instead of the
+    // debug AT passthrough
+    if (mqttStarted && modemTryLock())
     {
-        Serial.write(SerialAT.read());
+        modem.mqtt_handle(10);
+        modemUnlock();
     }
-    if (Serial.available())
+    mqttRunCommand();
+#else
+    // Debug AT, only while the uplink task is not using the modem
+    if (modemTryLock())
     {
-        SerialAT.write(Serial.read());
+        if (SerialAT.available())
+        {
+            Serial.write(SerialAT.read());
+        }
+        if (Serial.available())
+        {
+            SerialAT.write(Serial.read());
+        }
+        modemUnlock();
     }
+#endif
     delay(1);
 }
 
@@ -0,0 +1,155 @@
+/**
+ * @file      cbor_writer.h
+ * @brief     Streaming CBOR (RFC 8949) writer into a caller's fixed buffer, no heap
+ * @note
+ * * The binary counterpart of JsonWriter for CBOR_PAYLOAD: same buffer, same ok() / mark() /
+ *   rewind(), so the uplink fills a batch the same way whichever encoding it sends.
+ * * Only what the telemetry schema needs: integers in their shortest form, fixed point numbers
+ *   as scaled integers, text strings, tags, definite length arrays and indefinite length arrays
+ *   (a batch does not know its record count until the byte budget has been checked, so it is
+ *   closed with a break byte instead).
+ * * The telemetry schema itself is described in telemetry_cbor.py, the reference decoder.
+ */
+
+#pragma once
+
+#include <math.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+class CborWriter
+{
+public:
+    CborWriter(uint8_t *buffer, size_t size) : buf_(buffer), size_(size)
+    {
+        reset();
+    }
+
+    void reset()
+    {
+        len_ = 0;
+        ok_ = true;
+    }
+
+    void beginArray(size_t items) { head(4, items); }
+    void beginArray()             { put(0x9f); }   // Indefinite length, endArray() closes it
+    void endArray()               { put(0xff); }
+    void tag(uint64_t number)     { head(6, number); }
+
+    void integer(int64_t v)
+    {
+        if (v < 0)
+        {
+            head(1, (uint64_t)(-1 - v));
+        }
+        else
+        {
+            head(0, (uint64_t)v);
+        }
+    }
+
+    // v x 10^decimals as an integer (at most 6 decimals), rounded half away from zero like
+    // JsonWriter::fixed(), so both encodings carry the same value. NaN and infinities are null.
+    void fixed(float v, uint8_t decimals)
+    {
+        static const uint32_t scale[] = {1, 10, 100, 1000, 10000, 100000, 1000000};
+        if (decimals > 6)
+        {
+            decimals = 6;
+        }
+        const double scaled = fabs((double)v) * scale[decimals] + 0.5;
+        if (isnan(v) || isinf(v) || scaled >= 9223372036854775807.0)
+        {
+            put(0xf6);
+            return;
+        }
+        const int64_t n = (int64_t)scaled;
+        integer(v < 0 ? -n : n);
+    }
+
+    void string(const char *s)
+    {
+        const size_t n = strlen(s);
+        head(3, n);
+        bytes((const uint8_t *)s, n);
+    }
+
+    size_t mark() const { return len_; }
+
+    void rewind(size_t mark)
+    {
+        if (mark > len_)
+        {
+            return;
+        }
+        len_ = mark;
+        ok_ = true;
+    }
+
+    bool ok() const { return ok_; }
+    size_t length() const { return len_; }
+    const uint8_t *data() const { return buf_; }
+
+private:
+    // Major type and argument, the argument in as few bytes as it fits
+    void head(uint8_t major, uint64_t arg)
+    {
+        major <<= 5;
+        if (arg < 24)
+        {
+            put(major | (uint8_t)arg);
+        }
+        else if (arg <= 0xff)
+        {
+            put(major | 24);
+            put((uint8_t)arg);
+        }
+        else if (arg <= 0xffff)
+        {
+            put(major | 25);
+            be(arg, 2);
+        }
+        else if (arg <= 0xffffffffUL)
+        {
+            put(major | 26);
+            be(arg, 4);
+        }
+        else
+        {
+            put(major | 27);
+            be(arg, 8);
+        }
+    }
+
+    void be(uint64_t v, uint8_t n)
+    {
+        while (n--)
+        {
+            put((uint8_t)(v >> (8 * n)));
+        }
+    }
+
+    void bytes(const uint8_t *p, size_t n)
+    {
+        while (n--)
+        {
+            put(*p++);
+        }
+    }
+
+    void put(uint8_t b)
+    {
+        if (!ok_ || len_ >= size_)
+        {
+            ok_ = false;
+            return;
+        }
+        buf_[len_++] = b;
+    }
+
+    uint8_t *buf_;
+    size_t size_;
+    size_t len_;
+    bool ok_;
+};
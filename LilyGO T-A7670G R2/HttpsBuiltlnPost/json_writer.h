@@ -0,0 +1,226 @@
+/**
+ * @file      json_writer.h
+ * @brief     Streaming JSON writer into a caller's fixed buffer, no heap
+ * @note
+ * * The uplink builds every body in the same static buffer: nothing is allocated per post, so a
+ *   device that posts every 15 s for weeks does not fragment the heap. Numbers are written as
+ *   fixed point by hand instead of through String(float) or printf("%f"), which go through
+ *   dtoa and its heap allocated big integers.
+ * * Commas are placed by the writer. A container that was just opened has no element yet, one
+ *   that was just closed is an element of its parent, so one flag is all the state it needs.
+ * * When something does not fit, nothing past the buffer is touched, ok() turns false and the
+ *   text stays terminated. mark() / rewind() take back what was written since the mark, the
+ *   uplink uses them to stop a batch at its byte budget.
+ */
+
+#pragma once
+
+#include <math.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+class JsonWriter
+{
+public:
+    JsonWriter(char *buffer, size_t size) : buf_(buffer), size_(size)
+    {
+        reset();
+    }
+
+    void reset()
+    {
+        len_ = 0;
+        ok_ = size_ > 0;
+        first_ = true;
+        if (ok_)
+        {
+            buf_[0] = '\0';
+        }
+    }
+
+    void beginObject() { element(); put('{'); first_ = true; }
+    void endObject()   { put('}'); first_ = false; }
+    void beginArray()  { element(); put('['); first_ = true; }
+    void endArray()    { put(']'); first_ = false; }
+
+    // Member name, the value follows with one of the calls below
+    void key(const char *name)
+    {
+        element();
+        quoted(name);
+        put(':');
+        first_ = true; // No comma between the name and its value
+    }
+
+    void string(const char *s)
+    {
+        element();
+        quoted(s);
+    }
+
+    void integer(long v)
+    {
+        element();
+        if (v < 0)
+        {
+            put('-');
+            digits(0UL - (unsigned long)v, 1);
+        }
+        else
+        {
+            digits((unsigned long)v, 1);
+        }
+    }
+
+    // v with exactly decimals digits after the point (at most 6), rounded half away from zero.
+    // NaN and infinities have no JSON form and are written as null.
+    void fixed(float v, uint8_t decimals)
+    {
+        element();
+        if (isnan(v) || isinf(v))
+        {
+            text("null");
+            return;
+        }
+        static const uint32_t scale[] = {1, 10, 100, 1000, 10000, 100000, 1000000};
+        if (decimals > 6)
+        {
+            decimals = 6;
+        }
+        const double scaled = fabs((double)v) * scale[decimals] + 0.5;
+        if (scaled >= 18446744073709551615.0)
+        {
+            text("null");
+            return;
+        }
+        const uint64_t n = (uint64_t)scaled;
+        if (v < 0 && n != 0)
+        {
+            put('-');
+        }
+        digits64(n / scale[decimals], 1);
+        if (decimals)
+        {
+            put('.');
+            digits((unsigned long)(n % scale[decimals]), decimals);
+        }
+    }
+
+    // Written as is, the caller makes sure it is valid JSON
+    void raw(const char *json)
+    {
+        element();
+        text(json);
+    }
+
+    size_t mark() const { return len_; }
+
+    void rewind(size_t mark)
+    {
+        if (mark > len_)
+        {
+            return;
+        }
+        len_ = mark;
+        buf_[len_] = '\0';
+        ok_ = true;
+        first_ = len_ == 0 || buf_[len_ - 1] == '[' || buf_[len_ - 1] == '{';
+    }
+
+    bool ok() const { return ok_; }
+    size_t length() const { return len_; }
+    const char *c_str() const { return buf_; }
+
+private:
+    void element()
+    {
+        if (!first_)
+        {
+            put(',');
+        }
+        first_ = false;
+    }
+
+    void put(char c)
+    {
+        if (!ok_ || len_ + 1 >= size_)
+        {
+            ok_ = false;
+            return;
+        }
+        buf_[len_++] = c;
+        buf_[len_] = '\0';
+    }
+
+    void text(const char *s)
+    {
+        while (*s)
+        {
+            put(*s++);
+        }
+    }
+
+    void quoted(const char *s)
+    {
+        static const char hex[] = "0123456789abcdef";
+        put('"');
+        for (; *s; s++)
+        {
+            const uint8_t c = (uint8_t)*s;
+            if (c == '"' || c == '\\')
+            {
+                put('\\');
+                put((char)c);
+            }
+            else if (c < 0x20)
+            {
+                text("\\u00");
+                put(hex[c >> 4]);
+                put(hex[c & 0x0f]);
+            }
+            else
+            {
+                put((char)c);
+            }
+        }
+        put('"');
+    }
+
+    // At least width digits, zero padded
+    void digits(unsigned long v, uint8_t width)
+    {
+        char tmp[12];
+        uint8_t n = 0;
+        do
+        {
+            tmp[n++] = (char)('0' + v % 10);
+            v /= 10;
+        } while (v && n < sizeof(tmp));
+        while (n < width && n < sizeof(tmp))
+        {
+            tmp[n++] = '0';
+        }
+        while (n)
+        {
+            put(tmp[--n]);
+        }
+    }
+
+    void digits64(uint64_t v, uint8_t width)
+    {
+        if (v <= 0xFFFFFFFFUL)
+        {
+            digits((unsigned long)v, width);
+            return;
+        }
+        digits64(v / 1000000000UL, 1);
+        digits((unsigned long)(v % 1000000000UL), 9);
+    }
+
+    char *buf_;
+    size_t size_;
+    size_t len_;
+    bool ok_;
+    bool first_;
+};
@@ -0,0 +1,188 @@
+/**
+ * @file      report_policy.h
+ * @brief     Picks the snapshot interval from motion, charge and link state, with hysteresis
+ * @note
+ * * A parked PMA does not need a record every 15 s, one moving fast or one that just toppled
+ *   needs more than that. reportPolicyUpdate() is called from loop() with what the sensors say
+ *   and returns the interval postInterval should have:
+ *     parked   REPORT_PARKED_MS   GPS and IMU still, or on the charger
+ *     moving   REPORT_MOVING_MS   GPS speed or IMU rotation above the moving thresholds
+ *     fast     REPORT_FAST_MS     GPS speed above REPORT_FAST_KMPH
+ *     event    REPORT_EVENT_MS    for REPORT_EVENT_HOLD_MS after a safety event was raised
+ * * Hysteresis: a faster mode is taken on the first reading that asks for it, so no motion is
+ *   missed. A slower one only after the readings have asked for it without a break for a dwell
+ *   time (REPORT_FAST_DWELL_MS, REPORT_PARK_DWELL_MS), and the enter / leave thresholds differ,
+ *   so GPS speed noise around a stop or an uncalibrated gyro does not flip the mode.
+ * * Energy: with the battery low and not charging, or while the uplink cannot post (the records
+ *   go to the flash store), nothing but an event goes faster than REPORT_MOVING_MS.
+ * * The MQTT "interval" command pins a fixed interval, reportPolicyPin(0) goes back to automatic.
+ * * The interval is when a snapshot is taken, not when it reaches the server. With UPLINK_BATCHING
+ *   on, the uplink posts a batch at UPLINK_BATCH_MAX records or when the oldest is
+ *   UPLINK_BATCH_MAX_AGE_MS (3 min) old. A parked record, one per 5 min, therefore always waits out
+ *   those 3 min and goes alone. Fast-mode 5 s samples reach the server as batches of 12 about every
+ *   60 s, which defeats the point of fast mode for anyone watching live. With batching off (the
+ *   default) every snapshot is posted as soon as the modem is free.
+ * * test/06_Report_Policy_Replay replays the modes, dwell times and intervals on the PC: parked
+ *   takes 2 snapshots per 10 min, against 40 at the old fixed 15 s.
+ * * Only loop() calls it, so the state needs no lock.
+ */
+
+#pragma once
+
+#include <Arduino.h>
+
+#define REPORT_PARKED_MS        300000  // 5 min
+#define REPORT_MOVING_MS        15000
+#define REPORT_FAST_MS          5000
+#define REPORT_EVENT_MS         5000
+#define REPORT_EVENT_HOLD_MS    120000  // Event mode after the last raise
+#define REPORT_PARK_DWELL_MS    120000  // Still this long before moving turns to parked
+#define REPORT_FAST_DWELL_MS    30000   // Below REPORT_FAST_EXIT_KMPH this long before fast turns to moving
+#define REPORT_MOVING_KMPH      3.0f    // GPS speed that counts as moving
+#define REPORT_STILL_KMPH       1.5f    // and as still (GPS speed wanders by ~1 km/h when stopped)
+#define REPORT_FAST_KMPH        8.0f
+#define REPORT_FAST_EXIT_KMPH   6.0f
+#define REPORT_GYRO_MOVING_DPS  10.0f   // Average rotation rate that counts as moving
+#define REPORT_GYRO_STILL_DPS   5.0f    // and as still; raise both if the board's gyro offset is larger
+#define REPORT_LOW_SOC          20      // statusMessage()'s "BATTERY LOW"
+
+enum ReportMode
+{
+    REPORT_PARKED,
+    REPORT_MOVING,
+    REPORT_FAST,
+    REPORT_EVENT,
+    REPORT_MODE_COUNT
+};
+
+static const char *const reportModeNames[REPORT_MODE_COUNT] = {"parked", "moving", "fast", "event"};
+
+// One reading of everything the policy looks at
+typedef struct ReportInputs
+{
+    bool speedValid;        // GPS speed from a recent fix
+    float speedKmph;
+    float gyroDps;          // Average rotation rate, deg/s
+    int soc;                // %, -1 unknown
+    bool charging;
+    bool linkDown;          // The uplink is failing or replaying a backlog
+    uint32_t events;        // Safety events raised so far, any increase starts event mode
+} ReportInputs;
+
+typedef struct ReportStats
+{
+    ReportMode mode;        // Including the event overlay
+    uint32_t intervalMs;
+    bool pinned;
+    uint32_t changes;       // Mode changes
+    uint32_t modeMs[REPORT_MODE_COUNT]; // Time spent in each mode
+} ReportStats;
+
+static ReportMode reportMotion = REPORT_PARKED;     // parked / moving / fast, without the event overlay
+static uint32_t reportSlowerSinceMs = 0;            // The readings have asked for a slower mode since
+static bool reportSlower = false;
+static uint32_t reportEventUntilMs = 0;
+static uint32_t reportEvents = 0;
+static uint32_t reportPinnedMs = 0;
+static uint32_t reportLastMs = 0;
+static ReportStats reportStats = {REPORT_PARKED, REPORT_PARKED_MS, false, 0, {}};
+
+// ms > 0: always that interval, 0: automatic
+static void reportPolicyPin(uint32_t ms)
+{
+    reportPinnedMs = ms;
+}
+
+// Motion mode the readings ask for right now, and whether they allow leaving the current one
+static ReportMode reportWanted(const ReportInputs &in, ReportMode current)
+{
+    const float speed = in.speedValid ? in.speedKmph : 0.0f;
+    if (in.charging)
+    {
+        return REPORT_PARKED; // Plugged in: a bump is not a ride
+    }
+    if (speed >= REPORT_FAST_KMPH || (current == REPORT_FAST && speed >= REPORT_FAST_EXIT_KMPH))
+    {
+        return REPORT_FAST;
+    }
+    const bool moving = speed >= REPORT_MOVING_KMPH || in.gyroDps >= REPORT_GYRO_MOVING_DPS;
+    const bool still = speed < REPORT_STILL_KMPH && in.gyroDps < REPORT_GYRO_STILL_DPS;
+    if (moving || (current != REPORT_PARKED && !still))
+    {
+        return REPORT_MOVING;
+    }
+    return REPORT_PARKED;
+}
+
+// Call about once a second. Returns the interval to take snapshots at.
+static uint32_t reportPolicyUpdate(const ReportInputs &in, uint32_t now)
+{
+    const ReportMode wanted = reportWanted(in, reportMotion);
+    if (wanted > reportMotion)
+    {
+        reportMotion = wanted;
+        reportSlower = false;
+    }
+    else if (wanted < reportMotion)
+    {
+        if (!reportSlower)
+        {
+            reportSlower = true;
+            reportSlowerSinceMs = now;
+        }
+        const uint32_t dwell = (wanted == REPORT_PARKED) ? REPORT_PARK_DWELL_MS : REPORT_FAST_DWELL_MS;
+        if (now - reportSlowerSinceMs >= dwell)
+        {
+            reportMotion = wanted;
+            reportSlower = false;
+        }
+    }
+    else
+    {
+        reportSlower = false;
+    }
+
+    if (in.events != reportEvents)
+    {
+        reportEvents = in.events;
+        reportEventUntilMs = now + REPORT_EVENT_HOLD_MS;
+    }
+    const bool event = (int32_t)(reportEventUntilMs - now) > 0;
+
+    static const uint32_t motionMs[] = {REPORT_PARKED_MS, REPORT_MOVING_MS, REPORT_FAST_MS};
+    uint32_t interval = motionMs[reportMotion];
+    const bool lowBattery = !in.charging && in.soc >= 0 && in.soc <= REPORT_LOW_SOC;
+    if (lowBattery || in.linkDown)
+    {
+        interval = max(interval, (uint32_t)REPORT_MOVING_MS);
+    }
+    if (event)
+    {
+        interval = min(interval, (uint32_t)REPORT_EVENT_MS);
+    }
+    const ReportMode mode = event ? REPORT_EVENT : reportMotion;
+
+    if (reportLastMs != 0)
+    {
+        reportStats.modeMs[reportStats.mode] += now - reportLastMs;
+    }
+    reportLastMs = now;
+    if (mode != reportStats.mode)
+    {
+        reportStats.changes++;
+        reportStats.mode = mode;
+    }
+    reportStats.pinned = reportPinnedMs != 0;
+    reportStats.intervalMs = reportStats.pinned ? reportPinnedMs : interval;
+    return reportStats.intervalMs;
+}
+
+static void reportPrintStats()
+{
+    const ReportStats &s = reportStats;
+    Serial.printf("Report: %s, every %lu s%s, %lu changes, parked %lu s, moving %lu s, fast %lu s, event %lu s\n",
+                  reportModeNames[s.mode], (unsigned long)(s.intervalMs / 1000), s.pinned ? " (pinned)" : "",
+                  (unsigned long)s.changes,
+                  (unsigned long)(s.modeMs[REPORT_PARKED] / 1000), (unsigned long)(s.modeMs[REPORT_MOVING] / 1000),
+                  (unsigned long)(s.modeMs[REPORT_FAST] / 1000), (unsigned long)(s.modeMs[REPORT_EVENT] / 1000));
+}
@@ -0,0 +1,359 @@
+#!/usr/bin/env python3
+"""Local stand-in for the MQTT broker of MQTT_TRANSPORT, and a bytes / round trip benchmark of the
+MQTT transport against HTTPS POST.
+
+Broker: a minimal MQTT 3.1.1 broker, enough for the firmware: CONNECT with a last will,
+PUBLISH QoS 0/1, SUBSCRIBE with + and # wildcards, PINGREQ and DISCONNECT. The will goes out
+when a client drops without DISCONNECT. Telemetry publishes are printed with their record count
+and size, and each line typed on stdin is published to the command topic (e.g. "report" or
+"interval 30"). Build the firmware with -DMQTT_TRANSPORT=1 -DMQTT_BROKER_HOST=\\"<this pc>\\" and run
+  python stub_broker.py --port 1883
+
+  python stub_broker.py --selftest
+starts the broker and stub_endpoint.py on free ports and checks the protocol: a device that
+connects with a will, subscribes to its commands, publishes a batch with QoS 1 and drops. It
+then posts the same records over HTTP and prints the bytes on the wire per record and the
+modem round trips for each transport. TLS is not included, which adds a handshake per HTTPS
+post but only one per MQTT connection. Only bytes and command counts are compared: latency and
+modem-on time need the modem on a real network and are not measured here.
+"""
+
+import argparse
+import json
+import os
+import socket
+import struct
+import sys
+import threading
+
+import telemetry_cbor
+
+TOPIC_TELEMETRY = "pma/0001/telemetry"
+TOPIC_STATUS = "pma/0001/status"
+TOPIC_CMD = "pma/0001/cmd"
+
+CONNECT, CONNACK, PUBLISH, PUBACK = 1, 2, 3, 4
+SUBSCRIBE, SUBACK, PINGREQ, PINGRESP, DISCONNECT = 8, 9, 12, 13, 14
+
+
+def encode_length(n):
+    out = bytearray()
+    while True:
+        b, n = n % 128, n // 128
+        out.append(b | (0x80 if n else 0))
+        if not n:
+            return bytes(out)
+
+
+def mqtt_string(s):
+    b = s.encode() if isinstance(s, str) else s
+    return struct.pack(">H", len(b)) + b
+
+
+def packet(ptype, flags, body):
+    return bytes([(ptype << 4) | flags]) + encode_length(len(body)) + body
+
+
+def read_packet(sock):
+    """Returns (type, flags, body, bytes on the wire) or None when the connection is gone."""
+    head = sock.recv(1)
+    if not head:
+        return None
+    n, shift, size = 0, 0, 1
+    while True:
+        b = sock.recv(1)
+        if not b:
+            return None
+        size += 1
+        n |= (b[0] & 0x7F) << shift
+        shift += 7
+        if not b[0] & 0x80:
+            break
+    body = b""
+    while len(body) < n:
+        chunk = sock.recv(n - len(body))
+        if not chunk:
+            return None
+        body += chunk
+    return head[0] >> 4, head[0] & 0x0F, body, size + n
+
+
+def topic_matches(pattern, topic):
+    p, t = pattern.split("/"), topic.split("/")
+    for i, part in enumerate(p):
+        if part == "#":
+            return True
+        if i >= len(t) or (part != "+" and part != t[i]):
+            return False
+    return len(p) == len(t)
+
+
+class Broker:
+    def __init__(self, port, quiet=False):
+        self.sock = socket.socket(socket.AF_INET, socket.SOCK_STREAM)
+        self.sock.setsockopt(socket.SOL_SOCKET, socket.SO_REUSEADDR, 1)
+        self.sock.bind(("0.0.0.0", port))
+        self.sock.listen(4)
+        self.port = self.sock.getsockname()[1]
+        self.quiet = quiet
+        self.lock = threading.Lock()
+        self.clients = {}  # socket -> {"id", "subs", "will"}
+        self.bytes_in = self.bytes_out = 0
+
+    def log(self, *a):
+        if not self.quiet:
+            print(*a)
+
+    def serve_forever(self):
+        while True:
+            try:
+                conn, _ = self.sock.accept()
+            except OSError:
+                return
+            threading.Thread(target=self.client, args=(conn,), daemon=True).start()
+
+    def send(self, conn, data):
+        with self.lock:
+            self.bytes_out += len(data)
+        try:
+            conn.sendall(data)
+        except OSError:
+            pass
+
+    def publish(self, topic, payload, qos=1):
+        with self.lock:
+            targets = [c for c, st in self.clients.items() if any(topic_matches(s, topic) for s in st["subs"])]
+        for c in targets:
+            body = mqtt_string(topic) + (struct.pack(">H", 1) if qos else b"") + payload
+            self.send(c, packet(PUBLISH, qos << 1, body))
+
+    def client(self, conn):
+        state = {"id": "?", "subs": [], "will": None}
+        with self.lock:
+            self.clients[conn] = state
+        clean = False
+        try:
+            while True:
+                p = read_packet(conn)
+                if p is None:
+                    break
+                ptype, flags, body, size = p
+                with self.lock:
+                    self.bytes_in += size
+                if ptype == CONNECT:
+                    plen = struct.unpack(">H", body[:2])[0]
+                    pos = 2 + plen + 1
+                    cflags = body[pos]
+                    pos += 1 + 2  # flags, keepalive
+                    idlen = struct.unpack(">H", body[pos:pos + 2])[0]
+                    state["id"] = body[pos + 2:pos + 2 + idlen].decode()
+                    pos += 2 + idlen
+                    if cflags & 0x04:
+                        tl = struct.unpack(">H", body[pos:pos + 2])[0]
+                        wt = body[pos + 2:pos + 2 + tl].decode()
+                        pos += 2 + tl
+                        ml = struct.unpack(">H", body[pos:pos + 2])[0]
+                        state["will"] = (wt, body[pos + 2:pos + 2 + ml], (cflags >> 3) & 3)
+                    self.log("connect %s, will %s" % (state["id"], state["will"]))
+                    self.send(conn, packet(CONNACK, 0, b"\x00\x00"))
+                elif ptype == PUBLISH:
+                    qos = (flags >> 1) & 3
+                    tl = struct.unpack(">H", body[:2])[0]
+                    topic = body[2:2 + tl].decode()
+                    pos = 2 + tl
+                    if qos:
+                        pid = body[pos:pos + 2]
+                        pos += 2
+                        self.send(conn, packet(PUBACK, 0, pid))
+                    payload = body[pos:]
+                    if topic_matches("pma/+/telemetry", topic):
+                        try:
+                            n = len(json.loads(payload))
+                        except ValueError:
+                            try:
+                                n = len(telemetry_cbor.decode_body(payload))  # CBOR_PAYLOAD
+                            except ValueError:
+                                n = 0
+                        self.log("%s: %d records, %d bytes on the wire (%.0f per record)" % (
+                            topic, n, size, size / max(n, 1)))
+                    else:
+                        self.log("%s: %s" % (topic, payload[:80]))
+                    self.publish(topic, payload, qos)
+                elif ptype == SUBSCRIBE:
+                    pid, pos, granted = body[:2], 2, b""
+                    while pos < len(body):
+                        tl = struct.unpack(">H", body[pos:pos + 2])[0]
+                        state["subs"].append(body[pos + 2:pos + 2 + tl].decode())
+                        granted += bytes([min(body[pos + 2 + tl], 1)])
+                        pos += 3 + tl
+                    self.send(conn, packet(SUBACK, 0, pid + granted))
+                elif ptype == PINGREQ:
+                    self.send(conn, packet(PINGRESP, 0, b""))
+                elif ptype == DISCONNECT:
+                    clean = True
+                    break
+        except OSError:
+            pass
+        finally:
+            with self.lock:
+                self.clients.pop(conn, None)
+            conn.close()
+            if not clean and state["will"]:
+                self.log("%s dropped, last will to %s" % (state["id"], state["will"][0]))
+                self.publish(state["will"][0], state["will"][1], state["will"][2])
+
+
+class Client:
+    """Just enough of a client for the self-test, counting its bytes on the wire."""
+
+    def __init__(self, port, client_id, will=None):
+        self.sock = socket.create_connection(("127.0.0.1", port))
+        self.sent = self.received = 0
+        self.pid = 0
+        flags, payload = 0x02, mqtt_string(client_id)
+        if will:
+            flags |= 0x04 | (will[2] << 3)
+            payload += mqtt_string(will[0]) + mqtt_string(will[1])
+        self.write(packet(CONNECT, 0, mqtt_string("MQTT") + bytes([4, flags]) + struct.pack(">H", 120) + payload))
+        assert self.read()[0] == CONNACK
+
+    def write(self, data):
+        self.sent += len(data)
+        self.sock.sendall(data)
+
+    def read(self, timeout=2.0):
+        self.sock.settimeout(timeout)
+        p = read_packet(self.sock)
+        self.received += p[3]
+        return p
+
+    def subscribe(self, topic):
+        self.pid += 1
+        self.write(packet(SUBSCRIBE, 2, struct.pack(">H", self.pid) + mqtt_string(topic) + b"\x01"))
+        assert self.read()[0] == SUBACK
+
+    def publish(self, topic, payload, qos=1):
+        self.pid += 1
+        body = mqtt_string(topic) + (struct.pack(">H", self.pid) if qos else b"") + payload
+        self.write(packet(PUBLISH, qos << 1, body))
+        if qos:
+            assert self.read()[0] == PUBACK
+
+    def next_publish(self):
+        ptype, flags, body, _ = self.read()
+        assert ptype == PUBLISH
+        tl = struct.unpack(">H", body[:2])[0]
+        pos = 2 + tl + (2 if (flags >> 1) & 3 else 0)
+        return body[2:2 + tl].decode(), body[pos:]
+
+
+def compact_record(i):
+    """A record as appendMqttRecord() in telemetry_body.h writes it."""
+    return ('{"lat":%.5f,"lng":%.5f,"acc":7,"at":"2025-10-24T07:%02d:%02d+08:00","sev":"Safe","soc":%d,"chg":%d}'
+            % (1.2962018 + i * 1e-5, 103.776899, (i * 15) // 60, (i * 15) % 60, 87 - i % 3, i % 2))
+
+
+def http_wire_bytes(port, body):
+    """Bytes of one POST the way the modem sends it, and of the answer, over a raw socket."""
+    req = ("POST / HTTP/1.1\r\nHost: 127.0.0.1:%d\r\nUser-Agent: A7670G\r\nContent-Type: application/json\r\n"
+           "Accept: application/json\r\nContent-Length: %d\r\nConnection: close\r\n\r\n" % (port, len(body))).encode()
+    s = socket.create_connection(("127.0.0.1", port))
+    s.sendall(req + body.encode())
+    reply = b""
+    while True:
+        chunk = s.recv(4096)
+        if not chunk:
+            break
+        reply += chunk
+    s.close()
+    return len(req) + len(body), len(reply), int(reply.split()[1])
+
+
+def selftest():
+    sys.path.insert(0, os.path.dirname(os.path.abspath(__file__)))
+    import stub_endpoint
+    from http.server import HTTPServer
+
+    broker = Broker(0, quiet=True)
+    threading.Thread(target=broker.serve_forever, daemon=True).start()
+    fails = 0
+
+    def check(ok, what):
+        nonlocal fails
+        fails += not ok
+        print("%-4s %s" % ("ok" if ok else "FAIL", what))
+
+    server = Client(broker.port, "server")
+    server.subscribe("pma/+/telemetry")
+    server.subscribe("pma/+/status")
+    device = Client(broker.port, "pma-0001", (TOPIC_STATUS, b"offline", 1))
+    device.subscribe(TOPIC_CMD)
+    device.publish(TOPIC_STATUS, b"online")
+    check(server.next_publish() == (TOPIC_STATUS, b"online"), "device announces itself online")
+
+    n = 12
+    batch = ("[" + ",".join(compact_record(i) for i in range(n)) + "]").encode()
+    sent0, recv0 = device.sent, device.received
+    device.publish(TOPIC_TELEMETRY, batch)
+    mqtt_up, mqtt_down = device.sent - sent0, device.received - recv0
+    topic, payload = server.next_publish()
+    check(topic == TOPIC_TELEMETRY and len(json.loads(payload)) == n, "QoS 1 batch of %d acknowledged and delivered" % n)
+
+    server.publish(TOPIC_CMD, b"report")
+    check(device.next_publish() == (TOPIC_CMD, b"report"), "command reaches the device")
+
+    device.sock.close()  # power cut, no DISCONNECT
+    check(server.next_publish() == (TOPIC_STATUS, b"offline"), "last will marks the device offline")
+
+    args = argparse.Namespace(fail_every=0, max_bytes=stub_endpoint.MAX_BYTES, single_only=False, quiet=True)
+    counters = {"requests": 0, "records": 0, "bytes": 0}
+    http = HTTPServer(("127.0.0.1", 0), stub_endpoint.make_handler(args, counters))
+    threading.Thread(target=http.serve_forever, daemon=True).start()
+    hport = http.server_port
+    single_up = single_down = accepted = 0
+    for i in range(n):
+        up, down, status = http_wire_bytes(hport, stub_endpoint.sample_record(i))
+        single_up, single_down, accepted = single_up + up, single_down + down, accepted + (status == 200)
+    check(accepted == n, "HTTP single posts accepted by stub_endpoint")
+    body = "[" + ",".join(stub_endpoint.sample_record(i) for i in range(n)) + "]"
+    batch_up, batch_down, status = http_wire_bytes(hport, body)
+    check(status == 200, "HTTP batch post accepted by stub_endpoint")
+    http.shutdown()
+
+    # Modem round trips per post: HTTPS session: +CCLK?, +HTTPDATA, +HTTPACTION, +HTTPHEAD,
+    # +HTTPREAD?, +HTTPREAD. MQTT: +CCLK?, +CMQTTTOPIC, +CMQTTPAYLOAD, +CMQTTPUB (plus the
+    # connection check every 10 s at most).
+    print()
+    print("%-24s %10s %10s %12s %10s" % ("per %d records" % n, "up bytes", "down bytes", "bytes/record", "AT cmds"))
+    for name, up, down, at in (("HTTPS, one post each", single_up, single_down, 6 * n),
+                               ("HTTPS, one batch post", batch_up, batch_down, 6),
+                               ("MQTT QoS 1, one publish", mqtt_up, mqtt_down, 4)):
+        print("%-24s %10d %10d %12.0f %10d" % (name, up, down, (up + down) / n, at))
+    print("FAILED" if fails else "broker OK")
+    return 1 if fails else 0
+
+
+def main():
+    ap = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    ap.add_argument("--port", type=int, default=1883)
+    ap.add_argument("--quiet", action="store_true")
+    ap.add_argument("--selftest", action="store_true", help="check the protocol, print the benchmark and exit")
+    args = ap.parse_args()
+    if args.selftest:
+        return selftest()
+
+    broker = Broker(args.port, args.quiet)
+    threading.Thread(target=broker.serve_forever, daemon=True).start()
+    print("Listening on port %d. Lines typed here go to %s, Ctrl+C to stop" % (broker.port, TOPIC_CMD))
+    try:
+        for line in sys.stdin:
+            if line.strip():
+                broker.publish(TOPIC_CMD, line.strip().encode())
+    except KeyboardInterrupt:
+        pass
+    print("%d bytes in, %d bytes out" % (broker.bytes_in, broker.bytes_out))
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
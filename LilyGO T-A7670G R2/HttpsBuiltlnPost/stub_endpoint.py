@@ -0,0 +1,262 @@
+#!/usr/bin/env python3
+"""Local stand-in for the telemetry endpoint: checks every POST body against the server contract
+the uplink relies on, and answers like the real server would.
+
+Contract (see uplink.h): the body is one record object, or a JSON array of 1..n record objects,
+oldest first, at most --max-bytes long. A record is
+  {"itemId":"0001","location":{"lat":1.29620,"lng":103.77690,"accuracy":7.00},
+   "at":"2025-10-24T07:22:34Z","severity":"Safe","SOC":"87","chargeState":"0"}
+A 2xx acknowledges every record in the body, a 4xx (other than 408/429) tells the uplink to drop
+them, anything else makes it keep them and retry.
+A body with Content-Type application/cbor (firmware built with -DCBOR_PAYLOAD=1) is decoded with
+telemetry_cbor.py and its records are checked against the same contract.
+
+Point the firmware at it with build flag -DSERVER_URL=\\"http://<this pc>:8080/\\" and run
+  python stub_endpoint.py --port 8080
+--fail-every N answers every Nth request with 503 to exercise the store and forward path,
+--single-only rejects arrays like a server that predates batching.
+
+  python stub_endpoint.py --selftest
+posts sample bodies to itself (the same records postData() builds) and exits non-zero if any
+answer is not the expected one. It also prints the bytes per record for single and batched posts,
+in JSON and in CBOR.
+
+  python stub_endpoint.py --check body.json body.cbor
+checks bodies saved to files (a .cbor file is decoded as CBOR), e.g. the ones the host test
+test/04_Telemetry_Body_Host_Test writes from the firmware's own record code.
+"""
+
+import argparse
+import json
+import re
+import sys
+import threading
+import urllib.error
+import urllib.request
+from http.server import BaseHTTPRequestHandler, HTTPServer
+
+import telemetry_cbor
+
+MAX_BYTES = 4096  # UPLINK_BATCH_MAX_BYTES
+AT_FORMAT = re.compile(r"^\d{4}-\d{2}-\d{2}T\d{2}:\d{2}:\d{2}(Z|[+-]\d{2}:\d{2})$")
+
+
+def check_record(rec):
+    """Returns None if rec follows the contract, otherwise what is wrong with it."""
+    if not isinstance(rec, dict):
+        return "record is not an object"
+    if not isinstance(rec.get("itemId"), str):
+        return "itemId missing"
+    loc = rec.get("location")
+    if not isinstance(loc, dict):
+        return "location missing"
+    for key in ("lat", "lng", "accuracy"):
+        if not isinstance(loc.get(key), (int, float)) or isinstance(loc.get(key), bool):
+            return "location.%s is not a number" % key
+    if not -90 <= loc["lat"] <= 90 or not -180 <= loc["lng"] <= 180:
+        return "location out of range"
+    if not isinstance(rec.get("at"), str) or not AT_FORMAT.match(rec["at"]):
+        return "at is not an ISO-8601 time with Z or an offset"
+    if rec.get("severity") not in ("Safe", "Toppled"):
+        return "severity is not Safe / Toppled"
+    for key in ("SOC", "chargeState"):
+        if not isinstance(rec.get(key), str) or not re.match(r"^-?\d+$", rec[key]):
+            return "%s is not an integer string" % key
+    if not -1 <= int(rec["SOC"]) <= 100 or int(rec["chargeState"]) not in (-1, 0, 1):
+        return "SOC / chargeState out of range"
+    return None
+
+
+def check_body(raw, max_bytes, single_only, cbor=False):
+    """Returns (status, reply, records accepted)."""
+    if len(raw) > max_bytes:
+        return 413, {"error": "body of %d bytes is over the %d byte budget" % (len(raw), max_bytes)}, 0
+    if cbor:
+        try:
+            records = telemetry_cbor.decode_body(raw)
+        except ValueError as e:
+            return 400, {"error": "not a CBOR telemetry body: %s" % e}, 0
+    else:
+        try:
+            body = json.loads(raw)
+        except ValueError as e:
+            return 400, {"error": "not JSON: %s" % e}, 0
+        records = body if isinstance(body, list) else [body]
+        if isinstance(body, list) and single_only:
+            return 400, {"error": "arrays not supported"}, 0
+    if not records:
+        return 400, {"error": "empty array"}, 0
+    for i, rec in enumerate(records):
+        problem = check_record(rec)
+        if problem:
+            return 400, {"error": "record %d: %s" % (i, problem)}, 0
+    return 200, {"accepted": len(records)}, len(records)
+
+
+def make_handler(args, counters):
+    class Handler(BaseHTTPRequestHandler):
+        def do_POST(self):
+            raw = self.rfile.read(int(self.headers.get("Content-Length", 0)))
+            counters["requests"] += 1
+            if args.fail_every and counters["requests"] % args.fail_every == 0:
+                status, reply, n = 503, {"error": "injected failure"}, 0
+            elif self.headers.get("Content-Type", "").split(";")[0] not in ("application/json", "application/cbor"):
+                status, reply, n = 415, {"error": "Content-Type must be application/json or application/cbor"}, 0
+            else:
+                cbor = self.headers.get("Content-Type").split(";")[0] == "application/cbor"
+                status, reply, n = check_body(raw, args.max_bytes, args.single_only, cbor)
+            counters["records"] += n
+            counters["bytes"] += len(raw)
+            out = json.dumps(reply).encode()
+            self.send_response(status)
+            self.send_header("Content-Type", "application/json")
+            self.send_header("Content-Length", str(len(out)))
+            self.end_headers()
+            self.wfile.write(out)
+            if not args.quiet:
+                print("%s %d bytes -> %d %s (total %d records in %d requests)" % (
+                    self.client_address[0], len(raw), status, reply, counters["records"], counters["requests"]))
+
+        def log_message(self, fmt, *a):
+            pass
+
+    return Handler
+
+
+def sample_record(i, severity="Safe"):
+    """A record as appendRecord() in telemetry_body.h writes it."""
+    return ('{"itemId":"0001","location":{"lat":%.5f,"lng":%.5f,"accuracy":%.2f},'
+            '"at":"2025-10-24T07:%02d:%02dZ","severity":"%s","SOC":"%d","chargeState":"%d"}') % (
+        1.2962018 + i * 1e-5, 103.776899, 7, (i * 15) // 60, (i * 15) % 60, severity, 87 - i % 3, i % 2)
+
+
+def sample_cbor_record(i, severity="Safe"):
+    """The same record as appendCborRecord() writes it."""
+    return telemetry_cbor.encode_record(1.2962018 + i * 1e-5, 103.776899, 7, 1761290520 + i * 15,
+                                        severity, 87 - i % 3, i % 2)
+
+
+def post(url, body, content_type="application/json"):
+    data = body if isinstance(body, bytes) else body.encode()
+    req = urllib.request.Request(url, data=data, headers={"Content-Type": content_type})
+    try:
+        with urllib.request.urlopen(req) as r:
+            return r.status
+    except urllib.error.HTTPError as e:
+        return e.code
+
+
+def selftest():
+    args = argparse.Namespace(fail_every=0, max_bytes=MAX_BYTES, single_only=False, quiet=True)
+    counters = {"requests": 0, "records": 0, "bytes": 0}
+    server = HTTPServer(("127.0.0.1", 0), make_handler(args, counters))
+    threading.Thread(target=server.serve_forever, daemon=True).start()
+    url = "http://127.0.0.1:%d/" % server.server_port
+
+    batch = "[" + ",".join(sample_record(i) for i in range(12)) + "]"
+    cases = [
+        ("single record", sample_record(0), 200),
+        ("batch of 12", batch, 200),
+        ("batch with a topple", "[" + sample_record(0) + "," + sample_record(1, "Toppled") + "]", 200),
+        ("over the byte budget", "[" + ",".join(sample_record(i) for i in range(40)) + "]", 413),
+        ("empty array", "[]", 400),
+        ("not JSON", "[" + sample_record(0), 400),
+        ("at without zone", sample_record(0).replace("Z\"", "\""), 400),
+        ("at with an offset", sample_record(0).replace("Z\"", "+08:00\""), 200),
+        ("SOC as a number", sample_record(0).replace('"SOC":"87"', '"SOC":87'), 400),
+        ("bad record in a batch", "[" + sample_record(0) + ',{"itemId":"0001"}]', 400),
+    ]
+    fails = 0
+    for name, body, want in cases:
+        got = post(url, body)
+        ok = got == want
+        fails += not ok
+        print("%-4s %-22s %5d bytes -> %d (want %d)" % ("ok" if ok else "FAIL", name, len(body), got, want))
+    if post(url, sample_record(0), "text/plain") != 415:
+        print("FAIL wrong Content-Type accepted")
+        fails += 1
+
+    cbor_single = telemetry_cbor.encode_body("0001", [sample_cbor_record(0)])
+    cbor_batch = telemetry_cbor.encode_body("0001", [sample_cbor_record(i) for i in range(12)])
+    cbor_cases = [
+        ("CBOR single record", cbor_single, 200),
+        ("CBOR batch of 12", cbor_batch, 200),
+        ("CBOR with a topple", telemetry_cbor.encode_body(
+            "0001", [sample_cbor_record(0), sample_cbor_record(1, "Toppled")]), 200),
+        ("CBOR unknown schema", b"\x9f\x02" + cbor_single[2:], 400),
+        ("CBOR truncated", cbor_batch[:-5], 400),
+        ("CBOR no records", telemetry_cbor.encode_body("0001", []), 400),
+        ("JSON sent as CBOR", sample_record(0).encode(), 400),
+    ]
+    for name, body, want in cbor_cases:
+        got = post(url, body, "application/cbor")
+        ok = got == want
+        fails += not ok
+        print("%-4s %-22s %5d bytes -> %d (want %d)" % ("ok" if ok else "FAIL", name, len(body), got, want))
+    decoded = telemetry_cbor.decode_body(cbor_batch)
+    reference = json.loads(batch)
+    for rec, ref in zip(decoded, reference):
+        if rec["location"] != ref["location"] or rec["SOC"] != ref["SOC"] or rec["severity"] != ref["severity"]:
+            print("FAIL CBOR record decodes to %s, JSON has %s" % (rec, ref))
+            fails += 1
+            break
+
+    args.single_only = True
+    if post(url, batch) != 400 or post(url, sample_record(0)) != 200:
+        print("FAIL --single-only")
+        fails += 1
+    server.shutdown()
+
+    single = len(sample_record(0))
+    print("bytes per record: %d single, %.0f in a batch of 12 (before HTTP and TLS overhead, which a batch pays once)"
+          % (single, len(batch) / 12.0))
+    print("CBOR bytes per record: %d single, %.0f in a batch of 12, %.0f%% / %.0f%% smaller than JSON"
+          % (len(cbor_single), len(cbor_batch) / 12.0, 100.0 * (1 - len(cbor_single) / float(single)),
+             100.0 * (1 - len(cbor_batch) / float(len(batch)))))
+    print("FAILED" if fails else "contract OK")
+    return 1 if fails else 0
+
+
+def check_files(paths, max_bytes):
+    fails = 0
+    for path in paths:
+        with open(path, "rb") as f:
+            raw = f.read()
+        status, reply, accepted = check_body(raw, max_bytes, False, cbor=path.endswith(".cbor"))
+        print("%s: %d bytes, %d records, %.0f bytes per record: %d %s" % (
+            path, len(raw), accepted, len(raw) / float(accepted or 1), status, json.dumps(reply)))
+        fails += status != 200
+    print("FAILED" if fails else "contract OK")
+    return 1 if fails else 0
+
+
+def main():
+    ap = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    ap.add_argument("--port", type=int, default=8080)
+    ap.add_argument("--max-bytes", type=int, default=MAX_BYTES, help="byte budget, UPLINK_BATCH_MAX_BYTES")
+    ap.add_argument("--fail-every", type=int, default=0, help="answer every Nth request with 503")
+    ap.add_argument("--single-only", action="store_true", help="reject arrays, like a server without batching")
+    ap.add_argument("--quiet", action="store_true")
+    ap.add_argument("--selftest", action="store_true", help="check the contract against sample bodies and exit")
+    ap.add_argument("--check", nargs="+", metavar="FILE", help="check bodies saved to files and exit")
+    args = ap.parse_args()
+    if args.selftest:
+        return selftest()
+    if args.check:
+        return check_files(args.check, args.max_bytes)
+
+    counters = {"requests": 0, "records": 0, "bytes": 0}
+    server = HTTPServer(("0.0.0.0", args.port), make_handler(args, counters))
+    print("Listening on port %d, Ctrl+C to stop" % args.port)
+    try:
+        server.serve_forever()
+    except KeyboardInterrupt:
+        pass
+    if counters["records"]:
+        print("%d records in %d requests, %.0f bytes per record" % (
+            counters["records"], counters["requests"], counters["bytes"] / counters["records"]))
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -0,0 +1,150 @@
+/**
+ * @file      telemetry_body.h
+ * @brief     Writes a batch of snapshots as the body of a post: JSON or CBOR for HTTPS, JSON for MQTT
+ * @note
+ * * writeBatch() puts as many records as fit UPLINK_BATCH_MAX_BYTES into the writer's buffer, one
+ *   record function per wire format. Nothing here allocates: the writers fill a caller's buffer
+ *   and the time is formatted in place, see json_writer.h and time_service.h.
+ * * The HTTPS JSON record is the server contract checked by stub_endpoint.py, the CBOR one is
+ *   schema CBOR_SCHEMA_ID of telemetry_cbor.py and the MQTT one is what stub_broker.py expects.
+ */
+
+#pragma once
+
+#include <Arduino.h>
+#include "uplink.h"
+#include "json_writer.h"
+#include "cbor_writer.h"
+#include "time_service.h"
+
+#define CBOR_SCHEMA_ID 1    // Layout of the CBOR body, see telemetry_cbor.py. A new layout gets a new id.
+
+// When the snapshot was taken, UTC seconds. Snapshots taken before the clock was set get it from
+// their age; those from before a reboot, which have no usable age, get the send time. 0 (1970)
+// while the clock has never been set.
+static uint32_t captureTime(const TelemetrySnapshot &snap)
+{
+    if (snap.utc)
+    {
+        return snap.utc;
+    }
+    return timeUtcAt(snap.boot == uplinkBoot ? snap.sampledMs : millis());
+}
+
+// One record of the server contract, see stub_endpoint.py
+static void appendRecord(JsonWriter &json, const TelemetrySnapshot &snap, uint32_t utc)
+{
+    char at[24];
+    char number[12];
+    timeFormatIso(at, sizeof(at), utc);
+    json.beginObject();
+    json.key("itemId");
+    json.string("0001");
+    json.key("location");
+    json.beginObject();
+    json.key("lat");
+    json.fixed(snap.lat, 5);
+    json.key("lng");
+    json.fixed(snap.lng, 5);
+    json.key("accuracy");
+    json.fixed(snap.accuracy, 2);
+    json.endObject();
+    json.key("at");
+    json.string(at);
+    json.key("severity");
+    json.string(snap.severity);
+    json.key("SOC");            // The server takes SOC and chargeState as strings
+    snprintf(number, sizeof(number), "%d", snap.soc);
+    json.string(number);
+    json.key("chargeState");
+    snprintf(number, sizeof(number), "%d", snap.chg);
+    json.string(number);
+    json.endObject();
+}
+
+// One record of CBOR schema 1: [lat, lng, accuracy, at, severity, SOC, chargeState], no field
+// names. Positions are integers in units of 1e-5 degrees, at is a tag 1 UTC epoch time and the
+// severity a code. About 22 bytes against ~180 for the JSON record.
+static void appendCborRecord(CborWriter &cbor, const TelemetrySnapshot &snap, uint32_t utc)
+{
+    cbor.beginArray(7);
+    cbor.fixed(snap.lat, 5);
+    cbor.fixed(snap.lng, 5);
+    cbor.integer((int64_t)snap.accuracy);
+    cbor.tag(1);
+    cbor.integer(utc);
+    if (strcmp(snap.severity, "Safe") == 0)
+    {
+        cbor.integer(0);
+    }
+    else if (strcmp(snap.severity, "Toppled") == 0)
+    {
+        cbor.integer(1);
+    }
+    else
+    {
+        cbor.string(snap.severity);
+    }
+    cbor.integer(snap.soc);
+    cbor.integer(snap.chg);
+}
+
+// What comes before the records: nothing in JSON, the schema id and the item in CBOR
+static void writeBodyHead(JsonWriter &)
+{
+}
+
+static void writeBodyHead(CborWriter &cbor)
+{
+    cbor.integer(CBOR_SCHEMA_ID);
+    cbor.string("0001");
+}
+
+// Writes the front of snaps into the writer's buffer as one array, oldest first: as many records
+// as fit UPLINK_BATCH_MAX_BYTES, at least one. Returns how many went in.
+template <typename Writer>
+uint8_t writeBatch(Writer &out, void (*record)(Writer &, const TelemetrySnapshot &, uint32_t),
+                   const TelemetrySnapshot *snaps, uint8_t count)
+{
+    uint8_t taken = 0;
+    out.reset();
+    out.beginArray();
+    writeBodyHead(out);
+    for (uint8_t i = 0; i < count; i++)
+    {
+        const size_t mark = out.mark();
+        record(out, snaps[i], captureTime(snaps[i]));
+        // Byte budget: the closing bracket (or CBOR break) counts too
+        if (i > 0 && (!out.ok() || out.length() + 1 > UPLINK_BATCH_MAX_BYTES))
+        {
+            out.rewind(mark);
+            break;
+        }
+        taken++;
+    }
+    out.endArray();
+    return taken;
+}
+
+// Compact record for MQTT: the item is in the topic, numbers are numbers
+static void appendMqttRecord(JsonWriter &json, const TelemetrySnapshot &snap, uint32_t utc)
+{
+    char at[24];
+    timeFormatIso(at, sizeof(at), utc);
+    json.beginObject();
+    json.key("lat");
+    json.fixed(snap.lat, 5);
+    json.key("lng");
+    json.fixed(snap.lng, 5);
+    json.key("acc");
+    json.integer((long)snap.accuracy);
+    json.key("at");
+    json.string(at);
+    json.key("sev");
+    json.string(snap.severity);
+    json.key("soc");
+    json.integer(snap.soc);
+    json.key("chg");
+    json.integer(snap.chg);
+    json.endObject();
+}
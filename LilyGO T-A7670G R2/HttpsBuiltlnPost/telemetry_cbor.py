@@ -0,0 +1,213 @@
+#!/usr/bin/env python3
+"""Reference decoder (and encoder, for tests) of the CBOR telemetry body that the firmware sends
+when built with -DCBOR_PAYLOAD=1, Content-Type application/cbor.
+
+Schema 1 (CBOR_SCHEMA_ID in telemetry_body.h), one indefinite length array:
+  [_ 1, itemId, record, record, ...]        records oldest first, at least one
+  record = [lat, lng, accuracy, at, severity, SOC, chargeState]
+    lat, lng     int, degrees x 100000 (the 5 decimals of the JSON body), null if unknown
+    accuracy     int, satellites in view, x 1
+    at           tag 1 (epoch seconds), UTC
+    severity     0 = "Safe", 1 = "Toppled", or the text itself
+    SOC          int, %, -1 unknown
+    chargeState  int, 0 / 1, -1 unknown
+A change to this layout gets a new schema id; decoders reject ids they do not know.
+
+decode_body() turns a body into records of the JSON contract (see stub_endpoint.py), so a
+server can take both encodings through the same code.
+
+  python telemetry_cbor.py <file>      prints the records of a body saved to a file
+"""
+
+import datetime
+import json
+import struct
+import sys
+
+SCHEMA_ID = 1
+SEVERITIES = ("Safe", "Toppled")
+_BREAK = object()
+
+
+class _Reader:
+    def __init__(self, data):
+        self.data = data
+        self.pos = 0
+
+    def take(self, n):
+        if self.pos + n > len(self.data):
+            raise ValueError("truncated at byte %d" % self.pos)
+        out = self.data[self.pos:self.pos + n]
+        self.pos += n
+        return out
+
+    def argument(self, info):
+        if info < 24:
+            return info
+        if info in (24, 25, 26, 27):
+            n = 1 << (info - 24)
+            return int.from_bytes(self.take(n), "big")
+        if info == 31:
+            return None  # Indefinite length
+        raise ValueError("reserved additional info %d at byte %d" % (info, self.pos - 1))
+
+    def item(self, allow_break=False):
+        first = self.take(1)[0]
+        major, info = first >> 5, first & 0x1f
+        if first == 0xff:
+            if not allow_break:
+                raise ValueError("unexpected break at byte %d" % (self.pos - 1))
+            return _BREAK
+        if major == 7:
+            if info == 20:
+                return False
+            if info == 21:
+                return True
+            if info in (22, 23):
+                return None
+            if info == 25:
+                return struct.unpack(">e", self.take(2))[0]
+            if info == 26:
+                return struct.unpack(">f", self.take(4))[0]
+            if info == 27:
+                return struct.unpack(">d", self.take(8))[0]
+            raise ValueError("unsupported simple value %d" % info)
+        arg = self.argument(info)
+        if major == 0:
+            return arg
+        if major == 1:
+            return -1 - arg
+        if major in (2, 3):
+            if arg is None:
+                raise ValueError("indefinite length strings are not used by the schema")
+            raw = self.take(arg)
+            return raw if major == 2 else raw.decode("utf-8")
+        if major == 4:
+            if arg is not None:
+                return [self.item() for _ in range(arg)]
+            out = []
+            while True:
+                value = self.item(allow_break=True)
+                if value is _BREAK:
+                    return out
+                out.append(value)
+        if major == 5:
+            if arg is None:
+                raise ValueError("indefinite length maps are not used by the schema")
+            return dict((self.item(), self.item()) for _ in range(arg))
+        return ("tag", arg, self.item())
+
+
+def loads(data):
+    """Decodes one CBOR item that must fill all of data."""
+    reader = _Reader(bytes(data))
+    value = reader.item()
+    if reader.pos != len(reader.data):
+        raise ValueError("%d bytes after the body" % (len(reader.data) - reader.pos))
+    return value
+
+
+def _int(value, what):
+    if not isinstance(value, int) or isinstance(value, bool):
+        raise ValueError("%s is not an integer" % what)
+    return value
+
+
+def _degrees(value, what):
+    if value is None:
+        return None
+    return _int(value, what) / 100000.0
+
+
+def decode_body(raw):
+    """Returns the records of a schema 1 body in the JSON contract form, oldest first.
+    Raises ValueError when raw is not one."""
+    body = loads(raw)
+    if not isinstance(body, list) or len(body) < 3:
+        raise ValueError("body is not [schema, itemId, record, ...]")
+    if body[0] != SCHEMA_ID:
+        raise ValueError("unknown schema %r" % (body[0],))
+    item_id = body[1]
+    if not isinstance(item_id, str):
+        raise ValueError("itemId is not text")
+    records = []
+    for i, rec in enumerate(body[2:]):
+        if not isinstance(rec, list) or len(rec) != 7:
+            raise ValueError("record %d is not an array of 7" % i)
+        lat, lng, accuracy, at, severity, soc, chg = rec
+        if not (isinstance(at, tuple) and at[1] == 1):
+            raise ValueError("record %d: at is not a tag 1 time" % i)
+        when = datetime.datetime.fromtimestamp(_int(at[2], "at"), datetime.timezone.utc)
+        if isinstance(severity, int) and not isinstance(severity, bool):
+            if not 0 <= severity < len(SEVERITIES):
+                raise ValueError("record %d: unknown severity %d" % (i, severity))
+            severity = SEVERITIES[severity]
+        elif not isinstance(severity, str):
+            raise ValueError("record %d: severity is neither a code nor text" % i)
+        records.append({
+            "itemId": item_id,
+            "location": {"lat": _degrees(lat, "lat"), "lng": _degrees(lng, "lng"),
+                         "accuracy": float(_int(accuracy, "accuracy"))},
+            "at": when.strftime("%Y-%m-%dT%H:%M:%SZ"),
+            "severity": severity,
+            "SOC": str(_int(soc, "SOC")),
+            "chargeState": str(_int(chg, "chargeState")),
+        })
+    return records
+
+
+def _head(major, arg):
+    major <<= 5
+    if arg < 24:
+        return bytes([major | arg])
+    for info, n in ((24, 1), (25, 2), (26, 4), (27, 8)):
+        if arg < 1 << (8 * n):
+            return bytes([major | info]) + arg.to_bytes(n, "big")
+    raise ValueError("argument too large")
+
+
+def _int_bytes(v):
+    return _head(0, v) if v >= 0 else _head(1, -1 - v)
+
+
+def encode_record(lat, lng, accuracy, epoch, severity, soc, chg):
+    """One record as appendCborRecord() in telemetry_body.h writes it."""
+    out = _head(4, 7)
+    for degrees in (lat, lng):
+        # Half away from zero, like JsonWriter::fixed()
+        scaled = int(abs(degrees) * 100000 + 0.5)
+        out += _int_bytes(-scaled if degrees < 0 else scaled)
+    out += _int_bytes(int(accuracy)) + _head(6, 1) + _int_bytes(epoch)
+    if severity in SEVERITIES:
+        out += _int_bytes(SEVERITIES.index(severity))
+    else:
+        text = severity.encode()
+        out += _head(3, len(text)) + text
+    return out + _int_bytes(soc) + _int_bytes(chg)
+
+
+def encode_body(item_id, records):
+    """records: encode_record() results, oldest first."""
+    text = item_id.encode()
+    return b"\x9f" + _int_bytes(SCHEMA_ID) + _head(3, len(text)) + text + b"".join(records) + b"\xff"
+
+
+def main():
+    if len(sys.argv) != 2:
+        print(__doc__)
+        return 2
+    with open(sys.argv[1], "rb") as f:
+        raw = f.read()
+    try:
+        records = decode_body(raw)
+    except ValueError as e:
+        print("not a telemetry body: %s" % e)
+        return 1
+    for rec in records:
+        print(json.dumps(rec))
+    print("%d records in %d bytes, %.1f per record" % (len(records), len(raw), len(raw) / float(len(records))))
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
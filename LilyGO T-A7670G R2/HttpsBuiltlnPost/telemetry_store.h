@@ -0,0 +1,572 @@
+/**
+ * @file      telemetry_store.h
+ * @brief     Store-and-forward queue of encoded telemetry records on LittleFS
+ * @note
+ * * Records that could not be posted (no registration, non-2xx) are kept here and replayed oldest
+ *   first when the network is back. Records are opaque bytes, the uplink decides the encoding.
+ * * Layout: append-only segment files /tq/<id in hex>, each up to STORE_SEGMENT_BYTES, and a
+ *   small /tq/cursor file with the read position (segment id + offset). Every record is
+ *   [magic 'TQ'][length][CRC-32 of the payload][payload]. A segment is deleted once it has been
+ *   read completely and the records taken from it are delivered (holdCursor()), files are never
+ *   rewritten in place.
+ * * Power loss: a torn record at the end of the newest segment fails its CRC and is skipped
+ *   (appends continue in a fresh segment, the newest one is checked at boot). The cursor is saved at most every STORE_CURSOR_MS,
+ *   so after a crash up to that much of the replay is sent again: delivery is at-least-once.
+ * * Capacity: at most STORE_MAX_SEGMENTS segments. When the store is full the oldest segment is
+ *   aged out (its records are counted as dropped); above STORE_THIN_PERCENT the caller is told to
+ *   thin out routine records (shouldThin()), so a long gap is covered at lower resolution.
+ * * Wear: appends are collected in RAM and written STORE_FLUSH_RECORDS at a time or after
+ *   STORE_FLUSH_MS, the cursor at most every STORE_CURSOR_MS (only while replaying). LittleFS
+ *   does not append in place: each flush copies the partly filled last block of the segment into
+ *   a freshly erased one, so every flush costs at least one erase, plus the occasional compaction
+ *   of the directory's metadata block. Worst case (no coverage at all) that is one flush a minute
+ *   at 15 s records, about 1500 erases a day, up to about 2200 with 5 s records (8 per flush).
+ *   LittleFS only hands out free blocks: on the 1.4 MB default SPIFFS partition (352 blocks of
+ *   4 KB, up to 128 taken by a full store) that is about 4 to 10 erases per block per day, or
+ *   25 years or more at the flash's 100 000 cycles. Raising STORE_FLUSH_MS lowers it in step.
+ *   Everything in RAM waiting for a flush is lost on power loss.
+ * * Only the uplink task calls into it, so there is no locking.
+ */
+
+#pragma once
+
+#include <Arduino.h>
+#include <FS.h>
+#include <LittleFS.h>
+
+#define STORE_DIR               "/tq"
+#define STORE_CURSOR_PATH       "/tq/cursor"
+#define STORE_SEGMENT_BYTES     16384   // One segment file, ~300 records
+#define STORE_MAX_SEGMENTS      32      // 512 KB, about 40 hours at one record per 15 s
+#define STORE_MAX_RECORD_BYTES  256
+#define STORE_FLUSH_RECORDS     8       // RAM records written together
+#define STORE_FLUSH_MS          60000   // ... or once the oldest of them is this old
+#define STORE_CURSOR_MS         60000   // Read position saved at most this often
+#define STORE_THIN_PERCENT      75      // Above this fill level shouldThin() is true
+#define STORE_RECORD_MAGIC      0x5154  // "TQ"
+
+typedef struct StoreStats
+{
+    uint32_t appended;      // Records accepted by append()
+    uint32_t replayed;      // Records popped after they were delivered
+    uint32_t dropped;       // Records aged out because the store was full (estimate)
+    uint32_t corrupt;       // Records skipped on a bad header or CRC
+    uint32_t flushes;       // Segment writes
+    uint32_t cursorSaves;   // Cursor file writes
+    uint32_t segments;      // Segment files now
+} StoreStats;
+
+class TelemetryStore
+{
+public:
+    // Mounts LittleFS (formats it if it cannot be mounted) and finds the segments left from before
+    bool begin()
+    {
+        if (!LittleFS.begin(true))
+        {
+            Serial.println("Store: LittleFS mount failed, records will be lost during coverage gaps");
+            return false;
+        }
+        if (!LittleFS.exists(STORE_DIR))
+        {
+            LittleFS.mkdir(STORE_DIR);
+        }
+        scanSegments();
+        // Keep appending to the newest segment only if every record in it checks out, never
+        // behind a torn one
+        writeSeg_ = segCount_ ? lastSeg_ + 1 : 1;
+        writeSegSize_ = 0;
+        if (segCount_ > 0)
+        {
+            const size_t size = segSize(lastSeg_);
+            if (size < STORE_SEGMENT_BYTES && segmentIntact(lastSeg_, size))
+            {
+                writeSeg_ = lastSeg_;
+                writeSegSize_ = size;
+            }
+        }
+        if (segCount_ > 0)
+        {
+            loadCursor();
+        }
+        else
+        {
+            readSeg_ = doneSeg_ = writeSeg_;
+            readOff_ = readSegSize_ = fileBytes_ = 0;
+        }
+        ready_ = true;
+        Serial.printf("Store: %lu segment(s), about %lu record(s) waiting\n", (unsigned long)segCount_, (unsigned long)count());
+        return true;
+    }
+
+    bool ready() const { return ready_; }
+
+    // Records waiting, including those not flushed yet (file part estimated from the bytes left)
+    uint32_t count() const
+    {
+        return fileBytes_ / recordEstimate_ + pendingCount_;
+    }
+
+    bool empty() const { return fileBytes_ == 0 && pendingCount_ == 0; }
+
+    bool shouldThin() const
+    {
+        return segCount_ * 100 >= (uint32_t)STORE_MAX_SEGMENTS * STORE_THIN_PERCENT;
+    }
+
+    bool append(const uint8_t *data, uint16_t len, uint32_t nowMs)
+    {
+        if (!ready_ || len == 0 || len > STORE_MAX_RECORD_BYTES)
+        {
+            return false;
+        }
+        if (pendingBytes_ + sizeof(RecordHeader) + len > sizeof(pending_))
+        {
+            flush();
+        }
+        if (pendingCount_ == 0)
+        {
+            pendingSinceMs_ = nowMs;
+        }
+        RecordHeader h = {STORE_RECORD_MAGIC, len, crc32(data, len)};
+        memcpy(pending_ + pendingBytes_, &h, sizeof(h));
+        memcpy(pending_ + pendingBytes_ + sizeof(h), data, len);
+        pendingBytes_ += sizeof(h) + len;
+        pendingCount_++;
+        stats_.appended++;
+        if (pendingCount_ >= STORE_FLUSH_RECORDS)
+        {
+            flush();
+        }
+        return true;
+    }
+
+    // Oldest record into out (room for STORE_MAX_RECORD_BYTES). Returns its length, 0 if empty.
+    uint16_t peek(uint8_t *out)
+    {
+        while (fileBytes_ > 0)
+        {
+            const uint16_t len = readFileRecord(out);
+            if (len > 0)
+            {
+                return len;
+            }
+        }
+        if (pendingCount_ > 0)
+        {
+            RecordHeader h;
+            memcpy(&h, pending_, sizeof(h));
+            memcpy(out, pending_ + sizeof(h), h.len);
+            return h.len;
+        }
+        return 0;
+    }
+
+    // Removes the record peek() returned
+    void pop(uint32_t nowMs)
+    {
+        if (fileBytes_ > 0)
+        {
+            if (cursorHeld_)
+            {
+                heldUpTo_ = readSeg_;
+            }
+            const uint32_t size = sizeof(RecordHeader) + headLen_;
+            readOff_ += size;
+            fileBytes_ = (fileBytes_ > size) ? fileBytes_ - size : 0;
+            cursorDirty_ = true;
+            if (readOff_ >= readSegSize_)
+            {
+                nextReadSegment();
+            }
+        }
+        else if (pendingCount_ > 0)
+        {
+            RecordHeader h;
+            memcpy(&h, pending_, sizeof(h));
+            const uint16_t size = sizeof(h) + h.len;
+            memmove(pending_, pending_ + size, pendingBytes_ - size);
+            pendingBytes_ -= size;
+            pendingCount_--;
+        }
+        else
+        {
+            return;
+        }
+        stats_.replayed++;
+        tick(nowMs);
+    }
+
+    // While held, the saved cursor stays behind records that were popped but not delivered yet
+    // (a replay batch in RAM), and the segments they came from are kept, so a reboot sends them
+    // again. Releasing deletes those segments; tick() saves the cursor.
+    void holdCursor(bool hold)
+    {
+        if (hold && !cursorHeld_)
+        {
+            heldUpTo_ = 0; // nothing popped under this hold yet
+        }
+        cursorHeld_ = hold;
+        if (!hold)
+        {
+            removeDoneSegments();
+        }
+    }
+
+    // Time-based flush and cursor save, call regularly
+    void tick(uint32_t nowMs)
+    {
+        if (pendingCount_ > 0 && nowMs - pendingSinceMs_ >= STORE_FLUSH_MS)
+        {
+            flush();
+        }
+        if (cursorDirty_ && !cursorHeld_ && nowMs - cursorSavedMs_ >= STORE_CURSOR_MS)
+        {
+            saveCursor(nowMs);
+        }
+    }
+
+    // Writes the RAM records to the newest segment, starting a new one (and aging out the oldest)
+    // when needed
+    void flush()
+    {
+        if (!ready_ || pendingCount_ == 0)
+        {
+            return;
+        }
+        if (writeSegSize_ + pendingBytes_ > STORE_SEGMENT_BYTES && writeSegSize_ > 0)
+        {
+            writeSeg_++;
+            writeSegSize_ = 0;
+        }
+        if (writeSegSize_ == 0)
+        {
+            // Read segments kept for a held cursor do not count, they go on release
+            while (segCount_ - min(segCount_, keptSegments()) >= STORE_MAX_SEGMENTS && readSeg_ < writeSeg_)
+            {
+                ageOutOldest();
+            }
+        }
+        char path[24];
+        segPath(writeSeg_, path);
+        File f = LittleFS.open(path, FILE_APPEND);
+        if (!f)
+        {
+            Serial.printf("Store: cannot open %s, %u record(s) lost\n", path, pendingCount_);
+            stats_.dropped += pendingCount_;
+        }
+        else
+        {
+            const size_t written = f.write(pending_, pendingBytes_);
+            f.close();
+            if (writeSegSize_ == 0)
+            {
+                segCount_++;
+                lastSeg_ = writeSeg_;
+            }
+            writeSegSize_ += written;
+            fileBytes_ += written;
+            if (readSeg_ < writeSeg_ && readOff_ >= readSegSize_)
+            {
+                nextReadSegment(); // reader was idle at the end of the previous segment
+            }
+            if (readSeg_ == writeSeg_)
+            {
+                readSegSize_ = writeSegSize_;
+            }
+            recordEstimate_ = pendingBytes_ / pendingCount_;
+            stats_.flushes++;
+        }
+        pendingBytes_ = 0;
+        pendingCount_ = 0;
+    }
+
+    StoreStats stats() const
+    {
+        StoreStats s = stats_;
+        s.segments = segCount_;
+        return s;
+    }
+
+private:
+    typedef struct __attribute__((packed)) RecordHeader
+    {
+        uint16_t magic;
+        uint16_t len;
+        uint32_t crc;
+    } RecordHeader;
+
+    typedef struct CursorFile
+    {
+        uint32_t seg;
+        uint32_t off;
+        uint32_t crc;
+    } CursorFile;
+
+    static uint32_t crc32(const uint8_t *p, size_t n)
+    {
+        uint32_t c = 0xFFFFFFFF;
+        while (n--)
+        {
+            c ^= *p++;
+            for (uint8_t k = 0; k < 8; k++)
+            {
+                c = (c >> 1) ^ (0xEDB88320 & (0 - (c & 1)));
+            }
+        }
+        return ~c;
+    }
+
+    static void segPath(uint32_t id, char (&path)[24])
+    {
+        snprintf(path, sizeof(path), STORE_DIR "/%08lx", (unsigned long)id);
+    }
+
+    static size_t segSize(uint32_t id)
+    {
+        char path[24];
+        segPath(id, path);
+        File f = LittleFS.open(path, FILE_READ);
+        if (!f)
+        {
+            return 0;
+        }
+        const size_t size = f.size();
+        f.close();
+        return size;
+    }
+
+    bool segmentIntact(uint32_t id, size_t size)
+    {
+        char path[24];
+        segPath(id, path);
+        File f = LittleFS.open(path, FILE_READ);
+        if (!f)
+        {
+            return false;
+        }
+        uint8_t buf[STORE_MAX_RECORD_BYTES];
+        size_t off = 0;
+        while (off < size)
+        {
+            RecordHeader h;
+            if (f.read((uint8_t *)&h, sizeof(h)) != sizeof(h) || h.magic != STORE_RECORD_MAGIC || h.len == 0 ||
+                h.len > STORE_MAX_RECORD_BYTES || f.read(buf, h.len) != h.len || crc32(buf, h.len) != h.crc)
+            {
+                break;
+            }
+            off += sizeof(h) + h.len;
+        }
+        f.close();
+        return off == size;
+    }
+
+    void scanSegments()
+    {
+        segCount_ = 0;
+        firstSeg_ = UINT32_MAX;
+        lastSeg_ = 0;
+        File dir = LittleFS.open(STORE_DIR);
+        for (File e = dir.openNextFile(); e; e = dir.openNextFile())
+        {
+            const char *name = strrchr(e.name(), '/');
+            name = name ? name + 1 : e.name();
+            char *end;
+            const uint32_t id = strtoul(name, &end, 16);
+            if (*end == '\0' && id > 0 && !e.isDirectory())
+            {
+                segCount_++;
+                firstSeg_ = min(firstSeg_, id);
+                lastSeg_ = max(lastSeg_, id);
+            }
+            e.close();
+        }
+        dir.close();
+        if (segCount_ == 0)
+        {
+            firstSeg_ = lastSeg_ = 0;
+        }
+    }
+
+    void loadCursor()
+    {
+        readSeg_ = firstSeg_;
+        readOff_ = 0;
+        File f = LittleFS.open(STORE_CURSOR_PATH, FILE_READ);
+        if (f)
+        {
+            CursorFile c;
+            if (f.read((uint8_t *)&c, sizeof(c)) == sizeof(c) && c.crc == crc32((const uint8_t *)&c, offsetof(CursorFile, crc)) &&
+                c.seg >= firstSeg_ && c.seg <= lastSeg_)
+            {
+                readSeg_ = c.seg;
+                readOff_ = c.off;
+            }
+            f.close();
+        }
+        doneSeg_ = readSeg_;
+        // Segments before the cursor were read completely but not deleted yet
+        for (uint32_t id = firstSeg_; segCount_ > 0 && id < readSeg_; id++)
+        {
+            removeSegment(id);
+        }
+        fileBytes_ = 0;
+        for (uint32_t id = readSeg_; segCount_ > 0 && id <= lastSeg_; id++)
+        {
+            fileBytes_ += segSize(id);
+        }
+        readSegSize_ = segCount_ ? segSize(readSeg_) : 0;
+        if (readOff_ > readSegSize_)
+        {
+            readOff_ = readSegSize_;
+        }
+        fileBytes_ -= min(fileBytes_, readOff_);
+        if (segCount_ > 0 && readOff_ >= readSegSize_)
+        {
+            nextReadSegment();
+        }
+        // Size of the next record, so count() starts out right
+        uint8_t probe[STORE_MAX_RECORD_BYTES];
+        if (fileBytes_ > 0 && readFileRecord(probe) > 0)
+        {
+            recordEstimate_ = sizeof(RecordHeader) + headLen_;
+        }
+    }
+
+    void saveCursor(uint32_t nowMs)
+    {
+        CursorFile c = {readSeg_, (uint32_t)readOff_, 0};
+        c.crc = crc32((const uint8_t *)&c, offsetof(CursorFile, crc));
+        File f = LittleFS.open(STORE_CURSOR_PATH, FILE_WRITE);
+        if (f)
+        {
+            f.write((const uint8_t *)&c, sizeof(c));
+            f.close();
+            stats_.cursorSaves++;
+        }
+        cursorDirty_ = false;
+        cursorSavedMs_ = nowMs;
+    }
+
+    void removeSegment(uint32_t id)
+    {
+        char path[24];
+        segPath(id, path);
+        if (LittleFS.remove(path) && segCount_ > 0)
+        {
+            segCount_--;
+        }
+        if (id == firstSeg_)
+        {
+            firstSeg_++;
+        }
+    }
+
+    // Segments read to the end. While the cursor is held, those with popped records stay.
+    void removeDoneSegments()
+    {
+        for (uint32_t id = doneSeg_; id < readSeg_; id++)
+        {
+            if (!cursorHeld_ || id > heldUpTo_)
+            {
+                removeSegment(id); // again for one that went earlier: no file, only firstSeg_ moves
+            }
+        }
+        if (!cursorHeld_)
+        {
+            doneSeg_ = readSeg_;
+        }
+    }
+
+    // Segments read to the end but kept for a held cursor
+    uint32_t keptSegments() const
+    {
+        return (cursorHeld_ && heldUpTo_ >= doneSeg_) ? min(heldUpTo_ + 1, readSeg_) - doneSeg_ : 0;
+    }
+
+    // Done with the read segment: delete it (once the cursor is not held) and move on to the
+    // next one that exists
+    void nextReadSegment()
+    {
+        if (readSeg_ == writeSeg_)
+        {
+            return; // still being appended to, wait for more
+        }
+        readSeg_++;
+        removeDoneSegments();
+        readOff_ = 0;
+        readSegSize_ = (readSeg_ == writeSeg_) ? writeSegSize_ : segSize(readSeg_);
+        cursorDirty_ = true;
+        if (readSegSize_ == 0 && readSeg_ < writeSeg_)
+        {
+            nextReadSegment(); // gap left by a segment that was never written
+        }
+    }
+
+    void ageOutOldest()
+    {
+        const uint32_t id = readSeg_;
+        const size_t size = (id == writeSeg_) ? writeSegSize_ : segSize(id);
+        const size_t left = (size > readOff_) ? size - readOff_ : 0;
+        stats_.dropped += left / recordEstimate_;
+        Serial.printf("Store: full, dropping segment %08lx (about %u records)\n", (unsigned long)id, (unsigned)(left / recordEstimate_));
+        fileBytes_ -= min(fileBytes_, left);
+        readOff_ = size; // as if it had been read
+        nextReadSegment();
+        if (!cursorHeld_)
+        {
+            saveCursor(millis());
+        }
+    }
+
+    // Reads the record at the cursor. A bad record skips to the next segment and returns 0.
+    uint16_t readFileRecord(uint8_t *out)
+    {
+        char path[24];
+        segPath(readSeg_, path);
+        File f = LittleFS.open(path, FILE_READ);
+        RecordHeader h = {};
+        bool ok = f && f.seek(readOff_) && f.read((uint8_t *)&h, sizeof(h)) == sizeof(h) &&
+                  h.magic == STORE_RECORD_MAGIC && h.len > 0 && h.len <= STORE_MAX_RECORD_BYTES &&
+                  f.read(out, h.len) == h.len && crc32(out, h.len) == h.crc;
+        if (f)
+        {
+            f.close();
+        }
+        if (ok)
+        {
+            headLen_ = h.len;
+            return h.len;
+        }
+        // Torn or damaged: nothing after it in this segment can be trusted
+        stats_.corrupt++;
+        const size_t left = (readSegSize_ > readOff_) ? readSegSize_ - readOff_ : 0;
+        fileBytes_ -= min(fileBytes_, left);
+        readOff_ = readSegSize_;
+        cursorDirty_ = true;
+        if (readSeg_ == writeSeg_)
+        {
+            writeSeg_++; // keep new appends away from the damage
+            writeSegSize_ = 0;
+        }
+        nextReadSegment();
+        return 0;
+    }
+
+    bool ready_ = false;
+    uint32_t firstSeg_ = 0, lastSeg_ = 0, segCount_ = 0;
+    uint32_t readSeg_ = 0, writeSeg_ = 0;
+    uint32_t doneSeg_ = 0;          // Segments doneSeg_..readSeg_-1 were read; while held, those up to
+    uint32_t heldUpTo_ = 0;         // heldUpTo_ had records popped and are kept
+    size_t readOff_ = 0, readSegSize_ = 0, writeSegSize_ = 0;
+    size_t fileBytes_ = 0;          // Unread bytes in the segment files
+    uint16_t headLen_ = 0;          // Payload length of the record peek() returned
+    uint16_t recordEstimate_ = 64;  // Bytes per record incl. header, for count()
+    uint8_t pending_[STORE_FLUSH_RECORDS * (8 + STORE_MAX_RECORD_BYTES / 4)]; // headers + typical records, one max-size record always fits
+    uint16_t pendingBytes_ = 0, pendingCount_ = 0;
+    uint32_t pendingSinceMs_ = 0;
+    bool cursorDirty_ = false;
+    bool cursorHeld_ = false;
+    uint32_t cursorSavedMs_ = 0;
+    StoreStats stats_ = {};
+};
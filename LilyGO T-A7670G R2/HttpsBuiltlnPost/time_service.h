@@ -0,0 +1,200 @@
+/**
+ * @file      time_service.h
+ * @brief     UTC clock kept as an offset against esp_timer, set from GPS or the network (NITZ)
+ * @note
+ * * One sync gives the offset between esp_timer (microseconds since boot, monotonic, the clock
+ *   millis() runs on) and UTC. From then on the UTC time of any moment of this boot is one
+ *   addition: no modem round trip per post, and samples are stamped when they are taken.
+ * * Sources: GPS (UTC of the last fix) and the modem clock (+CCLK?, local time and zone, set by
+ *   the network through NITZ). GPS wins: once it has synced the clock, NITZ is ignored, and GPS
+ *   syncs again every TIME_RESYNC_MS to take out the drift of the ESP32 crystal. The step each
+ *   re-sync makes is kept in the stats, it is the drift over the interval.
+ * * Times before TIME_MIN_VALID_UTC are taken for an unset clock (a modem without NITZ counts
+ *   from 1970 or 2000, TinyGPS++ reports 2000-00-00 before the first fix) and ignored.
+ * * Conversions are integer arithmetic (days from civil date and back), formatting goes into the
+ *   caller's buffer: nothing allocates.
+ * * Synced from gpsTask() and the uplink task, read from everywhere, so the state is under a spinlock.
+ */
+
+#pragma once
+
+#include <Arduino.h>
+#include <esp_timer.h>
+#include <freertos/FreeRTOS.h>
+
+#define TIME_RESYNC_MS          3600000     // GPS re-sync interval
+#define TIME_MIN_VALID_UTC      1704067200  // 2024-01-01T00:00:00Z, anything earlier is an unset clock
+
+enum TimeSource
+{
+    TIME_NONE,
+    TIME_NITZ,      // Modem clock, set by the network
+    TIME_GPS
+};
+
+typedef struct TimeStats
+{
+    TimeSource source;      // Of the last sync
+    uint32_t syncs;
+    uint32_t lastSyncMs;    // millis() of the last sync
+    int32_t lastStepMs;     // How far the last sync moved the clock
+} TimeStats;
+
+static int64_t timeOffsetMs = 0;            // UTC ms minus esp_timer ms
+static TimeStats timeStats = {};
+static portMUX_TYPE timeMux = portMUX_INITIALIZER_UNLOCKED;
+
+static int64_t timeMonotonicMs()
+{
+    return esp_timer_get_time() / 1000;
+}
+
+// Days since 1970-01-01 of a proleptic Gregorian date (month 1..12)
+static int64_t timeDaysFromCivil(int year, int month, int day)
+{
+    year -= month <= 2;
+    const int64_t era = (year >= 0 ? year : year - 399) / 400;
+    const int yoe = (int)(year - era * 400);
+    const int doy = (153 * (month + (month > 2 ? -3 : 9)) + 2) / 5 + day - 1;
+    const int doe = yoe * 365 + yoe / 4 - yoe / 100 + doy;
+    return era * 146097 + doe - 719468;
+}
+
+// The inverse of timeDaysFromCivil()
+static void timeCivilFromDays(int64_t days, int &year, int &month, int &day)
+{
+    days += 719468;
+    const int64_t era = (days >= 0 ? days : days - 146096) / 146097;
+    const int doe = (int)(days - era * 146097);
+    const int yoe = (doe - doe / 1460 + doe / 36524 - doe / 146096) / 365;
+    const int doy = doe - (365 * yoe + yoe / 4 - yoe / 100);
+    const int mp = (5 * doy + 2) / 153;
+    day = doy - (153 * mp + 2) / 5 + 1;
+    month = mp < 10 ? mp + 3 : mp - 9;
+    year = (int)(yoe + era * 400) + (month <= 2);
+}
+
+static int64_t timeEpoch(int year, int month, int day, int hour, int minute, int second)
+{
+    return timeDaysFromCivil(year, month, day) * 86400 + hour * 3600 + minute * 60 + second;
+}
+
+static bool timeSynced()
+{
+    portENTER_CRITICAL(&timeMux);
+    const bool synced = timeStats.source != TIME_NONE;
+    portEXIT_CRITICAL(&timeMux);
+    return synced;
+}
+
+static TimeStats timeGetStats()
+{
+    portENTER_CRITICAL(&timeMux);
+    const TimeStats s = timeStats;
+    portEXIT_CRITICAL(&timeMux);
+    return s;
+}
+
+// utcMs was the UTC time at esp_timer time monotonicMs. Returns false if the sample was ignored:
+// an unset clock, NITZ after GPS, or a GPS re-sync before TIME_RESYNC_MS.
+static bool timeSync(int64_t utcMs, int64_t monotonicMs, TimeSource source)
+{
+    if (utcMs < (int64_t)TIME_MIN_VALID_UTC * 1000)
+    {
+        return false;
+    }
+    const uint32_t now = millis();
+    bool taken = false;
+    portENTER_CRITICAL(&timeMux);
+    const TimeSource current = timeStats.source;
+    if (current == TIME_NONE || source > current ||
+        (source == current && (source == TIME_NITZ || now - timeStats.lastSyncMs >= TIME_RESYNC_MS)))
+    {
+        const int64_t offset = utcMs - monotonicMs;
+        timeStats.lastStepMs = current == TIME_NONE ? 0 : (int32_t)constrain(offset - timeOffsetMs, INT32_MIN, INT32_MAX);
+        timeOffsetMs = offset;
+        timeStats.source = source;
+        timeStats.syncs++;
+        timeStats.lastSyncMs = now;
+        taken = true;
+    }
+    portEXIT_CRITICAL(&timeMux);
+    return taken;
+}
+
+// Parses a +CCLK? answer, "yy/MM/dd,hh:mm:ss±zz" with the zone in quarter hours (quotes and
+// leading spaces are skipped), into UTC seconds. False if it is not one.
+static bool timeParseCclk(const char *cclk, int64_t &utc)
+{
+    while (*cclk == ' ' || *cclk == '"')
+    {
+        cclk++;
+    }
+    if (strlen(cclk) < 20 || (cclk[17] != '+' && cclk[17] != '-'))
+    {
+        return false;
+    }
+    static const uint8_t fields[] = {0, 3, 6, 9, 12, 15, 18};
+    for (uint8_t f : fields)
+    {
+        if (!isdigit(cclk[f]) || !isdigit(cclk[f + 1]))
+        {
+            return false;
+        }
+    }
+    auto two = [cclk](uint8_t at) { return (cclk[at] - '0') * 10 + (cclk[at + 1] - '0'); };
+    const int month = two(3), day = two(6);
+    if (month < 1 || month > 12 || day < 1 || day > 31 || two(9) > 23 || two(12) > 59 || two(15) > 60)
+    {
+        return false;
+    }
+    const int zoneS = (cclk[17] == '-' ? -1 : 1) * two(18) * 15 * 60;
+    utc = timeEpoch(2000 + two(0), month, day, two(9), two(12), two(15)) - zoneS;
+    return true;
+}
+
+// UTC milliseconds now, 0 before the first sync
+static int64_t timeNowUtcMs()
+{
+    portENTER_CRITICAL(&timeMux);
+    const bool synced = timeStats.source != TIME_NONE;
+    const int64_t offset = timeOffsetMs;
+    portEXIT_CRITICAL(&timeMux);
+    return synced ? timeMonotonicMs() + offset : 0;
+}
+
+// UTC seconds of a millis() time of this boot (less than 49 days ago), 0 before the first sync
+static uint32_t timeUtcAt(uint32_t ms)
+{
+    const int64_t now = timeNowUtcMs();
+    if (now == 0)
+    {
+        return 0;
+    }
+    return (uint32_t)((now - (int64_t)(uint32_t)(millis() - ms)) / 1000);
+}
+
+// ISO-8601 UTC, "2025-10-24T07:22:34Z" (21 bytes with the terminator)
+static void timeFormatIso(char *out, size_t size, uint32_t utc)
+{
+    int year, month, day;
+    timeCivilFromDays(utc / 86400, year, month, day);
+    const uint32_t s = utc % 86400;
+    snprintf(out, size, "%04d-%02d-%02dT%02lu:%02lu:%02luZ", year, month, day,
+             (unsigned long)(s / 3600), (unsigned long)(s / 60 % 60), (unsigned long)(s % 60));
+}
+
+static void timePrintStats()
+{
+    const TimeStats s = timeGetStats();
+    if (s.source == TIME_NONE)
+    {
+        Serial.println("Time: not synced yet");
+        return;
+    }
+    char now[24];
+    timeFormatIso(now, sizeof(now), timeUtcAt(millis()));
+    Serial.printf("Time: %s from %s, %lu syncs, last %lu s ago moved it %ld ms\n", now,
+                  s.source == TIME_GPS ? "GPS" : "NITZ", (unsigned long)s.syncs,
+                  (unsigned long)((millis() - s.lastSyncMs) / 1000), (long)s.lastStepMs);
+}
@@ -0,0 +1,696 @@
+/**
+ * @file      uplink.h
+ * @brief     Cellular uplink task fed by a bounded queue of telemetry snapshots
+ * @note
+ * * Producers (loop(), sensor tasks) fill a TelemetrySnapshot with plain values and hand it to
+ *   uplinkEnqueue(). The snapshot is copied into a fixed-size FreeRTOS queue, so it cannot change
+ *   after it was taken, and uplinkEnqueue() never blocks: when the queue is full the oldest
+ *   snapshot is dropped to make room for the newest one.
+ * * Batching: every post pays https_begin, URL, headers, a TLS handshake and a response read.
+ *   With UPLINK_BATCHING 1 the task collects snapshots and posts them together as one JSON array
+ *   once UPLINK_BATCH_MAX are waiting, the oldest has waited UPLINK_BATCH_MAX_AGE_MS (the latency
+ *   bound), or the severity changes (a topple goes out at once). The body is limited to
+ *   UPLINK_BATCH_MAX_BYTES, whatever does not fit goes in the next post. The body itself is the
+ *   same per record (151 bytes alone, 152 in a batch of 12, stub_endpoint.py --selftest); what a
+ *   batch saves is the per-request HTTP overhead: 470 -> 179 bytes per record on the wire, request
+ *   and reply, without TLS (~2.6x, stub_broker.py --selftest on localhost). The modem time it
+ *   saves has not been measured.
+ *   Server contract: the body is one record object, or an array of them, oldest first. A 2xx
+ *   acknowledges the whole body. stub_endpoint.py checks a body against this contract.
+ *   The production SERVER_URL has only ever been seen to take a single object, so UPLINK_BATCHING
+ *   is 0 by default: every snapshot is posted alone, as a bare object. Batching on against a server
+ *   that refuses arrays costs a rejected post plus one post per record for each batch (4xx), or
+ *   parks everything in the flash store (5xx, timeout). Turn it on once the server is confirmed.
+ * * Safety events (a topple, a critical battery) do not wait for a batch: uplinkRaise() puts the
+ *   snapshot in its event type's slot and wakes the task, which posts it alone before anything
+ *   else, with its own short retries (UPLINK_EVENT_RETRY_MS, doubling, UPLINK_EVENT_TRIES times,
+ *   then it joins the flash backlog). An event can arrive ahead of older records of a backlog,
+ *   the server orders by "at". uplinkAlarm() turns a condition that is checked over and over
+ *   into one raise per onset, and raises of one type are at least UPLINK_EVENT_MIN_GAP_MS
+ *   apart: a later one waits for its turn, a newer one replaces one still waiting. A post in
+ *   progress is not interrupted, so the latency from raise to 2xx is at most that post plus its
+ *   own; the stats keep it per type.
+ * * The task holds the modem for the whole post
+ *   (https_begin, TLS handshake, https_post, https_body), which takes seconds.
+ *   Anything else that talks to the modem while the task runs (the AT passthrough in loop())
+ *   must hold modemLock() / modemTryLock() too, or it steals the task's responses.
+ * * Store and forward: a snapshot that cannot be posted (no registration, 5xx, timeout) goes to
+ *   the TelemetryStore on flash instead of being lost, and so does everything queued after it
+ *   while that backlog exists, so the server still gets records oldest first. The backlog is
+ *   replayed in batches as soon as a post goes through; failed attempts back off from UPLINK_RETRY_MIN_MS to
+ *   UPLINK_RETRY_MAX_MS. A 4xx other than 408 / 429 means the server will never take the record,
+ *   so it is dropped rather than blocking the backlog forever. A rejected batch is sent again one
+ *   record per post first, so only the bad records are dropped. When the store is nearly full only
+ *   every UPLINK_THIN_KEEP-th new snapshot is kept.
+ * * uplinkGetStats() / uplinkPrintStats() show queue depth, drops, failures, the backlog, the
+ *   latency from enqueue to the server's 2xx, and the body bytes and modem time per record.
+ * * The send functions build bodies in static buffers (telemetry_body.h), so posting should not
+ *   move the heap. After every post the task samples the free heap and its largest free block:
+ *   over a long soak the free heap should stay where it was after the first post, and the
+ *   fragmentation (1 - largest block / free) should not creep up.
+ */
+
+#pragma once
+
+#include <Arduino.h>
+#include <esp_heap_caps.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/queue.h>
+#include <freertos/semphr.h>
+#include <freertos/task.h>
+#include "telemetry_store.h"
+
+#define UPLINK_QUEUE_DEPTH      8       // Snapshots waiting for the modem, 2 minutes at one per 15 s
+#define UPLINK_TASK_STACK       8192    // TinyGSM's response parsing, record and time buffers
+#define UPLINK_TASK_PRIORITY    1       // Below GPSTask and Topple_DetectTask
+#define UPLINK_LATENCY_EWMA     0.2f    // Weight of the newest sample in the average latency
+#define UPLINK_RETRY_MIN_MS     15000   // First retry after a failed post
+#define UPLINK_RETRY_MAX_MS     300000  // Backoff doubles up to this
+#define UPLINK_THIN_KEEP        4       // Store nearly full: keep one new snapshot in this many
+#define UPLINK_IDLE_WAKE_MS     1000    // Queue wait while idle, so the store can flush on time
+#define UPLINK_EVENT_MIN_GAP_MS 60000   // Raises of one event type are at least this far apart
+#define UPLINK_EVENT_RETRY_MS   2000    // First retry of a failed event post, doubles per try
+#define UPLINK_EVENT_TRIES      5       // Event posts before it is left to the flash store
+#ifndef UPLINK_BATCHING
+  #define UPLINK_BATCHING         0       // 1: post JSON arrays of records, see the note above
+#endif
+#ifndef UPLINK_BATCH_MAX
+  #if UPLINK_BATCHING
+    #define UPLINK_BATCH_MAX      12      // Snapshots per post, 3 minutes of them at one per 15 s
+  #else
+    #define UPLINK_BATCH_MAX      1
+  #endif
+#endif
+#ifndef UPLINK_BATCH_MAX_AGE_MS
+  #define UPLINK_BATCH_MAX_AGE_MS 180000  // Post once the oldest waiting snapshot is this old
+#endif
+#ifndef UPLINK_BATCH_MAX_BYTES
+  #define UPLINK_BATCH_MAX_BYTES  4096    // Body budget, a record takes ~180 bytes
+#endif
+
+// Everything one HTTPS post needs, taken at one moment by the producer
+typedef struct TelemetrySnapshot
+{
+    uint32_t seq;           // Set by uplinkEnqueue(), counts up from 1
+    uint32_t sampledMs;     // millis() when the values were taken
+    uint32_t enqueuedMs;    // Set by uplinkEnqueue()
+    uint32_t boot;          // Set by uplinkEnqueue(), random per boot: millis() of another boot mean nothing
+    float lat;
+    float lng;
+    float accuracy;         // Satellites in view
+    int soc;                // %, -1 before the first ESP-NOW packet
+    int chg;                // 0 = not charging, 1 = charging, -1 unknown
+    char severity[12];      // pmaState: "Safe" / "Toppled"
+    uint32_t utc;           // UTC seconds when the values were taken, 0 if the clock was not set yet
+} TelemetrySnapshot;
+
+// What one post carried, filled in by the send function
+typedef struct UplinkPost
+{
+    uint8_t taken;          // Snapshots from the front of the batch that went into the body
+    uint32_t bodyBytes;
+} UplinkPost;
+
+// Sends snaps[0..count) in one body with the modem held, as many as fit UPLINK_BATCH_MAX_BYTES
+// (at least one). Returns the HTTP status (<= 0 for a modem error).
+typedef int (*UplinkSendFn)(const TelemetrySnapshot *snaps, uint8_t count, UplinkPost &post);
+
+// Safety events, posted ahead of the routine batches
+enum UplinkEvent
+{
+    UPLINK_EVENT_TOPPLE,
+    UPLINK_EVENT_BATTERY,   // Battery critical
+    UPLINK_EVENT_COUNT
+};
+
+static const char *const uplinkEventNames[UPLINK_EVENT_COUNT] = {"topple", "battery"};
+
+typedef struct UplinkEventStats
+{
+    uint32_t raised;        // uplinkRaise() calls
+    uint32_t limited;       // Held back by the rate limit, or replaced while waiting
+    uint32_t sent;          // Acknowledged with a 2xx
+    uint32_t retries;
+    uint32_t stored;        // Out of tries, left to the flash store
+    uint32_t lastLatencyMs; // Its turn (the raise, or the end of the rate limit hold) to 2xx
+    uint32_t maxLatencyMs;
+} UplinkEventStats;
+
+typedef struct UplinkStats
+{
+    uint32_t enqueued;      // Accepted by uplinkEnqueue()
+    uint32_t dropped;       // Lost: pushed out of the full queue, or failed with no flash store
+    uint32_t sent;          // Acknowledged with a 2xx (live and replayed)
+    uint32_t failed;        // Post attempts that failed and will be retried
+    uint32_t rejected;      // 4xx: dropped, the server will never take them
+    uint32_t stored;        // Put into the flash store
+    uint32_t replayed;      // Sent from the flash store
+    uint32_t thinned;       // Not stored because the store was nearly full
+    uint32_t backlog;       // Waiting in the flash store right now (estimate)
+    uint32_t posts;         // HTTP requests made
+    uint32_t bodyBytes;     // Sum over all requests
+    uint32_t modemMs;       // Time the modem was held for them
+    uint32_t heapFirst;     // Free heap after the first post
+    uint32_t heapFree;      // Free heap after the last post
+    uint32_t heapLargest;   // Largest free block after the last post
+    uint32_t heapLowest;    // Least free heap since boot
+    uint32_t depth;         // Waiting right now
+    uint32_t maxDepth;
+    uint32_t lastLatencyMs; // Enqueue to 2xx, last sent snapshot
+    uint32_t maxLatencyMs;
+    float avgLatencyMs;     // EWMA of the same
+    UplinkEventStats events[UPLINK_EVENT_COUNT];
+} UplinkStats;
+
+// One per event type, shared between uplinkRaise() and the task under uplinkStatsMux
+typedef struct UplinkEventSlot
+{
+    TelemetrySnapshot snap;
+    bool active;            // Condition at the last uplinkAlarm()
+    bool pending;           // snap waits to be posted
+    uint8_t tries;          // Failed posts of snap
+    uint32_t turnMs;        // When snap was raised, or its rate limit hold ended
+    uint32_t dueMs;         // Not posted before this
+} UplinkEventSlot;
+
+static QueueHandle_t uplinkQueue = NULL;
+static TaskHandle_t uplinkTaskHandle = NULL;
+static SemaphoreHandle_t modemMutex = NULL;
+static UplinkSendFn uplinkSend = NULL;
+static UplinkStats uplinkStats = {};
+static uint32_t uplinkSeq = 0;
+static uint32_t uplinkBoot = 0;
+static TelemetryStore uplinkStore;      // Only used by the uplink task
+static TelemetrySnapshot uplinkBatch[UPLINK_BATCH_MAX]; // Same
+static UplinkEventSlot uplinkEvents[UPLINK_EVENT_COUNT];
+static portMUX_TYPE uplinkStatsMux = portMUX_INITIALIZER_UNLOCKED;
+static volatile bool uplinkFlushRequested = false;
+
+// Serialise modem access between the uplink task and everyone else. Before uplinkBegin()
+// only setup() runs, so there is nothing to lock.
+static bool modemLock()
+{
+    return modemMutex == NULL || xSemaphoreTake(modemMutex, portMAX_DELAY) == pdTRUE;
+}
+
+static bool modemTryLock()
+{
+    return modemMutex == NULL || xSemaphoreTake(modemMutex, 0) == pdTRUE;
+}
+
+static void modemUnlock()
+{
+    if (modemMutex != NULL)
+    {
+        xSemaphoreGive(modemMutex);
+    }
+}
+
+// The task waits for a notification, not on the queue, so that an event wakes it too
+static void uplinkWake()
+{
+    if (uplinkTaskHandle != NULL)
+    {
+        xTaskNotifyGive(uplinkTaskHandle);
+    }
+}
+
+// Never blocks. Returns false if the snapshot could not be queued at all (uplink not started).
+static bool uplinkEnqueue(const TelemetrySnapshot &snap)
+{
+    if (uplinkQueue == NULL)
+    {
+        return false;
+    }
+    TelemetrySnapshot s = snap;
+    s.enqueuedMs = millis();
+    s.boot = uplinkBoot;
+    portENTER_CRITICAL(&uplinkStatsMux);
+    s.seq = ++uplinkSeq;
+    portEXIT_CRITICAL(&uplinkStatsMux);
+
+    bool dropped = false;
+    if (xQueueSend(uplinkQueue, &s, 0) != pdTRUE)
+    {
+        TelemetrySnapshot oldest;
+        dropped = xQueueReceive(uplinkQueue, &oldest, 0) == pdTRUE;
+        if (xQueueSend(uplinkQueue, &s, 0) != pdTRUE)
+        {
+            dropped = true; // Another producer refilled the slot, lose this one instead
+        }
+    }
+
+    const uint32_t depth = uxQueueMessagesWaiting(uplinkQueue);
+    portENTER_CRITICAL(&uplinkStatsMux);
+    uplinkStats.enqueued++;
+    if (dropped)
+    {
+        uplinkStats.dropped++;
+    }
+    if (depth > uplinkStats.maxDepth)
+    {
+        uplinkStats.maxDepth = depth;
+    }
+    portEXIT_CRITICAL(&uplinkStatsMux);
+    uplinkWake();
+    return true;
+}
+
+// For a condition that is checked over and over (every pass of a sensor task): true only on the
+// check where it turns on, so one onset is raised once.
+static bool uplinkAlarm(UplinkEvent type, bool active)
+{
+    portENTER_CRITICAL(&uplinkStatsMux);
+    const bool onset = active && !uplinkEvents[type].active;
+    uplinkEvents[type].active = active;
+    portEXIT_CRITICAL(&uplinkStatsMux);
+    return onset;
+}
+
+// Posts snap ahead of the routine queue: now, or when UPLINK_EVENT_MIN_GAP_MS have passed since
+// the turn of the last event of this type. Never blocks. Can be called before uplinkBegin(), the
+// event goes out once the task runs.
+static void uplinkRaise(UplinkEvent type, const TelemetrySnapshot &snap)
+{
+    const uint32_t now = millis();
+    TelemetrySnapshot s = snap;
+    s.enqueuedMs = now;
+    s.boot = uplinkBoot;
+    portENTER_CRITICAL(&uplinkStatsMux);
+    UplinkEventSlot &e = uplinkEvents[type];
+    UplinkEventStats &st = uplinkStats.events[type];
+    s.seq = ++uplinkSeq;
+    if (e.pending)
+    {
+        st.limited++; // Replaces the one still waiting, in its turn
+    }
+    else if (st.raised > 0 && (int32_t)(now - e.turnMs) < UPLINK_EVENT_MIN_GAP_MS)
+    {
+        st.limited++;
+        e.turnMs += UPLINK_EVENT_MIN_GAP_MS;
+        e.dueMs = e.turnMs;
+    }
+    else
+    {
+        e.turnMs = now;
+        e.dueMs = now;
+    }
+    e.snap = s;
+    e.pending = true;
+    e.tries = 0;
+    st.raised++;
+    portEXIT_CRITICAL(&uplinkStatsMux);
+    uplinkWake();
+}
+
+// The next snapshot is posted without waiting for its batch to fill (e.g. a report the server
+// asked for). Call right before uplinkEnqueue().
+static void uplinkFlush()
+{
+    uplinkFlushRequested = true;
+}
+
+static void uplinkCount(uint32_t UplinkStats::*counter)
+{
+    portENTER_CRITICAL(&uplinkStatsMux);
+    uplinkStats.*counter += 1;
+    portEXIT_CRITICAL(&uplinkStatsMux);
+}
+
+enum UplinkResult
+{
+    UPLINK_OK,
+    UPLINK_RETRY,   // Keep the record and try again later
+    UPLINK_REJECTED // Drop the record
+};
+
+// Posts the front of the batch, post.taken says how many went out
+static UplinkResult uplinkPost(const TelemetrySnapshot *snaps, uint8_t count, UplinkPost &post)
+{
+    post.taken = 0;
+    post.bodyBytes = 0;
+    const uint32_t startMs = millis();
+    modemLock();
+    const int httpCode = uplinkSend(snaps, count, post);
+    modemUnlock();
+    const uint32_t now = millis();
+    post.taken = constrain(post.taken, 1, count);
+    const uint32_t heapFree = heap_caps_get_free_size(MALLOC_CAP_8BIT);
+    const uint32_t heapLargest = heap_caps_get_largest_free_block(MALLOC_CAP_8BIT);
+    const uint32_t heapLowest = heap_caps_get_minimum_free_size(MALLOC_CAP_8BIT);
+
+    portENTER_CRITICAL(&uplinkStatsMux);
+    uplinkStats.posts++;
+    uplinkStats.bodyBytes += post.bodyBytes;
+    uplinkStats.modemMs += now - startMs;
+    if (uplinkStats.posts == 1)
+    {
+        uplinkStats.heapFirst = heapFree;
+    }
+    uplinkStats.heapFree = heapFree;
+    uplinkStats.heapLargest = heapLargest;
+    uplinkStats.heapLowest = heapLowest;
+    portEXIT_CRITICAL(&uplinkStatsMux);
+
+    if (httpCode >= 200 && httpCode < 300)
+    {
+        portENTER_CRITICAL(&uplinkStatsMux);
+        for (uint8_t i = 0; i < post.taken; i++)
+        {
+            uplinkStats.sent++;
+            if (snaps[i].boot != uplinkBoot)
+            {
+                continue; // Replayed from before a reboot, no latency to measure
+            }
+            const uint32_t latency = now - snaps[i].enqueuedMs;
+            uplinkStats.lastLatencyMs = latency;
+            if (latency > uplinkStats.maxLatencyMs)
+            {
+                uplinkStats.maxLatencyMs = latency;
+            }
+            uplinkStats.avgLatencyMs = (uplinkStats.sent == 1) ? latency
+                : uplinkStats.avgLatencyMs + UPLINK_LATENCY_EWMA * (latency - uplinkStats.avgLatencyMs);
+        }
+        portEXIT_CRITICAL(&uplinkStatsMux);
+        return UPLINK_OK;
+    }
+    if (httpCode >= 400 && httpCode < 500 && httpCode != 408 && httpCode != 429)
+    {
+        return UPLINK_REJECTED; // Counted by the caller, once per record it drops
+    }
+    uplinkCount(&UplinkStats::failed);
+    return UPLINK_RETRY;
+}
+
+static void uplinkPersist(const TelemetrySnapshot &snap)
+{
+    static uint32_t thinCount = 0;
+    if (uplinkStore.shouldThin() && (thinCount++ % UPLINK_THIN_KEEP) != 0)
+    {
+        uplinkCount(&UplinkStats::thinned);
+        return;
+    }
+    if (uplinkStore.append((const uint8_t *)&snap, sizeof(snap), millis()))
+    {
+        uplinkCount(&UplinkStats::stored);
+    }
+    else
+    {
+        uplinkCount(&UplinkStats::dropped); // No flash store: lost, as before
+    }
+}
+
+// Fills an empty batch with the oldest stored records. They leave the store now, the cursor is
+// held until they are delivered.
+static uint8_t uplinkLoadBatch()
+{
+    uint8_t count = 0;
+    uint8_t record[STORE_MAX_RECORD_BYTES];
+    uplinkStore.holdCursor(true);
+    while (count < UPLINK_BATCH_MAX && !uplinkStore.empty())
+    {
+        const uint16_t len = uplinkStore.peek(record);
+        if (len == 0)
+        {
+            continue; // Damaged, the store skipped it
+        }
+        uplinkStore.pop(millis());
+        // Also the layout before utc was added: the time comes from the send time then
+        if (len == sizeof(TelemetrySnapshot) || len == offsetof(TelemetrySnapshot, utc))
+        {
+            memset(&uplinkBatch[count], 0, sizeof(TelemetrySnapshot));
+            memcpy(&uplinkBatch[count++], record, len);
+        }
+        else
+        {
+            uplinkCount(&UplinkStats::rejected); // Written by a firmware with another snapshot layout
+        }
+    }
+    uplinkStore.holdCursor(count > 0);
+    return count;
+}
+
+// The pending event that is due, UPLINK_EVENT_COUNT if there is none
+static uint8_t uplinkEventDue()
+{
+    const uint32_t now = millis();
+    uint8_t due = UPLINK_EVENT_COUNT;
+    portENTER_CRITICAL(&uplinkStatsMux);
+    for (uint8_t t = 0; t < UPLINK_EVENT_COUNT && due == UPLINK_EVENT_COUNT; t++)
+    {
+        if (uplinkEvents[t].pending && (int32_t)(now - uplinkEvents[t].dueMs) >= 0)
+        {
+            due = t;
+        }
+    }
+    portEXIT_CRITICAL(&uplinkStatsMux);
+    return due;
+}
+
+// Posts the pending event of this type on its own. The slot is free while the post runs, so a
+// raise meanwhile is kept and a failed post is only retried if there was none.
+static UplinkResult uplinkPostEvent(uint8_t type)
+{
+    portENTER_CRITICAL(&uplinkStatsMux);
+    UplinkEventSlot &e = uplinkEvents[type];
+    const TelemetrySnapshot snap = e.snap;
+    const uint32_t turnMs = e.turnMs;
+    const uint8_t tries = e.tries + 1;
+    e.pending = false;
+    portEXIT_CRITICAL(&uplinkStatsMux);
+
+    UplinkPost post;
+    const UplinkResult result = uplinkPost(&snap, 1, post);
+    const uint32_t now = millis();
+    bool giveUp = false;
+    portENTER_CRITICAL(&uplinkStatsMux);
+    UplinkEventStats &st = uplinkStats.events[type];
+    if (result == UPLINK_OK)
+    {
+        st.sent++;
+        st.lastLatencyMs = now - turnMs;
+        if (st.lastLatencyMs > st.maxLatencyMs)
+        {
+            st.maxLatencyMs = st.lastLatencyMs;
+        }
+    }
+    else if (result == UPLINK_REJECTED)
+    {
+        uplinkStats.rejected++;
+    }
+    else if (!e.pending && tries < UPLINK_EVENT_TRIES)
+    {
+        st.retries++;
+        e.snap = snap;
+        e.pending = true;
+        e.tries = tries;
+        e.dueMs = now + (UPLINK_EVENT_RETRY_MS << (tries - 1));
+    }
+    else if (!e.pending)
+    {
+        st.stored++;
+        giveUp = true;
+    }
+    portEXIT_CRITICAL(&uplinkStatsMux);
+    if (giveUp)
+    {
+        uplinkPersist(snap);
+    }
+    return result;
+}
+
+// Full, old enough, or nothing to wait for
+static bool uplinkBatchDue(uint8_t count, bool noWait)
+{
+    return count > 0 && (noWait || count >= UPLINK_BATCH_MAX ||
+                         millis() - uplinkBatch[0].enqueuedMs >= UPLINK_BATCH_MAX_AGE_MS);
+}
+
+static void uplinkTask(void *parameter)
+{
+    uplinkStore.begin();
+
+    TelemetrySnapshot snap;
+    uint8_t count = 0;          // Snapshots in uplinkBatch, oldest first
+    bool fromStore = false;     // The batch is a replay, new snapshots go behind it into the store
+    bool urgent = false;        // Severity changed, post without waiting for the batch to fill
+    uint8_t singles = 0;        // After a rejected batch: records still to post one at a time
+    uint32_t retryAtMs = millis();
+    uint32_t backoffMs = UPLINK_RETRY_MIN_MS;
+    for (;;)
+    {
+        const bool retryDue = (int32_t)(millis() - retryAtMs) >= 0;
+        // Post or replay right away when there is something to send, otherwise wait for a snapshot
+        const uint8_t event = uplinkEventDue();
+        TickType_t wait = UPLINK_IDLE_WAKE_MS / portTICK_PERIOD_MS;
+        if (event < UPLINK_EVENT_COUNT ||
+            (retryDue && (uplinkBatchDue(count, fromStore || urgent) || (count == 0 && !uplinkStore.empty()))))
+        {
+            wait = 0;
+        }
+
+        // A live batch that is full (e.g. while a rejected one is resent record by record, or
+        // during a long event post) takes nothing more: new snapshots wait in the queue
+        const bool toStore = fromStore || !uplinkStore.empty() || !retryDue;
+        if ((toStore || count < UPLINK_BATCH_MAX) && xQueueReceive(uplinkQueue, &snap, 0) == pdTRUE)
+        {
+            if (toStore)
+            {
+                uplinkPersist(snap); // Behind the backlog, or backing off
+            }
+            else
+            {
+                urgent |= count > 0 && strcmp(snap.severity, uplinkBatch[count - 1].severity) != 0;
+                urgent |= uplinkFlushRequested;
+                uplinkBatch[count++] = snap;
+            }
+            uplinkFlushRequested = false;
+            continue; // Take everything that is waiting before deciding to post
+        }
+        if (wait > 0 && ulTaskNotifyTake(pdTRUE, wait) > 0)
+        {
+            continue; // A snapshot or an event came in
+        }
+
+        if (event < UPLINK_EVENT_COUNT)
+        {
+            if (uplinkPostEvent(event) == UPLINK_OK && !retryDue)
+            {
+                retryAtMs = millis(); // The network is back, no need to wait out the backoff
+                backoffMs = UPLINK_RETRY_MIN_MS;
+            }
+            continue; // Every due event goes before the batch
+        }
+
+        if (count == 0 && retryDue && !uplinkStore.empty())
+        {
+            count = uplinkLoadBatch();
+            fromStore = count > 0;
+        }
+        if (retryDue && uplinkBatchDue(count, fromStore || urgent))
+        {
+            UplinkPost post;
+            const UplinkResult result = uplinkPost(uplinkBatch, singles > 0 ? 1 : count, post);
+            uint8_t done = 0;
+            if (result == UPLINK_OK)
+            {
+                done = post.taken;
+                if (fromStore)
+                {
+                    portENTER_CRITICAL(&uplinkStatsMux);
+                    uplinkStats.replayed += done;
+                    portEXIT_CRITICAL(&uplinkStatsMux);
+                }
+            }
+            else if (result == UPLINK_REJECTED && post.taken > 1)
+            {
+                singles = post.taken; // Find the bad records one by one
+            }
+            else if (result == UPLINK_REJECTED)
+            {
+                done = 1;
+                uplinkCount(&UplinkStats::rejected);
+            }
+            else if (!fromStore)
+            {
+                for (uint8_t i = 0; i < count; i++)
+                {
+                    uplinkPersist(uplinkBatch[i]); // Kept on flash, replayed from there
+                }
+                count = 0;
+            }
+
+            if (done > 0)
+            {
+                singles = (singles > done) ? singles - done : 0;
+                count -= done;
+                memmove(uplinkBatch, uplinkBatch + done, count * sizeof(TelemetrySnapshot));
+            }
+            if (count == 0)
+            {
+                fromStore = false;
+                urgent = false;
+                singles = 0;
+                uplinkStore.holdCursor(false); // Everything popped so far is delivered
+            }
+
+            if (result == UPLINK_RETRY)
+            {
+                retryAtMs = millis() + backoffMs;
+                backoffMs = min((uint32_t)UPLINK_RETRY_MAX_MS, backoffMs * 2);
+            }
+            else
+            {
+                backoffMs = UPLINK_RETRY_MIN_MS;
+            }
+        }
+        uplinkStore.tick(millis());
+
+        portENTER_CRITICAL(&uplinkStatsMux);
+        uplinkStats.backlog = uplinkStore.count() + (fromStore ? count : 0);
+        portEXIT_CRITICAL(&uplinkStatsMux);
+    }
+}
+
+// Call once the network is up. send runs in the uplink task with the modem locked.
+static bool uplinkBegin(UplinkSendFn send)
+{
+    uplinkSend = send;
+    uplinkBoot = esp_random();
+    modemMutex = xSemaphoreCreateMutex();
+    uplinkQueue = xQueueCreate(UPLINK_QUEUE_DEPTH, sizeof(TelemetrySnapshot));
+    if (modemMutex == NULL || uplinkQueue == NULL)
+    {
+        Serial.println("Uplink: out of memory for the queue");
+        return false;
+    }
+    return xTaskCreate(uplinkTask, "UplinkTask", UPLINK_TASK_STACK, NULL, UPLINK_TASK_PRIORITY, &uplinkTaskHandle) == pdPASS;
+}
+
+static UplinkStats uplinkGetStats()
+{
+    UplinkStats s;
+    portENTER_CRITICAL(&uplinkStatsMux);
+    s = uplinkStats;
+    portEXIT_CRITICAL(&uplinkStatsMux);
+    s.depth = uplinkQueue ? uxQueueMessagesWaiting(uplinkQueue) : 0;
+    return s;
+}
+
+static void uplinkPrintStats()
+{
+    const UplinkStats s = uplinkGetStats();
+    Serial.printf("Uplink: queue %lu/%d (max %lu), sent %lu, failed %lu, rejected %lu, dropped %lu, latency last %lu ms avg %.0f ms max %lu ms\n",
+                  (unsigned long)s.depth, UPLINK_QUEUE_DEPTH, (unsigned long)s.maxDepth,
+                  (unsigned long)s.sent, (unsigned long)s.failed, (unsigned long)s.rejected, (unsigned long)s.dropped,
+                  (unsigned long)s.lastLatencyMs, s.avgLatencyMs, (unsigned long)s.maxLatencyMs);
+    const StoreStats f = uplinkStore.stats();
+    Serial.printf("Uplink store: backlog %lu, stored %lu, replayed %lu, thinned %lu, aged out %lu, corrupt %lu, %lu segment(s), %lu flushes\n",
+                  (unsigned long)s.backlog, (unsigned long)s.stored, (unsigned long)s.replayed, (unsigned long)s.thinned,
+                  (unsigned long)f.dropped, (unsigned long)f.corrupt, (unsigned long)f.segments, (unsigned long)f.flushes);
+    if (s.posts > 0 && s.sent > 0)
+    {
+        Serial.printf("Uplink batches: %lu posts, %.1f records/post, %lu body bytes/record, %lu modem ms/record\n",
+                      (unsigned long)s.posts, (float)s.sent / s.posts,
+                      (unsigned long)(s.bodyBytes / s.sent), (unsigned long)(s.modemMs / s.sent));
+    }
+    if (s.posts > 0)
+    {
+        Serial.printf("Uplink heap: free %lu (%+ld since the first post), largest block %lu, %.0f%% fragmented, lowest %lu\n",
+                      (unsigned long)s.heapFree, (long)s.heapFree - (long)s.heapFirst, (unsigned long)s.heapLargest,
+                      s.heapFree ? 100.0f * (1.0f - (float)s.heapLargest / s.heapFree) : 0.0f,
+                      (unsigned long)s.heapLowest);
+    }
+    for (uint8_t t = 0; t < UPLINK_EVENT_COUNT; t++)
+    {
+        const UplinkEventStats &e = s.events[t];
+        if (e.raised == 0)
+        {
+            continue;
+        }
+        Serial.printf("Uplink %s events: raised %lu (%lu rate limited), sent %lu, retries %lu, stored %lu, latency last %lu ms max %lu ms\n",
+                      uplinkEventNames[t], (unsigned long)e.raised, (unsigned long)e.limited, (unsigned long)e.sent,
+                      (unsigned long)e.retries, (unsigned long)e.stored,
+                      (unsigned long)e.lastLatencyMs, (unsigned long)e.maxLatencyMs);
+    }
+}
@@ -26,6 +26,24 @@ enum HttpMethod {
   TINYGSM_HTTP_PATCH,
 };
 
+/**
+ * @brief Counters of the persistent session, see https_session_request().
+ *
+ * Cold requests had to (re)initialize the HTTP service first, warm ones reused it.
+ * The times run from the call to the +HTTPACTION result, so cold vs warm is the
+ * saving per request.
+ */
+struct HttpsSessionStats {
+  uint32_t inits;          // Full +HTTPINIT set-ups
+  uint32_t stale;          // Kept sessions that failed and were set up again
+  uint32_t paramsSent;     // +HTTPPARA re-issued on a kept session because a value changed
+  uint32_t coldRequests;
+  uint32_t coldMs;
+  uint32_t warmRequests;
+  uint32_t warmMs;
+  uint32_t lastMs;         // Latest request
+};
+
 
 template <class modemType, ModemPlatform platform>
 class TinyGsmHttpsComm {
@@ -61,6 +79,7 @@ class TinyGsmHttpsComm {
    * configurations.
    */
   void https_end() {
+    _sessionOpen = false;
     thisModem().sendAT("+HTTPTERM");
     thisModem().waitResponse(3000);
   }
@@ -277,31 +296,67 @@ class TinyGsmHttpsComm {
     return header;
   }
 
+  /**
+   * @brief Get the headers of the HTTPS response into a buffer, without allocating.
+   *
+   * Headers longer than the buffer are cut, the rest is read from the modem and dropped.
+   *
+   * @param buffer The buffer to store the response headers, NUL terminated.
+   * @param buffer_size The size of the buffer.
+   * @return The number of header bytes stored, not counting the terminator.
+   */
+  int https_header(char* buffer, int buffer_size) {
+    if (!buffer || buffer_size <= 0) { return 0; }
+    buffer[0] = '\0';
+    thisModem().sendAT("+HTTPHEAD");
+    if (!https_wait_header_respond()) { return 0; }
+    int length = thisModem().streamGetIntBefore('\n');
+    if (length == -9999 || length <= 0) {
+      log_e("header is invalid");
+      return 0;
+    }
+    int stored = length < buffer_size ? length : buffer_size - 1;
+    stored     = thisModem().stream.readBytes(buffer, stored);
+    buffer[stored] = '\0';
+    for (int i = stored; i < length && thisModem().stream.read() >= 0; i++) {}
+    // wait ok
+    thisModem().waitResponse();
+    return stored;
+  }
+
   /**
    * @brief Get the body of the HTTPS response and store it in a buffer.
    *
    * This function reads the body of the HTTPS response and stores it in the provided
-   * buffer.
+   * buffer, without allocating. At most buffer_size bytes are read, the rest of the
+   * body stays unread in the modem.
    *
    * @param buffer The buffer to store the response body.
    * @param buffer_size The size of the buffer.
    * @return The number of bytes read from the response body.
    */
   int https_body(uint8_t* buffer, int buffer_size) {
-    if (!buffer || !buffer_size) { return 0; }
+    if (!buffer || buffer_size <= 0) { return 0; }
 
     size_t length = https_get_size();
 
     if (length == 0) return 0;
 
-    if (length > buffer_size) { length = buffer_size; }
+    if (length > (size_t)buffer_size) { length = buffer_size; }
 
     thisModem().sendAT("+HTTPREAD=0,", length);
     if (thisModem().waitResponse(3000) != 1) { return 0; }
-    if (!https_wait_body_respond()) { return 0; }
-    thisModem().streamGetIntBefore('\r');
-    thisModem().streamGetIntBefore('\n');
-    return thisModem().stream.readBytes(buffer, length);
+    // The modem may send the body in several +HTTPREAD: <len> chunks
+    size_t offset = 0;
+    do {
+      if (!https_wait_body_respond()) { break; }
+      int chunk = thisModem().streamGetIntBefore('\n');
+      if (chunk <= 0 || offset + chunk > length) { break; }
+      if (thisModem().stream.readBytes(buffer + offset, chunk) != (size_t)chunk) { break; }
+      offset += chunk;
+    } while (offset < length);
+    thisModem().waitResponse(5000UL, "+HTTPREAD: 0");
+    return offset;
   }
 
   /**
@@ -477,6 +532,147 @@ class TinyGsmHttpsComm {
     return https_method(TINYGSM_HTTP_DELETE, payload.c_str(), payload.length());
   }
 
+  /**
+   * @brief Set the URL of the persistent session.
+   *
+   * The session API keeps the HTTP service, the URL and the headers configured between
+   * requests instead of running https_begin() / https_set_url() / https_add_header() /
+   * https_end() around every one. Setters only record the value: the next
+   * https_session_request() sends +HTTPPARA for what changed since the last request and
+   * nothing for what did not.
+   *
+   * @param url The target URL.
+   * @param ssl_version The SSL version to be used. Defaults to TINYGSM_SSL_AUTO.
+   */
+  void https_session_set_url(const char* url,
+                             ServerSSLVersion ssl_version = TINYGSM_SSL_AUTO) {
+    if (_sessionUrl != url || _sessionSslVersion != ssl_version) {
+      _sessionUrl        = url;
+      _sessionSslVersion = ssl_version;
+      _sessionDirty |= SESSION_URL;
+    }
+  }
+
+  /**
+   * @brief Set the Content-Type of the persistent session (+HTTPPARA="CONTENT").
+   */
+  void https_session_set_content_type(const char* contentType) {
+    if (_sessionContent != contentType) {
+      _sessionContent = contentType;
+      _sessionDirty |= SESSION_CONTENT;
+    }
+  }
+
+  /**
+   * @brief Set the Accept type of the persistent session (+HTTPPARA="ACCEPT").
+   */
+  void https_session_set_accept_type(const char* acceptType) {
+    if (_sessionAccept != acceptType) {
+      _sessionAccept = acceptType;
+      _sessionDirty |= SESSION_ACCEPT;
+    }
+  }
+
+  /**
+   * @brief Set the one custom header of the persistent session (+HTTPPARA="USERDATA").
+   *
+   * @param name The name of the header, NULL or "" for none.
+   * @param value The value of the header.
+   */
+  void https_session_set_header(const char* name, const char* value) {
+    String header;
+    if (name && *name) { header = String(name) + ": " + value; }
+    if (_sessionHeader != header) {
+      _sessionHeader = header;
+      _sessionDirty |= SESSION_HEADER;
+    }
+  }
+
+  /**
+   * @brief Set up the session again after it has been idle this long.
+   *
+   * The modem may drop its HTTP service while idle (network detach, PDP context lost)
+   * without telling the host. A failed request is repeated after a full set-up anyway,
+   * this only saves the failed attempt when long gaps are known to go stale.
+   *
+   * @param ms Idle time in milliseconds, 0 (the default) to keep the session forever.
+   */
+  void https_session_set_max_idle(uint32_t ms) {
+    _sessionMaxIdleMs = ms;
+  }
+
+  /**
+   * @brief Send a request in the persistent session.
+   *
+   * The first request, and any after https_session_end() or https_end(), runs the full
+   * set-up: +HTTPTERM, +HTTPINIT, SNI, SSL version and every parameter. Later requests
+   * only send the parameters that changed. If a request on a kept session fails at the
+   * modem (no +HTTPACTION result, or a 7xx status: socket, DNS, TLS or busy errors) the
+   * session is taken as stale, set up from scratch and the request sent once more.
+   * Statuses from the server (1xx to 6xx) leave the session open.
+   *
+   * The response can be read with https_header() / https_body() as before; do not call
+   * https_end() afterwards, that closes the session.
+   *
+   * @param method The HTTP method.
+   * @param payload The request body, NULL for none.
+   * @param size The size of the request body in bytes.
+   * @return The HTTP status code of the response, -1 if the request failed.
+   */
+  int https_session_request(HttpMethod method, const char* payload, size_t size) {
+    const uint32_t start = millis();
+    bool cold = !_sessionOpen ||
+        (_sessionMaxIdleMs && start - _sessionLastMs > _sessionMaxIdleMs);
+    bool ready = cold ? https_session_init() : https_session_apply();
+    int status = ready ? https_method(method, payload, size) : -1;
+    if (!cold && (status < 0 || status >= 700)) {
+      log_d("HTTP session stale (%d), setting it up again", status);
+      _sessionStats.stale++;
+      cold   = true;
+      status = https_session_init() ? https_method(method, payload, size) : -1;
+    }
+    if (status < 0 || status >= 700) {
+      _sessionOpen = false;  // Start clean next time
+    }
+    _sessionLastMs = millis();
+
+    const uint32_t elapsed = _sessionLastMs - start;
+    _sessionStats.lastMs   = elapsed;
+    if (cold) {
+      _sessionStats.coldRequests++;
+      _sessionStats.coldMs += elapsed;
+    } else {
+      _sessionStats.warmRequests++;
+      _sessionStats.warmMs += elapsed;
+    }
+    return status;
+  }
+
+  /**
+   * @brief Send a POST request in the persistent session, see https_session_request().
+   */
+  int https_session_post(const char* payload, size_t size) {
+    return https_session_request(TINYGSM_HTTP_POST, payload, size);
+  }
+
+  int https_session_post(const String& payload) {
+    return https_session_request(TINYGSM_HTTP_POST, payload.c_str(), payload.length());
+  }
+
+  /**
+   * @brief Close the persistent session (+HTTPTERM). The next request sets it up again.
+   */
+  void https_session_end() {
+    if (_sessionOpen) { https_end(); }
+  }
+
+  /**
+   * @brief Counters of the persistent session since start-up.
+   */
+  const HttpsSessionStats& https_session_stats() const {
+    return _sessionStats;
+  }
+
   /**
    * @brief  POSTFile
    * @note   Send file to server
@@ -508,6 +704,52 @@ class TinyGsmHttpsComm {
   }
 
  private:
+  enum {
+    SESSION_URL     = 1 << 0,
+    SESSION_CONTENT = 1 << 1,
+    SESSION_ACCEPT  = 1 << 2,
+    SESSION_HEADER  = 1 << 3,
+    SESSION_ALL     = 0x0F,
+  };
+
+  // Full set-up of the HTTP service with every session parameter
+  bool https_session_init() {
+    _sessionStats.inits++;
+    if (!https_begin()) { return false; }
+    _sessionDirty = SESSION_ALL;
+    if (!https_session_apply()) {
+      https_end();
+      return false;
+    }
+    _sessionOpen = true;
+    return true;
+  }
+
+  // Sends the session parameters marked dirty
+  bool https_session_apply() {
+    if ((_sessionDirty & SESSION_URL) &&
+        !https_set_url(_sessionUrl, _sessionSslVersion)) {
+      return false;
+    }
+    if ((_sessionDirty & SESSION_CONTENT) && _sessionContent.length() &&
+        !https_set_content_type(_sessionContent.c_str())) {
+      return false;
+    }
+    if ((_sessionDirty & SESSION_ACCEPT) && _sessionAccept.length() &&
+        !https_set_accept_type(_sessionAccept.c_str())) {
+      return false;
+    }
+    if (_sessionDirty & SESSION_HEADER) {
+      thisModem().sendAT("+HTTPPARA=\"USERDATA\",\"", _sessionHeader, "\"");
+      if (thisModem().waitResponse(3000) != 1) { return false; }
+    }
+    for (uint8_t bit = SESSION_URL; _sessionOpen && (bit & SESSION_ALL); bit <<= 1) {
+      if (_sessionDirty & bit) { _sessionStats.paramsSent++; }  // Changes on a kept session
+    }
+    _sessionDirty = 0;
+    return true;
+  }
+
   bool https_wait_header_respond() {
     const char* header_respond = "+HTTPHEAD: ";
     switch (platform) {
@@ -545,6 +787,21 @@ class TinyGsmHttpsComm {
     }
     return -1;
   }
+  /*
+   * Persistent session state
+   */
+ protected:
+  bool              _sessionOpen       = false;
+  uint8_t           _sessionDirty      = SESSION_ALL;
+  String            _sessionUrl;
+  ServerSSLVersion  _sessionSslVersion = TINYGSM_SSL_AUTO;
+  String            _sessionContent;
+  String            _sessionAccept;
+  String            _sessionHeader;
+  uint32_t          _sessionMaxIdleMs  = 0;
+  uint32_t          _sessionLastMs     = 0;
+  HttpsSessionStats _sessionStats      = {};
+
   /*
    * CRTP Helper
    */
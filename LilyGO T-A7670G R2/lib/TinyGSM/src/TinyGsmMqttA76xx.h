@@ -236,7 +236,17 @@ public:
     bool mqtt_publish(uint8_t clientIndex, const char *topic, const char *playload,
                       uint8_t qos = 0, uint32_t timeout = 60)
     {
-        if (clientIndex > muxCount) {
+        return mqtt_publish(clientIndex, topic, (const uint8_t *)playload, strlen(playload), qos, timeout);
+    }
+
+    // Binary-safe publish. Returns once the modem reports the result: for QoS 1 and 2 that
+    // is the broker's acknowledgement, so true means the broker has the message. A message
+    // that arrives while it waits goes to the callback, as in mqtt_handle(), instead of being
+    // skipped over by waitResponse().
+    bool mqtt_publish(uint8_t clientIndex, const char *topic, const uint8_t *payload, size_t length,
+                      uint8_t qos = 0, uint32_t timeout = 60)
+    {
+        if (clientIndex > muxCount || length == 0) {
             return false;
         }
         // +CMQTTTOPIC: (0-1),(1-1024)
@@ -256,11 +266,11 @@ public:
         // AT+CMQTTPAYLOAD Input the publish message body
         // +CMQTTPAYLOAD: (0-1),(1-10240)
         // <client_index>,<req_length>
-        thisModem().sendAT("+CMQTTPAYLOAD=", clientIndex, ',', strlen(playload));
+        thisModem().sendAT("+CMQTTPAYLOAD=", clientIndex, ',', length);
         if (thisModem().waitResponse(10000UL, ">") != 1) {
             return false;
         }
-        thisModem().stream.write(playload);
+        thisModem().stream.write(payload, length);
         thisModem().stream.println();
         // Wait return OK
         if (thisModem().waitResponse() != 1) {
@@ -272,7 +282,25 @@ public:
         if (thisModem().waitResponse() != 1) {
             return false;
         }
-        return true;
+        // +CMQTTPUB: <client_index>,<err>, after the PUBACK / PUBCOMP for QoS 1 / 2
+        const uint32_t start = millis();
+        for (;;) {
+            const uint32_t waited = millis() - start;
+            if (waited >= timeout * 1000UL) {
+                return false;
+            }
+            const int8_t got = thisModem().waitResponse(timeout * 1000UL - waited, "+CMQTTPUB: ",
+                                                        "+CMQTTRXSTART:", "ERROR");
+            if (got == 1) {
+                break;
+            }
+            if (got != 2) {
+                return false;
+            }
+            mqttReceive(1000UL);
+        }
+        thisModem().streamSkipUntil(',');
+        return thisModem().streamGetIntBefore('\n') == 0;
     }
 
     bool mqtt_subscribe(uint8_t clientIndex, const char *topic, uint8_t qos = 0, uint8_t dup = 0)
@@ -405,63 +433,70 @@ public:
         //TODO:More than 1500 bytes will carry the Modem return flag
         // +CMQTTCONNLOST: 1,1
         if (thisModem().waitResponse(timeout, "+CMQTTRXSTART:") == 1) {
-            thisModem().streamSkipUntil(',');
-            size_t topicSize = 0;
-            size_t plyloadSize = 0;
-            size_t topic_total_len =  thisModem().streamGetIntBefore(',');
-            size_t payload_total_len =  thisModem().streamGetIntBefore('\n');
-            if (thisModem().waitResponse(timeout, "+CMQTTRXTOPIC:") == 1) {
-
-                thisModem().streamSkipUntil('\n');
-                topicSize = topic_total_len > bufferSize ? bufferSize - 1 : topic_total_len;
-                thisModem().stream.readBytes(buffer, topicSize);
-                buffer[topicSize] = '\0';
-                topicSize += 1;
-
-                if (topicSize == bufferSize) {
-                    DBG("Buffer overflow!");
-                    thisModem().waitResponse(10000UL);
-                    return false;
-                }
-                size_t recvSize = 0;
-                size_t remainingSize = bufferSize - topicSize;
-                size_t bufferOffset = topicSize;
+            return mqttReceive(timeout);
+        }
+        return false;
+    }
 
-                do {
-                    if (thisModem().waitResponse(timeout, "+CMQTTRXPAYLOAD:") == 1) {
-                        thisModem().streamSkipUntil(',');
-                        int packetSize = thisModem().streamGetIntBefore('\n');
 
-                        plyloadSize = packetSize > remainingSize ? remainingSize : packetSize;
+protected:
+    // Reads one received message after its +CMQTTRXSTART: and hands it to the callback
+    bool mqttReceive(uint32_t timeout)
+    {
+        thisModem().streamSkipUntil(',');
+        size_t topicSize = 0;
+        size_t plyloadSize = 0;
+        size_t topic_total_len =  thisModem().streamGetIntBefore(',');
+        size_t payload_total_len =  thisModem().streamGetIntBefore('\n');
+        if (thisModem().waitResponse(timeout, "+CMQTTRXTOPIC:") == 1) {
+
+            thisModem().streamSkipUntil('\n');
+            topicSize = topic_total_len > bufferSize ? bufferSize - 1 : topic_total_len;
+            thisModem().stream.readBytes(buffer, topicSize);
+            buffer[topicSize] = '\0';
+            topicSize += 1;
+
+            if (topicSize == bufferSize) {
+                DBG("Buffer overflow!");
+                thisModem().waitResponse(10000UL);
+                return false;
+            }
+            size_t recvSize = 0;
+            size_t remainingSize = bufferSize - topicSize;
+            size_t bufferOffset = topicSize;
 
-                        if (bufferOffset >= bufferSize) {
-                            DBG("Buffer overflow!");
-                            break;
-                        }
-                        thisModem().stream.readBytes(buffer + bufferOffset, plyloadSize);
+            do {
+                if (thisModem().waitResponse(timeout, "+CMQTTRXPAYLOAD:") == 1) {
+                    thisModem().streamSkipUntil(',');
+                    int packetSize = thisModem().streamGetIntBefore('\n');
 
-                        remainingSize -= plyloadSize;
-                        bufferOffset += plyloadSize;
-                        recvSize += packetSize;
+                    plyloadSize = packetSize > remainingSize ? remainingSize : packetSize;
 
+                    if (bufferOffset >= bufferSize) {
+                        DBG("Buffer overflow!");
+                        break;
                     }
-                } while (recvSize != payload_total_len);
+                    thisModem().stream.readBytes(buffer + bufferOffset, plyloadSize);
+
+                    remainingSize -= plyloadSize;
+                    bufferOffset += plyloadSize;
+                    recvSize += packetSize;
 
-                if (thisModem().waitResponse(timeout, "+CMQTTRXEND: 0") == 1) {
-                    if (this->callback) {
-                        this->callback((const char *)buffer, buffer + topicSize, recvSize);
-                    }
-                    memset(this->buffer, 0, bufferSize);
-                    return true;
                 }
+            } while (recvSize != payload_total_len);
 
+            if (thisModem().waitResponse(timeout, "+CMQTTRXEND: 0") == 1) {
+                if (this->callback) {
+                    this->callback((const char *)buffer, buffer + topicSize, recvSize);
+                }
+                memset(this->buffer, 0, bufferSize);
+                return true;
             }
+
         }
         return false;
     }
 
-
-protected:
     bool mqttWillTopic(uint8_t clientIndex, const char *topic)
     {
         if (clientIndex > muxCount) {
@@ -0,0 +1,333 @@
+// Host simulation of the uplink task: batching, store and forward, rejected batches, events
+//
+// Runs on the PC, not the ESP32. Compiles the real HttpsBuiltlnPost/uplink.h and telemetry_store.h
+// against ../host_stubs (LittleFS on a folder of the PC) and drives uplinkTask() in simulated time:
+// a producer enqueues a snapshot every 15 s and the send function stands in for the modem.
+// Build and run from this folder:
+//   g++ -O1 -g -std=gnu++17 -Wall -Wno-unused-function -fsanitize=address,undefined -I../host_stubs -I../../HttpsBuiltlnPost 01_Uplink_Host_Sim_Main_Code.cpp ../host_stubs/HostStubs.cpp -o uplink_sim
+//   ./uplink_sim                all scenarios, each in its own process (uplink.h state is static)
+//   ./uplink_sim reject         one scenario
+//
+// Scenarios (6 h each):
+//   steady   every post goes through
+//   outage   no coverage from 1 h to 3 h, and 5 % of the other posts get a 503
+//   reject   every 97th record is refused with a 400, so whole batches are rejected and resent
+//            one record per post; on a slow link (16 s a post) new snapshots arrive while the
+//            rejected batch is still full
+//   events   a topple every 20 s in bursts of three, 15 min apart, on top of the routine records
+//
+// The modem is a model, not a measurement: a post takes 3 s (16 s in reject) + 50 ms per record,
+// and a record takes SIM_RECORD_BYTES of body. Checks: no post carries more than UPLINK_BATCH_MAX
+// records, every record enqueued before the last 30 min is delivered (except the refused ones),
+// records arrive oldest first (events may go ahead), and the reject scenario did enqueue snapshots
+// while a rejected batch was being resent. AddressSanitizer catches a write past uplinkBatch[], as the
+// task made before it stopped taking snapshots into a full batch. Exits non-zero on any failure.
+
+#define UPLINK_BATCHING 1 // Off in the sketch until the server takes arrays; this is what is simulated
+#include "uplink.h"
+
+#include <stdlib.h>
+#include <deque>
+#include <filesystem>
+#include <map>
+#include <set>
+#include <string>
+#include <vector>
+
+constexpr uint32_t SIM_SNAPSHOT_MS = 15000;
+constexpr uint32_t SIM_RUN_MS = 6 * 3600000UL;
+constexpr uint32_t SIM_SETTLE_MS = 30 * 60000UL; // records enqueued later may still be in flight
+constexpr uint32_t SIM_POST_RECORD_MS = 50;
+constexpr uint32_t SIM_RECORD_BYTES = 157; // one JSON record as postData() writes it
+constexpr uint32_t SIM_BAD_EVERY = 97;
+constexpr float SIM_BAD_LAT = -999.0f; // marks a record the server refuses
+
+struct Scenario
+{
+  const char *name;
+  bool outage;
+  uint8_t failPercent;
+  bool bad;
+  bool events;
+  uint32_t postMs; // modem time of a post before the per-record part
+};
+
+static const Scenario SCENARIOS[] = {
+    {"steady", false, 0, false, false, 3000},
+    {"outage", true, 5, false, false, 3000},
+    {"reject", false, 0, true, false, 16000},
+    {"events", false, 0, false, true, 3000},
+};
+
+struct StopSim
+{
+};
+
+static Scenario g_sc;
+static std::deque<TelemetrySnapshot> g_queue;
+static uint32_t g_notified = 0;
+static bool g_inProducer = false;
+static uint32_t g_nextSnapMs = SIM_SNAPSHOT_MS;
+static uint32_t g_nextEventMs = 600000;
+static uint32_t g_eventCount = 0;
+static std::map<uint32_t, uint32_t> g_enqueuedAt; // routine seq -> enqueue time
+static std::set<uint32_t> g_badSeqs, g_eventSeqs;
+
+// What the "server" saw
+static std::vector<uint32_t> g_delivered;
+static uint32_t g_posts = 0;
+static uint32_t g_oversized = 0;       // posts with more than UPLINK_BATCH_MAX records
+static bool g_resending = false;       // a rejected batch is being resent one record per post
+static uint32_t g_enqueuedResending = 0;
+
+static bool inOutage(uint32_t t)
+{
+  return g_sc.outage && t > 3600000UL && t < 3 * 3600000UL;
+}
+
+static void produceSnapshot()
+{
+  TelemetrySnapshot s = {};
+  s.sampledMs = g_hostMillis;
+  s.lat = 1.3f;
+  s.lng = 103.8f;
+  s.soc = 80;
+  strcpy(s.severity, "Safe");
+  const uint32_t seq = uplinkSeq + 1; // what uplinkEnqueue() will give it
+  if (g_sc.bad && seq % SIM_BAD_EVERY == 0)
+  {
+    s.lat = SIM_BAD_LAT;
+    g_badSeqs.insert(seq);
+  }
+  if (g_resending)
+    g_enqueuedResending++;
+  g_enqueuedAt[seq] = g_hostMillis;
+  uplinkEnqueue(s);
+}
+
+static void produceEvent()
+{
+  TelemetrySnapshot s = {};
+  s.sampledMs = g_hostMillis;
+  strcpy(s.severity, "Toppled");
+  if (uplinkAlarm(UPLINK_EVENT_TOPPLE, true))
+  {
+    g_eventSeqs.insert(uplinkSeq + 1);
+    uplinkRaise(UPLINK_EVENT_TOPPLE, s);
+  }
+  uplinkAlarm(UPLINK_EVENT_TOPPLE, false);
+  g_eventCount++;
+  g_nextEventMs += (g_eventCount % 3) ? 20000 : 900000;
+}
+
+// Runs the producers up to time t. stopAtWake: return at the first one that wakes the task.
+static void produceUntil(uint32_t t, bool stopAtWake)
+{
+  g_inProducer = true;
+  for (;;)
+  {
+    if (stopAtWake && g_notified > 0)
+      break;
+    const uint32_t next = g_sc.events ? min(g_nextSnapMs, g_nextEventMs) : g_nextSnapMs;
+    if (next > t)
+      break;
+    g_hostMillis = max(g_hostMillis, next);
+    if (next == g_nextSnapMs)
+    {
+      produceSnapshot();
+      g_nextSnapMs += SIM_SNAPSHOT_MS;
+    }
+    else
+    {
+      produceEvent();
+    }
+  }
+  g_inProducer = false;
+}
+
+// ---- FreeRTOS, as the uplink task sees it in simulated time ----
+QueueHandle_t xQueueCreate(UBaseType_t, UBaseType_t) { return (QueueHandle_t)&g_queue; }
+
+BaseType_t xQueueSend(QueueHandle_t, const void *item, TickType_t)
+{
+  if (g_queue.size() >= UPLINK_QUEUE_DEPTH)
+    return pdFALSE;
+  g_queue.push_back(*(const TelemetrySnapshot *)item);
+  return pdTRUE;
+}
+
+BaseType_t xQueueReceive(QueueHandle_t, void *item, TickType_t)
+{
+  if (!g_inProducer) // the task polling: time for the producers to catch up
+  {
+    if (g_hostMillis >= SIM_RUN_MS)
+      throw StopSim();
+    produceUntil(g_hostMillis, false);
+  }
+  if (g_queue.empty())
+    return pdFALSE;
+  *(TelemetrySnapshot *)item = g_queue.front();
+  g_queue.pop_front();
+  return pdTRUE;
+}
+
+UBaseType_t uxQueueMessagesWaiting(QueueHandle_t) { return g_queue.size(); }
+
+uint32_t ulTaskNotifyTake(BaseType_t, TickType_t wait)
+{
+  produceUntil(g_hostMillis + wait, true);
+  if (g_notified > 0)
+  {
+    const uint32_t n = g_notified;
+    g_notified = 0;
+    return n;
+  }
+  g_hostMillis += wait;
+  return 0;
+}
+
+BaseType_t xTaskNotifyGive(TaskHandle_t)
+{
+  g_notified++;
+  return pdPASS;
+}
+
+BaseType_t xTaskCreate(void (*)(void *), const char *, uint32_t, void *, UBaseType_t, TaskHandle_t *handle)
+{
+  *handle = (TaskHandle_t)1; // main() runs the task itself
+  return pdPASS;
+}
+
+void vTaskDelay(TickType_t ticks) { g_hostMillis += ticks; }
+
+// ---- The modem and the server ----
+static int simSend(const TelemetrySnapshot *snaps, uint8_t count, UplinkPost &post)
+{
+  g_posts++;
+  if (count > UPLINK_BATCH_MAX)
+    g_oversized++;
+  const uint32_t doneMs = g_hostMillis + g_sc.postMs + SIM_POST_RECORD_MS * count;
+  produceUntil(doneMs, false); // snapshots keep coming while the modem is busy
+  g_hostMillis = doneMs;
+  if (inOutage(g_hostMillis))
+    return 0;
+  if (g_sc.failPercent && (uint32_t)(rand() % 100) < g_sc.failPercent)
+    return 503;
+
+  const uint8_t fit = (uint8_t)min<uint32_t>(count, UPLINK_BATCH_MAX_BYTES / (SIM_RECORD_BYTES + 1));
+  post.taken = fit;
+  post.bodyBytes = fit * (SIM_RECORD_BYTES + 1) + 1;
+  if (fit > 1)
+    g_resending = false;
+  for (uint8_t i = 0; i < fit; i++)
+  {
+    if (snaps[i].lat == SIM_BAD_LAT)
+    {
+      if (fit > 1)
+        g_resending = true;
+      return 400;
+    }
+  }
+  for (uint8_t i = 0; i < fit; i++)
+    g_delivered.push_back(snaps[i].seq);
+  return 200;
+}
+
+static int fails = 0;
+#define CHECK(c)                                            \
+  do                                                        \
+  {                                                         \
+    if (!(c))                                               \
+    {                                                       \
+      printf("  FAIL line %d: %s\n", __LINE__, #c);         \
+      fails++;                                              \
+    }                                                       \
+  } while (0)
+
+static int runScenario(const Scenario &sc)
+{
+  g_sc = sc;
+  g_hostFsRoot = std::string("host_fs_") + sc.name;
+  std::filesystem::remove_all(g_hostFsRoot);
+  srand(3);
+
+  uplinkBegin(simSend);
+  try
+  {
+    uplinkTask(nullptr);
+  }
+  catch (StopSim &)
+  {
+  }
+
+  std::set<uint32_t> seen;
+  uint32_t outOfOrder = 0, prev = 0, badDelivered = 0;
+  for (uint32_t seq : g_delivered)
+  {
+    if (!seen.insert(seq).second || g_eventSeqs.count(seq))
+      continue;
+    if (seq < prev)
+      outOfOrder++;
+    prev = seq;
+    badDelivered += g_badSeqs.count(seq);
+  }
+  uint32_t missing = 0, checked = 0;
+  for (const auto &e : g_enqueuedAt)
+  {
+    if (e.second + SIM_SETTLE_MS > SIM_RUN_MS || g_badSeqs.count(e.first))
+      continue;
+    checked++;
+    missing += !seen.count(e.first);
+  }
+
+  const UplinkStats st = uplinkGetStats();
+  printf("%s: %u records checked, %u missing, %u out of order, %u posts, %.1f records/post, %u oversized posts\n",
+         sc.name, checked, missing, outOfOrder, g_posts, st.posts ? (float)st.sent / st.posts : 0.0f, g_oversized);
+  printf("  sent %u, failed %u, rejected %u, dropped %u, stored %u, replayed %u, max latency %u s\n",
+         st.sent, st.failed, st.rejected, st.dropped, st.stored, st.replayed, st.maxLatencyMs / 1000);
+  if (sc.bad)
+    printf("  %zu refused records, %u snapshots enqueued while a rejected batch was resent\n", g_badSeqs.size(), g_enqueuedResending);
+  if (sc.events)
+  {
+    const UplinkEventStats &e = st.events[UPLINK_EVENT_TOPPLE];
+    printf("  topples %u: raised %u, rate limited %u, sent %u, max latency %u ms\n",
+           g_eventCount, e.raised, e.limited, e.sent, e.maxLatencyMs);
+  }
+
+  CHECK(g_oversized == 0);
+  CHECK(missing == 0);
+  CHECK(outOfOrder == 0);
+  CHECK(badDelivered == 0);
+  CHECK(st.dropped == 0);
+  if (sc.bad)
+  {
+    CHECK(st.rejected == g_badSeqs.size());
+    CHECK(g_enqueuedResending > 0); // the case this scenario is here for
+  }
+  if (!sc.outage && !sc.events)
+    CHECK(st.maxLatencyMs <= UPLINK_BATCH_MAX_AGE_MS + UPLINK_BATCH_MAX * (sc.postMs + SIM_POST_RECORD_MS) + SIM_SNAPSHOT_MS);
+  std::filesystem::remove_all(g_hostFsRoot);
+  printf(fails ? "  FAILED\n" : "  OK\n");
+  return fails;
+}
+
+int main(int argc, char **argv)
+{
+  if (argc > 1)
+  {
+    for (const Scenario &sc : SCENARIOS)
+      if (!strcmp(argv[1], sc.name))
+        return runScenario(sc);
+    fprintf(stderr, "unknown scenario %s\n", argv[1]);
+    return 2;
+  }
+  int failed = 0;
+  for (const Scenario &sc : SCENARIOS)
+  {
+    fflush(stdout);
+    const std::string cmd = std::string("\"") + argv[0] + "\" " + sc.name;
+    failed += system(cmd.c_str()) != 0;
+  }
+  printf(failed ? "%d scenario(s) FAILED\n" : "all scenarios OK\n", failed);
+  return failed;
+}
@@ -0,0 +1,282 @@
+// Host test of TelemetryStore: order, capacity, power loss and the held cursor
+//
+// Runs on the PC, not the ESP32. Compiles the real HttpsBuiltlnPost/telemetry_store.h against
+// ../host_stubs, whose LittleFS is a folder of the PC (host_fs_store, deleted before each run).
+// Build and run from this folder:
+//   g++ -O1 -g -std=gnu++17 -Wall -fsanitize=address,undefined -I../host_stubs -I../../HttpsBuiltlnPost 02_Telemetry_Store_Host_Test_Main_Code.cpp ../host_stubs/HostStubs.cpp -o store_test
+//   ./store_test
+//
+// Cases:
+//   random    200 000 random appends, pops, ticks and clean reboots against a model queue: every
+//             record comes back once and in order (except segments aged out when full)
+//   overflow  20 000 records into a store of STORE_MAX_SEGMENTS: the newest are kept, in order
+//   torn      the newest segment loses its last bytes: the records before the tear come back
+//   held      while holdCursor(true), a segment read to the end stays on flash and the cursor is
+//             not saved, so a reboot replays the popped records; holdCursor(false) deletes it
+//   held full the store fills up while the cursor is held: segments age out and are deleted,
+//             except the ones the popped records came from; no cursor save until release
+// Exits non-zero on any failure.
+
+#include "telemetry_store.h"
+
+#include <stdlib.h>
+#include <deque>
+#include <filesystem>
+
+constexpr uint16_t REC_BYTES = 48;
+
+static int fails = 0;
+#define CHECK(c)                                    \
+  do                                                \
+  {                                                 \
+    if (!(c))                                       \
+    {                                               \
+      printf("  FAIL line %d: %s\n", __LINE__, #c); \
+      fails++;                                      \
+    }                                               \
+  } while (0)
+
+static void appendRecord(TelemetryStore &st, uint32_t v)
+{
+  uint8_t rec[REC_BYTES];
+  memset(rec, v & 0xff, sizeof(rec));
+  memcpy(rec, &v, sizeof(v));
+  st.append(rec, sizeof(rec), millis());
+}
+
+// Value of the oldest record, 0 if the store is empty
+static uint32_t peekValue(TelemetryStore &st)
+{
+  uint8_t buf[STORE_MAX_RECORD_BYTES];
+  uint16_t len;
+  while ((len = st.peek(buf)) == 0 && !st.empty())
+  {
+  }
+  if (len == 0)
+    return 0;
+  uint32_t v;
+  memcpy(&v, buf, sizeof(v));
+  return v;
+}
+
+static uint32_t popValue(TelemetryStore &st)
+{
+  const uint32_t v = peekValue(st);
+  if (v)
+    st.pop(millis());
+  return v;
+}
+
+static bool segmentExists(uint32_t id)
+{
+  char path[64];
+  snprintf(path, sizeof(path), "%s" STORE_DIR "/%08lx", g_hostFsRoot.c_str(), (unsigned long)id);
+  return std::filesystem::exists(path);
+}
+
+static TelemetryStore *freshStore()
+{
+  std::filesystem::remove_all(g_hostFsRoot);
+  TelemetryStore *st = new TelemetryStore;
+  CHECK(st->begin());
+  return st;
+}
+
+static TelemetryStore *reboot(TelemetryStore *st)
+{
+  delete st;
+  st = new TelemetryStore;
+  st->begin();
+  return st;
+}
+
+static void testRandom()
+{
+  TelemetryStore *st = freshStore();
+  std::deque<uint32_t> model;
+  uint32_t next = 1, agedOut = 0;
+  srand(1);
+  for (int step = 0; step < 200000 && !fails; step++)
+  {
+    g_hostMillis += 1000;
+    const int r = rand() % 100;
+    if (r < 50)
+    {
+      appendRecord(*st, next);
+      model.push_back(next++);
+    }
+    else if (r < 95)
+    {
+      const uint32_t v = popValue(*st);
+      if (model.empty())
+      {
+        CHECK(v == 0);
+        continue;
+      }
+      while (!model.empty() && model.front() < v) // aged out while the store was full
+      {
+        model.pop_front();
+        agedOut++;
+      }
+      CHECK(!model.empty() && v == model.front());
+      if (!model.empty())
+        model.pop_front();
+    }
+    else if (r < 99)
+    {
+      st->tick(millis());
+    }
+    else // clean reboot: flushed and the cursor saved
+    {
+      st->flush();
+      g_hostMillis += STORE_CURSOR_MS;
+      st->tick(millis());
+      st = reboot(st);
+    }
+  }
+  printf("random: %u appended, %u aged out, %u left\n", next - 1, agedOut, (unsigned)model.size());
+  delete st;
+}
+
+static void testOverflow()
+{
+  TelemetryStore *st = freshStore();
+  for (uint32_t v = 1; v <= 20000; v++)
+    appendRecord(*st, v);
+  st->flush();
+  uint32_t prev = 0, kept = 0, v;
+  while ((v = popValue(*st)) != 0)
+  {
+    CHECK(v > prev);
+    prev = v;
+    kept++;
+  }
+  printf("overflow: %u of 20000 kept, newest %u, %u dropped\n", kept, prev, st->stats().dropped);
+  CHECK(prev == 20000);
+  CHECK(kept + st->stats().dropped >= 19900); // dropped is an estimate
+  delete st;
+}
+
+static void testTorn()
+{
+  TelemetryStore *st = freshStore();
+  for (uint32_t v = 1; v <= 10; v++)
+    appendRecord(*st, v);
+  st->flush();
+  delete st;
+  char path[64];
+  snprintf(path, sizeof(path), "%s" STORE_DIR "/%08lx", g_hostFsRoot.c_str(), 1ul);
+  std::filesystem::resize_file(path, std::filesystem::file_size(path) - 20);
+  st = new TelemetryStore;
+  st->begin();
+  uint32_t n = 0;
+  while (popValue(*st))
+    n++;
+  printf("torn: %u of 10 recovered, %u corrupt\n", n, st->stats().corrupt);
+  CHECK(n == 9);
+  appendRecord(*st, 11); // appends go to a fresh segment, not behind the tear
+  st->flush();
+  CHECK(peekValue(*st) == 11);
+  delete st;
+}
+
+// Records of one segment (the store starts a new one when the next flush would not fit)
+static uint32_t recordsPerSegment()
+{
+  const uint32_t rec = 8 + REC_BYTES;
+  return (STORE_SEGMENT_BYTES / (rec * STORE_FLUSH_RECORDS)) * STORE_FLUSH_RECORDS;
+}
+
+static void testHeld()
+{
+  const uint32_t perSeg = recordsPerSegment();
+  TelemetryStore *st = freshStore();
+  for (uint32_t v = 1; v <= 3 * perSeg; v++)
+    appendRecord(*st, v);
+  st->flush();
+  g_hostMillis += STORE_CURSOR_MS;
+  st->tick(millis());
+
+  // A replay batch that runs past the end of segment 1, not delivered yet
+  const uint32_t saves = st->stats().cursorSaves;
+  st->holdCursor(true);
+  for (uint32_t i = 0; i < perSeg + 5; i++)
+    popValue(*st);
+  g_hostMillis += 2 * STORE_CURSOR_MS;
+  st->tick(millis());
+  CHECK(segmentExists(1));
+  CHECK(st->stats().cursorSaves == saves);
+  st = reboot(st); // power lost before the 2xx
+  const uint32_t first = peekValue(*st);
+  printf("held: after a reboot with %u records in flight the replay starts at %u\n", perSeg + 5, first);
+  CHECK(first == 1);
+
+  // The same batch delivered this time
+  st->holdCursor(true);
+  for (uint32_t i = 0; i < perSeg + 5; i++)
+    popValue(*st);
+  st->holdCursor(false);
+  CHECK(!segmentExists(1));
+  g_hostMillis += STORE_CURSOR_MS;
+  st->tick(millis());
+  CHECK(st->stats().cursorSaves > 0);
+  st = reboot(st);
+  const uint32_t resumed = peekValue(*st);
+  printf("held: released, a reboot resumes at %u\n", resumed);
+  CHECK(resumed == perSeg + 6);
+  delete st;
+}
+
+static void testHeldFull()
+{
+  const uint32_t perSeg = recordsPerSegment();
+  TelemetryStore *st = freshStore();
+  for (uint32_t v = 1; v <= 2 * perSeg; v++)
+    appendRecord(*st, v);
+  st->flush();
+  g_hostMillis += STORE_CURSOR_MS;
+  st->tick(millis());
+  const uint32_t saves = st->stats().cursorSaves;
+
+  st->holdCursor(true);
+  for (uint32_t i = 0; i < perSeg + 5; i++)
+    popValue(*st);
+  // Fill far past capacity while the batch is out: the segments the batch came from stay and
+  // the cursor is not saved past them, everything else ages out as usual
+  uint32_t v = 2 * perSeg + 1;
+  for (; v <= (STORE_MAX_SEGMENTS + 4) * perSeg; v++)
+    appendRecord(*st, v);
+  st->flush();
+  const StoreStats s = st->stats();
+  printf("held full: %u segments on flash (max %u), %u dropped, %u cursor saves while held\n",
+         s.segments, STORE_MAX_SEGMENTS, s.dropped, s.cursorSaves - saves);
+  CHECK(s.cursorSaves == saves);
+  CHECK(segmentExists(1));
+  CHECK(s.segments <= STORE_MAX_SEGMENTS + 2);
+  CHECK(s.dropped > 0);
+
+  st->holdCursor(false);
+  CHECK(!segmentExists(1));
+  CHECK(st->stats().segments <= STORE_MAX_SEGMENTS);
+  uint32_t prev = 0, x;
+  while ((x = popValue(*st)) != 0)
+  {
+    CHECK(x > prev);
+    prev = x;
+  }
+  CHECK(prev == v - 1);
+  delete st;
+}
+
+int main()
+{
+  g_hostFsRoot = "host_fs_store";
+  testRandom();
+  testOverflow();
+  testTorn();
+  testHeld();
+  testHeldFull();
+  std::filesystem::remove_all(g_hostFsRoot);
+  printf(fails ? "FAILED\n" : "store OK\n");
+  return fails;
+}
@@ -0,0 +1,194 @@
+// Host test of the persistent HTTPS session in TinyGsmHttpsComm, against a scripted fake modem
+//
+// Runs on the PC, not the ESP32. Compiles the real lib/TinyGSM/src/TinyGsmHttpsComm.h against
+// ../host_stubs/FakeModem.h, which answers the HTTP service commands and counts them.
+// Build and run from this folder:
+//   g++ -O1 -g -std=gnu++17 -Wall -fsanitize=address,undefined -I../host_stubs -I../../lib/TinyGSM/src 03_Https_Session_Fake_Modem_Main_Code.cpp ../host_stubs/HostStubs.cpp -o https_session
+//   ./https_session
+//
+// Cases:
+//   per post    what postData() sends with HTTPS_SESSION=0: the full set-up and +HTTPTERM each time
+//   session     the first post sets the service up, later ones send only +HTTPDATA and +HTTPACTION
+//   changed     a changed parameter is sent again on its own
+//   server      a 4xx/5xx from the server leaves the session open
+//   dropped     the modem lost the service behind the library's back: one re-init, the post succeeds
+//   modem error a 7xx (socket, DNS, TLS) is retried once after a re-init, then reported as -1
+//   idle        after https_session_set_max_idle() the next post starts cold
+//   end         https_end() closes the session
+// The times printed come from the fake modem's model (FAKE_AT_MS, FAKE_ACTION_MS), not the modem.
+// Exits non-zero on any failure.
+
+#include "FakeModem.h"
+
+static int fails = 0;
+#define CHECK(c)                                    \
+  do                                                \
+  {                                                 \
+    if (!(c))                                       \
+    {                                               \
+      printf("  FAIL line %d: %s\n", __LINE__, #c); \
+      fails++;                                      \
+    }                                               \
+  } while (0)
+
+static const char URL[] = "https://example.com/telemetry";
+static const char BODY[] = "[{\"seq\":1}]";
+
+// postData() with HTTPS_SESSION=0
+static int legacyPost(FakeModem &m)
+{
+  m.https_begin();
+  if (!m.https_set_url(URL))
+    return -1;
+  m.https_add_header("Content-Type", "application/json");
+  m.https_add_header("Accept", "application/json");
+  const int status = m.https_post(BODY, strlen(BODY));
+  m.https_end();
+  return status;
+}
+
+static int sessionPost(FakeModem &m)
+{
+  m.https_session_set_url(URL);
+  m.https_session_set_content_type("application/json");
+  m.https_session_set_accept_type("application/json");
+  return m.https_session_post(BODY, strlen(BODY));
+}
+
+static void testPerPost(size_t &legacyCommands)
+{
+  FakeModem m;
+  for (int i = 0; i < 3; i++)
+  {
+    m.clearLog();
+    const uint32_t start = millis();
+    CHECK(legacyPost(m) == 200);
+    legacyCommands = m.sent.size();
+    printf("per post:    post %d, %zu AT commands, %u ms\n", i, m.sent.size(), (unsigned)(millis() - start));
+  }
+  CHECK(m.count("+HTTPINIT") == 1);
+  CHECK(m.body == BODY);
+}
+
+static void testSession(size_t legacyCommands)
+{
+  FakeModem m;
+  for (int i = 0; i < 5; i++)
+  {
+    m.clearLog();
+    CHECK(sessionPost(m) == 200);
+    printf("session:     post %d, %zu AT commands, %u ms\n", i, m.sent.size(), (unsigned)m.https_session_stats().lastMs);
+    if (i == 0)
+    {
+      CHECK(m.count("+HTTPINIT") == 1);
+    }
+    else
+    {
+      CHECK(m.sent.size() == 2);
+      CHECK(m.count("+HTTPDATA") == 1 && m.count("+HTTPACTION") == 1);
+    }
+  }
+  CHECK(m.body == BODY);
+  CHECK(2 < legacyCommands);
+  const HttpsSessionStats &s = m.https_session_stats();
+  CHECK(s.inits == 1 && s.stale == 0 && s.coldRequests == 1 && s.warmRequests == 4);
+
+  // changed: only the accept type goes out again
+  m.clearLog();
+  m.https_session_set_accept_type("*/*");
+  CHECK(m.https_session_post(BODY, strlen(BODY)) == 200);
+  printf("changed:     %zu AT commands\n", m.sent.size());
+  CHECK(m.sent.size() == 3 && m.count("+HTTPPARA=\"ACCEPT") == 1);
+  CHECK(m.https_session_stats().paramsSent == 1);
+}
+
+static void testServerError()
+{
+  FakeModem m;
+  sessionPost(m);
+  m.status = 503;
+  m.clearLog();
+  CHECK(sessionPost(m) == 503);
+  m.status = 200;
+  m.clearLog();
+  CHECK(sessionPost(m) == 200);
+  printf("server:      a 503 and the next post sends %zu AT commands\n", m.sent.size());
+  CHECK(m.sent.size() == 2);
+  CHECK(m.https_session_stats().stale == 0);
+}
+
+static void testDropped()
+{
+  FakeModem m;
+  sessionPost(m);
+  m.serviceUp = false; // e.g. the network detached while idle
+  m.clearLog();
+  CHECK(sessionPost(m) == 200);
+  printf("dropped:     %d re-init, %zu AT commands\n", m.count("+HTTPINIT"), m.sent.size());
+  CHECK(m.count("+HTTPINIT") == 1);
+  CHECK(m.https_session_stats().stale == 1);
+  m.clearLog();
+  CHECK(sessionPost(m) == 200);
+  CHECK(m.sent.size() == 2);
+}
+
+static void testModemError()
+{
+  FakeModem m;
+  sessionPost(m);
+  m.status = 715; // TLS handshake failed, retried once after a re-init
+  m.clearLog();
+  CHECK(sessionPost(m) == 715);
+  CHECK(m.count("+HTTPINIT") == 1 && m.count("+HTTPACTION") == 2);
+  m.status = 200;
+  m.clearLog();
+  CHECK(sessionPost(m) == 200);
+  printf("modem error: a 715 is retried once, the next post re-inits (%d)\n", m.count("+HTTPINIT"));
+  CHECK(m.count("+HTTPINIT") == 1); // the failed session was closed
+  CHECK(m.https_session_stats().stale == 1);
+}
+
+static void testIdle()
+{
+  FakeModem m;
+  m.https_session_set_max_idle(60000);
+  sessionPost(m);
+  g_hostMillis += 30000;
+  m.clearLog();
+  sessionPost(m);
+  CHECK(m.count("+HTTPINIT") == 0);
+  g_hostMillis += 120000;
+  m.clearLog();
+  sessionPost(m);
+  printf("idle:        after 120 s, %d re-init\n", m.count("+HTTPINIT"));
+  CHECK(m.count("+HTTPINIT") == 1);
+  CHECK(m.https_session_stats().stale == 0);
+}
+
+static void testEnd()
+{
+  FakeModem m;
+  sessionPost(m);
+  m.https_end();
+  CHECK(!m.serviceUp);
+  m.clearLog();
+  CHECK(sessionPost(m) == 200);
+  CHECK(m.count("+HTTPINIT") == 1);
+  const HttpsSessionStats &s = m.https_session_stats();
+  printf("end:         %u set-ups, cold %u ms avg, warm %u ms avg\n", (unsigned)s.inits,
+         (unsigned)(s.coldMs / s.coldRequests), (unsigned)(s.warmRequests ? s.warmMs / s.warmRequests : 0));
+}
+
+int main()
+{
+  size_t legacyCommands = 0;
+  testPerPost(legacyCommands);
+  testSession(legacyCommands);
+  testServerError();
+  testDropped();
+  testModemError();
+  testIdle();
+  testEnd();
+  printf(fails ? "FAILED\n" : "https session OK\n");
+  return fails;
+}
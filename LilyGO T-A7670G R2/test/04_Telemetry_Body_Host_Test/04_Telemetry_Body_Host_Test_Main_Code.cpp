@@ -0,0 +1,189 @@
+// Host test of the telemetry bodies: the contract, the byte budget and that nothing allocates
+//
+// Runs on the PC, not the ESP32. Compiles the real HttpsBuiltlnPost/telemetry_body.h (with
+// json_writer.h, cbor_writer.h and time_service.h) and TinyGsmHttpsComm.h's buffer readers against
+// ../host_stubs. malloc and operator new are replaced by counting versions, so this one is built
+// without the sanitizers. Build and run from this folder:
+//   g++ -O1 -g -std=gnu++17 -Wall -Wno-unused-function -I../host_stubs -I../../HttpsBuiltlnPost -I../../lib/TinyGSM/src 04_Telemetry_Body_Host_Test_Main_Code.cpp ../host_stubs/HostStubs.cpp -o body_test
+//   ./body_test
+//   python3 ../../HttpsBuiltlnPost/stub_endpoint.py --check body_single.json body.json body.cbor
+//
+// Cases:
+//   bodies    a single record and a 12-record batch in JSON and CBOR, written to the files above
+//             for the server contract check; records from before the clock was set and from an
+//             earlier boot get the right "at"
+//   budget    a batch that does not fit the buffer stops after the last whole record
+//   no heap   100 000 batches of 1 to 12 records in each format (HTTPS JSON, CBOR, MQTT JSON)
+//             make 0 allocations
+//   reply     https_body() reads a reply sent in several +HTTPREAD chunks into a fixed buffer and
+//             cuts one that does not fit, https_header() cuts long headers
+// Exits non-zero on any failure.
+
+#include <stdlib.h>
+#include <new>
+
+static bool counting = false;
+static long allocations = 0;
+
+extern "C" void *__libc_malloc(size_t size);
+extern "C" void *malloc(size_t size)
+{
+  if (counting)
+    allocations++;
+  return __libc_malloc(size);
+}
+void *operator new(size_t size)
+{
+  void *p = malloc(size); // counted there
+  if (!p)
+    throw std::bad_alloc();
+  return p;
+}
+__attribute__((noinline)) void operator delete(void *p) noexcept { free(p); }
+__attribute__((noinline)) void operator delete(void *p, size_t) noexcept { free(p); }
+
+#define UPLINK_BATCHING 1 // Off in the sketch until the server takes arrays; the batch bodies are tested
+#include "telemetry_body.h"
+#include "FakeModem.h"
+
+static int fails = 0;
+#define CHECK(c)                                    \
+  do                                                \
+  {                                                 \
+    if (!(c))                                       \
+    {                                               \
+      printf("  FAIL line %d: %s\n", __LINE__, #c); \
+      fails++;                                      \
+    }                                               \
+  } while (0)
+
+static char body[UPLINK_BATCH_MAX_BYTES + 1];
+
+static void save(const char *path, const void *data, size_t length)
+{
+  FILE *f = fopen(path, "wb");
+  CHECK(f != nullptr);
+  if (f)
+  {
+    fwrite(data, 1, length, f);
+    fclose(f);
+  }
+}
+
+static void makeSnapshots(TelemetrySnapshot *snaps)
+{
+  for (int i = 0; i < UPLINK_BATCH_MAX; i++)
+  {
+    TelemetrySnapshot &s = snaps[i];
+    memset(&s, 0, sizeof(s));
+    s.seq = i + 1;
+    s.boot = uplinkBoot;
+    s.sampledMs = millis() - (UPLINK_BATCH_MAX - i) * 15000;
+    s.lat = 1.2962018f + i * 1e-5f;
+    s.lng = 103.776899f;
+    s.accuracy = 7;
+    s.soc = 87 - i % 3;
+    s.chg = i % 2;
+    strcpy(s.severity, i == 5 ? "Toppled" : "Safe");
+  }
+}
+
+static void testBodies(TelemetrySnapshot *snaps)
+{
+  JsonWriter json(body, sizeof(body));
+  CHECK(writeBatch(json, appendRecord, snaps, 1) == 1);
+  CHECK(strstr(json.c_str(), "\"at\":\"1970-01-01T00:00:00Z\"") != nullptr); // clock never set
+
+  // GPS sets the clock to 2025-10-24T07:22:34Z
+  CHECK(timeSync(1761290554000LL, timeMonotonicMs(), TIME_GPS));
+  snaps[0].utc = 1761290000;   // stamped when taken
+  snaps[1].boot = uplinkBoot + 1; // from an earlier boot, not stamped: sent with the send time
+  CHECK(writeBatch(json, appendRecord, snaps, 1) == 1);
+  CHECK(strstr(json.c_str(), "\"at\":\"2025-10-24T07:13:20Z\"") != nullptr);
+  // stub_endpoint.py takes a single record as a bare object
+  save("body_single.json", json.c_str() + 1, json.length() - 2);
+
+  CHECK(writeBatch(json, appendRecord, snaps, UPLINK_BATCH_MAX) == UPLINK_BATCH_MAX);
+  CHECK(json.ok() && json.c_str()[json.length() - 1] == ']');
+  CHECK(strstr(json.c_str(), "\"at\":\"2025-10-24T07:22:34Z\"") != nullptr);
+  CHECK(strstr(json.c_str(), "\"at\":\"2025-10-24T07:20:04Z\"") != nullptr); // 2.5 min old
+  save("body.json", json.c_str(), json.length());
+  const size_t jsonBytes = json.length();
+
+  CborWriter cbor((uint8_t *)body, sizeof(body));
+  CHECK(writeBatch(cbor, appendCborRecord, snaps, UPLINK_BATCH_MAX) == UPLINK_BATCH_MAX);
+  CHECK(cbor.ok());
+  save("body.cbor", cbor.data(), cbor.length());
+  printf("bodies: %u records, JSON %u bytes, CBOR %u bytes\n", UPLINK_BATCH_MAX, (unsigned)jsonBytes,
+         (unsigned)cbor.length());
+}
+
+static void testBudget(const TelemetrySnapshot *snaps)
+{
+  char small[600];
+  JsonWriter json(small, sizeof(small));
+  const uint8_t taken = writeBatch(json, appendRecord, snaps, UPLINK_BATCH_MAX);
+  printf("budget: %u of %u records fit %u bytes\n", taken, UPLINK_BATCH_MAX, (unsigned)sizeof(small));
+  CHECK(taken > 0 && taken < UPLINK_BATCH_MAX);
+  CHECK(json.ok() && json.c_str()[json.length() - 1] == ']');
+}
+
+static void testNoHeap(const TelemetrySnapshot *snaps)
+{
+  JsonWriter json(body, sizeof(body));
+  CborWriter cbor((uint8_t *)body, sizeof(body));
+  uint32_t records = 0;
+  counting = true;
+  free(malloc(16)); // the counter itself works
+  delete new int;
+  CHECK(allocations == 2);
+  allocations = 0;
+  for (uint32_t k = 0; k < 100000; k++)
+  {
+    const uint8_t count = 1 + k % UPLINK_BATCH_MAX;
+    records += writeBatch(json, appendRecord, snaps, count);
+    records += writeBatch(cbor, appendCborRecord, snaps, count);
+    records += writeBatch(json, appendMqttRecord, snaps, count);
+    g_hostMillis += 15000;
+  }
+  counting = false;
+  printf("no heap: 3 x 100000 batches, %u records, %ld allocations\n", records, allocations);
+  CHECK(allocations == 0);
+}
+
+static void testReply()
+{
+  FakeModem m;
+  char reply[512];
+  m.replyBody = "{\"accepted\":12,\"note\":\"split over several +HTTPREAD chunks\"}";
+  m.readChunk = 10;
+  int n = m.https_body((uint8_t *)reply, sizeof(reply) - 1);
+  reply[n] = '\0';
+  CHECK(m.replyBody == reply);
+
+  m.replyBody = std::string(700, 'x');
+  m.readChunk = 512;
+  n = m.https_body((uint8_t *)reply, sizeof(reply) - 1);
+  CHECK(n == (int)sizeof(reply) - 1);
+
+  m.replyHeader = "HTTP/1.1 200 OK\r\n" + std::string(600, 'h') + "\r\n";
+  n = m.https_header(reply, sizeof(reply));
+  CHECK(n == (int)sizeof(reply) - 1 && strlen(reply) == sizeof(reply) - 1);
+  m.clearLog();
+  CHECK(m.https_body((uint8_t *)reply, 4) == 4); // the cut header was read to its end
+  printf("reply: chunked, cut body and cut header read into %u bytes\n", (unsigned)sizeof(reply));
+}
+
+int main()
+{
+  g_hostMillis = 400000;
+  uplinkBoot = 7;
+  TelemetrySnapshot snaps[UPLINK_BATCH_MAX];
+  makeSnapshots(snaps);
+  testBodies(snaps);
+  testBudget(snaps);
+  testNoHeap(snaps);
+  testReply();
+  printf(fails ? "FAILED\n" : "body OK\n");
+  return fails;
+}
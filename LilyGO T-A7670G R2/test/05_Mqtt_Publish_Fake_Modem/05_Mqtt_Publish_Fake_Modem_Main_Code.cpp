@@ -0,0 +1,262 @@
+// Host test of TinyGsmMqttA76xx: a message that arrives while mqtt_publish() waits for its PUBACK
+//
+// Runs on the PC, not the ESP32. Compiles the real lib/TinyGSM/src/TinyGsmMqttA76xx.h against a
+// scripted modem below, which answers the MQTT commands of a publish and can put +CMQTTRX URCs
+// (a message from the broker) ahead of the +CMQTTPUB result. Build and run from this folder:
+//   g++ -O1 -g -std=gnu++17 -Wall -Wno-sign-compare -fsanitize=address,undefined -I../host_stubs -I../../lib/TinyGSM/src 05_Mqtt_Publish_Fake_Modem_Main_Code.cpp ../host_stubs/HostStubs.cpp -o mqtt_publish
+//   ./mqtt_publish
+//
+// Cases:
+//   handle      mqtt_handle() delivers a message, as loop() gets it
+//   publish     a publish without anything in between returns the broker's result
+//   during      a message that arrives before the PUBACK goes to the callback and the publish
+//               still returns true; before, waitResponse() skipped over it and it was lost
+//   two         two messages before the PUBACK both reach the callback
+//   no puback   no +CMQTTPUB within the timeout: false, after waiting about the timeout, not more
+// Exits non-zero on any failure.
+
+#include <Arduino.h>
+#include <TinyGsmMqttA76xx.h>
+
+#include <sstream>
+#include <string>
+#include <vector>
+
+static int fails = 0;
+#define CHECK(c)                                    \
+  do                                                \
+  {                                                 \
+    if (!(c))                                       \
+    {                                               \
+      printf("  FAIL line %d: %s\n", __LINE__, #c); \
+      fails++;                                      \
+    }                                               \
+  } while (0)
+
+class FakeMqttModem : public TinyGsmMqttA76xx<FakeMqttModem, 2>
+{
+public:
+  // What the modem sends back, read by the library
+  struct FakeStream
+  {
+    std::string rx;
+    size_t pos = 0;
+    FakeMqttModem *modem = nullptr;
+
+    void write(const char *data) { modem->received(data, strlen(data)); }
+    void write(const uint8_t *data, size_t size) { modem->received((const char *)data, size); }
+    void println() {}
+    int read() { return pos < rx.size() ? (uint8_t)rx[pos++] : -1; }
+    size_t readBytes(uint8_t *buf, size_t n)
+    {
+      size_t i = 0;
+      while (i < n && pos < rx.size())
+        buf[i++] = rx[pos++];
+      return i;
+    }
+  };
+
+  FakeStream stream;
+  std::string published;      // Payload of the latest +CMQTTPAYLOAD
+  std::string beforePuback;   // URCs sent after +CMQTTPUB's OK, ahead of its result
+  bool puback = true;         // Send +CMQTTPUB: 0,0 at all
+
+  FakeMqttModem() { stream.modem = this; }
+  ~FakeMqttModem() { free(buffer); } // mqtt_begin()'s, mqtt_end() would free it
+
+  template <typename... A>
+  void sendAT(A... parts)
+  {
+    std::ostringstream cmd;
+    (cmd << ... << parts);
+    answer(cmd.str());
+  }
+
+  // The index of whichever of r1..r3 comes first, 0 after the timeout. Like the modem's
+  // waitResponse(), everything before the match is read and dropped.
+  int8_t waitResponse(uint32_t timeout_ms, const char *r1 = "OK", const char *r2 = "ERROR",
+                      const char *r3 = nullptr)
+  {
+    const char *r[] = {r1, r2, r3};
+    size_t best = std::string::npos, bestEnd = 0;
+    int8_t index = 0;
+    for (int8_t i = 0; i < 3; i++)
+    {
+      if (!r[i])
+        continue;
+      const size_t at = stream.rx.find(r[i], stream.pos);
+      if (at != std::string::npos && (best == std::string::npos || at + strlen(r[i]) < bestEnd))
+      {
+        best = at;
+        bestEnd = at + strlen(r[i]);
+        index = i + 1;
+      }
+    }
+    if (!index)
+    {
+      stream.pos = stream.rx.size();
+      g_hostMillis += timeout_ms;
+      return 0;
+    }
+    stream.pos = bestEnd;
+    return index;
+  }
+  int8_t waitResponse() { return waitResponse(1000); }
+
+  void streamSkipUntil(char c)
+  {
+    int got;
+    while ((got = stream.read()) >= 0 && got != c)
+    {
+    }
+  }
+
+  int streamGetIntBefore(char last)
+  {
+    std::string digits;
+    int c;
+    while ((c = stream.read()) >= 0 && c != last)
+      digits += (char)c;
+    return digits.empty() ? -9999 : atoi(digits.c_str());
+  }
+
+  // A message from the broker as the A76xx reports it
+  static std::string message(const std::string &topic, const std::string &payload)
+  {
+    return "\r\n+CMQTTRXSTART: 0," + std::to_string(topic.size()) + "," + std::to_string(payload.size()) +
+           "\r\n+CMQTTRXTOPIC: 0," + std::to_string(topic.size()) + "\r\n" + topic +
+           "\r\n+CMQTTRXPAYLOAD: 0," + std::to_string(payload.size()) + "\r\n" + payload +
+           "\r\n+CMQTTRXEND: 0\r\n";
+  }
+
+private:
+  enum { IDLE, TOPIC, PAYLOAD } input_ = IDLE;
+
+  void reply(const std::string &text) { stream.rx += "\r\n" + text + "\r\n"; }
+
+  void answer(const std::string &cmd)
+  {
+    if (cmd == "+CMQTTSTART")
+    {
+      reply("OK");
+      reply("+CMQTTSTART: 0");
+    }
+    else if (cmd.rfind("+CMQTTTOPIC=", 0) == 0)
+    {
+      input_ = TOPIC;
+      stream.rx += "\r\n>";
+    }
+    else if (cmd.rfind("+CMQTTPAYLOAD=", 0) == 0)
+    {
+      input_ = PAYLOAD;
+      stream.rx += "\r\n>";
+    }
+    else if (cmd.rfind("+CMQTTPUB=", 0) == 0)
+    {
+      reply("OK");
+      stream.rx += beforePuback;
+      g_hostMillis += 300; // the broker's PUBACK
+      if (puback)
+        reply("+CMQTTPUB: 0,0");
+    }
+    else
+    {
+      reply("OK");
+    }
+  }
+
+  void received(const char *data, size_t size)
+  {
+    if (input_ == PAYLOAD)
+      published.assign(data, size);
+    if (input_ != IDLE)
+      reply("OK");
+    input_ = IDLE;
+  }
+};
+
+static std::vector<std::string> g_got;
+
+static void onMessage(const char *topic, const uint8_t *payload, uint32_t len)
+{
+  g_got.push_back(std::string(topic) + " " + std::string((const char *)payload, len));
+}
+
+static bool publish(FakeMqttModem &m, const char *payload)
+{
+  return m.mqtt_publish(0, "pma/0001/telemetry", (const uint8_t *)payload, strlen(payload), 1, 60);
+}
+
+static void start(FakeMqttModem &m)
+{
+  m.mqtt_set_callback(onMessage);
+  CHECK(m.mqtt_begin(false));
+  g_got.clear();
+}
+
+static void testHandle()
+{
+  FakeMqttModem m;
+  start(m);
+  m.stream.rx += FakeMqttModem::message("pma/0001/cmd", "report");
+  CHECK(m.mqtt_handle(10));
+  printf("handle:    %zu message(s), %s\n", g_got.size(), g_got.empty() ? "-" : g_got[0].c_str());
+  CHECK(g_got.size() == 1 && g_got[0] == "pma/0001/cmd report");
+}
+
+static void testPublish()
+{
+  FakeMqttModem m;
+  start(m);
+  CHECK(publish(m, "[{\"soc\":87}]"));
+  CHECK(m.published == "[{\"soc\":87}]");
+  CHECK(g_got.empty());
+  printf("publish:   acknowledged, %zu message(s)\n", g_got.size());
+}
+
+static void testDuring()
+{
+  FakeMqttModem m;
+  start(m);
+  m.beforePuback = FakeMqttModem::message("pma/0001/cmd", "interval 30");
+  CHECK(publish(m, "[{\"soc\":86}]"));
+  printf("during:    acknowledged, %zu message(s), %s\n", g_got.size(), g_got.empty() ? "-" : g_got[0].c_str());
+  CHECK(g_got.size() == 1 && g_got[0] == "pma/0001/cmd interval 30");
+  CHECK(!m.mqtt_handle(10)); // nothing left over for loop()
+}
+
+static void testTwo()
+{
+  FakeMqttModem m;
+  start(m);
+  m.beforePuback = FakeMqttModem::message("pma/0001/cmd", "report") +
+                   FakeMqttModem::message("pma/0001/cmd", "interval auto");
+  CHECK(publish(m, "[{\"soc\":85}]"));
+  printf("two:       acknowledged, %zu message(s)\n", g_got.size());
+  CHECK(g_got.size() == 2 && g_got[1] == "pma/0001/cmd interval auto");
+}
+
+static void testNoPuback()
+{
+  FakeMqttModem m;
+  start(m);
+  m.puback = false;
+  m.beforePuback = FakeMqttModem::message("pma/0001/cmd", "report");
+  const uint32_t t0 = millis();
+  CHECK(!publish(m, "[{\"soc\":84}]"));
+  const uint32_t waited = millis() - t0;
+  printf("no puback: false after %u ms, %zu message(s)\n", (unsigned)waited, g_got.size());
+  CHECK(g_got.size() == 1);
+  CHECK(waited >= 60000 && waited <= 60000 + 1000);
+}
+
+int main()
+{
+  testHandle();
+  testPublish();
+  testDuring();
+  testTwo();
+  testNoPuback();
+  printf(fails ? "FAILED\n" : "mqtt publish OK\n");
+  return fails;
+}
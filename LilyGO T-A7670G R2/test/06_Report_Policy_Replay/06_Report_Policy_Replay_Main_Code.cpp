@@ -0,0 +1,271 @@
+// Host replay of the report policy: modes, hysteresis and the interval each mode gives
+//
+// Runs on the PC, not the ESP32. Compiles the real HttpsBuiltlnPost/report_policy.h against
+// ../host_stubs and plays a scripted day through it the way loop() does: the policy once a second,
+// a snapshot whenever millis() - postTime > postInterval, loop() itself every 100 ms.
+// Build and run from this folder:
+//   g++ -O1 -g -std=gnu++17 -Wall -Wno-unused-function -fsanitize=address,undefined -I../host_stubs -I../../HttpsBuiltlnPost 06_Report_Policy_Replay_Main_Code.cpp ../host_stubs/HostStubs.cpp -o report_policy
+//   ./report_policy
+//
+// Steps, in this order (the policy's state is static, so it is one timeline):
+//   parked    still for 6 h: snapshots per 10 min against the old fixed 15 s
+//   moving    3 km/h is taken on the first reading, 15 s interval
+//   stop      a 20 s stop does not fall back to parked, GPS noise of 1.5 to 3 km/h does not either
+//   park      still for REPORT_PARK_DWELL_MS turns moving into parked, not a second earlier
+//   noise     1.5 to 3 km/h and a gyro between the still and moving rates do not wake a parked PMA
+//   fast      8 km/h is taken at once; 6 to 8 km/h keeps it, below 6 km/h for REPORT_FAST_DWELL_MS leaves it
+//   energy    low battery or a link that is down hold fast mode to REPORT_MOVING_MS, an event does not
+//   event     a raised event gives REPORT_EVENT_MS for REPORT_EVENT_HOLD_MS, then the motion mode again
+//   charging  on the charger a bump is not a ride, and moving turns parked after the dwell
+//   pinned    the MQTT "interval" command overrides every mode until "interval auto"
+// Exits non-zero on any failure.
+
+#include "report_policy.h"
+
+static int fails = 0;
+#define CHECK(c)                                    \
+  do                                                \
+  {                                                 \
+    if (!(c))                                       \
+    {                                               \
+      printf("  FAIL line %d: %s\n", __LINE__, #c); \
+      fails++;                                      \
+    }                                               \
+  } while (0)
+
+constexpr uint32_t LOOP_MS = 100;
+constexpr uint32_t POLICY_MS = 1000; // loop()'s policyTime check
+
+// loop()'s side of the policy
+struct Replay
+{
+  ReportInputs in = {false, 0.0f, 0.0f, 80, false, false, 0};
+  uint32_t now = 1000;
+  uint32_t policyTime = 0;
+  uint32_t postTime = 0;
+  uint32_t postInterval = 15000;
+  uint32_t snapshots = 0;
+  uint32_t fixedMs = 0; // > 0: ignore the policy, as before it existed
+
+  void run(uint32_t ms)
+  {
+    for (const uint32_t end = now + ms; now < end; now += LOOP_MS)
+    {
+      g_hostMillis = now;
+      if (now - policyTime >= POLICY_MS)
+      {
+        policyTime = now;
+        const uint32_t interval = reportPolicyUpdate(in, now);
+        postInterval = fixedMs ? fixedMs : interval;
+      }
+      if (now - postTime > postInterval)
+      {
+        snapshots++;
+        postTime = now;
+      }
+    }
+  }
+
+  // Runs until the policy reports mode, up to limitMs. Returns how long that took.
+  uint32_t until(ReportMode mode, uint32_t limitMs)
+  {
+    const uint32_t start = now;
+    while (reportStats.mode != mode && now - start < limitMs)
+    {
+      run(LOOP_MS);
+    }
+    return now - start;
+  }
+
+  void speed(float kmph)
+  {
+    in.speedValid = true;
+    in.speedKmph = kmph;
+  }
+};
+
+static bool is(ReportMode mode, uint32_t intervalMs)
+{
+  return reportStats.mode == mode && reportStats.intervalMs == intervalMs;
+}
+
+static void testParked(Replay &r)
+{
+  r.run(600000); // settle
+  CHECK(is(REPORT_PARKED, REPORT_PARKED_MS));
+  uint32_t before = r.snapshots;
+  r.run(6 * 3600000UL);
+  const float policy = (r.snapshots - before) / 36.0f;
+
+  Replay fixed; // Separate loop() state, same (parked) readings, the policy's answer ignored
+  fixed.now = r.now;
+  fixed.fixedMs = 15000;
+  before = fixed.snapshots;
+  const ReportStats saved = reportStats;
+  fixed.run(6 * 3600000UL);
+  reportStats = saved;
+  const float old = (fixed.snapshots - before) / 36.0f;
+  printf("parked:   %.1f snapshots per 10 min (%.1f at the old fixed 15 s)\n", policy, old);
+  CHECK(policy >= 1.95f && policy <= 2.0f);
+  CHECK(old >= 39.0f && old <= 40.0f);
+}
+
+static void testMoving(Replay &r)
+{
+  const uint32_t snaps = r.snapshots;
+  r.speed(REPORT_MOVING_KMPH);
+  const uint32_t took = r.until(REPORT_MOVING, 60000);
+  printf("moving:   after %u ms, every %u s\n", (unsigned)took, (unsigned)(reportStats.intervalMs / 1000));
+  CHECK(took <= POLICY_MS);
+  CHECK(is(REPORT_MOVING, REPORT_MOVING_MS));
+  r.run(LOOP_MS);
+  CHECK(r.snapshots == snaps + 1); // the parked interval is long past: one goes at once
+  r.speed(4.0f);
+  r.run(120000);
+  CHECK(is(REPORT_MOVING, REPORT_MOVING_MS));
+}
+
+static void testStop(Replay &r)
+{
+  const uint32_t changes = reportStats.changes;
+  r.speed(0.0f);
+  r.run(20000);
+  r.speed(4.0f);
+  r.run(10000);
+  r.speed(2.0f); // between still and moving: GPS wander while walking it slowly
+  r.run(600000);
+  printf("stop:     %u mode changes over a 20 s stop and 10 min at 2 km/h\n",
+         (unsigned)(reportStats.changes - changes));
+  CHECK(reportStats.changes == changes);
+  CHECK(is(REPORT_MOVING, REPORT_MOVING_MS));
+}
+
+static void testPark(Replay &r)
+{
+  r.speed(0.5f);
+  r.run(REPORT_PARK_DWELL_MS - 2 * POLICY_MS);
+  CHECK(reportStats.mode == REPORT_MOVING);
+  const uint32_t took = REPORT_PARK_DWELL_MS - 2 * POLICY_MS + r.until(REPORT_PARKED, 60000);
+  printf("park:     parked after %u s still\n", (unsigned)(took / 1000));
+  CHECK(took >= REPORT_PARK_DWELL_MS && took <= REPORT_PARK_DWELL_MS + 2 * POLICY_MS);
+  CHECK(is(REPORT_PARKED, REPORT_PARKED_MS));
+}
+
+static void testNoise(Replay &r)
+{
+  const uint32_t changes = reportStats.changes;
+  r.speed(2.5f);
+  r.run(300000);
+  r.speed(0.0f);
+  r.in.gyroDps = (REPORT_GYRO_STILL_DPS + REPORT_GYRO_MOVING_DPS) / 2;
+  r.run(300000);
+  r.in.speedValid = false; // no fix: only the gyro counts
+  r.run(60000);
+  r.in.gyroDps = 0.0f;
+  printf("noise:    %u mode changes over 10 min of GPS and gyro noise while parked\n",
+         (unsigned)(reportStats.changes - changes));
+  CHECK(reportStats.changes == changes);
+  CHECK(is(REPORT_PARKED, REPORT_PARKED_MS));
+}
+
+static void testFast(Replay &r)
+{
+  r.speed(REPORT_FAST_KMPH);
+  const uint32_t took = r.until(REPORT_FAST, 60000);
+  CHECK(took <= POLICY_MS); // straight from parked
+  CHECK(is(REPORT_FAST, REPORT_FAST_MS));
+  r.speed(7.0f);
+  r.run(120000);
+  CHECK(is(REPORT_FAST, REPORT_FAST_MS));
+  r.speed(5.0f);
+  r.run(REPORT_FAST_DWELL_MS - 2 * POLICY_MS);
+  CHECK(reportStats.mode == REPORT_FAST);
+  const uint32_t left = REPORT_FAST_DWELL_MS - 2 * POLICY_MS + r.until(REPORT_MOVING, 60000);
+  printf("fast:     after %u ms, left %u s below %.0f km/h\n", (unsigned)took, (unsigned)(left / 1000),
+         REPORT_FAST_EXIT_KMPH);
+  CHECK(left >= REPORT_FAST_DWELL_MS && left <= REPORT_FAST_DWELL_MS + 2 * POLICY_MS);
+  CHECK(is(REPORT_MOVING, REPORT_MOVING_MS));
+}
+
+static void testEnergy(Replay &r)
+{
+  r.speed(12.0f);
+  r.in.soc = REPORT_LOW_SOC;
+  r.run(5000);
+  CHECK(is(REPORT_FAST, REPORT_MOVING_MS));
+  r.in.soc = 80;
+  r.in.linkDown = true;
+  r.run(5000);
+  CHECK(is(REPORT_FAST, REPORT_MOVING_MS));
+  r.in.events++;
+  r.run(POLICY_MS);
+  CHECK(is(REPORT_EVENT, REPORT_EVENT_MS)); // an event is never held back
+  r.run(REPORT_EVENT_HOLD_MS);
+  r.in.linkDown = false;
+  r.run(5000);
+  printf("energy:   fast mode every %u s with a low battery or the link down\n", (unsigned)(REPORT_MOVING_MS / 1000));
+  CHECK(is(REPORT_FAST, REPORT_FAST_MS));
+}
+
+static void testEvent(Replay &r)
+{
+  r.speed(0.0f);
+  r.until(REPORT_PARKED, REPORT_PARK_DWELL_MS + 60000);
+  CHECK(is(REPORT_PARKED, REPORT_PARKED_MS));
+  r.in.events++;
+  r.run(POLICY_MS);
+  CHECK(is(REPORT_EVENT, REPORT_EVENT_MS));
+  const uint32_t held = POLICY_MS + r.until(REPORT_PARKED, REPORT_EVENT_HOLD_MS + 60000);
+  printf("event:    every %u s for %u s, then parked again\n", (unsigned)(REPORT_EVENT_MS / 1000),
+         (unsigned)(held / 1000));
+  CHECK(held >= REPORT_EVENT_HOLD_MS && held <= REPORT_EVENT_HOLD_MS + 2 * POLICY_MS);
+  CHECK(is(REPORT_PARKED, REPORT_PARKED_MS));
+}
+
+static void testCharging(Replay &r)
+{
+  r.in.charging = true;
+  r.in.gyroDps = 30.0f; // plugging it in
+  r.run(60000);
+  CHECK(is(REPORT_PARKED, REPORT_PARKED_MS));
+  r.in.charging = false;
+  r.speed(4.0f);
+  r.in.gyroDps = 0.0f;
+  r.run(5000);
+  CHECK(reportStats.mode == REPORT_MOVING);
+  r.in.charging = true; // stopped at a charger with the GPS still wandering
+  const uint32_t took = r.until(REPORT_PARKED, REPORT_PARK_DWELL_MS + 60000);
+  printf("charging: parked %u s after it was plugged in\n", (unsigned)(took / 1000));
+  CHECK(took >= REPORT_PARK_DWELL_MS && took <= REPORT_PARK_DWELL_MS + 2 * POLICY_MS);
+}
+
+static void testPinned(Replay &r)
+{
+  reportPolicyPin(30000);
+  r.speed(REPORT_FAST_KMPH);
+  r.in.charging = false;
+  r.run(5000);
+  CHECK(reportStats.mode == REPORT_FAST && reportStats.pinned && reportStats.intervalMs == 30000);
+  reportPolicyPin(0);
+  r.run(POLICY_MS);
+  printf("pinned:   every 30 s while pinned, %u s after \"interval auto\"\n",
+         (unsigned)(reportStats.intervalMs / 1000));
+  CHECK(is(REPORT_FAST, REPORT_FAST_MS) && !reportStats.pinned);
+}
+
+int main()
+{
+  Replay r;
+  testParked(r);
+  testMoving(r);
+  testStop(r);
+  testPark(r);
+  testNoise(r);
+  testFast(r);
+  testEnergy(r);
+  testEvent(r);
+  testCharging(r);
+  testPinned(r);
+  printf(fails ? "FAILED\n" : "report policy OK\n");
+  return fails;
+}
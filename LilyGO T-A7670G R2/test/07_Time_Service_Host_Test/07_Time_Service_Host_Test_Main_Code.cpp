@@ -0,0 +1,182 @@
+// Host test of time_service.h: civil date arithmetic, +CCLK? parsing and which source sets the clock
+//
+// Runs on the PC, not the ESP32. Compiles the real HttpsBuiltlnPost/time_service.h against
+// ../host_stubs (esp_timer runs on g_hostMillis) and checks it against the C library's gmtime.
+// Build and run from this folder:
+//   g++ -O1 -g -std=gnu++17 -Wall -Wno-unused-function -fsanitize=address,undefined -I../host_stubs -I../../HttpsBuiltlnPost 07_Time_Service_Host_Test_Main_Code.cpp ../host_stubs/HostStubs.cpp -o time_service
+//   ./time_service
+//
+// Cases:
+//   civil    every day from 1900-01-01 to 2200-12-31: timeDaysFromCivil() and timeCivilFromDays()
+//            agree with gmtime and are each other's inverse
+//   iso      timeFormatIso() against strftime for times across the whole uint32_t range
+//   cclk     +CCLK? answers with positive, negative and zero zones, ones that cross midnight and a
+//            year end, quoted and with a leading space; malformed ones are refused
+//   sources  an unset clock is ignored, NITZ sets the clock, GPS takes over and NITZ is ignored
+//            from then on, GPS re-syncs only after TIME_RESYNC_MS and records the step
+// Exits non-zero on any failure.
+
+#include "time_service.h"
+
+#include <time.h>
+#include <string>
+
+static int fails = 0;
+#define CHECK(c)                                    \
+  do                                                \
+  {                                                 \
+    if (!(c))                                       \
+    {                                               \
+      printf("  FAIL line %d: %s\n", __LINE__, #c); \
+      fails++;                                      \
+    }                                               \
+  } while (0)
+
+static void testCivil()
+{
+  const int64_t first = timeDaysFromCivil(1900, 1, 1);
+  const int64_t last = timeDaysFromCivil(2200, 12, 31);
+  uint32_t bad = 0;
+  for (int64_t days = first; days <= last; days++)
+  {
+    const time_t t = (time_t)(days * 86400);
+    struct tm tm;
+    gmtime_r(&t, &tm);
+    int year, month, day;
+    timeCivilFromDays(days, year, month, day);
+    if (year != tm.tm_year + 1900 || month != tm.tm_mon + 1 || day != tm.tm_mday ||
+        timeDaysFromCivil(year, month, day) != days)
+    {
+      if (bad++ < 5)
+        printf("  day %lld: %04d-%02d-%02d, gmtime %04d-%02d-%02d\n", (long long)days, year, month, day,
+               tm.tm_year + 1900, tm.tm_mon + 1, tm.tm_mday);
+    }
+  }
+  printf("civil:   %lld days from 1900 to 2200, %u disagree with gmtime\n", (long long)(last - first + 1), bad);
+  CHECK(bad == 0);
+  CHECK(first == -25567 && timeDaysFromCivil(1970, 1, 1) == 0);
+  CHECK(timeEpoch(2025, 10, 24, 7, 22, 34) == 1761290554);
+}
+
+static void testIso()
+{
+  uint32_t bad = 0, n = 0;
+  for (uint64_t utc = 0; utc <= UINT32_MAX; utc += 86399 * 7 + 3601, n++)
+  {
+    char mine[24], theirs[24];
+    timeFormatIso(mine, sizeof(mine), (uint32_t)utc);
+    const time_t t = (time_t)utc;
+    struct tm tm;
+    gmtime_r(&t, &tm);
+    strftime(theirs, sizeof(theirs), "%Y-%m-%dT%H:%M:%SZ", &tm);
+    if (strcmp(mine, theirs) != 0 && bad++ < 5)
+      printf("  %llu: %s, strftime %s\n", (unsigned long long)utc, mine, theirs);
+  }
+  char last[24];
+  timeFormatIso(last, sizeof(last), UINT32_MAX);
+  printf("iso:     %u times up to %s, %u disagree with strftime\n", n, last, bad);
+  CHECK(bad == 0);
+  CHECK(strcmp(last, "2106-02-07T06:28:15Z") == 0);
+}
+
+// The UTC time a +CCLK? answer parses to, "" if it is refused
+static std::string cclk(const char *answer)
+{
+  int64_t utc;
+  if (!timeParseCclk(answer, utc))
+    return "";
+  char iso[24];
+  timeFormatIso(iso, sizeof(iso), (uint32_t)utc);
+  return iso;
+}
+
+static void testCclk()
+{
+  struct Case
+  {
+    const char *answer;
+    const char *utc;
+  };
+  static const Case cases[] = {
+      {"25/10/24,15:22:34+32", "2025-10-24T07:22:34Z"},    // UTC+8
+      {" \"25/10/24,15:22:34+32\"", "2025-10-24T07:22:34Z"}, // as the modem sends it
+      {"25/10/24,07:22:34+00", "2025-10-24T07:22:34Z"},
+      {"25/10/24,07:22:34-00", "2025-10-24T07:22:34Z"},
+      {"25/10/24,20:00:00-20", "2025-10-25T01:00:00Z"},    // UTC-5, crosses midnight forwards
+      {"25/10/24,02:00:00+36", "2025-10-23T17:00:00Z"},    // UTC+9, crosses midnight backwards
+      {"25/01/01,03:30:00+39", "2024-12-31T17:45:00Z"},    // UTC+9:45, crosses a year end
+      {"24/12/31,23:59:59-48", "2025-01-01T11:59:59Z"},    // UTC-12
+      {"24/02/29,12:00:00+22", "2024-02-29T06:30:00Z"},    // UTC+5:30, leap day
+      {"25/10/24,15:22:34", ""},                            // no zone
+      {"25/10/24,15:22:34*32", ""},
+      {"25/13/24,15:22:34+32", ""},
+      {"25/00/24,15:22:34+32", ""},
+      {"25/10/32,15:22:34+32", ""},
+      {"25/10/24,24:00:00+32", ""},
+      {"25/10/24,15:60:00+32", ""},
+      {"25/1O/24,15:22:34+32", ""},
+      {"", ""},
+  };
+  uint32_t bad = 0;
+  for (const Case &c : cases)
+  {
+    const std::string got = cclk(c.answer);
+    if (got != c.utc)
+    {
+      printf("  \"%s\": \"%s\", want \"%s\"\n", c.answer, got.c_str(), c.utc);
+      bad++;
+    }
+  }
+  printf("cclk:    %zu answers, %u wrong\n", sizeof(cases) / sizeof(cases[0]), bad);
+  CHECK(bad == 0);
+}
+
+static void testSources()
+{
+  g_hostMillis = 5000;
+  CHECK(!timeSynced() && timeNowUtcMs() == 0 && timeUtcAt(millis()) == 0);
+
+  // A modem without NITZ counts from 2000: parsed, but not taken
+  int64_t utc;
+  CHECK(timeParseCclk("00/01/01,00:00:12+00", utc));
+  CHECK(!timeSync(utc * 1000, timeMonotonicMs(), TIME_NITZ));
+  CHECK(!timeSynced());
+
+  CHECK(timeParseCclk("25/10/24,15:22:34+32", utc));
+  CHECK(timeSync(utc * 1000, timeMonotonicMs(), TIME_NITZ));
+  CHECK(timeGetStats().source == TIME_NITZ && timeUtcAt(millis()) == 1761290554);
+  g_hostMillis += 10000;
+  CHECK(timeUtcAt(millis()) == 1761290564 && timeUtcAt(millis() - 4000) == 1761290560);
+
+  // GPS takes over, 1.5 s away from what the network said
+  const int64_t gpsMs = 1761290564000LL + 1500;
+  CHECK(timeSync(gpsMs, timeMonotonicMs(), TIME_GPS));
+  TimeStats s = timeGetStats();
+  CHECK(s.source == TIME_GPS && s.lastStepMs == 1500 && s.syncs == 2);
+  CHECK(timeNowUtcMs() == gpsMs);
+
+  // NITZ after GPS is ignored, however far off
+  g_hostMillis += 60000;
+  CHECK(!timeSync(gpsMs, timeMonotonicMs(), TIME_NITZ));
+  CHECK(timeNowUtcMs() == gpsMs + 60000);
+
+  // GPS re-syncs once an hour, taking out the drift
+  CHECK(!timeSync(gpsMs + 60000 + 20, timeMonotonicMs(), TIME_GPS));
+  g_hostMillis += TIME_RESYNC_MS;
+  const int64_t later = gpsMs + 60000 + TIME_RESYNC_MS;
+  CHECK(timeSync(later - 35, timeMonotonicMs(), TIME_GPS));
+  s = timeGetStats();
+  CHECK(s.lastStepMs == -35 && s.syncs == 3 && timeNowUtcMs() == later - 35);
+  printf("sources: NITZ set the clock, GPS moved it %+d ms then %+d ms an hour later, %u syncs\n", 1500,
+         (int)s.lastStepMs, (unsigned)s.syncs);
+}
+
+int main()
+{
+  testCivil();
+  testIso();
+  testCclk();
+  testSources();
+  printf(fails ? "FAILED\n" : "time OK\n");
+  return fails;
+}
@@ -0,0 +1,64 @@
+// Host stand-in for the parts of the Arduino core the uplink headers use. Time is whatever the
+// host program puts in g_hostMillis; Serial output is dropped.
+#pragma once
+
+#include <math.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include <algorithm>
+#include <string>
+
+using std::max;
+using std::min;
+
+#define constrain(amt, low, high) ((amt) < (low) ? (low) : ((amt) > (high) ? (high) : (amt)))
+
+// The ESP32 core's log macros; only errors are printed
+template <typename... A>
+inline void hostLogNone(const char *, A...) {}
+#define log_e(fmt, ...) printf("[E] " fmt "\n", ##__VA_ARGS__)
+#define log_d(...) hostLogNone(__VA_ARGS__)
+#define log_v(...) hostLogNone(__VA_ARGS__)
+#define ESP_LOGE(tag, fmt, ...) printf("[E][%s] " fmt "\n", tag, ##__VA_ARGS__)
+
+extern uint32_t g_hostMillis;
+uint32_t millis();
+void delay(uint32_t ms); // advances g_hostMillis
+uint32_t esp_random();
+
+struct HostSerial
+{
+  template <typename... A>
+  int printf(const char *, A...) { return 0; }
+  template <typename T>
+  void print(T) {}
+  template <typename T>
+  void println(T) {}
+  void println() {}
+  int available() { return 0; }
+  int read() { return -1; }
+  size_t write(uint8_t) { return 1; }
+  size_t write(const uint8_t *, size_t n) { return n; }
+};
+extern HostSerial Serial;
+
+class String : public std::string
+{
+public:
+  String() {}
+  String(const char *s) : std::string(s) {}
+  String(const std::string &s) : std::string(s) {}
+  String(float v, int decimals)
+  {
+    char buf[32];
+    snprintf(buf, sizeof(buf), "%.*f", decimals, v);
+    assign(buf);
+  }
+  int indexOf(const char *s) const
+  {
+    const size_t at = find(s);
+    return at == npos ? -1 : (int)at;
+  }
+};
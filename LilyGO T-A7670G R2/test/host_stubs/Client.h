@@ -0,0 +1,6 @@
+// TinyGsmCommon.h includes it; the host tests use no sockets
+#pragma once
+
+class Client
+{
+};
@@ -0,0 +1,46 @@
+// Host stand-in for LittleFS: paths map to files under g_hostFsRoot on the PC.
+#pragma once
+
+#include <Arduino.h>
+#include <stdio.h>
+#include <filesystem>
+#include <string>
+
+#define FILE_READ "r"
+#define FILE_WRITE "w"
+#define FILE_APPEND "a"
+
+extern std::string g_hostFsRoot;
+
+class File
+{
+public:
+  explicit operator bool() const { return f_ != nullptr || isDir_; }
+  size_t size();
+  bool seek(size_t pos) { return fseek(f_, (long)pos, SEEK_SET) == 0; }
+  size_t read(uint8_t *buf, size_t n) { return fread(buf, 1, n, f_); }
+  size_t write(const uint8_t *buf, size_t n) { return fwrite(buf, 1, n, f_); }
+  void close();
+  const char *name() const { return name_.c_str(); }
+  bool isDirectory() const { return isDir_; }
+  File openNextFile();
+
+private:
+  friend class HostFS;
+  FILE *f_ = nullptr;
+  bool isDir_ = false;
+  std::string path_; // as the firmware sees it, e.g. /tq/00000001
+  std::string name_;
+  std::filesystem::directory_iterator it_;
+};
+
+class HostFS
+{
+public:
+  bool begin(bool formatOnFail);
+  bool exists(const char *path);
+  bool mkdir(const char *path);
+  bool remove(const char *path);
+  File open(const char *path, const char *mode = FILE_READ);
+};
+extern HostFS LittleFS;
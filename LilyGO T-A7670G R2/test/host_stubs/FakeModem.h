@@ -0,0 +1,185 @@
+// Scripted stand-in for the A76xx behind TinyGsmHttpsComm. Answers the HTTP service commands the
+// way the AT manual describes them (+HTTPINIT fails when the service is already up, every other
+// +HTTP command fails when it is not), serves replyBody / replyHeader through +HTTPREAD and
+// +HTTPHEAD, logs what was sent and advances g_hostMillis by a fixed time per command. The times
+// are a model, not a measurement of the modem.
+#pragma once
+
+#include <Arduino.h>
+#include <TinyGsmHttpsComm.h>
+
+#include <stdlib.h>
+#include <sstream>
+#include <vector>
+
+#define FAKE_AT_MS     20   // One AT command and its OK
+#define FAKE_ACTION_MS 2000 // +HTTPACTION: connect, TLS handshake, request and response
+
+class FakeModem : public TinyGsmHttpsComm<FakeModem, ASR_A7670X>
+{
+public:
+  // What the modem sends back, read by the library
+  struct FakeStream
+  {
+    std::string rx;
+    size_t pos = 0;
+    FakeModem *modem = nullptr;
+
+    void write(const char *data, size_t size) { modem->received(data, size); }
+    void flush() {}
+    int read() { return pos < rx.size() ? (uint8_t)rx[pos++] : -1; }
+    size_t readBytes(uint8_t *buf, size_t n)
+    {
+      size_t i = 0;
+      while (i < n && pos < rx.size())
+        buf[i++] = rx[pos++];
+      return i;
+    }
+    size_t readBytes(char *buf, size_t n) { return readBytes((uint8_t *)buf, n); }
+  };
+
+  FakeStream stream;
+  std::vector<std::string> sent; // AT commands, without the "AT"
+  std::string body;              // Payload of the latest +HTTPDATA
+  bool serviceUp = false;        // +HTTPINIT done and not dropped since
+  int status = 200;              // +HTTPACTION result, 7xx for modem side errors
+  std::string replyBody = "{\"accepted\":1}"; // Served by +HTTPREAD
+  std::string replyHeader = "HTTP/1.1 200 OK\r\nContent-Type: application/json\r\n"; // and +HTTPHEAD
+  size_t readChunk = 512;        // +HTTPREAD sends the body in chunks of this size
+
+  FakeModem() { stream.modem = this; }
+
+  template <typename... A>
+  void sendAT(A... parts)
+  {
+    std::ostringstream cmd;
+    (cmd << ... << parts);
+    sent.push_back(cmd.str());
+    g_hostMillis += FAKE_AT_MS;
+    answer(sent.back());
+  }
+
+  // 1 for r1, 2 for ERROR, 0 after the timeout
+  int8_t waitResponse(uint32_t timeout_ms = 1000, const char *r1 = "OK")
+  {
+    const size_t ok = stream.rx.find(r1, stream.pos);
+    const size_t error = stream.rx.find("ERROR", stream.pos);
+    if (ok == std::string::npos && error == std::string::npos)
+    {
+      stream.pos = stream.rx.size();
+      g_hostMillis += timeout_ms;
+      return 0;
+    }
+    if (ok < error)
+    {
+      stream.pos = ok + strlen(r1);
+      return 1;
+    }
+    stream.pos = error + 5;
+    return 2;
+  }
+
+  int streamGetIntBefore(char last)
+  {
+    std::string digits;
+    int c;
+    while ((c = stream.read()) >= 0 && c != last)
+      digits += (char)c;
+    return digits.empty() ? -9999 : atoi(digits.c_str());
+  }
+
+  long long streamGetLongLongBefore(char last) { return streamGetIntBefore(last); }
+
+  // Commands sent since clearLog() that start with prefix
+  int count(const char *prefix) const
+  {
+    int n = 0;
+    for (const std::string &cmd : sent)
+      n += cmd.rfind(prefix, 0) == 0;
+    return n;
+  }
+
+  void clearLog()
+  {
+    sent.clear();
+    stream.rx.clear();
+    stream.pos = 0;
+  }
+
+private:
+  bool downloading_ = false;
+
+  void reply(const std::string &text) { stream.rx += "\r\n" + text + "\r\n"; }
+
+  void answer(const std::string &cmd)
+  {
+    if (cmd == "+HTTPINIT")
+    {
+      reply(serviceUp ? "ERROR" : "OK");
+      serviceUp = true;
+    }
+    else if (cmd == "+HTTPTERM")
+    {
+      reply(serviceUp ? "OK" : "ERROR");
+      serviceUp = false;
+    }
+    else if (cmd.rfind("+HTTPDATA=", 0) == 0)
+    {
+      downloading_ = serviceUp;
+      reply(serviceUp ? "DOWNLOAD" : "ERROR");
+    }
+    else if (cmd.rfind("+HTTPACTION=", 0) == 0)
+    {
+      if (!serviceUp)
+      {
+        reply("ERROR");
+        return;
+      }
+      g_hostMillis += FAKE_ACTION_MS;
+      reply("OK");
+      reply("+HTTPACTION: " + cmd.substr(12) + "," + std::to_string(status) + "," +
+            std::to_string(status >= 700 ? 0 : replyBody.size()));
+    }
+    else if (cmd == "+HTTPREAD?")
+    {
+      reply("+HTTPREAD: LEN," + std::to_string(replyBody.size()));
+      reply("OK");
+    }
+    else if (cmd.rfind("+HTTPREAD=", 0) == 0) // +HTTPREAD=<offset>,<length>
+    {
+      const size_t offset = atoi(cmd.c_str() + 10);
+      const size_t end = std::min(replyBody.size(), offset + atoi(cmd.c_str() + cmd.find(',') + 1));
+      reply("OK");
+      for (size_t at = offset; at < end; at += readChunk)
+      {
+        const std::string chunk = replyBody.substr(at, std::min(readChunk, end - at));
+        stream.rx += "\r\n+HTTPREAD: " + std::to_string(chunk.size()) + "\r\n" + chunk;
+      }
+      reply("+HTTPREAD: 0");
+    }
+    else if (cmd == "+HTTPHEAD")
+    {
+      reply("+HTTPHEAD: " + std::to_string(replyHeader.size()));
+      stream.rx += replyHeader;
+      reply("OK");
+    }
+    else if (cmd.rfind("+HTTP", 0) == 0)
+    {
+      reply(serviceUp ? "OK" : "ERROR");
+    }
+    else
+    {
+      reply("OK"); // +CSSLCFG
+    }
+  }
+
+  void received(const char *data, size_t size)
+  {
+    if (downloading_)
+    {
+      body.assign(data, size);
+      downloading_ = false;
+      reply("OK");
+    }
+  }
+};
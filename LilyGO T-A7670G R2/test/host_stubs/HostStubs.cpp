@@ -0,0 +1,88 @@
+// Definitions behind the host stand-in headers that do not depend on the program: clock, Serial
+// and a LittleFS on a directory of the PC.
+#include <Arduino.h>
+#include <FS.h>
+#include <esp_timer.h>
+
+uint32_t g_hostMillis = 0;
+uint32_t millis() { return g_hostMillis; }
+void delay(uint32_t ms) { g_hostMillis += ms; }
+uint32_t esp_random() { return 0x1234abcd; }
+int64_t esp_timer_get_time() { return (int64_t)g_hostMillis * 1000; }
+
+HostSerial Serial;
+HostFS LittleFS;
+std::string g_hostFsRoot = "host_fs";
+
+namespace fs = std::filesystem;
+
+static std::string hostPath(const std::string &path) { return g_hostFsRoot + path; }
+
+size_t File::size()
+{
+  const long pos = ftell(f_);
+  fseek(f_, 0, SEEK_END);
+  const long end = ftell(f_);
+  fseek(f_, pos, SEEK_SET);
+  return (size_t)end;
+}
+
+void File::close()
+{
+  if (f_)
+    fclose(f_);
+  f_ = nullptr;
+  isDir_ = false;
+}
+
+File File::openNextFile()
+{
+  File next;
+  if (!isDir_ || it_ == fs::directory_iterator())
+    return next;
+  const fs::directory_entry entry = *it_++;
+  next.name_ = entry.path().filename().string();
+  next.path_ = path_ + "/" + next.name_;
+  if (entry.is_directory())
+    next.isDir_ = true;
+  else
+    next.f_ = fopen(entry.path().string().c_str(), "rb");
+  return next;
+}
+
+bool HostFS::begin(bool)
+{
+  std::error_code ec;
+  fs::create_directories(g_hostFsRoot, ec);
+  return !ec;
+}
+
+bool HostFS::exists(const char *path) { return fs::exists(hostPath(path)); }
+
+bool HostFS::mkdir(const char *path)
+{
+  std::error_code ec;
+  return fs::create_directory(hostPath(path), ec);
+}
+
+bool HostFS::remove(const char *path)
+{
+  std::error_code ec;
+  return fs::remove(hostPath(path), ec);
+}
+
+File HostFS::open(const char *path, const char *mode)
+{
+  File file;
+  file.path_ = path;
+  const std::string full = hostPath(path);
+  if (fs::is_directory(full))
+  {
+    file.isDir_ = true;
+    file.it_ = fs::directory_iterator(full);
+    return file;
+  }
+  const std::string m = std::string(mode) + "b";
+  file.f_ = fopen(full.c_str(), m.c_str());
+  return file;
+}
@@ -0,0 +1,228 @@
+// Compressed RGB565 images for the ESA and a streaming decoder that feeds them to the panel a few
+// lines at a time, so an icon never has to exist uncompressed in flash or RAM.
+//
+// Images are produced by pack_icons.py (next to this file) from the raw arrays in assets/. Formats:
+//   PACKED_RAW565  uncompressed, used when compression would not pay off
+//   PACKED_LZ565   pixel-domain LZ77 with a 256-pixel window. Control byte c, then:
+//                    c < 0x40   literal: c + 1 pixels follow, 2 bytes each
+//                    c < 0x80   fill: the next pixel (2 bytes) repeated (c & 0x3F) + 2 times
+//                    otherwise  copy: (c & 0x7F) + 2 pixels from d + 1 pixels back, d is the next byte
+//                  Tokens may span rows; "same as the row above" is a copy with distance = width.
+// Pixels are stored, and come out of the decoder, in panel byte order (high byte first in memory),
+// so decoded lines go to SPI/DMA as they are, with no swap pass.
+// The decoder keeps a 256-pixel history (512 B) and its position, nothing else.
+// Nothing in main.cpp draws the three icons in assets/icons.c yet, so the linker drops them and
+// their packed size (4728 bytes against 8448 raw) is no saving in the firmware until one is used.
+// Header-only and Arduino-free so it builds for both the ESP32 and host programs.
+
+#ifndef PACKED_IMAGE_H
+#define PACKED_IMAGE_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+#ifndef PACKED_IMAGE_LINE_PIXELS
+#define PACKED_IMAGE_LINE_PIXELS 256 // pixels per line buffer in drawPackedImage() (two of them)
+#endif
+
+enum PackedFormat : uint8_t
+{
+  PACKED_RAW565 = 0,
+  PACKED_LZ565 = 1
+};
+
+struct PackedImage
+{
+  uint16_t width;
+  uint16_t height;
+  uint8_t format;      // PackedFormat
+  uint32_t size;       // bytes in data
+  const uint8_t *data;
+};
+
+class PackedImageDecoder
+{
+public:
+  explicit PackedImageDecoder(const PackedImage &img) : img_(img) { rewind(); }
+
+  void rewind()
+  {
+    src_ = img_.data;
+    end_ = img_.data + img_.size;
+    left_ = (uint32_t)img_.width * img_.height;
+    mode_ = MODE_NONE;
+    count_ = 0;
+    pos_ = 0;
+  }
+
+  uint32_t remaining() const { return left_; }
+
+  // Decodes the next n pixels into out. Returns how many were written: fewer than n only at the end
+  // of the image, or if the data is truncated / malformed (then the rest of the image is lost).
+  uint32_t read(uint16_t *out, uint32_t n)
+  {
+    if (n > left_)
+      n = left_;
+    if (img_.format == PACKED_RAW565)
+      return readRaw(out, n);
+
+    uint32_t done = 0;
+    while (done < n)
+    {
+      if (count_ == 0 && !nextToken())
+      {
+        left_ = 0;
+        break;
+      }
+      uint32_t k = n - done;
+      if (k > count_)
+        k = count_;
+      switch (mode_)
+      {
+      case MODE_LITERAL:
+        for (uint32_t i = 0; i < k; ++i, src_ += 2)
+          emit(out[done + i], pixelAt(src_));
+        break;
+      case MODE_FILL:
+        for (uint32_t i = 0; i < k; ++i)
+          emit(out[done + i], fill_);
+        break;
+      default: // MODE_COPY; uint8_t wrap-around makes pos_ - dist_ index the ring
+        for (uint32_t i = 0; i < k; ++i)
+          emit(out[done + i], hist_[(uint8_t)(pos_ - dist_)]);
+        break;
+      }
+      count_ -= k;
+      done += k;
+      left_ -= k;
+    }
+    return done;
+  }
+
+private:
+  enum Mode : uint8_t
+  {
+    MODE_NONE,
+    MODE_LITERAL,
+    MODE_FILL,
+    MODE_COPY
+  };
+
+  // Memory order in, memory order out: the bytes land in the buffer exactly as stored
+  static uint16_t pixelAt(const uint8_t *p)
+  {
+    uint16_t v;
+    memcpy(&v, p, 2);
+    return v;
+  }
+
+  void emit(uint16_t &dst, uint16_t v)
+  {
+    dst = v;
+    hist_[pos_++] = v;
+  }
+
+  uint32_t readRaw(uint16_t *out, uint32_t n)
+  {
+    const uint32_t avail = (uint32_t)(end_ - src_) / 2;
+    if (n > avail)
+      n = avail;
+    memcpy(out, src_, n * 2);
+    src_ += n * 2;
+    left_ = (n == avail) ? 0 : left_ - n;
+    return n;
+  }
+
+  bool nextToken()
+  {
+    if (src_ >= end_)
+      return false;
+    const uint8_t c = *src_++;
+    if (c < 0x40)
+    {
+      mode_ = MODE_LITERAL;
+      count_ = c + 1u;
+      return end_ - src_ >= (ptrdiff_t)(count_ * 2);
+    }
+    if (c < 0x80)
+    {
+      if (end_ - src_ < 2)
+        return false;
+      mode_ = MODE_FILL;
+      count_ = (c & 0x3Fu) + 2u;
+      fill_ = pixelAt(src_);
+      src_ += 2;
+      return true;
+    }
+    if (src_ >= end_)
+      return false;
+    mode_ = MODE_COPY;
+    count_ = (c & 0x7Fu) + 2u;
+    dist_ = (uint16_t)(*src_++ + 1u);
+    return true;
+  }
+
+  const PackedImage img_;
+  const uint8_t *src_;
+  const uint8_t *end_;
+  uint32_t left_;
+  uint16_t hist_[256];
+  uint8_t pos_;
+  Mode mode_;
+  uint16_t count_;
+  uint16_t fill_;
+  uint16_t dist_;
+};
+
+// Draws img at (x, y) through two line buffers: while one block is going out by DMA the next is
+// decoded into the other. TFT is TFT_eSPI (a template so this header does not depend on it).
+// With dma false, or if DMA was never initialised (initDMA()), it uses pushImage() instead.
+// Swap bytes is turned off for the call because the pixels are already in panel order.
+// No clipping on the DMA path: the image must lie inside the screen.
+template <class TFT>
+void drawPackedImage(TFT &tft, int32_t x, int32_t y, const PackedImage &img, bool dma = true)
+{
+  static uint16_t lineBuf[2][PACKED_IMAGE_LINE_PIXELS]; // .bss is internal RAM, so DMA-capable
+  const uint32_t w = img.width, h = img.height;
+  if (w == 0 || h == 0)
+    return;
+
+  dma = dma && tft.DMA_Enabled;
+  PackedImageDecoder dec(img);
+  const bool swap = tft.getSwapBytes();
+  tft.setSwapBytes(false);
+  tft.startWrite();
+
+  uint8_t k = 0;
+  const uint32_t rowsPerBlock = PACKED_IMAGE_LINE_PIXELS / w;
+  bool ok = true;
+  for (uint32_t row = 0; ok && row < h;)
+  {
+    // Whole rows per block when they fit, otherwise slices of one row
+    const uint32_t rows = rowsPerBlock ? ((h - row < rowsPerBlock) ? h - row : rowsPerBlock) : 1;
+    for (uint32_t col = 0; ok && col < w;)
+    {
+      const uint32_t cols = rowsPerBlock ? w : ((w - col < PACKED_IMAGE_LINE_PIXELS) ? w - col : PACKED_IMAGE_LINE_PIXELS);
+      // pushImageDMA() waits for the previous block before starting, so the buffer decoded into
+      // here (the one sent two blocks ago) is free again
+      ok = dec.read(lineBuf[k], cols * rows) == cols * rows;
+      if (!ok)
+        break;
+      if (dma)
+        tft.pushImageDMA(x + col, y + row, cols, rows, (const uint16_t *)lineBuf[k]);
+      else
+        tft.pushImage(x + col, y + row, cols, rows, lineBuf[k]);
+      k ^= 1;
+      col += cols;
+    }
+    row += rows;
+  }
+
+  if (dma)
+    tft.dmaWait();
+  tft.endWrite();
+  tft.setSwapBytes(swap);
+}
+
+#endif
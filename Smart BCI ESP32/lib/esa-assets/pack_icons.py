@@ -0,0 +1,221 @@
+#!/usr/bin/env python3
+"""Asset converter for the ESA: turn raw RGB565 icon arrays into the compressed PackedImage format
+that PackedImage.h decodes (format description there).
+
+Input is C source with arrays like the ones image2cpp / LCD Image Converter write,
+  const unsigned char PROGMEM name[3200] = { 0xFF, 0xFF, ... };
+two bytes per pixel, low byte first; or PNG files (needs Pillow), named after the file.
+Square images get their size from the array length; others need --size name=WxH.
+
+Output is a .cpp with one `const PackedImage name` per image and a .h declaring them. Every image is
+decoded again and compared before anything is written. Run by hand:
+  python pack_icons.py ../../assets/icons.c -o ../../src/icons_packed
+or from PlatformIO before each build (only regenerates when an input is newer than the output):
+  extra_scripts = pre:lib/esa-assets/pack_icons.py
+"""
+
+import argparse
+import math
+import os
+import re
+
+WINDOW = 256       # history the decoder keeps, in pixels
+MAX_LITERAL = 64   # control byte 0x00..0x3F
+MAX_FILL = 65      # 0x40..0x7F, 2..65 pixels
+MAX_COPY = 129     # 0x80..0xFF, 2..129 pixels
+RAW565, LZ565 = 0, 1
+
+ARRAY_RE = re.compile(r"(?:const\s+)?unsigned\s+char\s+(?:PROGMEM\s+)?(\w+)\s*\[\s*(\d*)\s*\]\s*(?:PROGMEM\s*)?=\s*\{([^}]*)\}")
+
+
+def read_c_arrays(path):
+    """Returns [(name, pixels)] with pixels as RGB565 values."""
+    src = open(path, encoding="utf-8", errors="replace").read()
+    src = re.sub(r"/\*.*?\*/", "", src, flags=re.S)
+    src = re.sub(r"//[^\n]*", "", src)
+    images = []
+    for m in ARRAY_RE.finditer(src):
+        data = [int(tok, 0) for tok in re.findall(r"0[xX][0-9a-fA-F]+|\d+", m.group(3))]
+        if len(data) % 2:
+            raise ValueError("%s: %s has an odd number of bytes" % (path, m.group(1)))
+        images.append((m.group(1), [data[i] | (data[i + 1] << 8) for i in range(0, len(data), 2)]))
+    return images
+
+
+def read_png(path):
+    from PIL import Image  # only needed for PNG input
+
+    img = Image.open(path).convert("RGB")
+    w, h = img.size
+    pixels = [((r & 0xF8) << 8) | ((g & 0xFC) << 3) | (b >> 3) for r, g, b in img.getdata()]
+    name = re.sub(r"\W", "_", os.path.splitext(os.path.basename(path))[0])
+    return name, pixels, w, h
+
+
+def encode_lz(px):
+    """Greedy pixel LZ77: at each position take whichever of copy / fill / literal covers the most pixels."""
+    out = bytearray()
+    literal = []
+
+    def flush():
+        while literal:
+            chunk = literal[:MAX_LITERAL]
+            del literal[:MAX_LITERAL]
+            out.append(len(chunk) - 1)
+            for v in chunk:
+                out.extend((v >> 8, v & 0xFF))  # panel byte order
+
+    n = len(px)
+    i = 0
+    while i < n:
+        run = 1
+        while i + run < n and run < MAX_FILL and px[i + run] == px[i]:
+            run += 1
+        best_len, best_dist = 0, 0
+        for dist in range(1, min(WINDOW, i) + 1):
+            length = 0
+            while i + length < n and length < MAX_COPY and px[i + length - dist] == px[i + length]:
+                length += 1
+            if length > best_len:
+                best_len, best_dist = length, dist
+        if best_len >= 2 and best_len >= run:
+            flush()
+            out += bytes((0x80 | (best_len - 2), best_dist - 1))
+            i += best_len
+        elif run >= 2:
+            flush()
+            out += bytes((0x40 | (run - 2), px[i] >> 8, px[i] & 0xFF))
+            i += run
+        else:
+            literal.append(px[i])
+            i += 1
+    flush()
+    return bytes(out)
+
+
+def encode_raw(px):
+    return b"".join(bytes((v >> 8, v & 0xFF)) for v in px)
+
+
+def decode(fmt, data, count):
+    """Reference decoder, same rules as PackedImageDecoder. Returns pixels as RGB565 values."""
+    if fmt == RAW565:
+        return [(data[i] << 8) | data[i + 1] for i in range(0, len(data), 2)][:count]
+    px, i = [], 0
+    while i < len(data) and len(px) < count:
+        c = data[i]
+        i += 1
+        if c < 0x40:
+            for _ in range(c + 1):
+                px.append((data[i] << 8) | data[i + 1])
+                i += 2
+        elif c < 0x80:
+            px += [(data[i] << 8) | data[i + 1]] * ((c & 0x3F) + 2)
+            i += 2
+        else:
+            dist = data[i] + 1
+            i += 1
+            for _ in range((c & 0x7F) + 2):
+                px.append(px[-dist])
+    return px
+
+
+def pack(name, px, w, h):
+    if w * h != len(px):
+        raise ValueError("%s: %dx%d does not match %d pixels" % (name, w, h, len(px)))
+    lz = encode_lz(px)
+    fmt, data = (LZ565, lz) if len(lz) < 2 * len(px) else (RAW565, encode_raw(px))
+    if decode(fmt, data, len(px)) != px:
+        raise AssertionError("%s: round trip failed" % name)
+    return fmt, data
+
+
+def square_size(name, n, sizes):
+    if name in sizes:
+        return sizes[name]
+    side = int(math.isqrt(n)) if hasattr(math, "isqrt") else int(math.sqrt(n))
+    if side * side != n:
+        raise ValueError("%s: %d pixels is not square, give --size %s=WxH" % (name, n, name))
+    return side, side
+
+
+def write_outputs(base, images, sources):
+    names = ", ".join(os.path.basename(s) for s in sources)
+    stem = os.path.basename(base)
+    with open(base + ".h", "w", newline="\n") as hf:
+        hf.write("// Generated by lib/esa-assets/pack_icons.py from %s. Do not edit; rerun the script.\n\n" % names)
+        hf.write("#pragma once\n\n#include <PackedImage.h>\n\n")
+        for name, w, h, fmt, data in images:
+            hf.write("extern const PackedImage %s; // %dx%d\n" % (name, w, h))
+    with open(base + ".cpp", "w", newline="\n") as cf:
+        cf.write("// Generated by lib/esa-assets/pack_icons.py from %s. Do not edit; rerun the script.\n\n" % names)
+        cf.write('#include "%s.h"\n' % stem)
+        for name, w, h, fmt, data in images:
+            cf.write("\n// %s: %dx%d, %s, %d bytes (raw %d, %.0f%%)\n"
+                     % (name, w, h, "LZ565" if fmt == LZ565 else "RAW565", len(data), 2 * w * h, 100.0 * len(data) / (2 * w * h)))
+            cf.write("static const uint8_t %s_data[%d] = {\n" % (name, len(data)))
+            for i in range(0, len(data), 16):
+                cf.write("    " + ", ".join("0x%02X" % b for b in data[i:i + 16]) + ",\n")
+            cf.write("};\n")
+            cf.write("const PackedImage %s = {%d, %d, %s, sizeof(%s_data), %s_data};\n"
+                     % (name, w, h, "PACKED_LZ565" if fmt == LZ565 else "PACKED_RAW565", name, name))
+
+
+def run(inputs, base, sizes, quiet=False):
+    images = []
+    raw_total = packed_total = 0
+    for path in inputs:
+        if path.lower().endswith(".png"):
+            found = [read_png(path)]
+        else:
+            found = [(name, px) + square_size(name, len(px), sizes) for name, px in read_c_arrays(path)]
+        for name, px, w, h in found:
+            fmt, data = pack(name, px, w, h)
+            images.append((name, w, h, fmt, data))
+            raw_total += 2 * len(px)
+            packed_total += len(data)
+            if not quiet:
+                print("%-16s %3dx%-3d %5d -> %5d bytes" % (name, w, h, 2 * len(px), len(data)))
+    if not images:
+        raise ValueError("no images found in %s" % ", ".join(inputs))
+    write_outputs(base, images, inputs)
+    if not quiet:
+        print("total            %5d -> %5d bytes (%.0f%%)" % (raw_total, packed_total, 100.0 * packed_total / raw_total))
+
+
+def parse_size(text):
+    name, _, wh = text.partition("=")
+    w, _, h = wh.lower().partition("x")
+    return name, (int(w), int(h))
+
+
+def main():
+    ap = argparse.ArgumentParser(description=__doc__.split("\n\n")[0])
+    ap.add_argument("inputs", nargs="+", help="C files with RGB565 byte arrays, or PNG files")
+    ap.add_argument("-o", "--output", required=True, help="output path without extension (writes .h and .cpp)")
+    ap.add_argument("--size", action="append", type=parse_size, default=[], metavar="NAME=WxH")
+    args = ap.parse_args()
+    run(args.inputs, args.output, dict(args.size))
+
+
+def pio_pre_build(env):
+    """PlatformIO extra_scripts hook: regenerate src/icons_packed.* from assets/ when stale."""
+    project = env["PROJECT_DIR"]
+    assets = os.path.join(project, "assets")
+    inputs = sorted(os.path.join(assets, f) for f in os.listdir(assets) if f.endswith((".c", ".png")))
+    base = os.path.join(project, "src", "icons_packed")
+    newest = max(os.path.getmtime(p) for p in inputs)
+    if os.path.exists(base + ".cpp") and os.path.getmtime(base + ".cpp") >= newest:
+        return
+    print("pack_icons: regenerating %s.{h,cpp}" % base)
+    run(inputs, base, {}, quiet=True)
+
+
+if __name__ == "__main__":
+    main()
+else:
+    try:
+        Import("env")  # noqa: F821 - provided by SCons when PlatformIO runs this as an extra script
+        pio_pre_build(env)  # noqa: F821
+    except NameError:
+        pass  # imported as a module
@@ -0,0 +1,288 @@
+// Compact multi-window discharge-current history for the ESA's historical TTE.
+//
+// One 1 Hz sample stream feeds several sliding windows at once (e.g. 2 min, 15 min, 1 h) so
+// the TTE can blend short- and long-term draw. Samples are stored as int16 centi-amps in a
+// single arena shared by all windows; long windows keep one block-mean sample every few
+// seconds instead of every second, so the 1 h window costs the same RAM as the 15 min one.
+//
+// Each window also keeps a fixed-bin histogram of its samples, so order statistics come
+// straight off the bin counts instead of sorting a copy of the ring:
+//   push()        O(windows)
+//   valueAtRank() O(BINS)
+//   trimmedMean() O(BINS)
+//   mean()        O(1)
+// Header-only and Arduino-free so it builds for both the ESP32 and host programs.
+
+#ifndef CURRENT_HISTORY_H
+#define CURRENT_HISTORY_H
+
+#include <stdint.h>
+#include <math.h>
+
+struct HistWindowSpec
+{
+  uint16_t windowSec; // how far back the window reaches (in pushed 1 Hz samples)
+  uint8_t periodSec;  // one stored sample per periodSec pushes (block mean)
+};
+
+// Ring slots needed by a list of windows (usable in static_assert / array sizes)
+constexpr uint16_t histRingSlots(const HistWindowSpec *specs, uint8_t n)
+{
+  return n ? specs[0].windowSec / specs[0].periodSec + histRingSlots(specs + 1, n - 1) : 0;
+}
+
+// One sliding window over caller-provided int16 storage.
+// BINS   = number of histogram bins, bin b covers b * BIN_MA mA (values above the range land in the last bin)
+// BIN_MA = bin width in mA. 100 mA matches the Daly BMS current resolution, so no information is lost.
+template <uint16_t BINS, uint16_t BIN_MA = 100>
+class CurrentWindow
+{
+public:
+  static constexpr float BIN_WIDTH_A = BIN_MA / 1000.0f;
+  static constexpr float MAX_A = (BINS - 1) * BIN_WIDTH_A;
+
+  void begin(int16_t *ring, uint16_t cap, uint8_t periodSec)
+  {
+    ring_ = ring;
+    cap_ = cap;
+    period_ = periodSec ? periodSec : 1;
+    clear();
+  }
+
+  void clear()
+  {
+    for (uint16_t b = 0; b < BINS; ++b)
+      counts_[b] = 0;
+    count_ = 0;
+    head_ = 0;
+    sumCa_ = 0;
+    blockSumCa_ = 0;
+    blockN_ = 0;
+  }
+
+  // Feed one 1 Hz sample (A, magnitude). Stored as the mean of each block of periodSec samples.
+  void push(float amps)
+  {
+    blockSumCa_ += toCentiAmps(amps);
+    if (++blockN_ < period_)
+      return;
+    const int16_t cA = (int16_t)((blockSumCa_ + period_ / 2) / period_);
+    blockSumCa_ = 0;
+    blockN_ = 0;
+    store(cA);
+  }
+
+  uint16_t count() const { return count_; }
+  uint16_t capacity() const { return cap_; }
+  uint8_t periodSec() const { return period_; }
+  uint32_t spanSec() const { return (uint32_t)count_ * period_; } // history actually covered
+
+  float mean() const { return count_ ? (float)sumCa_ / count_ / 100.0f : NAN; }
+
+  // Value (A) of the k-th smallest sample, 0-based. NAN if k is out of range.
+  float valueAtRank(uint16_t k) const
+  {
+    if (k >= count_)
+      return NAN;
+    uint16_t cum = 0;
+    for (uint16_t b = 0; b < BINS; ++b)
+    {
+      cum += counts_[b];
+      if (k < cum)
+        return b * BIN_WIDTH_A;
+    }
+    return MAX_A; // unreachable while counts_ and count_ agree
+  }
+
+  // Mean of the samples left after dropping the bottom lowFrac and the top highFrac.
+  // Same rank bounds as the old sorted-array version; a bin that straddles a bound only
+  // contributes the ranks that fall inside it. Falls back to the median if nothing is left.
+  float trimmedMean(float lowFrac, float highFrac) const
+  {
+    const uint16_t n = count_;
+    if (n == 0)
+      return NAN;
+    const uint16_t lo = (uint16_t)floorf(n * lowFrac);
+    const uint16_t hi = n - (uint16_t)ceilf(n * highFrac);
+    if (hi <= lo)
+      return valueAtRank(n / 2);
+
+    uint32_t weightedBins = 0; // sum of bin index over the kept ranks (exact, no float drift)
+    uint16_t cum = 0;          // ranks [cum, cum + counts_[b]) sit in bin b
+    for (uint16_t b = 0; b < BINS && cum < hi; ++b)
+    {
+      const uint16_t c = counts_[b];
+      if (c == 0)
+        continue;
+      const uint16_t from = (cum > lo) ? cum : lo;
+      const uint16_t to = (cum + c < hi) ? cum + c : hi;
+      if (to > from)
+        weightedBins += (uint32_t)b * (to - from);
+      cum += c;
+    }
+    return (float)weightedBins / (float)(hi - lo) * BIN_WIDTH_A;
+  }
+
+  // Stored samples oldest first into out (room for count()). Returns how many were written.
+  // The partial block not stored yet is not included.
+  uint16_t exportSamples(int16_t *out) const
+  {
+    uint16_t at = (count_ == cap_) ? head_ : 0; // oldest sample
+    for (uint16_t i = 0; i < count_; ++i)
+    {
+      out[i] = ring_[at];
+      at = (at + 1 == cap_) ? 0 : at + 1;
+    }
+    return count_;
+  }
+
+  // Replaces the contents with n samples, oldest first, as written by exportSamples().
+  // Only the newest capacity() are kept if there are more.
+  void importSamples(const int16_t *in, uint16_t n)
+  {
+    clear();
+    const uint16_t skip = (n > cap_) ? n - cap_ : 0;
+    for (uint16_t i = skip; i < n; ++i)
+      store(in[i] < 0 ? 0 : in[i]);
+  }
+
+private:
+  static int16_t toCentiAmps(float amps)
+  {
+    const long cA = lrintf(amps * 100.0f);
+    if (cA <= 0)
+      return 0;
+    if (cA >= INT16_MAX)
+      return INT16_MAX;
+    return (int16_t)cA;
+  }
+
+  static uint16_t binOf(int16_t cA)
+  {
+    const int32_t b = ((int32_t)cA * 10 + BIN_MA / 2) / BIN_MA; // cA * 10 = mA
+    return (b >= BINS) ? BINS - 1 : (uint16_t)b;
+  }
+
+  void store(int16_t cA)
+  {
+    if (cap_ == 0)
+      return; // window did not fit in the arena
+    if (count_ == cap_)
+    {
+      const int16_t old = ring_[head_]; // slot at head is the oldest sample
+      --counts_[binOf(old)];
+      sumCa_ -= old;
+    }
+    else
+    {
+      ++count_;
+    }
+    ring_[head_] = cA;
+    ++counts_[binOf(cA)];
+    sumCa_ += cA;
+    head_ = (head_ + 1 == cap_) ? 0 : head_ + 1;
+  }
+
+  int16_t *ring_ = nullptr;
+  uint16_t counts_[BINS];
+  uint16_t cap_ = 0;
+  uint16_t count_ = 0;
+  uint16_t head_ = 0;
+  int32_t sumCa_ = 0;      // running sum of stored samples, for mean()
+  int32_t blockSumCa_ = 0; // partial block not stored yet
+  uint8_t blockN_ = 0;
+  uint8_t period_ = 1;
+};
+
+// N windows fed from one sample stream, carved out of one SLOTS-long int16 arena.
+// SLOTS must be >= histRingSlots(specs, N); windows that do not fit are shortened (or left empty).
+template <uint8_t N, uint16_t SLOTS, uint16_t BINS, uint16_t BIN_MA = 100>
+class CurrentHistory
+{
+public:
+  typedef CurrentWindow<BINS, BIN_MA> Window;
+
+  explicit CurrentHistory(const HistWindowSpec (&specs)[N])
+  {
+    uint16_t used = 0;
+    for (uint8_t i = 0; i < N; ++i)
+    {
+      const uint8_t period = specs[i].periodSec ? specs[i].periodSec : 1;
+      uint16_t cap = specs[i].windowSec / period;
+      if (cap > SLOTS - used)
+        cap = SLOTS - used;
+      win_[i].begin(arena_ + used, cap, period);
+      used += cap;
+    }
+  }
+
+  void push(float amps)
+  {
+    for (uint8_t i = 0; i < N; ++i)
+      win_[i].push(amps);
+  }
+
+  void clear()
+  {
+    for (uint8_t i = 0; i < N; ++i)
+      win_[i].clear();
+  }
+
+  const Window &window(uint8_t i) const { return win_[i]; }
+  static constexpr uint8_t windows() { return N; }
+
+  // Learned state in a form that survives a reboot (e.g. an NVS blob): per window the sample
+  // count, then all samples window after window, oldest first. Only the first sampleCount()
+  // entries of samples[] are used, so callers can store just those.
+  struct Snapshot
+  {
+    uint16_t count[N];
+    int16_t samples[SLOTS];
+  };
+
+  uint16_t save(Snapshot &s) const
+  {
+    uint16_t used = 0;
+    for (uint8_t i = 0; i < N; ++i)
+    {
+      s.count[i] = win_[i].exportSamples(s.samples + used);
+      used += s.count[i];
+    }
+    return used;
+  }
+
+  // Returns false (and leaves the history empty) if the counts do not add up to at most SLOTS
+  bool load(const Snapshot &s)
+  {
+    clear();
+    uint32_t used = 0;
+    for (uint8_t i = 0; i < N; ++i)
+      used += s.count[i];
+    if (used > SLOTS)
+      return false;
+    used = 0;
+    for (uint8_t i = 0; i < N; ++i)
+    {
+      win_[i].importSamples(s.samples + used, s.count[i]);
+      used += s.count[i];
+    }
+    return true;
+  }
+
+  static uint16_t sampleCount(const Snapshot &s)
+  {
+    uint32_t n = 0;
+    for (uint8_t i = 0; i < N; ++i)
+      n += s.count[i];
+    return (n > SLOTS) ? SLOTS : (uint16_t)n;
+  }
+
+  // RAM used by one instance, for reporting
+  static constexpr uint32_t footprintBytes() { return sizeof(CurrentHistory); }
+
+private:
+  int16_t arena_[SLOTS];
+  Window win_[N];
+};
+
+#endif
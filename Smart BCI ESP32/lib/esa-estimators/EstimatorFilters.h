@@ -0,0 +1,419 @@
+// Instance-based signal-chain building blocks for the ESA's TTE/TTF estimators.
+//
+// Every filter owns its state (no function-local statics), takes the sample time explicitly
+// (so recorded traces can be replayed on the host), and is configured through template
+// parameters so a chain is fixed at compile time:
+//   MedianN<N>                       running median of the last N samples
+//   Ema<TAU_MS>                      dt-aware exponential moving average
+//   AttackReleaseEma<DOWN_MS, UP_MS> dt-aware EMA with a different tau for falling and rising input
+//   StepJumpEma<TAU_MS>              fast-attack EMA that jumps most of the way on a step up
+//   HysteresisDwell<DIR, DWELL_MS>   two-threshold state that only flips after DWELL_MS of agreement
+//   OnDelay<DELAY_MS>                boolean that turns on after DELAY_MS of true input, off at once
+//   RisingEdge                       true on the first update after the input goes true
+//   StepQuantizer                    rounds hours to a step of minutes set at run time (e.g. from a confidence)
+//   Pipeline<Stages...>              feeds each stage's output into the next
+// Numeric stages share the interface  float update(float x, uint32_t nowMs)  and  void reset().
+//
+// EMA alphas (1 - exp(-dt/tau)) come from one shared table of 1 - exp(-u) instead of calling
+// expf() on every sample. Header-only and Arduino-free so it builds for both the ESP32 and host.
+
+#ifndef ESTIMATOR_FILTERS_H
+#define ESTIMATOR_FILTERS_H
+
+#include <stdint.h>
+#include <math.h>
+
+// dt assumed for the very first update of a time-aware filter (ms), matches BMS_QUERY_MS on the ESA
+#ifndef ESA_FILTER_DEFAULT_DT_MS
+#define ESA_FILTER_DEFAULT_DT_MS 250
+#endif
+
+namespace esa
+{
+
+// ---- Tabulated alpha ----
+// 1 - exp(-u) for u = 0 .. 4 in steps of 1/32, linearly interpolated (max error ~1.2e-4).
+// Below u = 1/4 (the usual case, dt of a few hundred ms against taus of seconds) a short series
+// is used instead, since the table's absolute error would be a large fraction of a small alpha.
+// Beyond u = 4 (dt > 4 tau, e.g. after a long gap) falls back to expf().
+constexpr uint8_t ALPHA_TABLE_STEPS_PER_TAU = 32;
+constexpr uint16_t ALPHA_TABLE_LAST = 4 * ALPHA_TABLE_STEPS_PER_TAU;
+
+inline float alphaTable(uint16_t i)
+{
+  static const float t[ALPHA_TABLE_LAST + 1] = {
+      0.0000000f, 0.0307668f, 0.0605869f, 0.0894896f, 0.1175031f, 0.1446547f, 0.1709709f, 0.1964774f,
+      0.2211992f, 0.2451604f, 0.2683844f, 0.2908938f, 0.3127107f, 0.3338564f, 0.3543515f, 0.3742160f,
+      0.3934693f, 0.4121303f, 0.4302172f, 0.4477475f, 0.4647386f, 0.4812068f, 0.4971684f, 0.5126389f,
+      0.5276334f, 0.5421666f, 0.5562527f, 0.5699054f, 0.5831380f, 0.5959635f, 0.6083944f, 0.6204428f,
+      0.6321206f, 0.6434390f, 0.6544092f, 0.6650420f, 0.6753475f, 0.6853360f, 0.6950172f, 0.7044006f,
+      0.7134952f, 0.7223100f, 0.7308537f, 0.7391344f, 0.7471604f, 0.7549395f, 0.7624792f, 0.7697869f,
+      0.7768698f, 0.7837348f, 0.7903886f, 0.7968377f, 0.8030883f, 0.8091467f, 0.8150186f, 0.8207099f,
+      0.8262261f, 0.8315725f, 0.8367545f, 0.8417770f, 0.8466450f, 0.8513633f, 0.8559363f, 0.8603687f,
+      0.8646647f, 0.8688285f, 0.8728643f, 0.8767758f, 0.8805670f, 0.8842416f, 0.8878031f, 0.8912550f,
+      0.8946008f, 0.8978436f, 0.9009866f, 0.9040329f, 0.9069855f, 0.9098473f, 0.9126210f, 0.9153093f,
+      0.9179150f, 0.9204405f, 0.9228883f, 0.9252608f, 0.9275602f, 0.9297890f, 0.9319491f, 0.9340429f,
+      0.9360721f, 0.9380390f, 0.9399453f, 0.9417930f, 0.9435839f, 0.9453196f, 0.9470019f, 0.9486325f,
+      0.9502129f, 0.9517447f, 0.9532294f, 0.9546684f, 0.9560631f, 0.9574149f, 0.9587251f, 0.9599950f,
+      0.9612258f, 0.9624187f, 0.9635750f, 0.9646957f, 0.9657819f, 0.9668347f, 0.9678551f, 0.9688440f,
+      0.9698026f, 0.9707317f, 0.9716322f, 0.9725050f, 0.9733509f, 0.9741708f, 0.9749655f, 0.9757357f,
+      0.9764823f, 0.9772058f, 0.9779071f, 0.9785868f, 0.9792457f, 0.9798842f, 0.9805031f, 0.9811030f,
+      0.9816844f};
+  return t[i];
+}
+
+// alpha for an elapsed time dtMs and time constant tauMs
+inline float alphaFor(uint32_t dtMs, float invTauMs)
+{
+  const float x = dtMs * invTauMs;
+  if (x < 0.25f)
+    return x * (1.0f - x * (0.5f - x * (1.0f / 6.0f - x * (1.0f / 24.0f)))); // error < 1e-5 relative
+  const float u = x * ALPHA_TABLE_STEPS_PER_TAU; // in table steps
+  if (u >= ALPHA_TABLE_LAST)
+    return 1.0f - expf(-u / ALPHA_TABLE_STEPS_PER_TAU);
+  const uint16_t i = (uint16_t)u;
+  const float frac = u - i;
+  return alphaTable(i) + frac * (alphaTable(i + 1) - alphaTable(i));
+}
+
+// Elapsed time since the previous update; the first update assumes ESA_FILTER_DEFAULT_DT_MS
+class DtClock
+{
+public:
+  uint32_t tick(uint32_t nowMs)
+  {
+    const uint32_t dt = hasLast_ ? nowMs - lastMs_ : ESA_FILTER_DEFAULT_DT_MS;
+    lastMs_ = nowMs;
+    hasLast_ = true;
+    return dt;
+  }
+  void reset() { hasLast_ = false; }
+
+private:
+  uint32_t lastMs_ = 0;
+  bool hasLast_ = false;
+};
+
+// ---- Median of the last N samples ----
+template <uint8_t N>
+class MedianN
+{
+public:
+  float update(float x, uint32_t /*nowMs*/ = 0)
+  {
+    ring_[idx_] = x;
+    idx_ = (idx_ + 1 == N) ? 0 : idx_ + 1;
+    if (count_ < N)
+      ++count_;
+
+    float tmp[N];
+    for (uint8_t i = 0; i < count_; ++i)
+    {
+      // insertion sort while copying, N is small
+      const float key = ring_[i];
+      int8_t j = i - 1;
+      while (j >= 0 && tmp[j] > key)
+      {
+        tmp[j + 1] = tmp[j];
+        --j;
+      }
+      tmp[j + 1] = key;
+    }
+    return tmp[count_ / 2]; // median for 1..N samples
+  }
+
+  void reset() { idx_ = count_ = 0; }
+
+private:
+  float ring_[N] = {};
+  uint8_t idx_ = 0;
+  uint8_t count_ = 0;
+};
+
+// ---- dt-aware EMA, seeds on the first sample ----
+template <uint32_t TAU_MS>
+class Ema
+{
+public:
+  float update(float x, uint32_t nowMs)
+  {
+    const uint32_t dt = clock_.tick(nowMs);
+    if (!init_)
+    {
+      y_ = x;
+      init_ = true;
+    }
+    else
+    {
+      y_ += alphaFor(dt, 1.0f / TAU_MS) * (x - y_);
+    }
+    return y_;
+  }
+
+  float value() const { return y_; }
+  bool valid() const { return init_; }
+  void reset()
+  {
+    init_ = false;
+    clock_.reset();
+  }
+
+private:
+  DtClock clock_;
+  float y_ = 0.0f;
+  bool init_ = false;
+};
+
+// ---- dt-aware EMA with separate time constants for falling and rising input ----
+// NAN input is ignored (output holds). Output is NAN until the first valid sample.
+// requestSeed() makes the next valid sample replace the output instead of being blended in,
+// e.g. on entering a new state so it does not glide from a stale value.
+template <uint32_t TAU_DOWN_MS, uint32_t TAU_UP_MS>
+class AttackReleaseEma
+{
+public:
+  float update(float x, uint32_t nowMs)
+  {
+    const uint32_t dt = clock_.tick(nowMs); // time advances even on invalid samples
+    if (x == x)
+    {
+      if (!init_ || seed_)
+      {
+        y_ = x;
+        init_ = true;
+        seed_ = false;
+      }
+      else
+      {
+        const float invTau = (x < y_) ? 1.0f / TAU_DOWN_MS : 1.0f / TAU_UP_MS;
+        y_ += alphaFor(dt, invTau) * (x - y_);
+      }
+    }
+    return init_ ? y_ : NAN;
+  }
+
+  void requestSeed() { seed_ = true; }
+  void reset()
+  {
+    init_ = seed_ = false;
+    y_ = NAN;
+    clock_.reset();
+  }
+
+private:
+  DtClock clock_;
+  float y_ = NAN;
+  bool init_ = false;
+  bool seed_ = false;
+};
+
+// ---- Fast-attack EMA with step jump ----
+// Snaps to the input while invalid or below bootstrapBelow, jumps jumpGain of the way when the
+// input is >= stepRatio x the EMA, otherwise a normal dt-aware EMA. No decay between updates.
+template <uint32_t TAU_MS>
+class StepJumpEma
+{
+public:
+  StepJumpEma(float stepRatio, float jumpGain, float bootstrapBelow)
+      : stepRatio_(stepRatio), jumpGain_(jumpGain), bootstrapBelow_(bootstrapBelow) {}
+
+  float update(float x, uint32_t nowMs)
+  {
+    const uint32_t dt = clock_.tick(nowMs);
+    if (!init_ || y_ < bootstrapBelow_)
+    {
+      y_ = x;
+      init_ = true;
+    }
+    else if (x >= y_ * stepRatio_)
+    {
+      y_ += jumpGain_ * (x - y_);
+    }
+    else
+    {
+      y_ += alphaFor(dt, 1.0f / TAU_MS) * (x - y_);
+    }
+    return y_;
+  }
+
+  float value() const { return y_; }
+  bool valid() const { return init_; }
+  void reset()
+  {
+    init_ = false;
+    y_ = 0.0f;
+    clock_.reset();
+  }
+  // Start from a value saved earlier (e.g. before a reboot) instead of the first sample
+  void restore(float y)
+  {
+    reset();
+    y_ = y;
+    init_ = true;
+  }
+
+private:
+  DtClock clock_;
+  float y_ = 0.0f;
+  bool init_ = false;
+  float stepRatio_, jumpGain_, bootstrapBelow_;
+};
+
+// ---- Two-threshold state with dwell ----
+// BELOW: on when x <= enter, off when x >= exit (e.g. discharge current, negative)
+// ABOVE: on when x >= enter, off when x <= exit (e.g. charge current, positive)
+// The wanted state must hold for DWELL_MS before the state flips.
+enum class HystDir : uint8_t
+{
+  ABOVE,
+  BELOW
+};
+
+template <HystDir DIR, uint32_t DWELL_MS>
+class HysteresisDwell
+{
+public:
+  HysteresisDwell(float enter, float exit) : enter_(enter), exit_(exit) {}
+
+  bool update(float x, uint32_t nowMs)
+  {
+    const bool wantOn = (DIR == HystDir::BELOW) ? (x <= enter_) : (x >= enter_);
+    const bool wantOff = (DIR == HystDir::BELOW) ? (x >= exit_) : (x <= exit_);
+    const bool wantFlip = state_ ? wantOff : wantOn;
+
+    if (wantFlip)
+    {
+      if (!armed_)
+      {
+        armed_ = true;
+        sinceMs_ = nowMs;
+      }
+      if (nowMs - sinceMs_ >= DWELL_MS)
+      {
+        state_ = !state_;
+        sinceMs_ = nowMs; // stays armed: an immediate flip back counts from here
+      }
+    }
+    else
+    {
+      armed_ = false; // reset dwell timer
+    }
+    return state_;
+  }
+
+  bool state() const { return state_; }
+  void reset() { state_ = armed_ = false; }
+
+private:
+  float enter_, exit_;
+  uint32_t sinceMs_ = 0;
+  bool armed_ = false;
+  bool state_ = false;
+};
+
+// ---- On-delay: true once the input has been true for DELAY_MS, false as soon as it is not ----
+template <uint32_t DELAY_MS>
+class OnDelay
+{
+public:
+  bool update(bool in, uint32_t nowMs)
+  {
+    if (!in)
+    {
+      armed_ = out_ = false;
+      return false;
+    }
+    if (!armed_)
+    {
+      armed_ = true;
+      sinceMs_ = nowMs;
+    }
+    if (!out_ && nowMs - sinceMs_ >= DELAY_MS)
+      out_ = true;
+    return out_;
+  }
+
+  bool state() const { return out_; }
+  void reset() { armed_ = out_ = false; }
+  // On at once, as if the delay had already run (state restored after a reboot); the next
+  // update(false) still turns it off
+  void preset() { armed_ = out_ = true; }
+
+private:
+  uint32_t sinceMs_ = 0;
+  bool armed_ = false;
+  bool out_ = false;
+};
+
+// ---- Rising edge detector ----
+class RisingEdge
+{
+public:
+  bool update(bool in)
+  {
+    const bool rose = in && !prev_;
+    prev_ = in;
+    return rose;
+  }
+  void reset() { prev_ = false; }
+
+private:
+  bool prev_ = false;
+};
+
+// ---- Quantise hours to a step set at run time; non-positive / NAN input gives NAN ----
+class StepQuantizer
+{
+public:
+  explicit StepQuantizer(uint8_t stepMin = 10) { setStepMin(stepMin); }
+
+  void setStepMin(uint8_t stepMin) { step_ = stepMin ? stepMin : 1; }
+  uint8_t stepMin() const { return step_; }
+
+  float update(float hours, uint32_t /*nowMs*/ = 0) const
+  {
+    if (!(hours > 0.0f))
+      return NAN;
+    const float minutes = roundf(hours * 60.0f / step_) * step_;
+    return minutes / 60.0f;
+  }
+  void reset() {}
+
+private:
+  uint8_t step_ = 10;
+};
+
+// ---- Compile-time chain: output of each stage is the input of the next ----
+template <class... Stages>
+class Pipeline;
+
+template <>
+class Pipeline<>
+{
+public:
+  float update(float x, uint32_t /*nowMs*/) { return x; }
+  void reset() {}
+};
+
+template <class Head, class... Tail>
+class Pipeline<Head, Tail...>
+{
+public:
+  float update(float x, uint32_t nowMs) { return tail_.update(head_.update(x, nowMs), nowMs); }
+  void reset()
+  {
+    head_.reset();
+    tail_.reset();
+  }
+
+  Head &head() { return head_; }
+  Pipeline<Tail...> &tail() { return tail_; }
+
+private:
+  Head head_;
+  Pipeline<Tail...> tail_;
+};
+
+} // namespace esa
+
+#endif
@@ -0,0 +1,169 @@
+// Two-state Kalman filter for the ESA's remaining charge, fusing the Daly BMS readings.
+//
+// State x = [Q, C]: remaining charge and usable capacity, both in mAh.
+//   predict: Q += I * dt (coulomb counting on the received current, +A charge / -A discharge)
+//            C is a slow random walk (ageing, temperature)
+//   update:  resmAh  measures Q directly            H = [1, 0]
+//            SoC %   measures 100 * Q / C           H = [100 / C, -100 * Q / C^2] (linearised)
+// Both measurements are applied as sequential scalar updates on the 2x2 covariance, so one
+// update() is a few dozen float operations and no expf()/sqrtf() (only the sigma getters take a root).
+//
+// The variance of Q is what lets the TTE/TTF display decide how precisely it can talk: a
+// freshly started or poorly agreeing filter has a wide Q and gets coarser time steps.
+// Header-only and Arduino-free so it builds for both the ESP32 and host trace replays.
+
+#ifndef SOC_KALMAN_H
+#define SOC_KALMAN_H
+
+#include <stdint.h>
+#include <math.h>
+
+namespace esa
+{
+
+struct SocKalmanParams
+{
+  float currentSigmaA;     // white noise on the integrated current (BMS resolution + sampling), A
+  float capWalkMahPerHour; // capacity random walk, mAh per sqrt(hour)
+  float resmAhSigmaMah;    // noise on the BMS remaining-capacity reading, mAh
+  float socSigmaPct;       // noise on the BMS SoC reading, %
+  float capInitMah;        // capacity used when SoC is too low to infer it from resmAh / SoC
+  float capInitSigmaMah;   // initial capacity uncertainty, mAh
+  uint32_t maxGapMs;       // longer gaps are not coulomb counted, only widen Q by the gap's noise
+};
+
+class SocKalman
+{
+public:
+  explicit SocKalman(const SocKalmanParams &p) : p_(p) {}
+
+  // One BMS sample. NAN soc / resmAh skip that measurement; NAN current skips the prediction.
+  void update(float currentA, float resmAh, float socPct, uint32_t nowMs)
+  {
+    if (!init_)
+    {
+      if (!(resmAh == resmAh))
+        return;
+      seed(resmAh, socPct);
+      lastMs_ = nowMs;
+      lastI_ = currentA;
+      return;
+    }
+
+    predict(nowMs - lastMs_);
+    lastMs_ = nowMs;
+    lastI_ = currentA;
+
+    if (resmAh == resmAh)
+      correct(1.0f, 0.0f, resmAh - q_, p_.resmAhSigmaMah * p_.resmAhSigmaMah);
+    if (socPct == socPct && c_ > 1.0f)
+    {
+      const float h0 = 100.0f / c_;
+      const float h1 = -100.0f * q_ / (c_ * c_);
+      correct(h0, h1, socPct - 100.0f * q_ / c_, p_.socSigmaPct * p_.socSigmaPct);
+    }
+    clampState();
+  }
+
+  void reset() { init_ = false; }
+
+  // Capacity learned in an earlier run (e.g. saved before a reboot). Used instead of the
+  // resmAh / SoC guess when the filter seeds; if it is running already, replaces C and its
+  // variance (and drops the Q/C correlation). NAN or non-positive values are ignored.
+  void setCapacityPrior(float capMah, float sigmaMah)
+  {
+    if (!(capMah > 1.0f) || !(sigmaMah > 0.0f))
+      return;
+    priorCapMah_ = capMah;
+    priorSigmaMah_ = sigmaMah;
+    if (!init_)
+      return;
+    c_ = capMah;
+    pcc_ = sigmaMah * sigmaMah;
+    pqc_ = 0.0f;
+    clampState();
+  }
+
+  bool valid() const { return init_; }
+  float remainingMah() const { return q_; }
+  float capacityMah() const { return c_; }
+  float socPct() const { return (c_ > 1.0f) ? 100.0f * q_ / c_ : NAN; }
+  float remainingSigmaMah() const { return sqrtf(pqq_); }
+  float capacitySigmaMah() const { return sqrtf(pcc_); }
+  float toFullMah() const { return c_ - q_; }
+  float toFullSigmaMah() const { return sqrtf(pqq_ + pcc_ - 2.0f * pqc_); } // var(C - Q)
+
+private:
+  void seed(float resmAh, float socPct)
+  {
+    q_ = resmAh;
+    const bool socUsable = (socPct == socPct) && socPct > 5.0f;
+    c_ = socUsable ? resmAh * 100.0f / socPct : p_.capInitMah;
+    pcc_ = p_.capInitSigmaMah * p_.capInitSigmaMah;
+    if (priorCapMah_ == priorCapMah_)
+    {
+      c_ = priorCapMah_;
+      pcc_ = priorSigmaMah_ * priorSigmaMah_;
+    }
+    pqq_ = p_.resmAhSigmaMah * p_.resmAhSigmaMah;
+    pqc_ = 0.0f;
+    init_ = true;
+    clampState();
+  }
+
+  void predict(uint32_t dtMs)
+  {
+    const float dtH = dtMs / 3600000.0f;
+    const float qNoise = p_.currentSigmaA * 1000.0f * dtH; // mAh over this interval
+    if (dtMs <= p_.maxGapMs && lastI_ == lastI_)
+      q_ += lastI_ * 1000.0f * dtH; // zero-order hold: previous current over the interval
+    else
+      pqq_ += 100.0f * qNoise * qNoise; // gap: we do not know what happened, widen a lot
+    pqq_ += qNoise * qNoise;
+    pcc_ += p_.capWalkMahPerHour * p_.capWalkMahPerHour * dtH;
+  }
+
+  // Scalar measurement update with H = [h0, h1], innovation y and measurement variance r
+  void correct(float h0, float h1, float y, float r)
+  {
+    const float phq = pqq_ * h0 + pqc_ * h1; // (P H^T)[0]
+    const float phc = pqc_ * h0 + pcc_ * h1; // (P H^T)[1]
+    const float s = h0 * phq + h1 * phc + r;
+    if (!(s > 0.0f))
+      return;
+    const float kq = phq / s;
+    const float kc = phc / s;
+    q_ += kq * y;
+    c_ += kc * y;
+    // P = P - K S K^T (symmetric form)
+    pqq_ -= kq * phq;
+    pqc_ -= kq * phc;
+    pcc_ -= kc * phc;
+  }
+
+  void clampState()
+  {
+    if (c_ < 1.0f)
+      c_ = 1.0f;
+    if (q_ < 0.0f)
+      q_ = 0.0f;
+    if (q_ > c_)
+      q_ = c_;
+    if (pqq_ < 1e-3f)
+      pqq_ = 1e-3f;
+    if (pcc_ < 1e-3f)
+      pcc_ = 1e-3f;
+  }
+
+  SocKalmanParams p_;
+  float q_ = 0.0f, c_ = 0.0f;
+  float pqq_ = 0.0f, pqc_ = 0.0f, pcc_ = 0.0f;
+  float lastI_ = NAN;
+  float priorCapMah_ = NAN, priorSigmaMah_ = NAN;
+  uint32_t lastMs_ = 0;
+  bool init_ = false;
+};
+
+} // namespace esa
+
+#endif
@@ -0,0 +1,184 @@
+// Per-peer ESP-NOW link quality for the ESA: which senders are allowed, when each was last heard,
+// how regular its packets are and how many it lost.
+//
+// For each peer in a fixed table of MAX_PEERS slots:
+//   last / first seen, packet count
+//   mean inter-arrival gap and jitter (EWMA of |gap - mean gap|, RFC 3550 style, gain 1/16)
+//   longest gap
+//   sequence gaps (packets the sender numbered but we never got) and sender restarts
+//   RSSI (last / min / EWMA), fed separately because the receive callback does not carry it
+//   stale flag: set once nothing has arrived for staleAfterMs
+// Unknown MACs are rejected in accept() before any other work. With learnUnknown, free slots are
+// filled by the first senders heard; otherwise only addPeer()'d MACs are accepted.
+// Header-only and Arduino-free (time is passed in) so it builds for both the ESP32 and host programs.
+
+#ifndef PEER_LINK_MONITOR_H
+#define PEER_LINK_MONITOR_H
+
+#include <stdint.h>
+#include <string.h>
+
+struct PeerLinkStats
+{
+  uint8_t mac[6];
+  uint32_t firstSeenMs;
+  uint32_t lastSeenMs;
+  uint32_t packets;
+  uint32_t seqGaps;   // packets missing according to the sender's sequence numbers
+  uint32_t seqResets; // sequence went backwards: sender rebooted
+  uint32_t maxGapMs;  // longest time between two packets
+  float meanGapMs;    // EWMA of the time between packets
+  float jitterMs;     // EWMA of |gap - meanGapMs|
+  float rssiAvg;      // EWMA of RSSI (dBm)
+  int8_t rssiLast;
+  int8_t rssiMin;
+  uint16_t lastSeq;
+  bool hasSeq;
+  bool hasRssi;
+  bool stale;
+};
+
+template <uint8_t MAX_PEERS>
+class PeerLinkMonitor
+{
+public:
+  PeerLinkMonitor(uint32_t staleAfterMs, bool learnUnknown)
+      : staleAfterMs_(staleAfterMs), learnUnknown_(learnUnknown)
+  {
+    memset(inUse_, 0, sizeof(inUse_));
+  }
+
+  // Register an allowed sender. Returns its slot, or -1 if the table is full.
+  int8_t addPeer(const uint8_t *mac)
+  {
+    const int8_t existing = find(mac);
+    if (existing >= 0)
+      return existing;
+    for (uint8_t i = 0; i < MAX_PEERS; ++i)
+    {
+      if (inUse_[i])
+        continue;
+      memset(&peers_[i], 0, sizeof(PeerLinkStats));
+      memcpy(peers_[i].mac, mac, 6);
+      peers_[i].stale = true; // not heard yet
+      inUse_[i] = true;
+      ++count_;
+      return (int8_t)i;
+    }
+    return -1;
+  }
+
+  int8_t find(const uint8_t *mac) const
+  {
+    for (uint8_t i = 0; i < MAX_PEERS; ++i)
+      if (inUse_[i] && memcmp(peers_[i].mac, mac, 6) == 0)
+        return (int8_t)i;
+    return -1;
+  }
+
+  // First thing to call for a received packet. Slot of the sender, or -1 to drop the packet.
+  int8_t accept(const uint8_t *mac)
+  {
+    const int8_t slot = find(mac);
+    if (slot >= 0 || !learnUnknown_)
+      return slot;
+    return addPeer(mac);
+  }
+
+  // Record a packet from an accepted sender. hasSeq is false for senders without a sequence number.
+  void onPacket(int8_t slot, uint32_t nowMs, bool hasSeq, uint16_t seq)
+  {
+    PeerLinkStats &p = peers_[slot];
+    if (p.packets == 0)
+    {
+      p.firstSeenMs = nowMs;
+    }
+    else
+    {
+      const uint32_t gap = nowMs - p.lastSeenMs;
+      if (gap > p.maxGapMs)
+        p.maxGapMs = gap;
+      if (p.packets == 1)
+        p.meanGapMs = (float)gap;
+      const float dev = (float)gap - p.meanGapMs;
+      p.jitterMs += ((dev < 0.0f ? -dev : dev) - p.jitterMs) / 16.0f;
+      p.meanGapMs += dev / 16.0f;
+    }
+    if (hasSeq)
+    {
+      if (p.hasSeq)
+      {
+        const uint16_t step = (uint16_t)(seq - p.lastSeq);
+        if (step == 0 || step > 0x8000u)
+          ++p.seqResets; // repeated or went backwards
+        else
+          p.seqGaps += step - 1u;
+      }
+      p.lastSeq = seq;
+      p.hasSeq = true;
+    }
+    p.lastSeenMs = nowMs;
+    ++p.packets;
+    p.stale = false;
+  }
+
+  // RSSI of a frame from mac (e.g. from a promiscuous-mode callback). Unknown senders are ignored.
+  void onRssi(const uint8_t *mac, int8_t rssi)
+  {
+    const int8_t slot = find(mac);
+    if (slot < 0)
+      return;
+    PeerLinkStats &p = peers_[slot];
+    if (!p.hasRssi)
+    {
+      p.rssiAvg = rssi;
+      p.rssiMin = rssi;
+      p.hasRssi = true;
+    }
+    p.rssiLast = rssi;
+    if (rssi < p.rssiMin)
+      p.rssiMin = rssi;
+    p.rssiAvg += (rssi - p.rssiAvg) / 8.0f;
+  }
+
+  // Re-evaluate the stale flags. Returns true if any peer went stale on this call.
+  bool checkStale(uint32_t nowMs)
+  {
+    bool wentStale = false;
+    for (uint8_t i = 0; i < MAX_PEERS; ++i)
+    {
+      if (!inUse_[i] || peers_[i].stale)
+        continue;
+      if (nowMs - peers_[i].lastSeenMs >= staleAfterMs_)
+      {
+        peers_[i].stale = true;
+        wentStale = true;
+      }
+    }
+    return wentStale;
+  }
+
+  // True while at least one registered peer is being heard
+  bool anyFresh() const
+  {
+    for (uint8_t i = 0; i < MAX_PEERS; ++i)
+      if (inUse_[i] && !peers_[i].stale)
+        return true;
+    return false;
+  }
+
+  bool inUse(uint8_t slot) const { return slot < MAX_PEERS && inUse_[slot]; }
+  const PeerLinkStats &stats(uint8_t slot) const { return peers_[slot]; }
+  uint8_t count() const { return count_; }
+  static constexpr uint8_t capacity() { return MAX_PEERS; }
+  uint32_t staleAfterMs() const { return staleAfterMs_; }
+
+private:
+  PeerLinkStats peers_[MAX_PEERS];
+  bool inUse_[MAX_PEERS];
+  uint8_t count_ = 0;
+  uint32_t staleAfterMs_;
+  bool learnUnknown_;
+};
+
+#endif
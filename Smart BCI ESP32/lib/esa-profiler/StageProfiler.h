@@ -0,0 +1,97 @@
+// Per-stage timing statistics for the ESA render path: min / avg / max and a log2 histogram.
+//
+// The caller measures with a microsecond clock (esp_timer_get_time() on the ESP32, which keeps
+// counting at the same rate when DFS changes the CPU clock) and hands record() the elapsed us.
+// Histogram bin i counts durations in [2^(i-1), 2^i) us, bin 0 is < 1 us and the last bin is open-ended.
+// record() is a handful of integer operations; all storage is fixed (STAGES x BINS counters).
+// Header-only and Arduino-free so it builds for both the ESP32 and host programs.
+
+#ifndef STAGE_PROFILER_H
+#define STAGE_PROFILER_H
+
+#include <stdint.h>
+#include <string.h>
+
+struct StageStats
+{
+  uint32_t count;
+  uint32_t minUs;
+  uint32_t maxUs;
+  uint64_t sumUs;
+  uint32_t lastUs;
+};
+
+template <uint8_t STAGES, uint8_t BINS = 12>
+class StageProfiler
+{
+public:
+  StageProfiler() { reset(); }
+
+  void record(uint8_t stage, uint32_t us)
+  {
+    if (stage >= STAGES)
+      return;
+    StageStats &s = stats_[stage];
+    if (s.count == 0 || us < s.minUs)
+      s.minUs = us;
+    if (us > s.maxUs)
+      s.maxUs = us;
+    s.sumUs += us;
+    s.lastUs = us;
+    ++s.count;
+    ++hist_[stage][binFor(us)];
+  }
+
+  void reset()
+  {
+    memset(stats_, 0, sizeof(stats_));
+    memset(hist_, 0, sizeof(hist_));
+  }
+
+  const StageStats &stats(uint8_t stage) const { return stats_[stage]; }
+  uint32_t bin(uint8_t stage, uint8_t b) const { return hist_[stage][b]; }
+  float minUs(uint8_t stage) const { return (float)stats_[stage].minUs; }
+  float maxUs(uint8_t stage) const { return (float)stats_[stage].maxUs; }
+  float lastUs(uint8_t stage) const { return (float)stats_[stage].lastUs; }
+  float avgUs(uint8_t stage) const
+  {
+    const StageStats &s = stats_[stage];
+    return s.count ? (float)s.sumUs / s.count : 0.0f;
+  }
+  static constexpr uint8_t stages() { return STAGES; }
+  static constexpr uint8_t bins() { return BINS; }
+
+  // Lower edge of histogram bin b in microseconds (0 for bin 0)
+  static constexpr uint32_t binLowUs(uint8_t b) { return b ? (1u << (b - 1)) : 0u; }
+
+private:
+  static uint8_t binFor(uint32_t us)
+  {
+    uint8_t b = 0;
+    while (us && b < BINS - 1)
+    {
+      us >>= 1;
+      ++b;
+    }
+    return b;
+  }
+
+  StageStats stats_[STAGES];
+  uint32_t hist_[STAGES][BINS];
+};
+
+// Records the time between construction and destruction. NOW is a function returning microseconds.
+template <typename PROFILER, uint32_t (*NOW)()>
+class StageScope
+{
+public:
+  StageScope(PROFILER &p, uint8_t stage) : p_(p), stage_(stage), start_(NOW()) {}
+  ~StageScope() { p_.record(stage_, NOW() - start_); }
+
+private:
+  PROFILER &p_;
+  uint8_t stage_;
+  uint32_t start_;
+};
+
+#endif
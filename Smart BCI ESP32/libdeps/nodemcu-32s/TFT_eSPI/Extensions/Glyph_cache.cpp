@@ -0,0 +1,236 @@
+ // This is part of the TFT_eSPI class and is associated with the GFX free font glyph cache.
+
+////////////////////////////////////////////////////////////////////////////////////////
+// Glyph cache for GFX free fonts
+////////////////////////////////////////////////////////////////////////////////////////
+/*
+  Without the cache an opaque free font string (text colour != background) is drawn as a
+  fillRect() of the text box and then one drawFastHLine() per horizontal run of every glyph,
+  each with its own address window. The glyph bitmaps are bit streams in FLASH that are
+  decoded again every time.
+
+  With GLYPH_CACHE defined, glyphs are decoded once into 1 bit per pixel masks, one byte
+  aligned row after another, kept in a fixed RAM pool together with their metrics. An opaque
+  string is then composed a row at a time from the masks into a line buffer and sent as a
+  single window covering the same box the fillRect() covered: one window and a continuous
+  pixel stream instead of one window per run.
+
+  The pool is a ring: new masks are appended and overwrite the oldest entries when it wraps,
+  so the glyphs of recently drawn strings stay. The result is pixel for pixel the same as the
+  uncached path. Strings fall back to that path when they cannot use the cache: transparent
+  or scaled text, sprites, a box outside the viewport or wider than GLYPH_CACHE_MAX_WIDTH,
+  characters missing from the font, more than GLYPH_CACHE_MAX_CHARS characters, or a string
+  whose glyphs do not fit the pool together.
+*/
+
+#ifndef GLYPH_CACHE_BYTES
+  #define GLYPH_CACHE_BYTES     2048  // Mask pool, FreeSansBold12pt glyphs take ~40 bytes each
+#endif
+#ifndef GLYPH_CACHE_ENTRIES
+  #define GLYPH_CACHE_ENTRIES     96  // Glyphs held at once, at most
+#endif
+#ifndef GLYPH_CACHE_MAX_CHARS
+  #define GLYPH_CACHE_MAX_CHARS   64  // Longer strings use the uncached path
+#endif
+#ifndef GLYPH_CACHE_MAX_WIDTH
+  #define GLYPH_CACHE_MAX_WIDTH  480  // Line buffer pixels, wider boxes use the uncached path
+#endif
+
+typedef struct
+{
+  const GFXfont *font;      // nullptr = free
+  uint16_t code;            // Character code
+  uint16_t offset;          // Mask position in gcPool
+  uint16_t bytes;           // Mask size, ((w + 7) / 8) * h
+  uint16_t lastString;      // gcStringId of the last string that used it
+  uint8_t  w, h, xAdvance;
+  int8_t   xo, yo;
+} gcEntry;
+
+typedef struct
+{
+  int16_t  x;               // Glyph origin relative to the box
+  uint8_t  entry;
+} gcPlaced;
+
+static gcEntry  gcEntries[GLYPH_CACHE_ENTRIES];
+static uint8_t  gcPool[GLYPH_CACHE_BYTES];
+static uint16_t gcHead = 0;                      // Next free byte in the pool ring
+static uint8_t  gcNextEntry = 0;                 // Entries are also reused oldest first
+static uint16_t gcStringId = 0;                  // Current string, protects its own glyphs
+static uint32_t gcHits = 0, gcMisses = 0, gcStrings = 0;
+static gcPlaced gcPlace[GLYPH_CACHE_MAX_CHARS];
+static uint16_t gcLine[GLYPH_CACHE_MAX_WIDTH];   // One row of the box, colours byte swapped
+
+/***************************************************************************************
+** Function name:           glyphCacheClear
+** Description:             Empty the cache and zero the statistics
+***************************************************************************************/
+void TFT_eSPI::glyphCacheClear(void)
+{
+  memset(gcEntries, 0, sizeof(gcEntries));
+  gcHead = 0;
+  gcNextEntry = 0;
+  gcHits = gcMisses = gcStrings = 0;
+}
+
+uint32_t TFT_eSPI::glyphCacheHits(void)    { return gcHits; }
+uint32_t TFT_eSPI::glyphCacheMisses(void)  { return gcMisses; }
+uint32_t TFT_eSPI::glyphCacheStrings(void) { return gcStrings; }
+
+/***************************************************************************************
+** Function name:           glyphCacheGet
+** Description:             Find code of the current free font, decode it on a miss
+***************************************************************************************/
+// Returns the entry index, or -1 if the glyph cannot be cached without evicting a glyph
+// of the string being drawn (pool or entry table too small for it)
+int16_t TFT_eSPI::glyphCacheGet(uint16_t code)
+{
+  for (uint8_t i = 0; i < GLYPH_CACHE_ENTRIES; i++) {
+    if (gcEntries[i].font == gfxFont && gcEntries[i].code == code) {
+      gcEntries[i].lastString = gcStringId;
+      gcHits++;
+      return i;
+    }
+  }
+
+  GFXglyph *glyph  = &(((GFXglyph *)pgm_read_dword(&gfxFont->glyph))[code - pgm_read_word(&gfxFont->first)]);
+  uint8_t  *bitmap = (uint8_t *)pgm_read_dword(&gfxFont->bitmap);
+  uint32_t bo = pgm_read_word(&glyph->bitmapOffset);
+  uint8_t  w  = pgm_read_byte(&glyph->width),
+           h  = pgm_read_byte(&glyph->height);
+  uint16_t rowBytes = (w + 7) >> 3;
+  uint16_t bytes = rowBytes * h;
+  if (bytes > GLYPH_CACHE_BYTES) return -1;
+
+  // Next entry slot and pool space from the ring heads on, stepping over glyphs of the
+  // string being drawn, then evict whatever else is there
+  uint8_t e = gcNextEntry;
+  for (uint8_t tries = 0; gcEntries[e].font && gcEntries[e].lastString == gcStringId; tries++) {
+    if (tries == GLYPH_CACHE_ENTRIES) return -1;
+    e = (e + 1) % GLYPH_CACHE_ENTRIES;
+  }
+  bool wrapped = false;
+  for (;;) {
+    if (gcHead + bytes > GLYPH_CACHE_BYTES) {
+      if (wrapped) return -1;
+      gcHead = 0;
+      wrapped = true;
+    }
+    int16_t busy = -1;
+    for (uint8_t i = 0; i < GLYPH_CACHE_ENTRIES && busy < 0; i++) {
+      const gcEntry &old = gcEntries[i];
+      if (old.font && old.lastString == gcStringId && old.offset < gcHead + bytes && gcHead < old.offset + old.bytes) busy = i;
+    }
+    if (busy < 0) break;
+    gcHead = gcEntries[busy].offset + gcEntries[busy].bytes;
+  }
+  for (uint8_t i = 0; i < GLYPH_CACHE_ENTRIES; i++) {
+    gcEntry &old = gcEntries[i];
+    if (old.font && old.offset < gcHead + bytes && gcHead < old.offset + old.bytes) old.font = nullptr;
+  }
+  gcNextEntry = (e + 1) % GLYPH_CACHE_ENTRIES;
+
+  gcEntry &n = gcEntries[e];
+  n.font       = gfxFont;
+  n.code       = code;
+  n.offset     = gcHead;
+  n.bytes      = bytes;
+  n.lastString = gcStringId;
+  n.w          = w;
+  n.h          = h;
+  n.xAdvance   = pgm_read_byte(&glyph->xAdvance);
+  n.xo         = pgm_read_byte(&glyph->xOffset);
+  n.yo         = pgm_read_byte(&glyph->yOffset);
+  gcHead += bytes;
+
+  // Re-pack the continuous bit stream into byte aligned rows
+  uint8_t *mask = gcPool + n.offset;
+  memset(mask, 0, bytes);
+  uint8_t bits = 0, bit = 0;
+  for (uint8_t yy = 0; yy < h; yy++) {
+    for (uint8_t xx = 0; xx < w; xx++) {
+      if (bit == 0) {
+        bits = pgm_read_byte(&bitmap[bo++]);
+        bit  = 0x80;
+      }
+      if (bits & bit) mask[yy * rowBytes + (xx >> 3)] |= 0x80 >> (xx & 7);
+      bit >>= 1;
+    }
+  }
+  gcMisses++;
+  return e;
+}
+
+/***************************************************************************************
+** Function name:           drawStringGlyphCache
+** Description:             Draw an opaque free font string as a single window
+***************************************************************************************/
+bool TFT_eSPI::drawStringGlyphCache(const char *string, int32_t poX, int32_t poY, int32_t boxX, int32_t boxW, int16_t *advance)
+{
+  if (_vpOoB || !_glyphCacheBlit || textsize != 1 || boxW <= 0 || boxW > GLYPH_CACHE_MAX_WIDTH) return false;
+
+  int32_t boxH = glyph_ab + glyph_bb;
+  int32_t xd = boxX + _xDatum;
+  int32_t yd = poY - glyph_ab + _yDatum;
+  if (xd < _vpX || yd < _vpY || xd + boxW > _vpW || yd + boxH > _vpH) return false;
+
+  // Look up every glyph first, so nothing is drawn if one of them cannot be cached
+  gcStringId++;
+  uint16_t first = pgm_read_word(&gfxFont->first);
+  uint16_t last  = pgm_read_word(&gfxFont->last);
+  uint16_t len = strlen(string);
+  uint16_t n = 0;
+  uint8_t  count = 0;
+  int16_t  sumX = 0;
+  while (n < len) {
+    uint16_t code = decodeUTF8((uint8_t*)string, &n, len - n);
+    if (!code) continue;   // drawChar() skips these too
+    if (code < first || code > last || count == GLYPH_CACHE_MAX_CHARS) return false;
+    int16_t e = glyphCacheGet(code);
+    if (e < 0) return false;
+    const gcEntry &g = gcEntries[e];
+    int32_t gx = poX + sumX - boxX;
+    // Glyphs poking out of the box would be clipped here but not by the uncached path
+    if (g.w && (gx + g.xo < 0 || gx + g.xo + g.w > boxW)) return false;
+    gcPlace[count].x = gx;
+    gcPlace[count].entry = e;
+    count++;
+    sumX += g.xAdvance;
+  }
+
+  // Colours go out byte swapped, so pushPixels() must not swap them again
+  uint16_t fg = (uint16_t)textcolor, bg = (uint16_t)textbgcolor;
+  fg = (fg >> 8) | (fg << 8);
+  bg = (bg >> 8) | (bg << 8);
+  bool swap = _swapBytes;
+  _swapBytes = false;
+
+  begin_tft_write();
+  setWindow(xd, yd, xd + boxW - 1, yd + boxH - 1);
+  for (int32_t row = 0; row < boxH; row++) {
+    int32_t ry = row - glyph_ab;   // Relative to the baseline, like yOffset
+    for (int32_t i = 0; i < boxW; i++) gcLine[i] = bg;
+    for (uint8_t c = 0; c < count; c++) {
+      const gcEntry &g = gcEntries[gcPlace[c].entry];
+      int32_t gy = ry - g.yo;
+      if (gy < 0 || gy >= g.h) continue;
+      uint16_t rowBytes = (g.w + 7) >> 3;
+      const uint8_t *m = gcPool + g.offset + gy * rowBytes;
+      uint16_t *dst = gcLine + gcPlace[c].x + g.xo;
+      for (uint16_t b = 0; b < rowBytes; b++) {
+        uint8_t bits = m[b];
+        for (uint8_t k = 0; bits; k++, bits <<= 1) {
+          if (bits & 0x80) dst[(b << 3) + k] = fg;
+        }
+      }
+    }
+    pushPixels(gcLine, boxW);
+  }
+  end_tft_write();
+
+  _swapBytes = swap;
+  gcStrings++;
+  *advance = sumX;
+  return true;
+}
@@ -0,0 +1,22 @@
+ // This is part of the TFT_eSPI class and is associated with the GFX free font glyph cache.
+ // Loaded if GLYPH_CACHE is defined by the user setup, see Glyph_cache.cpp for how it works.
+
+ public:
+
+  void     glyphCacheClear(void);          // Forget all cached glyphs and zero the counters
+  uint32_t glyphCacheHits(void),           // Glyph lookups served from the cache
+           glyphCacheMisses(void),         // Glyphs decoded from the font bitmap
+           glyphCacheStrings(void);        // Strings drawn through the cache (one window each)
+
+ protected:
+
+  bool     _glyphCacheBlit = true;         // Sprites clear this: they draw into their own buffer
+
+  // Draws an opaque free font string as one window covering boxX..boxX+boxW-1 and the font's
+  // full height around baseline poY. Returns false (nothing drawn) if the string cannot take
+  // this path, then drawString() falls back to glyph by glyph drawing
+  bool     drawStringGlyphCache(const char *string, int32_t poX, int32_t poY, int32_t boxX, int32_t boxW, int16_t *advance);
+
+ private:
+
+  int16_t  glyphCacheGet(uint16_t code);   // Entry index for code in gfxFont, decoding it on a miss
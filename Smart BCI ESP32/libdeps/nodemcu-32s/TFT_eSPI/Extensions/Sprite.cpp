@@ -37,6 +37,10 @@ TFT_eSprite::TFT_eSprite(TFT_eSPI *tft)
   _colorMap = nullptr;
 
   _psram_enable = true;
+
+#ifdef GLYPH_CACHE
+  _glyphCacheBlit = false; // drawString() must use the virtual drawing functions
+#endif
   
   // Ensure end_tft_write() does nothing in inherited functions.
   lockTransaction = true;
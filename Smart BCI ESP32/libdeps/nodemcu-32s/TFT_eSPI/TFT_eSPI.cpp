@@ -5598,6 +5598,7 @@ int16_t TFT_eSPI::drawString(const char *string, int32_t poX, int32_t poY, uint8
 
 
   int8_t xo = 0;
+  bool cached = false; // String already drawn in one window by the glyph cache
 #ifdef LOAD_GFXFF
   if (freeFont && (textcolor!=textbgcolor)) {
       cheight = (glyph_ab + glyph_bb) * textsize;
@@ -5618,6 +5619,11 @@ int16_t TFT_eSPI::drawString(const char *string, int32_t poX, int32_t poY, uint8
         // Add 1 pixel of padding all round
         //cheight +=2;
         //fillRect(poX+xo-1, poY - 1 - glyph_ab * textsize, cwidth+2, cheight, textbgcolor);
+  #ifdef GLYPH_CACHE
+        // Background and glyphs together, otherwise fill the box and draw the glyph runs on it
+        cached = drawStringGlyphCache(string, poX, poY, poX+xo, cwidth, &sumX);
+        if (!cached)
+  #endif
         fillRect(poX+xo, poY - glyph_ab * textsize, cwidth, cheight, textbgcolor);
       }
       padding -=100;
@@ -5645,7 +5651,7 @@ int16_t TFT_eSPI::drawString(const char *string, int32_t poX, int32_t poY, uint8
   }
   else
 #endif
-  {
+  if (!cached) {
     while (n < len) {
       uint16_t uniCode = decodeUTF8((uint8_t*)string, &n, len - n);
       sumX += drawChar(uniCode, poX+sumX, poY, font);
@@ -6145,6 +6151,10 @@ void TFT_eSPI::getSetup(setup_t &tft_settings)
   #include "Extensions/Smooth_font.cpp"
 #endif
 
+#ifdef GLYPH_CACHE
+  #include "Extensions/Glyph_cache.cpp"
+#endif
+
 #ifdef AA_GRAPHICS
   #include "Extensions/AA_graphics.cpp"  // Loaded if SMOOTH_FONT is defined by user
 #endif
@@ -979,6 +979,11 @@ class TFT_eSPI : public Print { friend class TFT_eSprite; // Sprite class has ac
   #include "Extensions/Smooth_font.h"  // Loaded if SMOOTH_FONT is defined by user
 #endif
 
+// Load the free font glyph cache
+#ifdef GLYPH_CACHE
+  #include "Extensions/Glyph_cache.h"  // Loaded if GLYPH_CACHE is defined by user
+#endif
+
 }; // End of class TFT_eSPI
 
 // Swap any type
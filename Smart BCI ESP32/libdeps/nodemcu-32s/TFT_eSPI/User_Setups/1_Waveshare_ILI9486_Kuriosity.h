@@ -320,6 +320,11 @@
 // this will save ~20kbytes of FLASH
 // #define SMOOTH_FONT
 
+// Comment out the #define below to draw free font text glyph run by glyph run again.
+// With it, opaque free font strings go out as one window each, composed from a small RAM
+// cache of decoded glyphs (Extensions/Glyph_cache.cpp, ~4.5 kbytes of RAM by default)
+#define GLYPH_CACHE
+
 // ##################################################################################
 //
 // Section 4. Other options
@@ -358,7 +363,9 @@
 // #define SPI_FREQUENCY   1000000
 // #define SPI_FREQUENCY   5000000
 // #define SPI_FREQUENCY  10000000
+#ifndef SPI_FREQUENCY // test/23_TFT_Primitive_Benchmark builds with -DSPI_FREQUENCY=... to sweep it
 #define SPI_FREQUENCY 20000000
+#endif
 // #define SPI_FREQUENCY  27000000
 // #define SPI_FREQUENCY  40000000
 // #define SPI_FREQUENCY  55000000 // STM32 SPI1 only (SPI2 maximum is 27MHz)
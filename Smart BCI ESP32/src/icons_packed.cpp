@@ -0,0 +1,315 @@
+// Generated by lib/esa-assets/pack_icons.py from icons.c. Do not edit; rerun the script.
+
+#include "icons_packed.h"
+
+// penguin: 40x40, LZ565, 2124 bytes (raw 3200, 66%)
+static const uint8_t penguin_data[2124] = {
+    0x4C, 0xFF, 0xFF, 0x0B, 0xF7, 0xBE, 0xEF, 0x7D, 0xD6, 0xBA, 0xB5, 0xB6, 0x9C, 0xF3, 0x94, 0xB2,
+    0x9C, 0xB3, 0x94, 0xB2, 0xA5, 0x34, 0xBD, 0xF7, 0xDE, 0xFB, 0xEF, 0x7D, 0x58, 0xFF, 0xFF, 0x06,
+    0xF7, 0xBE, 0xDE, 0xFB, 0x9C, 0xF3, 0x5A, 0xCB, 0x39, 0xC7, 0x21, 0x04, 0x10, 0x82, 0x40, 0x10,
+    0x42, 0x07, 0x08, 0x41, 0x18, 0x83, 0x29, 0x45, 0x39, 0xC7, 0x63, 0x0C, 0xAD, 0x75, 0xE7, 0x3C,
+    0xF7, 0xBE, 0x94, 0x26, 0x06, 0xE7, 0x3C, 0x94, 0xB2, 0x42, 0x08, 0x18, 0xC3, 0x10, 0x82, 0x21,
+    0x04, 0x29, 0x45, 0x42, 0x31, 0x86, 0x00, 0x29, 0x45, 0x80, 0x2D, 0x04, 0x08, 0x41, 0x18, 0xC3,
+    0x42, 0x08, 0x9C, 0xF3, 0xE7, 0x3C, 0x92, 0x26, 0x01, 0xDE, 0xFB, 0x63, 0x0C, 0x40, 0x18, 0xC3,
+    0x80, 0x46, 0x44, 0x42, 0x08, 0x40, 0x39, 0xC7, 0x80, 0x2B, 0x04, 0x21, 0x04, 0x08, 0x41, 0x10,
+    0x82, 0x5A, 0xCB, 0xD6, 0xBA, 0x91, 0x26, 0x01, 0x5A, 0xCB, 0x10, 0x82, 0x82, 0x25, 0x00, 0x4A,
+    0x09, 0x43, 0x4A, 0x49, 0x81, 0x28, 0x80, 0x29, 0x04, 0x29, 0x45, 0x18, 0x83, 0x00, 0x00, 0x41,
+    0xC8, 0xC6, 0x38, 0x8E, 0x26, 0x01, 0xEF, 0x7D, 0x73, 0x8E, 0x82, 0x26, 0x0A, 0x4A, 0x09, 0x52,
+    0x8A, 0x84, 0x30, 0x7B, 0xCF, 0x52, 0x8A, 0x4A, 0x49, 0x52, 0x4A, 0x4A, 0x49, 0x5A, 0xCB, 0x7B,
+    0xCF, 0x63, 0x0C, 0x80, 0x2A, 0x80, 0x28, 0x02, 0x18, 0xC3, 0x00, 0x00, 0x4A, 0x49, 0x8E, 0x51,
+    0x02, 0x9C, 0xF3, 0x18, 0xC3, 0x21, 0x04, 0x80, 0x26, 0x80, 0x48, 0x00, 0x94, 0x72, 0x40, 0xEF,
+    0x7D, 0x00, 0x94, 0xB2, 0x80, 0x26, 0x04, 0x52, 0x8A, 0xAD, 0x75, 0xF7, 0xBE, 0xD6, 0xBA, 0x6B,
+    0x4D, 0x82, 0x51, 0x03, 0x18, 0xC3, 0x08, 0x41, 0x7B, 0xCF, 0xE7, 0x7C, 0x8B, 0x26, 0x02, 0xD6,
+    0xBA, 0x42, 0x08, 0x10, 0x82, 0x82, 0x26, 0x01, 0x73, 0x8E, 0xDE, 0xFB, 0x80, 0xF4, 0x08, 0xD6,
+    0xBA, 0x73, 0x8E, 0x42, 0x08, 0x84, 0x30, 0xE7, 0x3C, 0xEF, 0x7D, 0xFF, 0xFF, 0xB5, 0xB6, 0x4A,
+    0x49, 0x81, 0x27, 0x80, 0xA3, 0x01, 0x29, 0x45, 0xB5, 0xB6, 0x8A, 0x26, 0x01, 0xF7, 0xBE, 0x8C,
+    0x71, 0x80, 0x10, 0x81, 0x26, 0x01, 0x52, 0x4A, 0x94, 0xB2, 0x40, 0xF7, 0xBE, 0x00, 0x94, 0xB2,
+    0x40, 0x7B, 0xCF, 0x07, 0x4A, 0x49, 0xB5, 0xB6, 0x9C, 0xF3, 0x63, 0x0C, 0xC6, 0x38, 0xD6, 0xBA,
+    0x63, 0x0C, 0x39, 0x87, 0x83, 0x50, 0x00, 0x84, 0x30, 0x80, 0x32, 0x88, 0x00, 0x02, 0xE7, 0x3C,
+    0x5A, 0xCB, 0x08, 0x41, 0x81, 0x4E, 0x02, 0x52, 0x4A, 0x52, 0x8A, 0x9C, 0xF3, 0x80, 0xA7, 0x09,
+    0x39, 0xC7, 0x18, 0xC3, 0x63, 0x0C, 0x5A, 0xCB, 0xB5, 0xB6, 0x94, 0xB2, 0x5A, 0xCB, 0xAD, 0x75,
+    0xD6, 0xFA, 0x6B, 0x4D, 0x82, 0x27, 0x80, 0x50, 0x01, 0x52, 0x8A, 0xCE, 0x79, 0x89, 0x27, 0x03,
+    0xC6, 0x38, 0x31, 0x86, 0x21, 0x04, 0x41, 0xC8, 0x81, 0x4E, 0x01, 0x4A, 0x49, 0x8C, 0xB1, 0x84,
+    0x4F, 0x05, 0xA5, 0x74, 0xEF, 0x7D, 0xE7, 0x7C, 0xF7, 0xBE, 0xCE, 0x79, 0x63, 0x0C, 0x82, 0xA0,
+    0x00, 0x21, 0x04, 0x80, 0xDD, 0x80, 0xAB, 0x88, 0x27, 0x02, 0xA5, 0x34, 0x10, 0x82, 0x31, 0x86,
+    0x81, 0x76, 0x80, 0xE9, 0x00, 0x6B, 0x4D, 0x81, 0xDE, 0x03, 0xCE, 0x79, 0x63, 0x0D, 0x39, 0xC7,
+    0x7B, 0xCF, 0x81, 0x6B, 0x02, 0xAD, 0x75, 0x42, 0x08, 0x31, 0x86, 0x81, 0x27, 0x80, 0x78, 0x01,
+    0x18, 0xC3, 0x94, 0xB2, 0x88, 0x78, 0x01, 0xF7, 0xBE, 0x8C, 0xB2, 0x82, 0x76, 0x80, 0x27, 0x0C,
+    0x52, 0x8A, 0x4A, 0x4A, 0x7B, 0xD0, 0xC6, 0x7A, 0xBE, 0x7B, 0x6B, 0x90, 0x39, 0xC9, 0x31, 0x88,
+    0x39, 0xC9, 0x84, 0xB3, 0xC6, 0xBB, 0xB5, 0xF8, 0x5A, 0xCC, 0x80, 0x26, 0x82, 0x27, 0x00, 0x20,
+    0xC4, 0x80, 0xA0, 0x00, 0xE7, 0x3C, 0x88, 0x9E, 0x01, 0x4A, 0x8A, 0x10, 0xC3, 0x82, 0x27, 0x0F,
+    0x4A, 0x4A, 0x42, 0x4A, 0x3A, 0x09, 0x4A, 0x08, 0x6B, 0x09, 0x7B, 0x49, 0x7A, 0xC6, 0x83, 0x05,
+    0x83, 0x46, 0x7A, 0xC5, 0x72, 0xC6, 0x7B, 0x09, 0x5A, 0x48, 0x31, 0x87, 0x21, 0x88, 0x29, 0x88,
+    0x40, 0x31, 0x86, 0x80, 0x27, 0x80, 0xA0, 0x00, 0x4A, 0x4A, 0x81, 0x63, 0x85, 0x00, 0x03, 0xC5,
+    0xF7, 0x50, 0x82, 0x41, 0x05, 0x29, 0xC7, 0x80, 0x27, 0x07, 0x42, 0x4A, 0x4A, 0x49, 0x7B, 0x09,
+    0x9B, 0x88, 0xB3, 0xC6, 0xD4, 0x21, 0xDC, 0xA0, 0xE4, 0xE1, 0x40, 0xED, 0x61, 0x0E, 0xED, 0x21,
+    0xE4, 0xA0, 0xDC, 0x20, 0xCB, 0x80, 0xAB, 0x43, 0x82, 0xC4, 0x5A, 0x06, 0x21, 0x47, 0x29, 0x46,
+    0x29, 0x45, 0x29, 0x04, 0x19, 0x04, 0x10, 0x82, 0x18, 0x82, 0x9C, 0xF3, 0x86, 0x78, 0x0B, 0xEF,
+    0x7D, 0x93, 0x4D, 0xA0, 0x00, 0xB8, 0x82, 0x31, 0xC7, 0x32, 0x09, 0x4A, 0x49, 0x7A, 0x86, 0xC3,
+    0x43, 0xED, 0x6B, 0xF6, 0xF4, 0xFD, 0xEB, 0x40, 0xFD, 0x20, 0x00, 0xFD, 0x60, 0x40, 0xFD, 0xA0,
+    0x40, 0xFD, 0x60, 0x0C, 0xFD, 0x20, 0xFC, 0xE0, 0xFC, 0xA0, 0xF4, 0x60, 0xDB, 0xC1, 0x9A, 0x83,
+    0x49, 0xC5, 0x29, 0x45, 0x19, 0x04, 0x20, 0xC4, 0x38, 0x82, 0x50, 0x00, 0x6A, 0xCB, 0x86, 0x50,
+    0x0C, 0xEE, 0xFB, 0xA1, 0x04, 0xC0, 0x00, 0xF0, 0x00, 0xA0, 0xC3, 0x41, 0xC8, 0x42, 0x49, 0x9B,
+    0x05, 0xFC, 0x20, 0xFC, 0xA4, 0xFD, 0x69, 0xFD, 0xE8, 0xFD, 0x63, 0x80, 0x27, 0x81, 0x25, 0x80,
+    0x26, 0x80, 0x27, 0x0A, 0xFC, 0x60, 0xFC, 0x20, 0xD3, 0x41, 0x49, 0xC5, 0x19, 0x45, 0x38, 0xC4,
+    0x68, 0x82, 0x88, 0x41, 0x70, 0x00, 0x5A, 0x49, 0xCE, 0x79, 0x85, 0x27, 0x0C, 0xF6, 0xFB, 0xC0,
+    0x82, 0xD0, 0x00, 0xC1, 0x86, 0xF1, 0x46, 0xC8, 0x41, 0x79, 0x45, 0x52, 0x89, 0x62, 0x88, 0x6A,
+    0x86, 0x7A, 0xC6, 0xBB, 0xC4, 0xFC, 0xE1, 0x80, 0x25, 0x82, 0x4F, 0x0C, 0xFC, 0xE0, 0xE4, 0x60,
+    0x93, 0x03, 0x72, 0x84, 0x6A, 0x44, 0x41, 0xC5, 0x29, 0x45, 0x58, 0xC3, 0xA8, 0x41, 0x98, 0x40,
+    0xB0, 0x00, 0x60, 0x00, 0x6B, 0x0C, 0x85, 0x27, 0x1F, 0xEF, 0x7D, 0x83, 0xCE, 0x88, 0x82, 0xF8,
+    0x00, 0xD8, 0xC4, 0xF3, 0x0C, 0xFA, 0x8A, 0xE8, 0x82, 0xB0, 0x82, 0x69, 0x45, 0x51, 0xC7, 0x42,
+    0x08, 0x3A, 0x08, 0x5A, 0x86, 0x9B, 0x83, 0xBC, 0xA2, 0xCD, 0x22, 0xCD, 0x21, 0xC4, 0xA1, 0xB4,
+    0x22, 0x7A, 0xC4, 0x3A, 0x06, 0x29, 0x86, 0x29, 0x45, 0x31, 0x05, 0x50, 0xC4, 0x90, 0x41, 0xC0,
+    0x00, 0xA8, 0x00, 0xA0, 0x00, 0xA8, 0x00, 0x30, 0x00, 0x85, 0xC8, 0x06, 0xEF, 0x7D, 0x73, 0x8E,
+    0x18, 0xC3, 0x39, 0x05, 0xA8, 0x82, 0xF8, 0x00, 0xF8, 0xC3, 0x40, 0xFB, 0x4D, 0x06, 0xF9, 0xC7,
+    0xF0, 0xC3, 0xD8, 0x82, 0xB0, 0xC3, 0x81, 0x04, 0x61, 0x45, 0x51, 0x46, 0x40, 0x49, 0x86, 0x00,
+    0x41, 0x46, 0x41, 0x41, 0x45, 0x05, 0x49, 0x05, 0x61, 0x04, 0x90, 0x82, 0xB0, 0x41, 0xD0, 0x00,
+    0xC8, 0x00, 0x40, 0xA8, 0x00, 0x01, 0xB8, 0x00, 0x58, 0x41, 0x40, 0x10, 0x82, 0x01, 0x94, 0xB2,
+    0xF7, 0xBE, 0x81, 0x26, 0x11, 0xF7, 0xBE, 0x7B, 0xCF, 0x10, 0x82, 0x21, 0x04, 0x29, 0x86, 0x41,
+    0x86, 0x99, 0x04, 0xE8, 0x40, 0xF8, 0x41, 0xF9, 0x86, 0xFA, 0xCB, 0xFA, 0x49, 0xF8, 0x82, 0xF8,
+    0x00, 0xF0, 0x00, 0xE8, 0x00, 0xD8, 0x41, 0xD0, 0x41, 0x42, 0xC0, 0x41, 0x01, 0xC8, 0x41, 0xD0,
+    0x00, 0x40, 0xE0, 0x00, 0x05, 0xD8, 0x00, 0xD0, 0x00, 0xB8, 0x00, 0xA8, 0x00, 0x88, 0x41, 0x48,
+    0x82, 0x80, 0x26, 0x01, 0x00, 0x00, 0x29, 0x45, 0x81, 0x78, 0x0B, 0xF7, 0xBE, 0x9C, 0xF3, 0x10,
+    0x82, 0x18, 0xC3, 0x29, 0x45, 0x31, 0x86, 0x31, 0xC7, 0x7C, 0x30, 0xDC, 0xF3, 0xE1, 0x86, 0xF0,
+    0x00, 0xF8, 0x00, 0x40, 0xF8, 0x41, 0x48, 0xF8, 0x00, 0x00, 0xE8, 0x00, 0x81, 0x27, 0x04, 0xC8,
+    0x00, 0xA0, 0x41, 0x9A, 0x8A, 0x63, 0x0C, 0x11, 0x04, 0x80, 0x27, 0x07, 0x08, 0x41, 0x00, 0x00,
+    0x6B, 0x4D, 0xEF, 0x7D, 0xFF, 0xFF, 0xDE, 0xFB, 0x42, 0x08, 0x10, 0x42, 0x80, 0x26, 0x07, 0x31,
+    0x86, 0x4A, 0x49, 0xBE, 0x38, 0xFF, 0xFF, 0xD6, 0x38, 0xA9, 0x86, 0xC8, 0x00, 0xE0, 0x00, 0x80,
+    0x2A, 0x85, 0x00, 0x40, 0xF0, 0x00, 0x80, 0x27, 0x07, 0xD0, 0x00, 0x98, 0xC3, 0x8A, 0x8A, 0xA4,
+    0xB2, 0xC6, 0xBA, 0xB5, 0xF7, 0x42, 0x08, 0x08, 0x41, 0x81, 0x27, 0x05, 0x29, 0x45, 0xBD, 0xF7,
+    0xFF, 0xFF, 0x8C, 0x71, 0x08, 0x41, 0x21, 0x04, 0x81, 0x27, 0x0B, 0x63, 0x0C, 0xE7, 0x3C, 0xFF,
+    0xFF, 0xD6, 0x79, 0xB9, 0x46, 0xE0, 0x00, 0xC8, 0x42, 0xA8, 0x82, 0xB0, 0x82, 0xD8, 0x41, 0xE8,
+    0x82, 0xF0, 0x82, 0x41, 0xE8, 0x41, 0x0C, 0xF0, 0x41, 0xE8, 0x41, 0xD8, 0x41, 0xC1, 0x04, 0x92,
+    0x08, 0x8B, 0x4D, 0xA5, 0x34, 0xC6, 0xFB, 0xD6, 0xFB, 0xCE, 0xBA, 0xE7, 0x3C, 0x84, 0x30, 0x18,
+    0xC3, 0x40, 0x08, 0x41, 0x05, 0x00, 0x00, 0x08, 0x41, 0x7B, 0xCF, 0xEF, 0x7D, 0x4A, 0x49, 0x00,
+    0x00, 0x80, 0x27, 0x0E, 0x31, 0x46, 0x31, 0x86, 0x84, 0x30, 0xFF, 0xFF, 0xF7, 0xFF, 0xDD, 0xF7,
+    0xDA, 0x09, 0xF8, 0x83, 0xF0, 0x01, 0xC0, 0x42, 0x98, 0x82, 0x9A, 0x49, 0xB4, 0xF3, 0xCC, 0xF3,
+    0xBC, 0x71, 0x40, 0xBB, 0x8E, 0x0C, 0xBC, 0x30, 0xBC, 0x71, 0xBC, 0xF3, 0xBD, 0xB6, 0xCE, 0xFB,
+    0xE7, 0xBE, 0xE7, 0x7D, 0xDF, 0x3B, 0xD6, 0xBA, 0xCE, 0x79, 0xDE, 0xFB, 0xAD, 0x75, 0x31, 0x86,
+    0x81, 0x27, 0x03, 0x00, 0x00, 0x4A, 0x49, 0xDE, 0xFB, 0x21, 0x04, 0x81, 0x4F, 0x02, 0x29, 0x45,
+    0x39, 0x87, 0x94, 0xB2, 0x80, 0xA7, 0x07, 0xDD, 0x34, 0xEB, 0x0C, 0xFA, 0x09, 0xF0, 0x00, 0xD8,
+    0x01, 0xD8, 0x00, 0xD2, 0x8B, 0xE7, 0x7D, 0x46, 0xFF, 0xFF, 0x01, 0xFF, 0xBE, 0xEF, 0x7D, 0x40,
+    0xDE, 0xFB, 0x80, 0x27, 0x02, 0xD6, 0xBA, 0xC6, 0x78, 0x39, 0xC7, 0x80, 0x4D, 0x80, 0x27, 0x02,
+    0x39, 0xC7, 0xCE, 0x79, 0x00, 0x00, 0x80, 0xC6, 0x03, 0x21, 0x04, 0x29, 0x05, 0x31, 0x86, 0x9C,
+    0xB3, 0x80, 0x4F, 0x07, 0xDD, 0x75, 0xE9, 0xC7, 0xF9, 0xC7, 0xF8, 0x01, 0xF0, 0x01, 0xE8, 0x00,
+    0xE2, 0x49, 0xEE, 0xFB, 0x86, 0x27, 0x00, 0xF7, 0xBE, 0x84, 0x27, 0x01, 0xCE, 0xB9, 0x42, 0x08,
+    0x42, 0x00, 0x00, 0x01, 0x39, 0xC7, 0xC6, 0x38, 0x80, 0x27, 0x00, 0x10, 0x82, 0x40, 0x21, 0x04,
+    0x00, 0x29, 0x45, 0x80, 0x77, 0x04, 0xFF, 0xFF, 0xDE, 0x38, 0xD0, 0xC4, 0xF0, 0x00, 0xF8, 0x01,
+    0x80, 0xBF, 0x01, 0xD2, 0x08, 0xE6, 0xFB, 0x89, 0x27, 0x80, 0x26, 0x80, 0x27, 0x01, 0xCE, 0x79,
+    0x39, 0xC7, 0x81, 0x4E, 0x01, 0x00, 0x00, 0x31, 0x86, 0x80, 0x27, 0x03, 0x00, 0x00, 0x18, 0xC3,
+    0x5A, 0xCB, 0x31, 0x86, 0x80, 0x02, 0x80, 0xF8, 0x02, 0xEF, 0x7D, 0xBB, 0xCF, 0xB0, 0xC3, 0x40,
+    0xD0, 0x41, 0x01, 0xB8, 0x82, 0xB3, 0x4D, 0x86, 0x77, 0x40, 0xF7, 0xBE, 0x00, 0xEF, 0x3D, 0x82,
+    0x27, 0x04, 0xD6, 0xFA, 0xBD, 0xF7, 0x21, 0x04, 0x31, 0x86, 0x21, 0x04, 0x82, 0x27, 0x81, 0x23,
+    0x03, 0xAD, 0x75, 0x7B, 0xCF, 0x08, 0x41, 0x31, 0x86, 0x80, 0xF8, 0x02, 0xFF, 0xFF, 0xEF, 0xBE,
+    0xB5, 0x74, 0x40, 0x9C, 0x30, 0x01, 0xA4, 0x72, 0xD6, 0xBB, 0x88, 0x4E, 0x00, 0xE7, 0x3C, 0x82,
+    0x27, 0x0B, 0xE7, 0x3C, 0x8C, 0x71, 0x08, 0x81, 0x63, 0x0C, 0x7B, 0xCF, 0x10, 0x82, 0x00, 0x00,
+    0x52, 0x8A, 0xC6, 0x38, 0xAD, 0x75, 0x8C, 0x71, 0xB5, 0xB6, 0x80, 0x10, 0x80, 0xAB, 0x00, 0x73,
+    0xCF, 0x4D, 0xFF, 0xFF, 0x80, 0x26, 0x02, 0xEF, 0x7D, 0xDF, 0x3B, 0xD6, 0xFA, 0x80, 0x26, 0x09,
+    0xDE, 0xFB, 0xCE, 0xB9, 0x39, 0xC7, 0x20, 0xC4, 0x8C, 0x71, 0xD6, 0xBA, 0x8C, 0x71, 0x5A, 0xCB,
+    0x94, 0xB2, 0xD6, 0xBA, 0x80, 0x6F, 0x80, 0x72, 0x04, 0xFF, 0xFF, 0xB5, 0xB6, 0x29, 0x46, 0x19,
+    0x05, 0xA5, 0x75, 0x8E, 0x27, 0x82, 0x4E, 0x07, 0xD6, 0xBA, 0xDE, 0xFC, 0x63, 0x4E, 0x08, 0x42,
+    0x63, 0x0C, 0xBD, 0xF7, 0xF7, 0xBE, 0xFF, 0xFF, 0x80, 0xD1, 0x80, 0x03, 0x83, 0x00, 0x03, 0x9C,
+    0xF4, 0x21, 0x04, 0x21, 0x05, 0xA5, 0xB6, 0x8A, 0x25, 0x84, 0x26, 0x06, 0xDE, 0xFB, 0xD6, 0xBB,
+    0x73, 0xD1, 0x18, 0x83, 0x39, 0x86, 0x9D, 0x34, 0xEF, 0xBD, 0x87, 0x16, 0x07, 0xFF, 0xBE, 0xD6,
+    0x35, 0xCC, 0xEB, 0xB3, 0x43, 0x51, 0x40, 0x19, 0x05, 0x8C, 0xF5, 0xEF, 0xBE, 0x88, 0x25, 0x81,
+    0x26, 0x09, 0xDE, 0xBA, 0xD6, 0xBA, 0xDF, 0x3C, 0xBE, 0x3A, 0x63, 0x4F, 0x49, 0x82, 0xA3, 0x40,
+    0xB4, 0x23, 0x83, 0xCC, 0xBE, 0x3A, 0x86, 0x26, 0x0A, 0xF7, 0xBF, 0xBD, 0xB5, 0x92, 0x82, 0xF4,
+    0x20, 0xFC, 0xA0, 0xE4, 0x60, 0x82, 0x40, 0x41, 0x84, 0x6B, 0x8F, 0xAD, 0x77, 0xE7, 0x3D, 0x80,
+    0x0C, 0x00, 0xFF, 0xFE, 0x41, 0xF7, 0xBE, 0x82, 0x26, 0x0B, 0xDE, 0xFB, 0xE7, 0x3D, 0xCE, 0xBB,
+    0x9D, 0x36, 0x6B, 0x0B, 0x6A, 0x41, 0xC4, 0x60, 0xFE, 0x20, 0xF5, 0x60, 0x8B, 0x00, 0x6A, 0xC7,
+    0xC6, 0x38, 0x85, 0x74, 0x02, 0xEF, 0x7D, 0x7B, 0x4B, 0xB2, 0x80, 0x40, 0xFC, 0xA0, 0x40, 0xFC,
+    0xE0, 0x07, 0xCB, 0xC0, 0x8A, 0xC1, 0x62, 0x45, 0x6B, 0x4D, 0x94, 0xB3, 0xBD, 0xF7, 0xDF, 0x3D,
+    0xF7, 0xFF, 0x82, 0xC3, 0x07, 0xE7, 0x7D, 0xDF, 0x3D, 0xC6, 0xBA, 0xA5, 0x75, 0x7B, 0x8D, 0x7A,
+    0x84, 0xB3, 0x40, 0xEC, 0xE0, 0x40, 0xFD, 0xE0, 0x04, 0xF5, 0x60, 0xE5, 0x20, 0xD4, 0xA0, 0x6B,
+    0x0A, 0xDE, 0xFB, 0x85, 0x27, 0x02, 0x93, 0xCC, 0xEB, 0x40, 0xFC, 0x60, 0x80, 0x27, 0x13, 0xFD,
+    0x20, 0xFD, 0x60, 0xF5, 0x20, 0xD4, 0xA0, 0xBB, 0xC0, 0x9B, 0x42, 0x8B, 0x45, 0x9C, 0x6B, 0x9C,
+    0xAE, 0x8C, 0x71, 0x94, 0xB3, 0x9D, 0x33, 0xA5, 0x34, 0xA4, 0xF2, 0xB4, 0xF0, 0x9B, 0xCA, 0x9B,
+    0x04, 0xBB, 0x40, 0xE4, 0x20, 0xFD, 0x20, 0x40, 0xFD, 0xA0, 0x41, 0xFD, 0xE0, 0x02, 0xC4, 0x20,
+    0x5A, 0x88, 0xBE, 0x38, 0x85, 0x78, 0x03, 0xD6, 0x78, 0xAB, 0x46, 0xDB, 0x40, 0xF4, 0x20, 0x81,
+    0x29, 0x01, 0xFD, 0x60, 0xFD, 0xA0, 0x80, 0x2A, 0x0A, 0xDC, 0xA0, 0xB3, 0xC0, 0x51, 0xC0, 0x29,
+    0x86, 0x63, 0x0D, 0x7B, 0x8F, 0x5B, 0x0D, 0x41, 0xC7, 0x82, 0x01, 0xC3, 0x00, 0xE3, 0xC0, 0x81,
+    0x11, 0x00, 0xFC, 0xE0, 0x40, 0xF5, 0x60, 0x04, 0xE5, 0x20, 0x9B, 0x80, 0x62, 0x86, 0x84, 0x30,
+    0xCE, 0x79, 0x86, 0xA1, 0x04, 0xC6, 0x38, 0x9C, 0x2D, 0x93, 0x05, 0xA3, 0x43, 0xB3, 0x82, 0x40,
+    0xBB, 0xC2, 0x0F, 0xB4, 0x22, 0xA3, 0x82, 0x93, 0x42, 0x7A, 0xC3, 0x62, 0x85, 0x63, 0x0B, 0x84,
+    0x71, 0xB5, 0xB6, 0xCE, 0x79, 0xC6, 0x79, 0xAD, 0xB5, 0x94, 0x70, 0x8B, 0x4A, 0x83, 0x06, 0x93,
+    0x04, 0x9B, 0x04, 0x40, 0x9B, 0x43, 0x06, 0x93, 0x43, 0x83, 0x04, 0x73, 0x08, 0x73, 0x8D, 0x94,
+    0xB3, 0xCE, 0x79, 0xEF, 0x7D, 0x87, 0xF1, 0x02, 0xDF, 0x3C, 0xBE, 0x38, 0xB5, 0x75, 0x40, 0xA5,
+    0x33, 0x41, 0x9C, 0xF3, 0x04, 0x94, 0xF3, 0x9C, 0xF3, 0xA5, 0x35, 0xBD, 0xF8, 0xDE, 0xFB, 0x82,
+    0xB6, 0x0B, 0xEF, 0x7E, 0xD6, 0xBB, 0xBD, 0xF8, 0xAD, 0xB6, 0xAD, 0x75, 0xA5, 0x34, 0x9D, 0x33,
+    0x9D, 0x34, 0xA5, 0x35, 0xAD, 0xB7, 0xC6, 0x79, 0xE7, 0x3C, 0x83, 0xC6,
+};
+const PackedImage penguin = {40, 40, PACKED_LZ565, sizeof(penguin_data), penguin_data};
+
+// icon_40x40: 40x40, LZ565, 1889 bytes (raw 3200, 59%)
+static const uint8_t icon_40x40_data[1889] = {
+    0x72, 0xFF, 0xFF, 0x01, 0xEF, 0x5D, 0x8C, 0x71, 0x40, 0x84, 0x31, 0x02, 0xC5, 0x93, 0xCD, 0x92,
+    0xCD, 0x91, 0x40, 0xD5, 0x91, 0x06, 0xCD, 0x91, 0xCD, 0x72, 0xC5, 0x72, 0xDE, 0x56, 0xFF, 0xBE,
+    0xDE, 0xDB, 0xDE, 0xFB, 0x96, 0x27, 0x00, 0x7B, 0xCE, 0x41, 0x00, 0x00, 0x00, 0x5A, 0x00, 0x43,
+    0xDD, 0x20, 0x06, 0xD4, 0xE0, 0xD4, 0xA0, 0xA3, 0x61, 0x39, 0xA7, 0x18, 0xE5, 0x21, 0x05, 0x94,
+    0x92, 0x93, 0x25, 0x08, 0xEE, 0xF9, 0x9B, 0xEB, 0x18, 0xA1, 0x73, 0x23, 0xC5, 0x81, 0x9C, 0x21,
+    0x39, 0x61, 0xEE, 0x81, 0xFF, 0x40, 0x41, 0xFE, 0xE0, 0x07, 0xFF, 0x40, 0xF6, 0xC0, 0x49, 0xC0,
+    0x18, 0xA0, 0x42, 0x00, 0x18, 0x60, 0x00, 0x00, 0xB5, 0x74, 0x91, 0x26, 0x04, 0xCD, 0x93, 0xBB,
+    0xC3, 0x51, 0xA0, 0x39, 0xE1, 0xFF, 0xC2, 0x40, 0xFF, 0xE0, 0x01, 0xBD, 0x63, 0xE6, 0x61, 0x81,
+    0x27, 0x0A, 0xFE, 0xC0, 0xFF, 0x60, 0x73, 0x21, 0x28, 0xE1, 0xEE, 0x81, 0xFF, 0x61, 0xEE, 0x21,
+    0x41, 0xA0, 0x08, 0x20, 0xCD, 0x90, 0xFF, 0xDE, 0x8D, 0x25, 0x06, 0xF7, 0x5C, 0xAC, 0x0B, 0xB3,
+    0xC0, 0xEE, 0xA1, 0x5A, 0xC3, 0x8C, 0x22, 0xFF, 0xE1, 0x40, 0xFF, 0x40, 0x01, 0xFF, 0xC0, 0xFF,
+    0x80, 0x41, 0xFF, 0x20, 0x0B, 0xFF, 0x00, 0xFF, 0x20, 0xAC, 0xA1, 0xC5, 0x21, 0xFF, 0x20, 0xFE,
+    0x60, 0xFF, 0x00, 0xDE, 0x02, 0x20, 0xE0, 0x82, 0x40, 0xBC, 0x49, 0xEF, 0x3B, 0x8C, 0x26, 0x06,
+    0x9B, 0x67, 0xB3, 0xE0, 0xFF, 0x81, 0xFF, 0xC3, 0x9C, 0x83, 0xDE, 0x82, 0xFF, 0xC0, 0x40, 0xFF,
+    0x60, 0x00, 0xFF, 0x40, 0x80, 0x01, 0x80, 0x00, 0x80, 0x28, 0x80, 0x05, 0x08, 0xFE, 0xA0, 0xFE,
+    0x80, 0xFE, 0x40, 0xFE, 0xE0, 0xB4, 0xA2, 0xBC, 0x41, 0xCC, 0x20, 0xA3, 0x87, 0xE6, 0xB8, 0x89,
+    0x26, 0x08, 0xF7, 0x9D, 0xA3, 0xA8, 0xBC, 0x60, 0xFF, 0xA2, 0xFF, 0xA5, 0xFF, 0x44, 0xFF, 0xA1,
+    0xFF, 0xA0, 0xFF, 0x60, 0x42, 0xFF, 0x80, 0x81, 0x2B, 0x80, 0x28, 0x80, 0x29, 0x00, 0xFE, 0xC0,
+    0x81, 0x28, 0x05, 0xFE, 0x60, 0xFE, 0x20, 0xFE, 0x40, 0xCB, 0xE0, 0x92, 0xE3, 0xF7, 0x7C, 0x88,
+    0x27, 0x05, 0xAC, 0x4C, 0xB3, 0xC0, 0xFF, 0xA4, 0xFF, 0xA6, 0xFF, 0x45, 0xFF, 0x62, 0x81, 0x23,
+    0x42, 0xFF, 0xA0, 0x82, 0x2A, 0x81, 0x29, 0x80, 0xA4, 0x08, 0xFE, 0x80, 0xFE, 0x60, 0xFE, 0x40,
+    0xFE, 0x20, 0xFE, 0x00, 0xFD, 0xE0, 0xC3, 0xE0, 0xAC, 0x2A, 0xF7, 0x7D, 0x86, 0x26, 0x04, 0xD5,
+    0xD4, 0xAB, 0x40, 0xFF, 0x43, 0xFF, 0xA8, 0xFF, 0x67, 0x81, 0x26, 0x80, 0x23, 0x41, 0xFF, 0xC0,
+    0x83, 0x29, 0x81, 0x28, 0x01, 0xFF, 0x00, 0xFE, 0xE0, 0x81, 0x50, 0x00, 0xFE, 0x20, 0x40, 0xFD,
+    0xE0, 0x02, 0xFD, 0xC0, 0xA2, 0xA0, 0xBD, 0x11, 0x85, 0x26, 0x05, 0xE6, 0xDA, 0x9A, 0xE4, 0xE5,
+    0xE1, 0xFF, 0xE8, 0xFF, 0x69, 0xFF, 0x65, 0x80, 0x73, 0x80, 0x25, 0x42, 0xFF, 0xE0, 0x82, 0x29,
+    0x82, 0x28, 0x40, 0xFF, 0x00, 0x80, 0x52, 0x80, 0x77, 0x05, 0xFE, 0x00, 0xFD, 0xC0, 0xFD, 0xE0,
+    0xE4, 0xE0, 0xAB, 0x85, 0xE6, 0xFA, 0x84, 0x27, 0x05, 0xB4, 0x2B, 0xB3, 0xC0, 0xFF, 0xC8, 0xFF,
+    0x8C, 0xFF, 0x68, 0xFF, 0x61, 0x81, 0x4C, 0x04, 0xFF, 0xE0, 0xFF, 0xE1, 0xDE, 0xA1, 0xEF, 0x61,
+    0xFF, 0xE1, 0x83, 0x29, 0x81, 0x27, 0x03, 0xFF, 0x60, 0xFF, 0xC0, 0xDE, 0x61, 0xE6, 0x00, 0x80,
+    0x50, 0x80, 0x77, 0x80, 0x28, 0x01, 0xC3, 0xC0, 0xAB, 0xE9, 0x83, 0x26, 0x05, 0xEF, 0x5D, 0xAB,
+    0xA3, 0xF6, 0xA3, 0xFF, 0xCC, 0xFF, 0x4C, 0xFF, 0x64, 0x82, 0x4D, 0x04, 0xEF, 0x61, 0x6B, 0x22,
+    0x5A, 0x82, 0xB5, 0x82, 0xFF, 0xE2, 0x81, 0x28, 0x00, 0xFF, 0xE0, 0x81, 0x27, 0x04, 0xFF, 0xA0,
+    0xFF, 0xE1, 0x8C, 0x42, 0x41, 0xC1, 0xA4, 0x21, 0x80, 0x79, 0x80, 0x78, 0x04, 0xFD, 0xC0, 0xFD,
+    0xA0, 0xF5, 0x20, 0x9A, 0xC0, 0xD6, 0x35, 0x82, 0x27, 0x05, 0xC5, 0x51, 0xBC, 0x60, 0xFF, 0xC9,
+    0xFF, 0x8E, 0xFF, 0x6A, 0xFF, 0x61, 0x81, 0x27, 0x07, 0xFF, 0xE1, 0x62, 0xE1, 0x10, 0x80, 0xE7,
+    0x05, 0xF7, 0xA4, 0xFF, 0xE4, 0xFF, 0xE3, 0xFF, 0xE2, 0x81, 0x51, 0x80, 0x5C, 0x05, 0xFF, 0xC1,
+    0x83, 0xE2, 0x08, 0x40, 0xCE, 0x22, 0xF7, 0x60, 0xFE, 0xA0, 0x80, 0x78, 0x80, 0x27, 0x03, 0xFD,
+    0x80, 0xFD, 0xA0, 0xC3, 0xA0, 0xBC, 0xAC, 0x81, 0x26, 0x05, 0xFF, 0xDE, 0xAB, 0xA7, 0xDD, 0x81,
+    0xFF, 0xED, 0xFF, 0xB0, 0xFF, 0x69, 0x81, 0x9D, 0x07, 0xFF, 0xE0, 0xD6, 0x61, 0x29, 0x22, 0x31,
+    0xA6, 0x7B, 0xE3, 0xEF, 0x46, 0xFF, 0xE6, 0xFF, 0xE4, 0x81, 0x51, 0x80, 0x27, 0x06, 0xFF, 0xE0,
+    0xD6, 0x81, 0x18, 0xA0, 0x18, 0xC4, 0x62, 0xA1, 0xCD, 0xC1, 0xFF, 0x40, 0x83, 0x27, 0x03, 0xFD,
+    0x80, 0xEC, 0xA0, 0xBC, 0x48, 0xFF, 0xDF, 0x80, 0x27, 0x05, 0xE6, 0xF9, 0x9A, 0xE3, 0xEE, 0x67,
+    0xFF, 0xD1, 0xFF, 0xB0, 0xFF, 0x86, 0x82, 0x27, 0x07, 0x94, 0x60, 0x73, 0x91, 0xBD, 0xD9, 0x00,
+    0x00, 0x84, 0x05, 0xFF, 0xE8, 0xFF, 0xE5, 0xFF, 0xE3, 0x83, 0x27, 0x05, 0xAD, 0x20, 0x41, 0xE9,
+    0xB5, 0xB7, 0x00, 0x01, 0x62, 0x60, 0xFF, 0x21, 0x82, 0x77, 0x04, 0xFD, 0x80, 0xFD, 0x60, 0xF5,
+    0x20, 0xBB, 0xE3, 0xE6, 0xD9, 0x80, 0x27, 0x05, 0xCD, 0xD3, 0xA3, 0x40, 0xF7, 0x2B, 0xFF, 0xD3,
+    0xFF, 0xB0, 0xFF, 0x63, 0x82, 0x27, 0x05, 0x9C, 0xA0, 0x6B, 0x30, 0xB5, 0x97, 0x00, 0x00, 0x52,
+    0x83, 0xFF, 0xC6, 0x86, 0x27, 0x05, 0x41, 0xEA, 0xAD, 0x77, 0x00, 0x01, 0x49, 0xC0, 0xF6, 0xE0,
+    0xFE, 0xA0, 0x83, 0x27, 0x02, 0xFD, 0x40, 0xBB, 0xA0, 0xCD, 0xD3, 0x80, 0x27, 0x05, 0xCD, 0x50,
+    0xB4, 0x00, 0xFF, 0x8E, 0xFF, 0xF4, 0xFF, 0xB0, 0xFF, 0x42, 0x82, 0x27, 0x01, 0xDE, 0xA1, 0x21,
+    0x01, 0x40, 0x00, 0x00, 0x00, 0x8C, 0x25, 0x80, 0x26, 0x83, 0x9F, 0x01, 0xFF, 0xE0, 0xDE, 0xE1,
+    0x81, 0x0C, 0x01, 0x5A, 0x61, 0xFF, 0x20, 0x80, 0x4F, 0x80, 0xF0, 0x00, 0xFD, 0xA0, 0x40, 0xFD,
+    0x60, 0x01, 0xCB, 0xC0, 0xCD, 0x71, 0x81, 0x27, 0x04, 0xC4, 0x40, 0xFF, 0xB0, 0xFF, 0xF5, 0xFF,
+    0x8F, 0xFF, 0x41, 0x82, 0xEE, 0x04, 0xFF, 0xE1, 0x8C, 0x21, 0x10, 0x60, 0x6B, 0x43, 0xEF, 0x44,
+    0x40, 0xFF, 0xE2, 0x82, 0x4E, 0x40, 0xFF, 0x80, 0x05, 0xFF, 0xE1, 0xA4, 0xC1, 0x18, 0xC2, 0x39,
+    0xA2, 0xCD, 0xA1, 0xFF, 0x20, 0x80, 0x9F, 0x81, 0x9E, 0x80, 0x27, 0x01, 0xCB, 0xE0, 0xCD, 0x91,
+    0x82, 0x27, 0x03, 0xFF, 0xD2, 0xFF, 0xF7, 0xFF, 0xAF, 0xFF, 0x01, 0x40, 0xFF, 0x00, 0x00, 0xFF,
+    0x40, 0x80, 0x43, 0x02, 0xFF, 0xA1, 0xD6, 0x82, 0xFF, 0xC2, 0x42, 0xFF, 0xE0, 0x40, 0xFF, 0xC0,
+    0x80, 0x27, 0x40, 0xFF, 0x60, 0x07, 0xFF, 0xC1, 0xDE, 0x82, 0xEE, 0xC2, 0xFF, 0x61, 0xFE, 0x80,
+    0xFD, 0xC0, 0xFD, 0x20, 0xFC, 0xA1, 0x40, 0xFC, 0x61, 0x00, 0xFC, 0xC0, 0x80, 0x27, 0x00, 0xC5,
+    0x51, 0x81, 0x27, 0x08, 0xC4, 0x60, 0xFF, 0xD4, 0xFF, 0xF9, 0xFF, 0x2D, 0xFE, 0x00, 0xFD, 0xC0,
+    0xFD, 0xA1, 0xFE, 0x21, 0xFE, 0xE0, 0x80, 0x51, 0x83, 0x00, 0x82, 0x26, 0x80, 0x27, 0x40, 0xFF,
+    0x40, 0x01, 0xFF, 0x80, 0xFF, 0x20, 0x80, 0x9D, 0x08, 0xFD, 0x01, 0xFC, 0x01, 0xFB, 0x62, 0xFB,
+    0x42, 0xFB, 0x82, 0xFC, 0x21, 0xFD, 0x20, 0xD4, 0x00, 0xC5, 0x71, 0x81, 0x27, 0x04, 0xC4, 0x20,
+    0xFF, 0xD4, 0xFF, 0xBA, 0xFE, 0x2E, 0xFC, 0xE1, 0x80, 0x35, 0x02, 0xFD, 0x01, 0xFE, 0x01, 0xFF,
+    0x20, 0x40, 0xFF, 0xA0, 0x42, 0xFF, 0xC0, 0x80, 0x05, 0x83, 0x26, 0x06, 0xFF, 0x00, 0xFE, 0xC0,
+    0xFE, 0xA0, 0xFE, 0x80, 0xFD, 0x80, 0xFC, 0x61, 0xFB, 0x62, 0x40, 0xFA, 0xA3, 0x03, 0xFB, 0x42,
+    0xFC, 0x01, 0xFC, 0xE0, 0xCB, 0xE0, 0x82, 0x9F, 0x09, 0xB3, 0xC0, 0xFF, 0xB3, 0xFF, 0x7A, 0xFD,
+    0x91, 0xFC, 0x03, 0xFB, 0x02, 0xFB, 0x22, 0xFC, 0x62, 0xFD, 0x81, 0xFE, 0xC0, 0x44, 0xFF, 0xA0,
+    0x81, 0x25, 0x81, 0x26, 0x01, 0xFF, 0x20, 0xFE, 0xE0, 0x80, 0x27, 0x04, 0xFE, 0x60, 0xFD, 0x60,
+    0xFC, 0x41, 0xFB, 0x62, 0xFA, 0xC3, 0x81, 0x27, 0x01, 0xFD, 0x20, 0xCB, 0xC0, 0x81, 0x9F, 0x0A,
+    0xD6, 0x14, 0xAB, 0x20, 0xF7, 0x51, 0xFF, 0xBE, 0xFE, 0x17, 0xFC, 0x65, 0xFB, 0x61, 0xFB, 0xA2,
+    0xFC, 0xA1, 0xFD, 0xC1, 0xFF, 0x00, 0x45, 0xFF, 0x80, 0x41, 0xFF, 0x60, 0x80, 0x26, 0x82, 0x4E,
+    0x0A, 0xFE, 0x60, 0xFD, 0xC0, 0xFC, 0xC0, 0xFC, 0x41, 0xFB, 0xC1, 0xFB, 0xA2, 0xFC, 0x01, 0xFC,
+    0xA0, 0xFD, 0x40, 0xC3, 0xA0, 0xD5, 0xF4, 0x80, 0x27, 0x0A, 0xEF, 0x5B, 0x9B, 0x24, 0xE6, 0x49,
+    0xFF, 0xB8, 0xFE, 0x92, 0xFD, 0x25, 0xFC, 0xA0, 0xFD, 0x02, 0xFD, 0xE1, 0xFE, 0xE0, 0xFF, 0x40,
+    0x80, 0x1E, 0x42, 0xFF, 0x60, 0x42, 0xFF, 0x40, 0x83, 0x26, 0x40, 0xFE, 0x40, 0x09, 0xFE, 0x00,
+    0xFD, 0x80, 0xF5, 0x01, 0xFD, 0x41, 0xFD, 0x01, 0xFC, 0xC0, 0xFD, 0x40, 0xF5, 0x00, 0xBB, 0xC4,
+    0xE6, 0xFA, 0x41, 0xFF, 0xFF, 0x08, 0xB4, 0x2A, 0xD4, 0xA0, 0xFE, 0xA2, 0xFE, 0x20, 0xFD, 0xE0,
+    0xFE, 0x00, 0xFE, 0x80, 0xEE, 0x21, 0xE6, 0x41, 0x46, 0xFF, 0x40, 0x40, 0xFF, 0x20, 0x00, 0xFF,
+    0x00, 0x81, 0x74, 0x80, 0x4D, 0x80, 0x26, 0x80, 0x00, 0x06, 0xCC, 0x40, 0xAB, 0xE1, 0xED, 0xC1,
+    0xFD, 0x80, 0xFD, 0x60, 0xE4, 0x60, 0xB4, 0x29, 0x42, 0xFF, 0xFF, 0x02, 0xD6, 0x15, 0xBB, 0xE0,
+    0xFE, 0x60, 0x40, 0xFE, 0xC8, 0x03, 0xFF, 0x02, 0xDD, 0x60, 0xA3, 0x40, 0xDD, 0xA1, 0x81, 0x20,
+    0x83, 0x00, 0x81, 0x25, 0x83, 0x26, 0x42, 0xFE, 0x20, 0x06, 0xED, 0x40, 0x9A, 0xC0, 0xA3, 0x40,
+    0xF5, 0x80, 0xFD, 0x60, 0xBB, 0x60, 0xBC, 0xEE, 0x82, 0x27, 0x09, 0xFF, 0xDF, 0xAB, 0x63, 0xE5,
+    0x42, 0xFF, 0xB4, 0xFF, 0x97, 0xF6, 0xAA, 0xAB, 0x80, 0x92, 0xA0, 0xDD, 0xA1, 0xFF, 0x41, 0x86,
+    0x76, 0x83, 0x2A, 0x0C, 0xFE, 0x80, 0xFE, 0x61, 0xFE, 0x00, 0xED, 0xA0, 0xE5, 0x20, 0xCC, 0x21,
+    0xB3, 0x80, 0xBC, 0x00, 0xC3, 0xE0, 0xED, 0x40, 0xEC, 0xC0, 0x92, 0x60, 0xE6, 0x97, 0x43, 0xFF,
+    0xFF, 0x0C, 0xC5, 0x0F, 0xA3, 0x00, 0xF6, 0xAA, 0xFF, 0x93, 0xEE, 0x2D, 0xDD, 0x63, 0xD5, 0x80,
+    0xB4, 0x42, 0xCC, 0x82, 0xCD, 0x00, 0xD5, 0x40, 0xDD, 0xA0, 0xE5, 0xE1, 0x42, 0xE5, 0xC1, 0x06,
+    0xDD, 0x80, 0xDD, 0x60, 0xD5, 0x20, 0xCC, 0xC0, 0xCC, 0xA0, 0xC4, 0x61, 0xC4, 0x21, 0x40, 0xBC,
+    0x01, 0x07, 0xBB, 0xE0, 0xBB, 0xC0, 0xD4, 0x60, 0xFD, 0x80, 0xFD, 0x40, 0xFD, 0x80, 0xBB, 0x80,
+    0xAC, 0x2B, 0x44, 0xFF, 0xFF, 0x0B, 0xF7, 0x9D, 0xA3, 0x87, 0xD4, 0x60, 0xFF, 0x0A, 0xFE, 0xCF,
+    0xFE, 0xC9, 0xFE, 0xC0, 0xF6, 0xC0, 0xE6, 0x40, 0xCD, 0x41, 0xB4, 0x42, 0xAB, 0xC1, 0x40, 0xA3,
+    0x60, 0x41, 0xA3, 0x80, 0x09, 0xAB, 0xA0, 0xAB, 0xC1, 0xB3, 0xE1, 0xB4, 0x22, 0xC4, 0x82, 0xCC,
+    0xC0, 0xD5, 0x00, 0xE5, 0x60, 0xED, 0x81, 0xF5, 0x80, 0x40, 0xFD, 0x80, 0x80, 0x26, 0x02, 0xE4,
+    0x80, 0xAB, 0x85, 0xEF, 0x5C, 0x45, 0xFF, 0xFF, 0x09, 0xE6, 0xFA, 0xA3, 0x23, 0xE4, 0xE0, 0xFE,
+    0xE8, 0xFE, 0x6A, 0xFE, 0x05, 0xFE, 0x40, 0xFE, 0xA0, 0xFE, 0xC0, 0xFE, 0xE1, 0x42, 0xF6, 0xA0,
+    0x41, 0xF6, 0x80, 0x06, 0xF6, 0x60, 0xFE, 0x61, 0xFE, 0x81, 0xFE, 0x61, 0xFE, 0x20, 0xFE, 0x00,
+    0xFD, 0xC0, 0x80, 0xC1, 0x40, 0xFD, 0x20, 0x03, 0xFD, 0x60, 0xF5, 0x20, 0xA2, 0xA0, 0xCD, 0xB4,
+    0x47, 0xFF, 0xFF, 0x05, 0xC5, 0x52, 0xA2, 0xE0, 0xF5, 0xA1, 0xFE, 0x86, 0xFE, 0x06, 0xFD, 0xE2,
+    0x80, 0xF4, 0x81, 0xB8, 0x82, 0xBD, 0x00, 0xFE, 0x00, 0x40, 0xFD, 0xE0, 0x01, 0xFD, 0xC0, 0xFD,
+    0xA0, 0x80, 0x24, 0x00, 0xFD, 0x40, 0x41, 0xFD, 0x20, 0x00, 0xFD, 0x40, 0x80, 0xC4, 0x01, 0xB4,
+    0x6C, 0xFF, 0xDE, 0x48, 0xFF, 0xFF, 0x06, 0xCD, 0x92, 0xA2, 0xC0, 0xED, 0x20, 0xFE, 0x22, 0xFD,
+    0xC1, 0xFD, 0xA0, 0xFD, 0xC0, 0x43, 0xFD, 0xE0, 0x42, 0xFD, 0xC0, 0x80, 0x25, 0x84, 0x26, 0x80,
+    0x04, 0x02, 0xB3, 0x20, 0xA3, 0xEA, 0xF7, 0x9D, 0x4A, 0xFF, 0xFF, 0x02, 0xBC, 0x8E, 0xA2, 0xE1,
+    0xE5, 0x00, 0x81, 0x43, 0x81, 0x00, 0x83, 0x04, 0x85, 0x25, 0x04, 0xFD, 0x20, 0xFD, 0x80, 0xF5,
+    0x00, 0xBB, 0x40, 0xAC, 0x2B, 0x8B, 0x26, 0x80, 0x00, 0x04, 0xD6, 0x35, 0x9A, 0xE2, 0xC3, 0xA0,
+    0xFD, 0xA0, 0xFD, 0xE0, 0x80, 0x1E, 0x81, 0x21, 0x82, 0x00, 0x40, 0xFD, 0x40, 0x82, 0x72, 0x03,
+    0xFD, 0x60, 0xD4, 0x00, 0x9A, 0xC1, 0xC5, 0x10, 0x89, 0x74, 0x84, 0x00, 0x03, 0xDE, 0x98, 0xAC,
+    0x2B, 0xB3, 0x40, 0xD4, 0x00, 0x80, 0xDC, 0x81, 0x48, 0x85, 0x00, 0x80, 0x08, 0x03, 0xDC, 0x40,
+    0xBB, 0x80, 0xAB, 0xE8, 0xDE, 0x57, 0x51, 0xFF, 0xFF, 0x06, 0xFF, 0xDF, 0xD6, 0x37, 0xA3, 0x86,
+    0x9A, 0xC0, 0xCB, 0xE0, 0xEC, 0x80, 0xF4, 0xE0, 0x44, 0xFD, 0x20, 0x06, 0xF5, 0x00, 0xEC, 0xA0,
+    0xD4, 0x00, 0xB3, 0x40, 0x9B, 0x03, 0xC5, 0x92, 0xF7, 0xBD, 0x54, 0xFF, 0xFF, 0x05, 0xF7, 0xBE,
+    0xCD, 0xF5, 0xBC, 0xAD, 0xBC, 0x69, 0xBC, 0x05, 0xC4, 0x03, 0x42, 0xC4, 0x01, 0x05, 0xC3, 0xE2,
+    0xC4, 0x24, 0xBC, 0x68, 0xBC, 0xAC, 0xCD, 0xD3, 0xF7, 0x9E, 0x5A, 0xFF, 0xFF, 0x02, 0xEF, 0x5B,
+    0xDE, 0x98, 0xD6, 0x56, 0x40, 0xD6, 0x57, 0x02, 0xD6, 0x56, 0xDE, 0x77, 0xEF, 0x1B, 0x76, 0xFF,
+    0xFF,
+};
+const PackedImage icon_40x40 = {40, 40, PACKED_LZ565, sizeof(icon_40x40_data), icon_40x40_data};
+
+// wifi_full: 32x32, LZ565, 715 bytes (raw 2048, 35%)
+static const uint8_t wifi_full_data[715] = {
+    0x41, 0x00, 0x00, 0x00, 0x21, 0x49, 0x56, 0xC2, 0x71, 0x00, 0x01, 0x41, 0x42, 0x00, 0x00, 0x01,
+    0xA0, 0x28, 0x23, 0xCB, 0x58, 0xA4, 0xEB, 0x04, 0x03, 0xC3, 0x60, 0x18, 0x00, 0x00, 0x20, 0x08,
+    0x23, 0xD3, 0x5A, 0xA4, 0xEB, 0x02, 0x03, 0xC3, 0x00, 0x00, 0x61, 0x59, 0x5C, 0xA4, 0xEB, 0x01,
+    0x01, 0x41, 0x22, 0x8A, 0x9C, 0x1F, 0x01, 0xC2, 0x71, 0x42, 0x92, 0x9E, 0x1F, 0x03, 0x89, 0xF4,
+    0x34, 0xFE, 0xB7, 0xFE, 0x19, 0xFF, 0x40, 0x3A, 0xFF, 0x04, 0xD8, 0xFE, 0x76, 0xFE, 0xD1, 0xF5,
+    0x0C, 0xF5, 0xE6, 0xEB, 0x93, 0x1F, 0x00, 0xEC, 0xF4, 0x48, 0xFF, 0xFF, 0x02, 0x19, 0xFF, 0x90,
+    0xF5, 0x06, 0xEC, 0x90, 0x1F, 0x00, 0x06, 0xF4, 0x4B, 0xFF, 0xFF, 0x01, 0x54, 0xFE, 0x47, 0xF4,
+    0x8F, 0x7F, 0x02, 0x9D, 0xFF, 0xFF, 0xFF, 0xBD, 0xFF, 0x40, 0x7C, 0xFF, 0x80, 0x04, 0x86, 0x00,
+    0x01, 0x13, 0xF6, 0xE5, 0xEB, 0x8D, 0x1F, 0x00, 0x47, 0xF4, 0x83, 0x10, 0x04, 0xC4, 0xEB, 0x48,
+    0xF4, 0x2E, 0xF5, 0x55, 0xFE, 0xBD, 0xFF, 0x83, 0x20, 0x01, 0x7C, 0xFF, 0xAA, 0xF4, 0x96, 0xBF,
+    0x02, 0xC4, 0xEB, 0x0C, 0xF5, 0xF9, 0xFE, 0x83, 0x21, 0x00, 0xB1, 0xF5, 0x8D, 0x1F, 0x01, 0x27,
+    0xF4, 0xCB, 0xF4, 0x40, 0x0C, 0xF5, 0x01, 0xAB, 0xF4, 0x27, 0xF4, 0x83, 0x0F, 0x01, 0xEC, 0xF4,
+    0x7C, 0xFF, 0x82, 0x20, 0x01, 0x34, 0xFE, 0xC4, 0xEB, 0x8B, 0x1F, 0x00, 0xF8, 0xFE, 0x83, 0x35,
+    0x02, 0x9D, 0xFF, 0x76, 0xFE, 0xEC, 0xF4, 0x81, 0x16, 0x01, 0xC5, 0xEB, 0x34, 0xFE, 0x82, 0x0B,
+    0x00, 0x55, 0xFE, 0x8B, 0x1F, 0x00, 0x13, 0xF6, 0x86, 0x9B, 0x01, 0x7C, 0xFF, 0x6F, 0xF5, 0x81,
+    0x21, 0x00, 0x4E, 0xF5, 0x82, 0x09, 0x00, 0xF2, 0xF5, 0x8A, 0x1F, 0x06, 0x69, 0xF4, 0x0C, 0xF5,
+    0xAA, 0xF4, 0x89, 0xF4, 0xCB, 0xF4, 0x6F, 0xF5, 0x55, 0xFE, 0x82, 0xC3, 0x01, 0x1A, 0xFF, 0x48,
+    0xF4, 0x80, 0x0E, 0x00, 0x0C, 0xF5, 0x82, 0x20, 0x00, 0x0D, 0xF5, 0x90, 0x9F, 0x02, 0xC4, 0xEB,
+    0xEC, 0xF4, 0x19, 0xFF, 0x80, 0x17, 0x00, 0xDE, 0xFF, 0x81, 0x18, 0x82, 0x41, 0x00, 0xBE, 0xFF,
+    0x84, 0x8F, 0x8B, 0xBF, 0x81, 0x19, 0x00, 0xDE, 0xFF, 0x80, 0x19, 0x00, 0x4E, 0xF5, 0x80, 0x06,
+    0x00, 0x54, 0xFE, 0x81, 0x20, 0x00, 0xB7, 0xFE, 0x89, 0x1F, 0x05, 0xC4, 0xEB, 0x3A, 0xFF, 0x9D,
+    0xFF, 0x9C, 0xFF, 0x19, 0xFF, 0x13, 0xF6, 0x82, 0xF7, 0x00, 0x48, 0xF4, 0x81, 0xBF, 0x00, 0xEC,
+    0xF4, 0x80, 0xA4, 0x82, 0xC5, 0x80, 0x06, 0x88, 0x3F, 0x00, 0xD8, 0xFE, 0x40, 0x19, 0xFF, 0x00,
+    0x9C, 0xFF, 0x81, 0x7C, 0x81, 0x21, 0x00, 0x47, 0xF4, 0x80, 0x85, 0x01, 0xBE, 0xFF, 0x47, 0xF4,
+    0x80, 0xE6, 0x81, 0x1F, 0x00, 0x19, 0xFF, 0x8D, 0x5F, 0x04, 0x27, 0xF4, 0xD1, 0xF5, 0xBD, 0xFF,
+    0xFF, 0xFF, 0xD2, 0xF5, 0x80, 0x06, 0x00, 0xAA, 0xF4, 0x80, 0x19, 0x00, 0xD8, 0xFE, 0x80, 0x05,
+    0x00, 0xF9, 0xFE, 0x81, 0x20, 0x00, 0xCB, 0xF4, 0x8E, 0x7F, 0x03, 0x06, 0xEC, 0xB7, 0xFE, 0xFF,
+    0xFF, 0x34, 0xFE, 0x83, 0xED, 0x80, 0x5A, 0x82, 0xC3, 0x00, 0x55, 0xFE, 0x8A, 0x1F, 0x03, 0x27,
+    0xF4, 0x4E, 0xF5, 0x2D, 0xF5, 0xE5, 0xEB, 0x80, 0x87, 0x07, 0x96, 0xFE, 0xFF, 0xFF, 0x6F, 0xF5,
+    0xA4, 0xEB, 0xE5, 0xEB, 0xBE, 0xFF, 0xFF, 0xFF, 0xF9, 0xFE, 0x80, 0x09, 0x81, 0xEC, 0x01, 0xDE,
+    0xFF, 0xC5, 0xEB, 0x88, 0x1F, 0x01, 0xEC, 0xF4, 0xDF, 0xFF, 0x80, 0x0F, 0x08, 0x9D, 0xFF, 0x48,
+    0xEC, 0x84, 0xEB, 0xC5, 0xEB, 0x5B, 0xFF, 0xDE, 0xFF, 0x07, 0xEC, 0x84, 0xE3, 0xF3, 0xF5, 0x80,
+    0x0A, 0x02, 0x28, 0xEC, 0x84, 0xE3, 0x14, 0xF6, 0x81, 0x40, 0x00, 0xAB, 0xEC, 0x40, 0x64, 0xE3,
+    0x01, 0xE2, 0x79, 0x64, 0xAA, 0x43, 0x84, 0xB2, 0x00, 0xC5, 0xB2, 0x43, 0xFF, 0xFF, 0x00, 0x98,
+    0xEE, 0x80, 0x08, 0x04, 0x0C, 0xC4, 0xFF, 0xFF, 0x93, 0xDD, 0x84, 0xB2, 0x69, 0xBB, 0x80, 0x09,
+    0x02, 0x11, 0xD5, 0x84, 0xB2, 0x4D, 0xCC, 0x81, 0x0F, 0x00, 0x32, 0xDD, 0x80, 0x0F, 0x00, 0x23,
+    0x92, 0x84, 0x1F, 0x00, 0x8A, 0xC3, 0x83, 0x1F, 0x00, 0xDF, 0xFF, 0x81, 0x09, 0x0B, 0x3B, 0xF7,
+    0x9D, 0xFF, 0x85, 0xB2, 0x84, 0xB2, 0x5C, 0xF7, 0xFA, 0xEE, 0xD0, 0xD4, 0x84, 0xB2, 0xE6, 0xB2,
+    0x93, 0xDD, 0x6E, 0xCC, 0x68, 0xBB, 0x80, 0x09, 0x86, 0x1F, 0x00, 0x07, 0xBB, 0x83, 0x1F, 0x00,
+    0x5C, 0xF7, 0x81, 0x09, 0x03, 0x52, 0xDD, 0xD9, 0xEE, 0x07, 0xBB, 0x84, 0xB2, 0x81, 0x17, 0x86,
+    0x00, 0x01, 0x23, 0x92, 0x64, 0xA2, 0x84, 0x07, 0x00, 0xD5, 0xE5, 0x82, 0x1F, 0x00, 0xAF, 0xCC,
+    0x50, 0x84, 0xB2, 0x01, 0x23, 0x92, 0x43, 0x9A, 0x84, 0x07, 0x04, 0xA5, 0xB2, 0xF0, 0xD4, 0x99,
+    0xEE, 0x78, 0xEE, 0x4D, 0xCC, 0x51, 0x84, 0xB2, 0x01, 0xC3, 0x79, 0xE3, 0x81, 0x5C, 0x84, 0xB2,
+    0x01, 0x42, 0x59, 0xC3, 0x79, 0x9D, 0x1F, 0x00, 0x42, 0x51, 0x40, 0xC3, 0x79, 0x00, 0x23, 0x9A,
+    0x56, 0x63, 0xA2, 0x00, 0x23, 0x92, 0x80, 0x1B, 0x00, 0xE1, 0x38,
+};
+const PackedImage wifi_full = {32, 32, PACKED_LZ565, sizeof(wifi_full_data), wifi_full_data};
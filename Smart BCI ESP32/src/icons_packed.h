@@ -0,0 +1,9 @@
+// Generated by lib/esa-assets/pack_icons.py from icons.c. Do not edit; rerun the script.
+
+#pragma once
+
+#include <PackedImage.h>
+
+extern const PackedImage penguin; // 40x40
+extern const PackedImage icon_40x40; // 40x40
+extern const PackedImage wifi_full; // 32x32
@@ -10,7 +10,7 @@ SCLK (D13): SPI Clock → 18
 MISO (D12) SPI Data Input → 19
 MOSI (D11) SPI Data Output → 23
 LCD_CS (D10) LCD Chip Select → 15
-LCD_BL (D9) LCD Backlight → 5V
+LCD_BL (D9) LCD Backlight → 5V (or a GPIO to dim it, see PANEL POWER)
 LCD_RST (D8) LCD Reset → 4
 LCD_DC (D7) LCD Data/Command Selection → 2
 TP stands for Touch Panel, not used.
@@ -24,11 +24,23 @@ TFT_eSPI tft; // uses pins/driver from User_Setup.h
 extern const GFXfont FreeSansBold12pt7b;
 extern const GFXfont FreeSansBold24pt7b;
 #include <esp_now.h>
+#include <esp_timer.h>
 #include <WiFi.h>
+#include <esp_wifi.h>
+#include <Preferences.h>
+#include <new>
+#include <CurrentHistory.h>
+#include <EstimatorFilters.h>
+#include <SocKalman.h>
+#include <PeerLinkMonitor.h>
+#include <StageProfiler.h>
 
 // ==== BUTTON ISR: ESP32 FreeRTOS helpers for atomic access
 #include "freertos/FreeRTOS.h"
 #include "freertos/task.h"
+#if CONFIG_PM_ENABLE
+#include <esp_pm.h>
+#endif
 
 // Assign human-readable names to some common 16-bit RGB565 colour values:
 #define BLACK 0x0000
@@ -73,25 +85,124 @@ constexpr int16_t MOSFET_GATE = 12;
 constexpr uint32_t BMS_QUERY_MS = 250; // poll Daly BMS no faster than 4 Hz
 
 // ==== BUTTON ISR: shared state (volatile) and debounce
-static volatile bool g_buttonEvent = false;
 static volatile uint32_t g_lastButtonIsrUs = 0;
-static portMUX_TYPE g_isrMux = portMUX_INITIALIZER_UNLOCKED;
 constexpr uint32_t BUTTON_DEBOUNCE_US = 500 * 1000; // 500 ms
 
+// ==== EVENTS: loop() sleeps in xTaskNotifyWait() until one of these bits is set
+static TaskHandle_t g_mainTask = nullptr;   // task running loop(), set in setup()
+constexpr uint32_t EVT_BUTTON = 1u << 0;    // set by onButtonISR
+constexpr uint32_t EVT_BLINK = 1u << 1;     // set by the 1 Hz low-battery blink timer
+constexpr uint32_t EVT_LINK_STALE = 1u << 2; // set by the link watchdog timer
+constexpr uint32_t EVT_PACKET = 1u << 4;     // set by receiveCallback: packets waiting in g_rxRing
+constexpr uint32_t BLINK_PERIOD_MS = 1000;
+static esp_timer_handle_t g_blinkTimer = nullptr;
+static bool g_blinkTimerRunning = false;
+void updateBlinkTimer();
+void panelPowerUpdate();
+
+// ==== PACKS: several Battery Boxes on one display
+// Each sender gets its own estimator state (PackState, ~6.5 KB, mostly the current history) in a
+// table of ESA_MAX_PACKS indexed by its link slot, so RAM and per-packet work grow linearly with it.
+// With more than one pack heard the screen pages through "all packs" and then each pack.
+// Build flag ESA_PACKS sets the table size (default 1).
+#ifndef ESA_PACKS
+#define ESA_PACKS 1
+#endif
+constexpr uint8_t ESA_MAX_PACKS = ESA_PACKS;
+constexpr uint32_t ESA_PAGE_MS = 5000; // how long each page stays up
+
+// ==== LINK: which Battery Boxes we listen to, and when one counts as gone
+// MACs of the Battery Box(es) to accept, e.g. "24:6f:28:aa:bb:cc". With none listed, the first
+// LINK_MAX_PEERS senders heard are accepted (learn mode) and everything else is dropped.
+// Learn mode keeps those senders until the next reboot: if a neighbouring Battery Box is heard first,
+// this display follows it and ignores its own. It is meant for bring-up; list the MAC for real use.
+const char *const LINK_ALLOWED_PEERS[] = {nullptr}; // nullptr-terminated
+constexpr uint8_t LINK_MAX_PEERS = ESA_MAX_PACKS;
+constexpr uint32_t LINK_STALE_MS = 3000;         // nothing for 3 s (12 packets at 4 Hz) -> "No Signal"
+constexpr uint32_t LINK_STATS_PRINT_MS = 5000;   // how often the link stats go to Serial
+#define LINK_RSSI_SNIFF 1                        // read ESP-NOW RSSI in promiscuous mode (the recv callback has none)
+static PeerLinkMonitor<LINK_MAX_PEERS> g_link(LINK_STALE_MS, LINK_ALLOWED_PEERS[0] == nullptr);
+static esp_timer_handle_t g_staleTimer = nullptr; // one-shot, restarted by every accepted packet
+bool linkLost = false;                            // "No Signal" is on screen
+
+// ==== POWER: let the idle task scale the CPU clock (and optionally light-sleep) while loop() waits
+// Only takes effect on an IDF build with CONFIG_PM_ENABLE; light sleep also needs CONFIG_FREERTOS_USE_TICKLESS_IDLE.
+// Light sleep switches the radio off between wakeups, so ESP-NOW packets are missed; leave it at 0
+// unless the Battery Box is changed to tolerate that.
+#define ESA_PM_LIGHT_SLEEP 0
+constexpr int ESA_PM_MAX_MHZ = 240;
+constexpr int ESA_PM_MIN_MHZ = 80;
+
+// ==== PANEL POWER: dim the backlight when nothing is happening, sleep the ILI9486 when parked
+// ON -> DIM after PANEL_DIM_AFTER_MS without a wake event (button, SoC change, charge start, alarm).
+// DIM -> SLEEP once additionally no pack has been discharging or charging for PANEL_SLEEP_AFTER_MS:
+// backlight off, DISPOFF + SLPIN (GRAM keeps being written, so waking shows the current values).
+// Any wake event goes straight back to ON; a button press that wakes the panel does nothing else.
+// Every change is logged on Serial ("[Panel]") so the supply current of each state can be read off
+// a USB meter. None has been measured yet, so no saving is claimed: record ON / DIM / SLEEP here
+// once a board with LCD_BL on a GPIO has been measured.
+// With TFT_BL_PIN = -1 (LCD_BL tied to 5 V, as wired now) the panel simply stays ON: SLEEP would
+// blank it while the backlight, the main consumer, stays lit.
+// Only loop() runs this (it sends panel commands on tft).
+constexpr int16_t TFT_BL_PIN = -1;     // GPIO driving LCD_BL (D9), -1 if it is tied to 5 V
+constexpr uint8_t BL_LEDC_CHANNEL = 0;
+constexpr uint32_t BL_PWM_HZ = 5000;   // above audible / visible flicker
+constexpr uint8_t BL_PWM_BITS = 8;
+constexpr uint8_t BL_DUTY_ON = 255;
+constexpr uint8_t BL_DUTY_DIM = 40;    // ~15%, still readable in a dark garage
+constexpr uint32_t PANEL_DIM_AFTER_MS = 60 * 1000UL;
+constexpr uint32_t PANEL_SLEEP_AFTER_MS = 10 * 60 * 1000UL;
+constexpr uint8_t PANEL_CMD_SLPIN = 0x10;   // ILI9486 sleep in
+constexpr uint8_t PANEL_CMD_SLPOUT = 0x11;  // sleep out, needs 5 ms before the next command
+constexpr uint8_t PANEL_CMD_DISPOFF = 0x28;
+constexpr uint8_t PANEL_CMD_DISPON = 0x29;
+
+// ==== PROFILE: optional timing of each draw helper and callback stage (compiles to nothing at 0)
+// ESA_PROFILE 1: per-stage n / min / avg / max (us) and a log2 histogram on Serial every
+// PROFILE_REPORT_MS. ESA_PROFILE_OVERLAY 1 also writes the averages of the heavy stages into the
+// bottom border. Times come from esp_timer (1 us steps), not the CPU cycle counter: with power
+// management the clock moves between 80 and 240 MHz inside a stage, so cycles cannot be converted.
+#ifndef ESA_PROFILE
+#define ESA_PROFILE 0
+#endif
+#ifndef ESA_PROFILE_OVERLAY
+#define ESA_PROFILE_OVERLAY 0
+#endif
+#if ESA_PROFILE
+constexpr uint32_t PROFILE_REPORT_MS = 5000;
+enum ProfStage : uint8_t
+{
+  PROF_CALLBACK, // handlePacket() as a whole
+  PROF_ESTIMATE, // packUpdateTopLine(): filters, history, Kalman -> TTE / TTF text
+  PROF_RENDER,   // renderPage() as a whole (contains the draw stages below)
+  PROF_BORDER,
+  PROF_ICON,
+  PROF_BARS,
+  PROF_BOLT,
+  PROF_PERCENT,
+  PROF_STATUS,
+  PROF_TOPSTRIP, // only calls that redraw
+  PROF_AUDIO,    // updateSpeaker(): cue decisions and queueing
+  PROF_STAGE_COUNT
+};
+static const char *const PROF_STAGE_NAMES[PROF_STAGE_COUNT] = {
+    "callback", "estimate", "render", "border", "icon", "bars", "bolt", "percent", "status", "topstrip", "audio"};
+static uint32_t profNow() { return (uint32_t)esp_timer_get_time(); }
+static StageProfiler<PROF_STAGE_COUNT> g_prof;
+#define PROF_SCOPE(stage) StageScope<StageProfiler<PROF_STAGE_COUNT>, profNow> esa_prof_scope(g_prof, stage)
+#else
+#define PROF_SCOPE(stage)
+#endif
+
 // GLOBALS
 int previous_soc = -1;
-int input_soc = -1;        // to store user input
+int input_soc = -1;        // SoC on screen (the page's pack, or all packs combined)
 int previous_chg = -1;     // 0 = not charging, 1 = charging
-int input_chg = -1;        // to store user input
-float input_I = -1.0;      // Current in Amperes, +ve charge, -ve discharge
-float input_resmAh = -1.0; // Remaining capacity in mAh
-uint32_t lastBlinkMs = 0;
+int input_chg = -1;        // charge state on screen
 bool lowBlinkState = false; // toggles when blinking
 bool isBatteryBarsWiped = false;
 const char *current_status_msg = "";
 const char *previous_status_msg = "";
-uint8_t crcFailCnt = 0; // consecutive CRC error count
-bool crcFailed = false;
 int8_t lastLowSOCAudioPlayed = -1; // Remember last SoC that triggered "Battery Low. Please Charge" audio
 bool audio_module_on = true;
 
@@ -108,6 +219,7 @@ typedef struct struct_message
   float soc;
   float I;
   float resmAh;
+  uint16_t seq; // packet counter from the Battery Box, wraps (absent from older Battery Box firmware)
 } struct_message;
 
 // Create a structure object
@@ -121,156 +233,34 @@ void formatMacAddress(const uint8_t *macAddr, char *buffer, int maxLength)
 
 //!
 // --- TTE discharge-history (very fast attack, no decay when idle) ---
-struct TTEHist
-{
-  float emaA; // EMA of discharge current magnitude (A)
-  bool valid;
-} g_tteHist = {0.0f, false};
 // ---- Historical TTE Tuneables ---
-constexpr float TTE_TAU_UP_S = 2.5f;    // fast attack (~95% in ~7.5 s) (make TTE_TAU_UP_S even smaller if you want it snappier)
-constexpr float STEP_RATIO = 1.25f;     // consider it a "step up" if new draw >= 125% of EMA
-constexpr float STEP_JUMP_GAIN = 0.80f; // jump 80% of the way immediately on step up
-constexpr float TTE_BOOTSTRAP_A = 1.0f; // if EMA very small, snap to first real draw
+constexpr uint32_t TTE_TAU_UP_MS = 2500; // fast attack (~95% in ~7.5 s) (make TTE_TAU_UP_MS even smaller if you want it snappier)
+constexpr float STEP_RATIO = 1.25f;      // consider it a "step up" if new draw >= 125% of EMA
+constexpr float STEP_JUMP_GAIN = 0.80f;  // jump 80% of the way immediately on step up
+constexpr float TTE_BOOTSTRAP_A = 1.0f;  // if EMA very small, snap to first real draw
 //!
 constexpr uint32_t HIST_TTE_DWELL_MS = 3000; // show historical TTE only after 3s
-// ---- Historical TTE based on long-window robust draw ----
-constexpr uint16_t HIST_SAMPLE_HZ = 1.0;                        // collect once per second
-constexpr uint32_t HIST_WINDOW_SEC = 15 * 60;                   // 15 minutes window (adjust)
-constexpr float HIST_KEEP_MIN_A = 1.0f;                         // ignore tiny discharge (decel/coast)
-constexpr float HIST_TRIM_LOW_FRAC = 0.40f;                     // drop bottom HIST_TRIM_LOW_FRAC
-constexpr float HIST_TRIM_HIGH_FRAC = 0.05f;                    // drop top HIST_TRIM_HIGH_FRAC
-constexpr uint16_t HIST_MIN_SAMPLES = 10;                       // need at least 10s of history
-constexpr uint16_t HIST_CAP = HIST_SAMPLE_HZ * HIST_WINDOW_SEC; // buffer size
-static float g_histBuf[HIST_CAP];
-static uint16_t g_histCount = 0, g_histHead = 0;
-static uint32_t g_histLastPushMs = 0;
-
-static inline void insertionSort(float *a, int n)
-{
-  for (int i = 1; i < n; ++i)
-  {
-    float key = a[i];
-    int j = i - 1;
-    while (j >= 0 && a[j] > key)
-    {
-      a[j + 1] = a[j];
-      --j;
-    }
-    a[j + 1] = key;
-  }
-}
-
-static inline void histPushDischarge(float I_raw)
-{
-  if (I_raw < -DISCH_MIN_ABS_A)
-  {
-    const float Idis = -I_raw; // magnitude
-    if (Idis >= HIST_KEEP_MIN_A)
-    { // ignore tiny decel/coast
-      const uint32_t now = millis();
-      if (now - g_histLastPushMs >= (1000 / HIST_SAMPLE_HZ))
-      {
-        g_histBuf[g_histHead] = Idis;
-        g_histHead = (g_histHead + 1) % HIST_CAP;
-        if (g_histCount < HIST_CAP)
-          ++g_histCount;
-        g_histLastPushMs = now;
-      }
-    }
-  }
-}
-
-static float histTypicalDrawA_trimmedMean()
-{
-  if (g_histCount < HIST_MIN_SAMPLES)
-    return NAN;
-
-  // Copy ring -> tmp (linearize)
-  static float tmp[HIST_CAP];
-  uint16_t n = g_histCount;
-  uint16_t idx = (g_histHead + HIST_CAP - g_histCount) % HIST_CAP;
-  for (uint16_t i = 0; i < n; ++i)
-  {
-    tmp[i] = g_histBuf[idx];
-    idx = (idx + 1) % HIST_CAP;
-  }
-
-  // Sort and trimmed mean
-  insertionSort(tmp, n);
-  uint16_t lo = (uint16_t)floorf(n * HIST_TRIM_LOW_FRAC);
-  uint16_t hi = n - (uint16_t)ceilf(n * HIST_TRIM_HIGH_FRAC);
-  if (hi <= lo)
-    return tmp[n / 2]; // fallback: median
-
-  double sum = 0.0;
-  uint16_t cnt = 0;
-  for (uint16_t i = lo; i < hi; ++i)
-  {
-    sum += tmp[i];
-    ++cnt;
-  }
-  return (cnt ? (float)(sum / cnt) : tmp[n / 2]);
-}
-
-//!
-static inline void tteHistUpdate(float I_raw)
-{
-  if (I_raw < -DISCH_MIN_ABS_A)
-  {
-    const float Idis = -I_raw;  // positive magnitude
-    static uint32_t lastMs = 0; // Note that the lastMs variable is a static variable, so it is only initialised once
-    const uint32_t now = millis();
-    const float dt = (lastMs == 0) ? (BMS_QUERY_MS / 1000.0f) : (now - lastMs) / 1000.0f; // If lastMs == 0 (only occurs in first call, i.e., during lastMs's initialisation), dt = BMS_QUERY_MS in seconds (0.25 s), else dt = elapsed time since last update in seconds
-    lastMs = now;
-
-    const float alpha = 1.0f - expf(-dt / TTE_TAU_UP_S);
-    // Kinda similar to a log graph but starting from the origin.
-    // The larger the value of dt (x-value), the closer alpha (y-value) gets to 1 (asymptote at 1).
-    // The smaller the value of TTE_TAU_UP_S, the faster alpha approaches 1 (the graph approaches a step function)
-
-    if (!g_tteHist.valid || g_tteHist.emaA < TTE_BOOTSTRAP_A) // If TTE history is not being shown or the current EMA current is less than bootstrap threshold
-    {
-      g_tteHist.emaA = Idis;  // Update EMA current to current raw current draw
-      g_tteHist.valid = true; // Show TTE history
-    }
-    else if (Idis >= g_tteHist.emaA * STEP_RATIO) // If current raw current draw is significantly higher (≥125%) than current EMA current
-    {
-      // Update EMA current quickly by jumping most of the way (STEP_JUMP_GAIN = 80%) towards the value of the current raw current draw
-      g_tteHist.emaA = g_tteHist.emaA + STEP_JUMP_GAIN * (Idis - g_tteHist.emaA);
-    }
-    else
-    {
-      // If the current raw current draw is not that big or smaller than the current EMA current, update EMA current normally according to alpha.
-      // If dt is large (infrequent updates), alpha is large (approaching 1), so EMA current moves quickly towards current raw current draw.
-      // If dt is small (frequent updates), alpha is small (positive decimal), so EMA current moves slowly towards current raw current draw.
-      g_tteHist.emaA += alpha * (Idis - g_tteHist.emaA);
-    }
-  }
-}
-//!
-
-//!
-// --- Debug: print TTE history (throttled once/sec) ---
-void debugPrintTTEHist()
+// ---- Historical TTE based on multi-window robust draw ----
+constexpr uint16_t HIST_SAMPLE_HZ = 1.0;     // collect once per second
+constexpr float HIST_KEEP_MIN_A = 1.0f;      // ignore tiny discharge (decel/coast)
+constexpr float HIST_TRIM_LOW_FRAC = 0.40f;  // drop bottom HIST_TRIM_LOW_FRAC
+constexpr float HIST_TRIM_HIGH_FRAC = 0.05f; // drop top HIST_TRIM_HIGH_FRAC
+constexpr uint16_t HIST_MIN_SAMPLES = 10;    // a window needs at least 10 stored samples to count
+constexpr uint16_t HIST_BINS = 401;          // 0.0 .. 40.0 A in 0.1 A bins (BMS resolution)
+enum HistWindowId : uint8_t
 {
-  static uint32_t lastPrint = 0;
-  const uint32_t PRINT_PERIOD_MS = 1000;
-  uint32_t now = millis();
-  if (now - lastPrint < PRINT_PERIOD_MS)
-    return;
-  lastPrint = now;
-
-  Serial.print(F("👉 [TTEHist] valid="));
-  Serial.print(g_tteHist.valid ? F("yes") : F("no"));
-  Serial.print(F("  emaA="));
-  if (g_tteHist.valid)
-    Serial.print(g_tteHist.emaA, 3);
-  else
-    Serial.print(F("NA"));
-  Serial.println(F(" A"));
-}
-//!
-
+  HIST_WIN_SHORT,
+  HIST_WIN_MID,
+  HIST_WIN_LONG,
+  HIST_WIN_COUNT
+};
+constexpr HistWindowSpec HIST_WINDOWS[HIST_WIN_COUNT] = {
+    {2 * 60, 1},  // short: last 2 minutes at 1 Hz (reacts to the current riding style)
+    {15 * 60, 1}, // mid: last 15 minutes at 1 Hz (the original single window)
+    {60 * 60, 4}, // long: last hour as 4 s block means (same RAM as the 15 min window)
+};
+constexpr float HIST_BLEND_W[HIST_WIN_COUNT] = {0.25f, 0.50f, 0.25f}; // weights for the blended typical draw
+constexpr uint16_t HIST_RING_SLOTS = histRingSlots(HIST_WINDOWS, HIST_WIN_COUNT);
 // COLOUR UTILITIES
 uint16_t colourForSOC(int soc)
 {
@@ -293,6 +283,7 @@ uint16_t colourForSOC(int soc)
 // DRAW HELPERS
 void drawBatteryIcon(int soc, int chg)
 {
+  PROF_SCOPE(PROF_ICON);
   // Erase previous drawing in icon area
   tft.fillRect(ICON_X - 2, ICON_Y - 2, ICON_W + TERM_W + 4, ICON_H + 4, BACKGROUND_COLOUR);
   isBatteryBarsWiped = true;
@@ -319,6 +310,7 @@ void drawBatteryIcon(int soc, int chg)
 
 void drawBorder(int soc)
 {
+  PROF_SCOPE(PROF_BORDER);
   tft.fillRect(0, 0, tft.width(), BORDER_THICKNESS, colourForSOC(soc));
   tft.fillRect(0, 0, BORDER_THICKNESS, tft.height(), colourForSOC(soc));
   tft.fillRect(0, tft.height() - BORDER_THICKNESS, tft.width(), BORDER_THICKNESS, colourForSOC(soc));
@@ -364,6 +356,7 @@ static inline void drawThickLine(int16_t x0, int16_t y0, int16_t x1, int16_t y1,
 
 void drawLightningBolt()
 {
+  PROF_SCOPE(PROF_BOLT);
   const uint16_t FILL_COLOUR = YELLOW;
   const uint16_t OUTLINE_COLOUR = BLACK;
   const uint8_t OUTLINE_THICK = 4; // <-- adjust 2..6 to taste
@@ -398,6 +391,7 @@ void drawLightningBolt()
 
 void drawBatteryBars(int soc)
 {
+  PROF_SCOPE(PROF_BARS);
   // Bars inside the battery
   uint16_t barColour = colourForSOC(soc);
 
@@ -418,6 +412,7 @@ void drawBatteryBars(int soc)
 
 void drawPercentage(int soc)
 {
+  PROF_SCOPE(PROF_PERCENT);
   char buf[12];
   snprintf(buf, sizeof(buf), "%d%%", soc); // one string so everything matches
 
@@ -446,105 +441,202 @@ void drawPercentage(int soc)
   tft.setTextFont(1);
 }
 
-void statusMessage(int soc, int chg)
+const char *statusMessage(int soc, int chg)
 {
-  current_status_msg = "";
-
   if (chg && soc < 100)
   {
-    current_status_msg = "BATTERY CHARGING";
+    return "BATTERY CHARGING";
   }
   else if (chg && soc == 100)
   {
-    current_status_msg = "BATTERY FULL!";
+    return "BATTERY FULL!";
   }
   else if (soc <= 20)
   {
-    current_status_msg = "BATTERY LOW PLEASE CHARGE";
+    return "BATTERY LOW PLEASE CHARGE";
   }
+  return "";
 }
 
-void playAudio(const char *status_message)
+// ==== AUDIO: non-blocking cue scheduler for the DYSV8F (I/O trigger mode)
+// playAudio() only queues a cue and returns. An esp_timer one-shot holds the trigger pattern for
+// AUDIO_PULSE_MS, releases it, then waits for the clip to end (BUSY line if wired, otherwise the
+// clip's nominal length) before starting the next cue, so no task blocks and clips never cut each
+// other off. One pending flag per cue: a cue that is already queued is not queued again.
+enum AudioCue : uint8_t
 {
-  if (audio_module_on == false)
-    return;
-
-  digitalWrite(DYSV8F_IO0, HIGH);
-  digitalWrite(DYSV8F_IO1, HIGH);
-  digitalWrite(DYSV8F_IO2, HIGH);
+  AUDIO_CUE_SILENT,
+  AUDIO_CUE_CHARGING,
+  AUDIO_CUE_FULL,
+  AUDIO_CUE_LOW,
+  AUDIO_CUE_COUNT,
+  AUDIO_CUE_NONE = 0xFF
+};
+
+struct AudioCueSpec
+{
+  uint8_t io0, io1, io2; // trigger pattern
+  uint8_t priority;      // higher plays first
+  uint16_t clipMs;       // nominal clip length, used when BUSY is not wired
+};
+
+constexpr AudioCueSpec AUDIO_CUES[AUDIO_CUE_COUNT] = {
+    {HIGH, HIGH, LOW, 0, 500},  // silent audio file
+    {HIGH, LOW, HIGH, 1, 2000}, // "Charging"
+    {LOW, LOW, HIGH, 2, 8000},  // music and "Battery Full. Charging Complete"
+    {LOW, HIGH, HIGH, 3, 3000}, // "Battery Low. Please Charge"
+};
+constexpr uint32_t AUDIO_PULSE_MS = 10;           // trigger hold time (4 ms is the borderline shortest the module registers)
+constexpr int16_t DYSV8F_BUSY = -1;               // GPIO wired to the module's BUSY pin (low while playing), -1 if not wired
+constexpr uint32_t AUDIO_BUSY_SETTLE_MS = 150;    // BUSY takes a moment to go low after the trigger
+constexpr uint32_t AUDIO_BUSY_POLL_MS = 50;       // how often to look at BUSY while a clip plays
+constexpr uint32_t AUDIO_BUSY_TIMEOUT_MS = 15000; // never wait longer than this for BUSY to clear
+
+enum AudioPhase : uint8_t
+{
+  AUDIO_IDLE,
+  AUDIO_PULSE,  // trigger pattern is on the pins
+  AUDIO_PLAYING // pins released, waiting for the clip to end
+};
+
+static esp_timer_handle_t g_audioTimer = nullptr;
+static portMUX_TYPE g_audioMux = portMUX_INITIALIZER_UNLOCKED; // queue is touched by the ESP-NOW, loop and esp_timer tasks
+static uint8_t g_audioPendingMask = 0;                         // bit per AudioCue
+static uint32_t g_audioPendingSeq[AUDIO_CUE_COUNT];            // queue order, breaks priority ties
+static uint32_t g_audioSeq = 0;
+static AudioPhase g_audioPhase = AUDIO_IDLE;
+static uint8_t g_audioCurrent = AUDIO_CUE_NONE;
+static uint32_t g_audioStartMs = 0;
+
+static inline void audioWritePins(uint8_t io0, uint8_t io1, uint8_t io2)
+{
+  digitalWrite(DYSV8F_IO0, io0);
+  digitalWrite(DYSV8F_IO1, io1);
+  digitalWrite(DYSV8F_IO2, io2);
+}
 
-  // If the strings are equal, the strcmp function returns 0.
-  if (strcmp(status_message, "BATTERY CHARGING") == 0)
-  {
-    digitalWrite(DYSV8F_IO0, HIGH); // Plays "Charging"
-    digitalWrite(DYSV8F_IO1, LOW);
-    digitalWrite(DYSV8F_IO2, HIGH);
-  }
-  else if (strcmp(status_message, "BATTERY FULL!") == 0)
+// Pop the highest-priority pending cue (oldest first on ties). Call with g_audioMux held.
+static uint8_t audioTakeNextLocked()
+{
+  uint8_t best = AUDIO_CUE_NONE;
+  for (uint8_t c = 0; c < AUDIO_CUE_COUNT; ++c)
   {
-    digitalWrite(DYSV8F_IO0, LOW); // Plays music and "Battery Full. Charging Complete"
-    digitalWrite(DYSV8F_IO1, LOW);
-    digitalWrite(DYSV8F_IO2, HIGH);
+    if (!(g_audioPendingMask & (1u << c)))
+      continue;
+    if (best == AUDIO_CUE_NONE || AUDIO_CUES[c].priority > AUDIO_CUES[best].priority ||
+        (AUDIO_CUES[c].priority == AUDIO_CUES[best].priority && g_audioPendingSeq[c] < g_audioPendingSeq[best]))
+      best = c;
   }
-  else if (strcmp(status_message, "BATTERY LOW PLEASE CHARGE") == 0)
+  if (best != AUDIO_CUE_NONE)
+    g_audioPendingMask &= ~(1u << best);
+  return best;
+}
+
+// Start the next pending cue, or go idle if there is none
+static void audioStartNext()
+{
+  portENTER_CRITICAL(&g_audioMux);
+  const uint8_t cue = audioTakeNextLocked();
+  g_audioPhase = (cue == AUDIO_CUE_NONE) ? AUDIO_IDLE : AUDIO_PULSE;
+  g_audioCurrent = cue;
+  portEXIT_CRITICAL(&g_audioMux);
+
+  if (cue == AUDIO_CUE_NONE)
+    return;
+  const AudioCueSpec &spec = AUDIO_CUES[cue];
+  audioWritePins(HIGH, HIGH, HIGH);
+  audioWritePins(spec.io0, spec.io1, spec.io2);
+  g_audioStartMs = millis();
+  esp_timer_start_once(g_audioTimer, AUDIO_PULSE_MS * 1000ULL);
+}
+
+// esp_timer callback (esp_timer task): end the trigger pulse, then wait for the clip to finish
+static void audioTimerCallback(void *)
+{
+  portENTER_CRITICAL(&g_audioMux);
+  const AudioPhase phase = g_audioPhase;
+  const uint8_t current = g_audioCurrent;
+  if (phase == AUDIO_PULSE)
+    g_audioPhase = AUDIO_PLAYING;
+  portEXIT_CRITICAL(&g_audioMux);
+
+  if (phase == AUDIO_PULSE)
   {
-    digitalWrite(DYSV8F_IO0, LOW); // Plays "Battery Low. Please Charge"
-    digitalWrite(DYSV8F_IO1, HIGH);
-    digitalWrite(DYSV8F_IO2, HIGH);
+    audioWritePins(HIGH, HIGH, HIGH);
+    const uint32_t waitMs = (DYSV8F_BUSY >= 0) ? AUDIO_BUSY_SETTLE_MS : AUDIO_CUES[current].clipMs;
+    esp_timer_start_once(g_audioTimer, waitMs * 1000ULL);
+    return;
   }
-  else if (strcmp(status_message, "") == 0)
+  if (phase == AUDIO_PLAYING && DYSV8F_BUSY >= 0 && digitalRead(DYSV8F_BUSY) == LOW &&
+      millis() - g_audioStartMs < AUDIO_BUSY_TIMEOUT_MS)
   {
-    digitalWrite(DYSV8F_IO0, HIGH); // Plays silent audio file
-    digitalWrite(DYSV8F_IO1, HIGH);
-    digitalWrite(DYSV8F_IO2, LOW);
+    esp_timer_start_once(g_audioTimer, AUDIO_BUSY_POLL_MS * 1000ULL); // still playing
+    return;
   }
-
-  delay(10); // Must have delay, without it, the pin states changes too fast and the audio module does not register. (4ms is the borderline shortest delay needed)
-
-  digitalWrite(DYSV8F_IO0, HIGH);
-  digitalWrite(DYSV8F_IO1, HIGH);
-  digitalWrite(DYSV8F_IO2, HIGH);
+  audioStartNext();
 }
 
-// Exponential moving average (EMA) of current with ~3s time constant (dt-aware)
-float filteredCurrentA(float input_I)
+void audioSchedulerBegin()
 {
-  static bool init = false;
-  static float ema = 0.0f;
-  static uint32_t lastMs = 0;
-  // Note that these are static variables, so they are only initialised once
+  if (DYSV8F_BUSY >= 0)
+    pinMode(DYSV8F_BUSY, INPUT_PULLUP);
+  esp_timer_create_args_t args = {};
+  args.callback = &audioTimerCallback;
+  args.dispatch_method = ESP_TIMER_TASK;
+  args.name = "audio";
+  esp_timer_create(&args, &g_audioTimer);
+}
 
-  uint32_t now = millis();
-  float dt = (lastMs == 0) ? (BMS_QUERY_MS / 1000.0f) : (now - lastMs) / 1000.0f;
-  // If lastMs is zero (first call), assume dt = BMS_QUERY_MS (250ms), else dt = now - lastMs
-  lastMs = now;
+// Drop everything queued and stop driving the pins (audio switched off)
+void audioSchedulerStop()
+{
+  if (g_audioTimer)
+    esp_timer_stop(g_audioTimer);
+  portENTER_CRITICAL(&g_audioMux);
+  g_audioPendingMask = 0;
+  g_audioPhase = AUDIO_IDLE;
+  g_audioCurrent = AUDIO_CUE_NONE;
+  portEXIT_CRITICAL(&g_audioMux);
+}
 
-  // time constant tau ~ 3 s
-  const float tau = 3.0f;
-  float alpha = 1.0f - expf(-dt / tau);
-  // Imagine a log graph starting at the origin (0, 0).
-  // As dt increases, alpha approaches 1 asymptotically.
-  // The smaller the value of tau, the faster alpha approaches 1 (the graph approaches a step function)
+// Queue the cue for a status message. Returns immediately.
+void playAudio(const char *status_message)
+{
+  if (audio_module_on == false || !g_audioTimer)
+    return;
 
-  if (!init) // If init == false (will only occur on first call, i.e., initialisation)
-  {
-    ema = input_I; // In first call, set EMA current to be the raw input current
-    init = true;
-  }
+  uint8_t cue;
+  // If the strings are equal, the strcmp function returns 0.
+  if (strcmp(status_message, "BATTERY CHARGING") == 0)
+    cue = AUDIO_CUE_CHARGING; // Plays "Charging"
+  else if (strcmp(status_message, "BATTERY FULL!") == 0)
+    cue = AUDIO_CUE_FULL; // Plays music and "Battery Full. Charging Complete"
+  else if (strcmp(status_message, "BATTERY LOW PLEASE CHARGE") == 0)
+    cue = AUDIO_CUE_LOW; // Plays "Battery Low. Please Charge"
+  else if (strcmp(status_message, "") == 0)
+    cue = AUDIO_CUE_SILENT; // Plays silent audio file
   else
+    return;
+
+  portENTER_CRITICAL(&g_audioMux);
+  if (!(g_audioPendingMask & (1u << cue))) // already queued -> coalesce, keep its place
   {
-    ema += alpha * (input_I - ema);
-    // In subsequent calls, calculate EMA current as such.
-    // The larger the value of dt, the larger the value of alpha approaching 1, the updated EMA current value is closer to the current raw current draw.
-    // The smaller the value of dt, the smaller the value of alpha (正小数), the updated EMA current value only inches towards the current raw current draw (less influenced by the current raw current draw)
-    // dt represents the time elapsed since the last EMA update.
-    // So if updates are infrequent (large dt), EMA current should respond more quickly to the current raw current draw.
-    // If updates are frequent (small dt), EMA current should respond more slowly to the current raw current draw.
+    g_audioPendingMask |= (1u << cue);
+    g_audioPendingSeq[cue] = g_audioSeq++;
   }
+  const bool startNow = (g_audioPhase == AUDIO_IDLE);
+  if (startNow)
+    g_audioPhase = AUDIO_PULSE; // claim the scheduler so only one caller starts it
+  portEXIT_CRITICAL(&g_audioMux);
 
-  return ema;
+  if (startNow)
+    audioStartNext();
 }
 
+// Exponential moving average (EMA) of current with ~3s time constant (dt-aware)
+// The larger the time since the last update, the closer alpha gets to 1 and the more the EMA follows the new sample.
+constexpr uint32_t CURRENT_EMA_TAU_MS = 3000;
+
 void formatHoursToHM(float hours, char *out, size_t n)
 {
   if (!(hours > 0.0f))
@@ -561,21 +653,16 @@ void formatHoursToHM(float hours, char *out, size_t n)
     snprintf(out, n, "%uh %02um", h, m);
 }
 
-// Returns hours to full
+// Returns hours to full from the charge still missing (mAh)
 // Assumes positive current when charging
-float computeTTF_Hours(float res_mAh, float soc_pct, float I_A)
+float computeTTF_Hours(float toFull_mAh, float soc_pct, float I_A)
 {
   if (soc_pct >= 100.0f || I_A <= I_MIN_ABS_A)
     return NAN;
-  if (soc_pct <= 0.5f)
-    return NAN; // avoid divide-by-small; at 0% use TTE instead
-
-  // Estimate nominal capacity from residual capacity and SOC: Nominal capacity ≈ residual capacity / (SOC/100).
-  // Then mAh required to full = Nominal capacity - Residual capacity.
-  float C_nom_mAh = res_mAh * (100.0f / soc_pct);
-  float toFull_mAh = max(0.0f, C_nom_mAh - res_mAh);
+  if (!(toFull_mAh == toFull_mAh))
+    return NAN;
 
-  return (toFull_mAh / 1000.0f) / I_A; // hours
+  return (max(0.0f, toFull_mAh) / 1000.0f) / I_A; // hours
 }
 
 // Returns hours to empty
@@ -588,79 +675,84 @@ float computeTTE_Hours(float res_mAh, float I_A)
   return (res_mAh / 1000.0f) / I_dis_A; // hours
 }
 
-// --- median-of-5 helper for robust current ---
-static inline float median5_ring(float x)
+// --- Remaining charge: Kalman filter fusing BMS resmAh, SoC and coulomb counting ---
+// TTE/TTF are computed from its Q (remaining) and C - Q (missing) instead of the raw resmAh, so a
+// BMS recalibration step is blended in rather than jumping the displayed time.
+constexpr esa::SocKalmanParams SOC_KF_PARAMS = {
+    0.5f,     // currentSigmaA: error of the integrated BMS current between samples
+    50.0f,    // capWalkMahPerHour: usable capacity drifts slowly
+    200.0f,   // resmAhSigmaMah: BMS remaining-capacity reading
+    1.5f,     // socSigmaPct: BMS SoC reading
+    11000.0f, // capInitMah: pack capacity, used if the first sample has SoC <= 5%
+    1500.0f,  // capInitSigmaMah
+    5000,     // maxGapMs: do not coulomb count across longer ESP-NOW gaps
+};
+// ---- Confidence-driven display quantisation ----
+// The display step is the smallest of TIME_QUANT_STEPS_MIN that is >= TIME_QUANT_SIGMA_MULT x the
+// 1-sigma uncertainty of the time, so the rounding never claims more precision than the estimate has.
+// A coarser step is taken at once; a finer one only after the uncertainty has stayed below
+// TIME_QUANT_FINER_MARGIN x that step for TIME_QUANT_FINER_DWELL_MS, so the step does not follow
+// every wobble of sigma (each step change moves the displayed time).
+constexpr uint8_t TIME_QUANT_STEPS_MIN[] = {10, 15}; // candidate display steps (minutes)
+constexpr float TIME_QUANT_SIGMA_MULT = 1.0f;
+constexpr float TIME_QUANT_FINER_MARGIN = 0.8f;
+constexpr uint32_t TIME_QUANT_FINER_DWELL_MS = 300000;
+constexpr float TIME_LOAD_REL_SIGMA = 0.05f; // relative uncertainty of the (smoothed) current the time is divided by
+
+// 1-sigma uncertainty (h) of charge_mAh / I_abs_A given the charge's sigma
+static float timeSigmaH(float t_h, float sigma_mAh, float I_abs_A)
 {
-  static float ring[5] = {0, 0, 0, 0, 0};
-  static int idx = 0, count = 0;
-  ring[idx] = x;
-  idx = (idx + 1) % 5;
-  if (count < 5)
-    count++;
-  float tmp[5];
-  for (int i = 0; i < count; i++)
-    tmp[i] = ring[i];
-  insertionSort(tmp, count);
-  return tmp[count / 2]; // median for 1..5 samples
+  if (!(t_h > 0.0f) || !(I_abs_A > 0.0f))
+    return NAN;
+  const float chargeTerm = (sigma_mAh / 1000.0f) / I_abs_A;
+  const float loadTerm = t_h * TIME_LOAD_REL_SIGMA;
+  return sqrtf(chargeTerm * chargeTerm + loadTerm * loadTerm);
 }
 
-// --- stable "discharging" state with hysteresis + dwell ---
-static bool g_dischargingStable = false;
-static uint32_t g_stateSinceMs = 0;
-// ---- TTE stabilization tunables ----
-constexpr float I_DISCH_ENTER_A = -DISCH_MIN_ABS_A; // must be <= -DISCH_MIN_ABS_A to enter
-constexpr float I_DISCH_EXIT_A = -DISCH_MIN_ABS_A;  // must be >= DISCH_MIN_ABS_A to exit
-constexpr uint32_t STATE_DWELL_MS = 2000;
-constexpr uint8_t TTE_QUANT_MIN = 10; // quantize TTE to 10-minute steps
-// Asymmetric smoothing: fast drop, slower rise
-constexpr float TTE_TAU_ATTACK_S = 5.0f;   // when TTE is decreasing
-constexpr float TTE_TAU_RELEASE_S = 18.0f; // when TTE is increasing / relaxing
-
-static inline void updateDischargeState(float I_robust)
+// Display step currently in use for one time (TTE or TTF) of one pack
+struct QuantStep
 {
-  const uint32_t now = millis();
-  bool wantDisch = (I_robust <= I_DISCH_ENTER_A);
-  bool wantIdle = (I_robust >= I_DISCH_EXIT_A);
+  bool started = false;
+  uint8_t idx = 0; // into TIME_QUANT_STEPS_MIN
+  esa::OnDelay<TIME_QUANT_FINER_DWELL_MS> finer;
+};
 
-  if (!g_dischargingStable) // If g_dischargingStable == false
-  {
-    if (wantDisch)
-    {
-      if (g_stateSinceMs == 0)
-        g_stateSinceMs = now;
-      if (now - g_stateSinceMs >= STATE_DWELL_MS)
-      {
-        g_dischargingStable = true; // Have to make sure the current is persistently <= I_DISCH_ENTER_A for at least STATE_DWELL_MS before entering "discharging" state
-        g_stateSinceMs = now;
-      }
-    }
-    else
+static uint8_t quantStepForSigmaH(QuantStep &qs, float sigma_h, uint32_t nowMs)
+{
+  constexpr uint8_t n = sizeof(TIME_QUANT_STEPS_MIN) / sizeof(TIME_QUANT_STEPS_MIN[0]);
+  const float want_min = (sigma_h == sigma_h) ? TIME_QUANT_SIGMA_MULT * sigma_h * 60.0f : INFINITY; // unknown: coarsest
+  uint8_t want = n - 1;
+  for (uint8_t i = 0; i < n; ++i)
+    if (TIME_QUANT_STEPS_MIN[i] >= want_min)
     {
-      g_stateSinceMs = 0; // reset dwell timer
+      want = i;
+      break;
     }
+
+  if (!qs.started || want > qs.idx)
+  {
+    qs.started = true;
+    qs.idx = want;
+    qs.finer.reset();
   }
-  else
+  else if (qs.finer.update(qs.idx > 0 && TIME_QUANT_STEPS_MIN[qs.idx - 1] * TIME_QUANT_FINER_MARGIN >= want_min, nowMs))
   {
-    if (wantIdle)
-    {
-      if (g_stateSinceMs == 0)
-        g_stateSinceMs = now;
-      if (now - g_stateSinceMs >= STATE_DWELL_MS)
-      {
-        g_dischargingStable = false; // Have to make sure the current is persistently >= I_DISCH_EXIT_A for at least STATE_DWELL_MS before exiting "discharging" state
-        g_stateSinceMs = now;
-      }
-    }
-    else
-    {
-      g_stateSinceMs = 0;
-    }
+    qs.idx--; // one notch per dwell
+    qs.finer.reset();
   }
+  return TIME_QUANT_STEPS_MIN[qs.idx];
 }
 
+// --- stable "discharging" state with hysteresis + dwell ---
+// ---- TTE stabilization tunables ----
+constexpr float I_DISCH_ENTER_A = -DISCH_MIN_ABS_A; // must be <= -DISCH_MIN_ABS_A to enter
+constexpr float I_DISCH_EXIT_A = -DISCH_MIN_ABS_A;  // must be >= DISCH_MIN_ABS_A to exit
+constexpr uint32_t STATE_DWELL_MS = 2000;
+// Asymmetric smoothing: fast drop, slower rise
+constexpr uint32_t TTE_TAU_ATTACK_MS = 5000;   // when TTE is decreasing
+constexpr uint32_t TTE_TAU_RELEASE_MS = 18000; // when TTE is increasing / relaxing
+
 // ---- Robust CHARGING detection (reject regen spikes) ----
-static bool g_chargingStable = false;
-static uint32_t g_chgSinceMs = 0;
 // Enter/exit thresholds (hysteresis)
 constexpr float I_CHG_ENTER_A = +1.2f; // must be >= +1.2 A to call it "charging"
 constexpr float I_CHG_EXIT_A = +0.4f;  // must fall to <= +0.4 A to exit charging
@@ -668,288 +760,468 @@ constexpr float I_CHG_EXIT_A = +0.4f;  // must fall to <= +0.4 A to exit chargin
 constexpr uint32_t CHG_DWELL_MS = 2000; // 1.2 s works well for brief brake blips
 // Treat tiny +ve blips as zero (ignore back-EMF trickle)
 constexpr float POSITIVE_CLAMP_A = +0.5f; // +0..+2 A -> 0 A for state logic
-// ---- TTF stabilization (10-minute steps, asymmetric smoothing) ----
-constexpr uint8_t TTF_QUANT_MIN = 10;      // quantize TTF to 10-minute steps
-constexpr float TTF_TAU_ATTACK_S = 9.0f;   // when TTF is decreasing
-constexpr float TTF_TAU_RELEASE_S = 36.0f; // when TTF increases
+// ---- TTF stabilization (confidence-driven steps, asymmetric smoothing) ----
+constexpr uint32_t TTF_TAU_ATTACK_MS = 9000;   // when TTF is decreasing
+constexpr uint32_t TTF_TAU_RELEASE_MS = 36000; // when TTF increases
 
-static inline void updateChargingState(float I_robust)
-{
-  // dwell/hysteresis logic
-  const uint32_t now = millis();
-  // Decide what the input "wants" to be
-  const bool wantChg = (I_robust >= I_CHG_ENTER_A);
-  const bool wantIdle = (I_robust <= I_CHG_EXIT_A);
+// ==== PACKS: everything the estimators remember about one Battery Box
+// One instance per link slot, so a second pack on the same channel cannot feed the first one's TTE.
+typedef CurrentHistory<HIST_WIN_COUNT, HIST_RING_SLOTS, HIST_BINS> PackHistory;
 
-  if (!g_chargingStable)
+struct PackState
+{
+  // Latest good packet
+  int soc = -1;
+  int chg = -1;                 // stable charging state, 0 = not charging, 1 = charging
+  float I = -1.0f;              // Current in Amperes, +ve charge, -ve discharge
+  float I_med = 0.0f;           // Median-of-5 of I (robust current for state logic and live TTE)
+  float resmAh = -1.0f;         // Remaining capacity in mAh
+  const char *statusMsg = "";
+  uint8_t crcFailCnt = 0;       // consecutive CRC error count
+  bool crcFailed = false;
+  bool bmsOk = false;           // bms_status of the last packet
+  uint32_t lastTteHistPrintMs = 0;
+
+  // EMA of discharge current magnitude (A), only fed while discharging so it does not decay when idle
+  esa::StepJumpEma<TTE_TAU_UP_MS> tteHist{STEP_RATIO, STEP_JUMP_GAIN, TTE_BOOTSTRAP_A};
+  // int16 centi-amps: 1920 slots (3.8 KB) + 3 histograms (2.4 KB), vs 7.2 KB for the old float ring + sort buffer
+  PackHistory hist{HIST_WINDOWS};
+  uint32_t histLastPushMs = 0;
+  esa::Ema<CURRENT_EMA_TAU_MS> currentEma;
+  esa::MedianN<5> currentMedian5; // fed once per received sample
+  // Have to make sure the current is persistently <= I_DISCH_ENTER_A (>= I_DISCH_EXIT_A) for at least STATE_DWELL_MS
+  // before entering (exiting) the "discharging" state
+  esa::HysteresisDwell<esa::HystDir::BELOW, STATE_DWELL_MS> dischargeState{I_DISCH_ENTER_A, I_DISCH_EXIT_A};
+  esa::HysteresisDwell<esa::HystDir::ABOVE, CHG_DWELL_MS> chargeState{I_CHG_ENTER_A, I_CHG_EXIT_A};
+  // Display smoothing chains: EMA with asymmetric attack/release, then quantisation to calm the UI
+  esa::Pipeline<esa::AttackReleaseEma<TTE_TAU_ATTACK_MS, TTE_TAU_RELEASE_MS>, esa::StepQuantizer> tteDisplay;
+  esa::Pipeline<esa::AttackReleaseEma<TTF_TAU_ATTACK_MS, TTF_TAU_RELEASE_MS>, esa::StepQuantizer> ttfDisplay;
+  QuantStep tteStep, ttfStep; // their quantisation steps
+  // Rising edges into stable discharging / charging (used to seed the display chains)
+  esa::RisingEdge enterDischargeEdge, enterChargeEdge;
+  // Historical TTE is only shown after HIST_TTE_DWELL_MS of its base conditions holding
+  esa::OnDelay<HIST_TTE_DWELL_MS> histReady;
+  esa::SocKalman socKf{SOC_KF_PARAMS};
+
+  // Top strip text for this pack, rebuilt with every good packet whether or not its page is up
+  char topLine[48] = "";
+  float tteDispH = NAN; // TTE / TTF on that line (h), NAN when it shows neither
+  float ttfDispH = NAN;
+
+  // Learned state in NVS (PERSIST section): restored once per boot, then saved when worth it
+  bool persistRestored = false;   // restored, or nothing usable was saved
+  bool persistSavePending = false; // a ride / charge started or ended since the last save
+  bool persistWasDischarging = false;
+  bool persistWasCharging = false;
+  uint16_t persistNewSamples = 0; // hist samples pushed since the last save
+  float persistSavedCapMah = NAN;
+  uint32_t persistLastSaveMs = 0;
+};
+
+static PackState g_packs[ESA_MAX_PACKS]; // indexed by g_link slot
+
+static inline void histPushDischarge(PackState &pk, float I_raw)
+{
+  if (I_raw < -DISCH_MIN_ABS_A)
   {
-    if (wantChg)
-    {
-      if (g_chgSinceMs == 0)
-        g_chgSinceMs = now;
-      if (now - g_chgSinceMs >= CHG_DWELL_MS)
+    const float Idis = -I_raw; // magnitude
+    if (Idis >= HIST_KEEP_MIN_A)
+    { // ignore tiny decel/coast
+      const uint32_t now = millis();
+      if (now - pk.histLastPushMs >= (1000 / HIST_SAMPLE_HZ))
       {
-        g_chargingStable = true;
-        g_chgSinceMs = now;
+        pk.hist.push(Idis);
+        pk.histLastPushMs = now;
+        if (pk.persistNewSamples < UINT16_MAX)
+          pk.persistNewSamples++;
       }
     }
-    else
-    {
-      g_chgSinceMs = 0;
-    }
   }
-  else
+}
+
+// Trimmed mean of one window, NAN until it has enough samples
+static float histWindowDrawA(const PackState &pk, uint8_t win)
+{
+  const auto &w = pk.hist.window(win);
+  if (w.count() < HIST_MIN_SAMPLES)
+    return NAN;
+  return w.trimmedMean(HIST_TRIM_LOW_FRAC, HIST_TRIM_HIGH_FRAC);
+}
+
+// Typical draw blended across the windows that have enough history (weights renormalised)
+static float histTypicalDrawA_blended(const PackState &pk)
+{
+  float sum = 0.0f, wsum = 0.0f;
+  for (uint8_t i = 0; i < HIST_WIN_COUNT; ++i)
   {
-    if (wantIdle)
-    {
-      if (g_chgSinceMs == 0)
-        g_chgSinceMs = now;
-      if (now - g_chgSinceMs >= CHG_DWELL_MS)
-      {
-        g_chargingStable = false;
-        g_chgSinceMs = now;
-      }
-    }
-    else
-    {
-      g_chgSinceMs = 0;
-    }
+    const float a = histWindowDrawA(pk, i);
+    if (!(a == a))
+      continue;
+    sum += HIST_BLEND_W[i] * a;
+    wsum += HIST_BLEND_W[i];
   }
+  return (wsum > 0.0f) ? sum / wsum : NAN;
 }
 
-// TTE EMA + quantization with edge-aware seeding and asymmetric attack/release.
-// Pass 'force_seed=true' on the instant we ENTER discharging so it “teleports”
-// to the instantaneous TTE instead of gliding from a stale value.
-static inline float smoothQuantizedTTE(float tte_raw_h, bool force_seed = false)
+//!
+static inline void tteHistUpdate(PackState &pk, float I_raw)
 {
-  static bool init = false;
-  static float tte_disp_h = NAN;
-  static uint32_t lastMs = 0;
+  // Snap on first/small EMA, jump STEP_JUMP_GAIN of the way on a step up (>= STEP_RATIO x EMA),
+  // otherwise a dt-aware EMA with TTE_TAU_UP_MS (large dt -> alpha close to 1 -> follows quickly)
+  if (I_raw < -DISCH_MIN_ABS_A)
+    pk.tteHist.update(-I_raw, millis()); // positive magnitude
+}
+//!
 
-  const uint32_t now = millis();
-  const float dt = (lastMs == 0) ? (BMS_QUERY_MS / 1000.0f)
-                                 : (now - lastMs) / 1000.0f;
-  lastMs = now;
+// ==== PERSIST: what a pack has learned survives a reboot of the ESA
+// The current history, the tteHist EMA and the Kalman capacity are saved in NVS under the Battery
+// Box's MAC and restored from its first packet after boot, so the historical TTE is up within the
+// first second instead of after minutes of riding. handlePacket() runs in loop(), so it reads and
+// writes NVS itself; the ~3.9 KB snapshot is on the heap only while that I/O runs.
+// Wear: a full snapshot is ~3.9 KB, about one 4 KB page of the 20 KB NVS partition per write, and
+// every page takes ~100k erases. Saves happen only once PERSIST_MIN_NEW_SAMPLES of new history (or
+// a capacity change) have piled up, after a ride / charge starts or ends, or every PERSIST_PERIOD_MS
+// while learning, and never closer than PERSIST_MIN_GAP_MS: at most 12 writes per riding hour,
+// tens of thousands of riding hours before the flash wears out.
+constexpr uint32_t PERSIST_PERIOD_MS = 15 * 60 * 1000UL;
+constexpr uint32_t PERSIST_MIN_GAP_MS = 5 * 60 * 1000UL;
+constexpr uint16_t PERSIST_MIN_NEW_SAMPLES = 60;  // a minute of new 1 Hz history
+constexpr float PERSIST_CAP_CHANGE_FRAC = 0.01f;  // Kalman capacity moved by 1% since the last save
+constexpr uint16_t PERSIST_VERSION = 1;           // bump when PackSnapshot or HIST_WINDOWS change
+const char *const PERSIST_NVS_NAMESPACE = "esa";
+
+struct PackSnapshot
+{
+  uint16_t version;
+  uint16_t reserved;
+  float tteEmaA;     // NAN: tteHist had not learned anything
+  float capMah;      // NAN: the Kalman filter was not seeded
+  float capSigmaMah;
+  PackHistory::Snapshot hist; // last: only the used part of hist.samples is stored
+};
+
+static size_t persistBlobBytes(const PackSnapshot &s)
+{
+  return offsetof(PackSnapshot, hist.samples) + PackHistory::sampleCount(s.hist) * sizeof(int16_t);
+}
 
-  const bool raw_ok = (tte_raw_h == tte_raw_h) && (tte_raw_h > 0.0f);
+// NVS key of a pack: "p" + its MAC in hex (keys are at most 15 characters)
+static void persistKey(uint8_t slot, char (&key)[14])
+{
+  const uint8_t *m = g_link.stats(slot).mac;
+  snprintf(key, sizeof(key), "p%02x%02x%02x%02x%02x%02x", m[0], m[1], m[2], m[3], m[4], m[5]);
+}
 
-  // Seed hard on first use or explicit entry edge
-  if ((!init || force_seed) && raw_ok)
-  {
-    tte_disp_h = tte_raw_h;
-    init = true;
-  }
-  else if (init && raw_ok)
+static void packRestore(PackState &pk, const PackSnapshot &s)
+{
+  pk.hist.load(s.hist);
+  if (s.tteEmaA == s.tteEmaA)
+    pk.tteHist.restore(s.tteEmaA);
+  pk.socKf.setCapacityPrior(s.capMah, s.capSigmaMah);
+  pk.histReady.preset(); // the history behind it is not new, no need to wait HIST_TTE_DWELL_MS
+  pk.persistSavedCapMah = s.capMah;
+}
+
+// Reads the snapshot of pack slot from NVS into pk; false if nothing usable was saved
+static bool persistLoad(PackState &pk, uint8_t slot)
+{
+  char key[14];
+  persistKey(slot, key);
+  Preferences prefs;
+  if (!prefs.begin(PERSIST_NVS_NAMESPACE, true)) // read-only fails until the first save
   {
-    // Asymmetric smoothing: faster when TTE should drop, slower when it should rise
-    const bool dropping = (tte_raw_h < tte_disp_h);
-    const float tau = dropping ? TTE_TAU_ATTACK_S : TTE_TAU_RELEASE_S;
-    const float alpha = 1.0f - expf(-dt / tau);
-    tte_disp_h += alpha * (tte_raw_h - tte_disp_h);
+    Serial.printf("💾 [Persist] pack %d: NVS namespace not available\n", slot + 1);
+    return false;
   }
-  if (!init || !(tte_disp_h == tte_disp_h) || tte_disp_h <= 0.0f)
-    return NAN;
 
-  // Quantize to calm the UI
-  float minutes = tte_disp_h * 60.0f;
-  minutes = roundf(minutes / TTE_QUANT_MIN) * TTE_QUANT_MIN;
-  return minutes / 60.0f;
+  const uint32_t t0 = millis();
+  PackSnapshot *s = new (std::nothrow) PackSnapshot;
+  const size_t len = prefs.getBytesLength(key);
+  bool ok = s && len >= offsetof(PackSnapshot, hist.samples) && len <= sizeof(*s) && prefs.getBytes(key, s, len) == len;
+  ok = ok && s->version == PERSIST_VERSION && len == persistBlobBytes(*s);
+  if (ok)
+    packRestore(pk, *s);
+  delete s;
+  prefs.end();
+  Serial.printf("💾 [Persist] pack %d: %s %s (%u bytes, %u ms)\n", slot + 1, ok ? "restored" : "nothing usable in", key,
+                (unsigned)len, (unsigned)(millis() - t0));
+  return ok;
 }
 
-// TTF EMA + 10-min quantization with edge-aware seeding and asymmetric attack/release.
-// Pass 'force_seed=true' on the instant we ENTER stable charging so it “teleports”
-// to the instantaneous TTF instead of gliding from a stale value.
-static inline float smoothQuantizedTTF(float ttf_raw_h, bool force_seed = false)
+// Writes pk's learned state to NVS under pack slot's key
+static bool persistSave(const PackState &pk, uint8_t slot, float capMah)
 {
-  static bool init = false;
-  static float ttf_disp_h = NAN;
-  static uint32_t lastMs = 0;
-
-  const uint32_t now = millis();
-  const float dt = (lastMs == 0) ? (BMS_QUERY_MS / 1000.0f)
-                                 : (now - lastMs) / 1000.0f;
-  lastMs = now;
-
-  const bool raw_ok = (ttf_raw_h == ttf_raw_h) && (ttf_raw_h > 0.0f);
-
-  // Seed hard on first use or explicit entry edge
-  if ((!init || force_seed) && raw_ok)
+  PackSnapshot *s = new (std::nothrow) PackSnapshot;
+  if (!s)
   {
-    ttf_disp_h = ttf_raw_h;
-    init = true;
+    Serial.printf("💾 [Persist] pack %d: no heap for the snapshot\n", slot + 1);
+    return false;
   }
-  else if (init && raw_ok)
+  s->version = PERSIST_VERSION;
+  s->reserved = 0;
+  s->tteEmaA = pk.tteHist.valid() ? pk.tteHist.value() : NAN;
+  s->capMah = capMah;
+  s->capSigmaMah = pk.socKf.valid() ? pk.socKf.capacitySigmaMah() : NAN;
+  pk.hist.save(s->hist);
+
+  char key[14];
+  persistKey(slot, key);
+  const uint32_t t0 = millis();
+  const size_t len = persistBlobBytes(*s);
+  size_t put = 0;
+  Preferences prefs;
+  if (prefs.begin(PERSIST_NVS_NAMESPACE, false))
   {
-    // Faster when TTF should DROP (charging effective), slower when it rises
-    const bool dropping = (ttf_raw_h < ttf_disp_h);
-    const float tau = dropping ? TTF_TAU_ATTACK_S : TTF_TAU_RELEASE_S;
-    const float alpha = 1.0f - expf(-dt / tau);
-    ttf_disp_h += alpha * (ttf_raw_h - ttf_disp_h);
+    put = prefs.putBytes(key, s, len);
+    prefs.end();
   }
-
-  if (!init || !(ttf_disp_h == ttf_disp_h) || ttf_disp_h <= 0.0f)
-    return NAN;
-
-  // Quantize to nearest 10 minutes
-  float minutes = ttf_disp_h * 60.0f;
-  minutes = roundf(minutes / TTF_QUANT_MIN) * TTF_QUANT_MIN;
-  return minutes / 60.0f;
+  delete s;
+  Serial.printf("💾 [Persist] pack %d: %s %s (%u bytes, %u ms)\n", slot + 1, (put == len) ? "saved" : "FAILED to save", key,
+                (unsigned)len, (unsigned)(millis() - t0));
+  return put == len;
 }
 
-// Draws the correct top strip text
-// Only redraws when content changes to prevent flicker.
-void updateTopStripWithTTF_TTE()
+// Called by handlePacket() (in loop()) with every good packet of pk, before the estimators see it
+static void packPersistUpdate(PackState &pk, uint8_t slot, uint32_t nowMs)
 {
-  // Decide what we want to show
-  char line[48] = "";
-  bool wantSomething = false;
-
-  // Priority of messages:
-  // 1) If low (<=20%) -> keep "BATTERY LOW PLEASE CHARGE" (no TTE).
-  // 2) If charging and <100% -> "BATTERY CHARGING • TTF Xh Ym".
-  // 3) Else if discharging and >20% -> "TTE Xh Ym".
-  // 4) Else show current_status_msg (may be empty).
-
-  float I_raw = input_I;             // raw current value
-  float I_med = median5_ring(I_raw); // median of 5 raw current values
+  if (!pk.persistRestored)
+  {
+    persistLoad(pk, slot);
+    pk.persistRestored = true;
+    pk.persistLastSaveMs = nowMs; // what was just loaded does not need writing back soon
+    return;
+  }
 
-  // Edge detection: rising edge into stable discharging
-  static bool prevStable = false;
-  bool enteringDischarge = (g_dischargingStable && !prevStable);
-  prevStable = g_dischargingStable;
+  const bool discharging = pk.dischargeState.state();
+  const bool charging = pk.chargeState.state();
+  if (discharging != pk.persistWasDischarging || charging != pk.persistWasCharging)
+    pk.persistSavePending = true;
+  pk.persistWasDischarging = discharging;
+  pk.persistWasCharging = charging;
+
+  const float cap = pk.socKf.valid() ? pk.socKf.capacityMah() : NAN;
+  const bool capMoved = (cap == cap) && !(fabsf(cap - pk.persistSavedCapMah) <= PERSIST_CAP_CHANGE_FRAC * cap);
+  const bool learned = pk.persistNewSamples >= PERSIST_MIN_NEW_SAMPLES || capMoved;
+  const uint32_t sinceSave = nowMs - pk.persistLastSaveMs;
+  const bool due = (pk.persistSavePending && sinceSave >= PERSIST_MIN_GAP_MS) || sinceSave >= PERSIST_PERIOD_MS;
+  if (!learned || !due)
+    return;
 
-  // Edge detection: rising edge into stable charging
-  static bool prevChargeStable = false;
-  bool enteringCharge = (g_chargingStable && !prevChargeStable);
-  prevChargeStable = g_chargingStable;
+  persistSave(pk, slot, cap); // a failed write is tried again after the next gap
+  pk.persistSavePending = false;
+  pk.persistNewSamples = 0;
+  pk.persistSavedCapMah = cap;
+  pk.persistLastSaveMs = nowMs;
+}
 
-  if (I_med > 0.0f && I_med < POSITIVE_CLAMP_A) // Clamp brief positive blips/back-EMF to zero for TTE purposes
-    I_med = 0.0f;                               // treat tiny +ve as 0 A
+//!
+// --- Debug: print TTE history (throttled once/sec per pack) ---
+void debugPrintTTEHist(PackState &pk)
+{
+  const uint32_t PRINT_PERIOD_MS = 1000;
+  uint32_t now = millis();
+  if (now - pk.lastTteHistPrintMs < PRINT_PERIOD_MS)
+    return;
+  pk.lastTteHistPrintMs = now;
 
-  float soc = (float)input_soc;
-  float res_mAh = input_resmAh;
+  Serial.printf("👉 [TTEHist] pack=%d valid=", (int)(&pk - g_packs) + 1);
+  Serial.print(pk.tteHist.valid() ? F("yes") : F("no"));
+  Serial.print(F("  emaA="));
+  if (pk.tteHist.valid())
+    Serial.print(pk.tteHist.value(), 3);
+  else
+    Serial.print(F("NA"));
+  Serial.print(F(" A  win2m="));
+  Serial.print(histWindowDrawA(pk, HIST_WIN_SHORT), 2);
+  Serial.print(F(" win15m="));
+  Serial.print(histWindowDrawA(pk, HIST_WIN_MID), 2);
+  Serial.print(F(" win1h="));
+  Serial.print(histWindowDrawA(pk, HIST_WIN_LONG), 2);
+  Serial.println(F(" A"));
+}
+//!
 
-  updateDischargeState(I_med); // Maintain a stable "discharging" state with hysteresis + dwell
+float filteredCurrentA(PackState &pk)
+{
+  return pk.currentEma.update(pk.I, millis());
+}
 
-  // Learn from raw current value, don't use EMA (I_smooth), because the function already has its own EMA smoothing inside.
-  //!
-  tteHistUpdate(I_raw); // your fast-attack EMA (kept for now)
-  //!
-  histPushDischarge(I_raw); // NEW: feed historical ring buffer
+// Remaining / missing charge (mAh) for TTE and TTF, raw BMS values until the filter has seeded
+static float remainingMahEstimate(const PackState &pk)
+{
+  return pk.socKf.valid() ? pk.socKf.remainingMah() : pk.resmAh;
+}
 
-  // --- Historical TTE dwell gate ---------------------------------------------
-  static uint32_t histStartMs = 0;
-  static bool histReady = false;
-  const uint32_t nowMs = millis();
+static float toFullMahEstimate(const PackState &pk, float soc_pct)
+{
+  if (pk.socKf.valid())
+    return pk.socKf.toFullMah();
+  if (soc_pct <= 0.5f)
+    return NAN; // avoid divide-by-small when estimating capacity from resmAh / SoC
+  return pk.resmAh * (100.0f / soc_pct) - pk.resmAh;
+}
 
-  // Base conditions (same as before, but without the dwell)
+// TTE EMA + quantization with edge-aware seeding and asymmetric attack/release.
+// sigma_h picks the quantisation step (see quantStepForSigmaH).
+// Pass 'force_seed=true' on the instant we ENTER discharging so it “teleports”
+// to the instantaneous TTE instead of gliding from a stale value.
+static inline float smoothQuantizedTTE(PackState &pk, float tte_raw_h, float sigma_h, bool force_seed = false)
+{
+  if (force_seed)
+    pk.tteDisplay.head().requestSeed();
+  const uint32_t nowMs = millis();
+  pk.tteDisplay.tail().head().setStepMin(quantStepForSigmaH(pk.tteStep, sigma_h, nowMs));
+  return pk.tteDisplay.update((tte_raw_h > 0.0f) ? tte_raw_h : NAN, nowMs);
+}
+
+// TTF EMA + quantization with edge-aware seeding and asymmetric attack/release.
+// sigma_h picks the quantisation step (see quantStepForSigmaH).
+// Pass 'force_seed=true' on the instant we ENTER stable charging so it “teleports”
+// to the instantaneous TTF instead of gliding from a stale value.
+static inline float smoothQuantizedTTF(PackState &pk, float ttf_raw_h, float sigma_h, bool force_seed = false)
+{
+  if (force_seed)
+    pk.ttfDisplay.head().requestSeed();
+  const uint32_t nowMs = millis();
+  pk.ttfDisplay.tail().head().setStepMin(quantStepForSigmaH(pk.ttfStep, sigma_h, nowMs));
+  return pk.ttfDisplay.update((ttf_raw_h > 0.0f) ? ttf_raw_h : NAN, nowMs);
+}
+
+// Runs the pack's TTE/TTF estimators and decides its top strip text (pk.topLine, empty for none).
+// Called for every good packet, so each pack keeps learning while another pack's page is up.
+void packUpdateTopLine(PackState &pk)
+{
+  PROF_SCOPE(PROF_ESTIMATE);
+  char *line = pk.topLine;
+  line[0] = '\0';
+  pk.tteDispH = NAN;
+  pk.ttfDispH = NAN;
+
+  // Priority of messages:
+  // 1) If low (<=20%) -> keep "BATTERY LOW PLEASE CHARGE" (no TTE).
+  // 2) If charging and <100% -> "BATTERY CHARGING • TTF Xh Ym".
+  // 3) Else if discharging and >20% -> "TTE Xh Ym".
+  // 4) Else show the status message (may be empty).
+
+  float I_raw = pk.I;     // raw current value
+  float I_med = pk.I_med; // median of 5 raw current values
+
+  // Edge detection: rising edge into stable discharging / charging
+  bool enteringDischarge = pk.enterDischargeEdge.update(pk.dischargeState.state());
+  bool enteringCharge = pk.enterChargeEdge.update(pk.chargeState.state());
+
+  if (I_med > 0.0f && I_med < POSITIVE_CLAMP_A) // Clamp brief positive blips/back-EMF to zero for TTE purposes
+    I_med = 0.0f;                               // treat tiny +ve as 0 A
+
+  float soc = (float)pk.soc;
+  float res_mAh = remainingMahEstimate(pk); // Kalman remaining charge (raw resmAh until seeded)
+
+  const uint32_t nowMs = millis();
+  pk.dischargeState.update(I_med, nowMs); // Maintain a stable "discharging" state with hysteresis + dwell
+
+  // Learn from raw current value, don't use EMA (I_smooth), because the function already has its own EMA smoothing inside.
+  //!
+  tteHistUpdate(pk, I_raw); // your fast-attack EMA (kept for now)
+  //!
+  histPushDischarge(pk, I_raw); // NEW: feed historical ring buffer
+
+  // --- Historical TTE dwell gate ---------------------------------------------
+  // Base conditions (same as before, but without the dwell)
   bool histBaseCond =
-      (!input_chg) &&           // not charging
-      (soc > 20.0f) &&          // above low battery messaging
-      (!g_dischargingStable) && // not stably discharging
+      (!pk.chg) &&                    // not charging
+      (soc > 20.0f) &&                // above low battery messaging
+      (!pk.dischargeState.state()) && // not stably discharging
       //!
-      (g_tteHist.valid) &&
-      (g_tteHist.emaA >= DISCH_MIN_ABS_A); // EMA magnitude strong enough
-                                           //!
-                                           //! (g_histCount >= HIST_MIN_SAMPLES); // enough history
+      (pk.tteHist.valid()) &&
+      (pk.tteHist.value() >= DISCH_MIN_ABS_A); // EMA magnitude strong enough
+      //!
+      //! (pk.hist.window(HIST_WIN_SHORT).count() >= HIST_MIN_SAMPLES); // enough history
 
   // Dwell logic
-  if (histBaseCond)
-  {
-    if (histStartMs == 0)
-      histStartMs = nowMs;
-    if (!histReady && (nowMs - histStartMs >= HIST_TTE_DWELL_MS))
-      histReady = true;
-  }
-  else
-  {
-    histStartMs = 0;
-    histReady = false;
-  }
+  const bool histReady = pk.histReady.update(histBaseCond, nowMs);
 
-  if (!strcmp(current_status_msg, "BATTERY LOW PLEASE CHARGE"))
+  if (!strcmp(pk.statusMsg, "BATTERY LOW PLEASE CHARGE"))
   {
-    snprintf(line, sizeof(line), "%s", current_status_msg);
-    wantSomething = true;
+    snprintf(line, sizeof(pk.topLine), "%s", pk.statusMsg);
   }
-  else if (input_chg && soc < 100.0f && I_raw > I_MIN_ABS_A)
+  else if (pk.chg && soc < 100.0f && I_raw > I_MIN_ABS_A)
   {
-    // TTF while charging: smooth + 10-min quantization, seed when we enter stable charging
-    float I_for_ttf = filteredCurrentA(input_I);
-    float ttf_h = computeTTF_Hours(res_mAh, soc, I_for_ttf);
-    float ttf_disp_h = smoothQuantizedTTF(ttf_h, /*force_seed=*/enteringCharge);
+    // TTF while charging: smooth + quantization, seed when we enter stable charging
+    float I_for_ttf = filteredCurrentA(pk);
+    float ttf_h = computeTTF_Hours(toFullMahEstimate(pk, soc), soc, I_for_ttf);
+    float ttf_sigma_h = pk.socKf.valid() ? timeSigmaH(ttf_h, pk.socKf.toFullSigmaMah(), I_for_ttf) : NAN;
+    float ttf_disp_h = smoothQuantizedTTF(pk, ttf_h, ttf_sigma_h, /*force_seed=*/enteringCharge);
     if (ttf_disp_h == ttf_disp_h)
     {
       char dur[16];
       formatHoursToHM(ttf_disp_h, dur, sizeof(dur));
-      snprintf(line, sizeof(line), "BATTERY CHARGING - %s until full", dur);
-      wantSomething = true;
+      snprintf(line, sizeof(pk.topLine), "BATTERY CHARGING - %s until full", dur);
+      pk.ttfDispH = ttf_disp_h;
     }
   }
-  else if (!input_chg && soc > 20.0f)
+  else if (!pk.chg && soc > 20.0f)
   {
 
-    if (g_dischargingStable)
+    if (pk.dischargeState.state())
     {
       // Live TTE with robust current; ignore tiny magnitudes
       float I_for_tte = (I_med <= -DISCH_MIN_ABS_A) ? I_med : NAN;
       float tte_live_h = (I_for_tte == I_for_tte) ? computeTTE_Hours(res_mAh, I_for_tte) : NAN;
+      float tte_sigma_h = pk.socKf.valid() ? timeSigmaH(tte_live_h, pk.socKf.remainingSigmaMah(), -I_for_tte) : NAN;
 
       // Smooth + quantize for the display; seed on entry so we don't lag from a stale big value
-      float tte_disp_h = smoothQuantizedTTE(tte_live_h, /*force_seed=*/enteringDischarge);
+      float tte_disp_h = smoothQuantizedTTE(pk, tte_live_h, tte_sigma_h, /*force_seed=*/enteringDischarge);
       if (tte_disp_h == tte_disp_h)
       {
         char dur[16];
         formatHoursToHM(tte_disp_h, dur, sizeof(dur));
-        snprintf(line, sizeof(line), "Travel time left: %s", dur);
-        wantSomething = true;
+        snprintf(line, sizeof(pk.topLine), "Travel time left: %s", dur);
+        pk.tteDispH = tte_disp_h;
       }
     }
     else if (histReady)
     {
       // NEW: robust long-window typical draw
-      float A_typ = histTypicalDrawA_trimmedMean();
-      Serial.print("👉 Typical discharge current A (trimmed mean): ");
+      float A_typ = histTypicalDrawA_blended(pk);
+      Serial.print("👉 Typical discharge current A (blended trimmed mean): ");
       Serial.println(A_typ);
 
       //!
       // If not enough history yet, fall back to your EMA-based estimate
       if (!(A_typ == A_typ))
-        A_typ = g_tteHist.valid ? g_tteHist.emaA : NAN;
+        A_typ = pk.tteHist.valid() ? pk.tteHist.value() : NAN;
       //!
 
       if (A_typ == A_typ && A_typ >= DISCH_MIN_ABS_A)
       {
         float tte_h = computeTTE_Hours(res_mAh, -A_typ); // note the negative sign
-        float tte_disp_h = smoothQuantizedTTE(tte_h, false);
+        float tte_sigma_h = pk.socKf.valid() ? timeSigmaH(tte_h, pk.socKf.remainingSigmaMah(), A_typ) : NAN;
+        float tte_disp_h = smoothQuantizedTTE(pk, tte_h, tte_sigma_h, false);
         if (tte_disp_h == tte_disp_h)
         {
           char dur[16];
           formatHoursToHM(tte_disp_h, dur, sizeof(dur));
-          snprintf(line, sizeof(line), "Travel time left (historical): %s", dur);
-          wantSomething = true;
+          snprintf(line, sizeof(pk.topLine), "Travel time left (historical): %s", dur);
+          pk.tteDispH = tte_disp_h;
         }
       }
     }
   }
   else
   {
-    if (current_status_msg && *current_status_msg)
-    {
-      snprintf(line, sizeof(line), "%s", current_status_msg);
-      wantSomething = true;
-    }
+    if (pk.statusMsg && *pk.statusMsg)
+      snprintf(line, sizeof(pk.topLine), "%s", pk.statusMsg);
   }
+}
 
-  // Nothing to draw AND previously empty? bail
-  if (!wantSomething && lastTopLine[0] == '\0')
-    return;
-
-  // If unchanged, do nothing
-  if (wantSomething && (strcmp(line, lastTopLine) == 0))
-    return;
-  if (!wantSomething && lastTopLine[0] == '\0')
+// Draws the top strip text (empty string = blank strip)
+// Only redraws when content changes to prevent flicker.
+void drawTopStrip(const char *line)
+{
+  // Unchanged (including still empty)? do nothing
+  if (strcmp(line, lastTopLine) == 0)
     return;
+  PROF_SCOPE(PROF_TOPSTRIP);
 
   // --- draw into the existing top strip area ---
   tft.setFreeFont(&FreeSansBold12pt7b);
@@ -966,7 +1238,7 @@ void updateTopStripWithTTF_TTE()
                BACKGROUND_COLOUR);
 
   // Centered
-  if (wantSomething)
+  if (*line)
   {
     tft.setTextDatum(MC_DATUM);
     tft.drawString(line, tft.width() / 2, (areaTop + areaBottom) / 2);
@@ -978,19 +1250,34 @@ void updateTopStripWithTTF_TTE()
   tft.setTextFont(1);
 
   // Remember what we drew
-  if (wantSomething)
-  {
-    strncpy(lastTopLine, line, sizeof(lastTopLine) - 1);
-    lastTopLine[sizeof(lastTopLine) - 1] = '\0';
-  }
-  else
-  {
-    lastTopLine[0] = '\0';
-  }
+  strncpy(lastTopLine, line, sizeof(lastTopLine) - 1);
+  lastTopLine[sizeof(lastTopLine) - 1] = '\0';
 }
 
+// ==== PACKS: what a page shows
+enum ViewKind : uint8_t
+{
+  VIEW_DASHBOARD,
+  VIEW_LOADING,
+  VIEW_NO_DATA,
+  VIEW_NO_SIGNAL
+};
+struct PackView
+{
+  ViewKind kind;
+  int soc;
+  int chg;
+  const char *statusMsg;
+  const char *topLine;
+};
+constexpr int8_t PAGE_ALL = -1;  // all packs combined, otherwise the page is a link slot
+constexpr int8_t PAGE_NONE = -2; // nothing drawn yet
+static int8_t g_shownPage = PAGE_NONE;
+static ViewKind g_shownKind = VIEW_NO_SIGNAL; // a dashboard after this needs a full redraw
+static char g_allTopLine[48] = "";
 void drawStatus(const char *msg)
 {
+  PROF_SCOPE(PROF_STATUS);
   tft.setFreeFont(&FreeSansBold12pt7b);
   tft.setTextColor(SOME_LINE_COLOUR, BACKGROUND_COLOUR);
 
@@ -1016,7 +1303,29 @@ void drawStatus(const char *msg)
   tft.setTextFont(1);
 }
 
-void updateScreenAndSpeaker()
+// Which page is up, bottom-left inside the border (only when several packs are heard)
+void drawPageLabel()
+{
+  if (g_link.count() <= 1)
+    return;
+  char buf[12];
+  if (g_shownPage == PAGE_ALL)
+    snprintf(buf, sizeof(buf), "ALL PACKS");
+  else
+    snprintf(buf, sizeof(buf), "PACK %d", g_shownPage + 1);
+
+  tft.setTextFont(2);
+  tft.setTextSize(1);
+  tft.setTextColor(SOME_LINE_COLOUR, BACKGROUND_COLOUR);
+  tft.setTextDatum(BL_DATUM);
+  tft.drawString(buf, BORDER_THICKNESS + 6, tft.height() - BORDER_THICKNESS - 4);
+
+  // Restore defaults
+  tft.setTextDatum(TL_DATUM);
+  tft.setTextFont(1);
+}
+
+void updateScreen()
 {
   if (input_soc != previous_soc || input_chg != previous_chg)
   {
@@ -1030,6 +1339,7 @@ void updateScreenAndSpeaker()
     if (input_soc != previous_soc)
     {
       drawPercentage(input_soc);
+      drawPageLabel(); // shares the band drawPercentage clears
     }
 
     // Redraw the coloured border, coloured bars, and cross only when the colour has changed (i.e., the current SoC value is within a different range from before)
@@ -1050,46 +1360,71 @@ void updateScreenAndSpeaker()
       }
     }
 
-    if (input_soc != previous_soc || input_chg != previous_chg)
-    {
-      if (!strcmp(current_status_msg, "BATTERY FULL!"))
-      {
-        playAudio(current_status_msg);
-        // Plays when charged to 100%
-      }
-      else if (input_chg == 0 && !strcmp(current_status_msg, "BATTERY LOW PLEASE CHARGE"))
-      {
-        bool onStep = (input_soc == 20) || (input_soc == 15) || (input_soc <= 10);
-        if (onStep && input_soc != lastLowSOCAudioPlayed)
-        {
-          playAudio(current_status_msg);
-          lastLowSOCAudioPlayed = input_soc;
-          // "Battery Low. Please Charge" only at 20, 15, and every value 10..0, and only when NOT charging
-        }
-        // reset memory when we climb back out of the low zone
-        if (input_soc > 20)
-          lastLowSOCAudioPlayed = -1;
-      }
-      else if (!strcmp(current_status_msg, previous_status_msg) && !strcmp(current_status_msg, ""))
-      {
-        playAudio(current_status_msg);
-      }
-    }
-
     // Redraw the status message only when the message has changed.
     if (strcmp(current_status_msg, previous_status_msg) != 0)
     {
       drawStatus(current_status_msg);
-      if (strcmp(current_status_msg, "BATTERY CHARGING") == 0)
+    }
+  }
+}
+
+// Audio cues follow the all-packs view (with one pack, that pack), so paging does not repeat them
+static int g_cueSoc = -1;
+static int g_cueChg = -1;
+static const char *g_cueStatusMsg = "";
+
+void updateSpeaker(int soc, int chg, const char *status_msg)
+{
+  PROF_SCOPE(PROF_AUDIO);
+  if (soc != g_cueSoc || chg != g_cueChg)
+  {
+    if (!strcmp(status_msg, "BATTERY FULL!"))
+    {
+      playAudio(status_msg);
+      // Plays when charged to 100%
+    }
+    else if (chg == 0 && !strcmp(status_msg, "BATTERY LOW PLEASE CHARGE"))
+    {
+      bool onStep = (soc == 20) || (soc == 15) || (soc <= 10);
+      if (onStep && soc != lastLowSOCAudioPlayed)
       {
-        playAudio(current_status_msg);
-        // "Charging" is only played when the status changes to it.
+        playAudio(status_msg);
+        lastLowSOCAudioPlayed = soc;
+        // "Battery Low. Please Charge" only at 20, 15, and every value 10..0, and only when NOT charging
       }
+      // reset memory when we climb back out of the low zone
+      if (soc > 20)
+        lastLowSOCAudioPlayed = -1;
+    }
+    else if (!strcmp(status_msg, g_cueStatusMsg) && !strcmp(status_msg, ""))
+    {
+      playAudio(status_msg);
+    }
+
+    if (strcmp(status_msg, g_cueStatusMsg) != 0 && strcmp(status_msg, "BATTERY CHARGING") == 0)
+    {
+      playAudio(status_msg);
+      // "Charging" is only played when the status changes to it.
     }
   }
 
-  // Always refresh the top strip with TTF/TTE logic (handles changing current)
-  updateTopStripWithTTF_TTE();
+  g_cueSoc = soc;
+  g_cueChg = chg;
+  g_cueStatusMsg = status_msg;
+}
+
+// Draw every dashboard element from scratch after the screen was wiped (no audio cues)
+void redrawDashboard()
+{
+  drawBorder(input_soc);
+  drawBatteryIcon(input_soc, input_chg);
+  drawBatteryBars(input_soc);
+  if (input_chg && isBatteryBarsWiped)
+    drawLightningBolt();
+  drawPercentage(input_soc);
+  drawPageLabel();
+  drawStatus(current_status_msg);
+  lastTopLine[0] = '\0'; // make the top strip redraw too
 }
 
 void noDataText()
@@ -1140,25 +1475,382 @@ void LoadingDataText()
   tft.print("Loading Data");
 }
 
+// Shown when no Battery Box has been heard for LINK_STALE_MS
+void noSignalText()
+{
+  tft.setTextDatum(TL_DATUM);
+  tft.setTextFont(1); // built-in font index
+  tft.setTextSize(1); // ensure no leftover scaling
+  tft.setFreeFont(nullptr);
+
+  if (lowBlinkState)
+  {
+    lowBlinkState = false;
+    tft.invertDisplay(false);
+  }
+  tft.fillScreen(BLACK);
+
+  // Use a known font + datum
+  tft.setFreeFont(&FreeSansBold24pt7b);
+  tft.setTextDatum(MC_DATUM);
+
+  tft.setTextSize(1); // big error text is fine
+  tft.setTextColor(RED, BLACK);
+  tft.setCursor(30, tft.height() / 2);
+  tft.print("No Signal");
+}
+
+// ==== PACKS: one pack's page
+void packView(uint8_t slot, PackView &v)
+{
+  const PackState &pk = g_packs[slot];
+  v.soc = pk.soc;
+  v.chg = pk.chg;
+  v.statusMsg = pk.statusMsg;
+  v.topLine = pk.topLine;
+  if (g_link.stats(slot).stale)
+    v.kind = VIEW_NO_SIGNAL;
+  else if (pk.crcFailCnt > 0 && pk.bmsOk)
+    v.kind = VIEW_LOADING; // counting back down after CRC errors
+  else if (pk.crcFailed)
+    v.kind = VIEW_NO_DATA;
+  else if (pk.soc < 0)
+    v.kind = VIEW_LOADING; // nothing good from this pack yet
+  else
+    v.kind = VIEW_DASHBOARD;
+}
+
+// ==== PACKS: all packs that currently have good data, combined.
+// SoC is weighted by each pack's (Kalman) capacity, charging if any pack charges, TTE is the
+// shortest pack TTE (the first pack to run out ends the ride) and TTF the longest.
+void allPacksView(PackView &v)
+{
+  float socSum = 0.0f, capSum = 0.0f;
+  float tteMinH = NAN, ttfMaxH = NAN;
+  uint8_t used = 0, loading = 0;
+  int8_t only = -1;
+  bool anyChg = false;
+  for (uint8_t i = 0; i < g_link.capacity(); ++i)
+  {
+    if (!g_link.inUse(i))
+      continue;
+    PackView pv;
+    packView(i, pv);
+    if (pv.kind == VIEW_LOADING)
+      ++loading;
+    if (pv.kind != VIEW_DASHBOARD)
+      continue;
+    const PackState &pk = g_packs[i];
+    const float cap = pk.socKf.valid() ? pk.socKf.capacityMah() : SOC_KF_PARAMS.capInitMah;
+    socSum += pk.soc * cap;
+    capSum += cap;
+    anyChg = anyChg || pk.chg;
+    if (pk.tteDispH == pk.tteDispH && !(pk.tteDispH >= tteMinH))
+      tteMinH = pk.tteDispH;
+    if (pk.ttfDispH == pk.ttfDispH && !(pk.ttfDispH <= ttfMaxH))
+      ttfMaxH = pk.ttfDispH;
+    only = i;
+    ++used;
+  }
+
+  v.topLine = g_allTopLine;
+  g_allTopLine[0] = '\0';
+  if (used == 0)
+  {
+    v.kind = loading ? VIEW_LOADING : VIEW_NO_DATA;
+    v.soc = -1;
+    v.chg = -1;
+    v.statusMsg = "";
+    return;
+  }
+  v.kind = VIEW_DASHBOARD;
+  if (used == 1)
+  {
+    packView(only, v); // exactly that pack, including its historical-TTE wording
+    return;
+  }
+
+  v.soc = constrain((int)lroundf(socSum / capSum), 0, 100);
+  v.chg = anyChg ? 1 : 0;
+  v.statusMsg = statusMessage(v.soc, v.chg);
+
+  // Same priority as packUpdateTopLine()
+  char dur[16];
+  if (!strcmp(v.statusMsg, "BATTERY LOW PLEASE CHARGE"))
+  {
+    snprintf(g_allTopLine, sizeof(g_allTopLine), "%s", v.statusMsg);
+  }
+  else if (v.chg && v.soc < 100)
+  {
+    if (ttfMaxH == ttfMaxH)
+    {
+      formatHoursToHM(ttfMaxH, dur, sizeof(dur));
+      snprintf(g_allTopLine, sizeof(g_allTopLine), "BATTERY CHARGING - %s until full", dur);
+    }
+  }
+  else if (!v.chg && v.soc > 20)
+  {
+    if (tteMinH == tteMinH)
+    {
+      formatHoursToHM(tteMinH, dur, sizeof(dur));
+      snprintf(g_allTopLine, sizeof(g_allTopLine), "Travel time left: %s", dur);
+    }
+  }
+  else if (*v.statusMsg)
+  {
+    snprintf(g_allTopLine, sizeof(g_allTopLine), "%s", v.statusMsg);
+  }
+}
+
+// ==== PACKS: page due now. One pack: always that pack. Several: all packs, then each pack in
+// slot order, ESA_PAGE_MS each.
+static int8_t currentPage()
+{
+  const uint8_t n = g_link.count();
+  if (n <= 1)
+    return 0;
+  const uint8_t p = (millis() / ESA_PAGE_MS) % (n + 1);
+  return (p == 0) ? PAGE_ALL : (int8_t)(p - 1);
+}
+
+// Draw the page that is due. A new page, or a page that stops showing a message screen, is drawn
+// from scratch; otherwise only what changed is redrawn, as with a single pack.
+void renderPage()
+{
+  PROF_SCOPE(PROF_RENDER);
+  const int8_t page = currentPage();
+  PackView v;
+  if (page == PAGE_ALL)
+    allPacksView(v);
+  else
+    packView((uint8_t)page, v);
+
+  const bool changed = (page != g_shownPage) || (v.kind != g_shownKind);
+  const bool wasDashboard = (g_shownKind == VIEW_DASHBOARD);
+  g_shownPage = page;
+  g_shownKind = v.kind;
+
+  if (v.kind != VIEW_DASHBOARD)
+  {
+    if (!changed)
+      return;
+    if (v.kind == VIEW_LOADING)
+      LoadingDataText();
+    else if (v.kind == VIEW_NO_DATA)
+      noDataText();
+    else
+      noSignalText();
+    return;
+  }
+
+  input_soc = v.soc;
+  input_chg = v.chg;
+  current_status_msg = v.statusMsg;
+  if (changed)
+  {
+    if (lowBlinkState)
+    {
+      lowBlinkState = false;
+      tft.invertDisplay(false);
+    }
+    if (!wasDashboard)
+      tft.fillScreen(BLACK);
+    redrawDashboard(); // nothing on screen to diff against
+  }
+  updateScreen();
+  drawTopStrip(v.topLine);
+
+  // Update previous values
+  previous_soc = input_soc;
+  previous_chg = input_chg;
+  previous_status_msg = current_status_msg;
+}
+
+// ==== LINK: per-peer stats for placing the radios (throttled)
+void debugPrintLinkStats()
+{
+  static uint32_t lastPrint = 0;
+  uint32_t now = millis();
+  if (now - lastPrint < LINK_STATS_PRINT_MS)
+    return;
+  lastPrint = now;
+
+  for (uint8_t i = 0; i < g_link.capacity(); ++i)
+  {
+    if (!g_link.inUse(i))
+      continue;
+    const PeerLinkStats &p = g_link.stats(i);
+    char macStr[18];
+    formatMacAddress(p.mac, macStr, sizeof(macStr));
+    Serial.printf("📶 [Link] %s %s pkts=%lu age=%lums gap=%.0fms jitter=%.1fms maxGap=%lums lost=%lu restarts=%lu",
+                  macStr, p.stale ? "STALE" : "ok", (unsigned long)p.packets, (unsigned long)(now - p.lastSeenMs),
+                  p.meanGapMs, p.jitterMs, (unsigned long)p.maxGapMs, (unsigned long)p.seqGaps, (unsigned long)p.seqResets);
+    if (p.hasRssi)
+      Serial.printf(" rssi=%d avg=%.1f min=%d dBm\n", p.rssiLast, p.rssiAvg, p.rssiMin);
+    else
+      Serial.println(" rssi=NA");
+  }
+}
+
+#if ESA_PROFILE
+#if ESA_PROFILE_OVERLAY
+// ==== PROFILE: averages of the heavy stages in the bottom border (font 1 is as tall as the border)
+void drawProfileOverlay()
+{
+  char buf[64];
+  snprintf(buf, sizeof(buf), " cb %.0f est %.0f rnd %.0f top %.0f us ",
+           g_prof.avgUs(PROF_CALLBACK), g_prof.avgUs(PROF_ESTIMATE), g_prof.avgUs(PROF_RENDER), g_prof.avgUs(PROF_TOPSTRIP));
+  tft.setTextFont(1);
+  tft.setTextSize(1);
+  tft.setTextColor(BLACK, colourForSOC(input_soc));
+  tft.setTextDatum(BR_DATUM);
+  tft.drawString(buf, tft.width() - BORDER_THICKNESS, tft.height());
+  tft.setTextDatum(TL_DATUM);
+}
+#endif
+
+// ==== PROFILE: compact per-stage report (throttled), then start a new period
+void debugPrintProfile()
+{
+  static uint32_t lastPrint = 0;
+  uint32_t now = millis();
+  if (now - lastPrint < PROFILE_REPORT_MS)
+    return;
+  lastPrint = now;
+
+  Serial.print("⏱ [Prof] stage        n    min    avg    max us | histogram <1");
+  for (uint8_t b = 1; b < g_prof.bins(); ++b)
+    Serial.printf(" %lu", (unsigned long)g_prof.binLowUs(b));
+  Serial.println(" us");
+  for (uint8_t i = 0; i < PROF_STAGE_COUNT; ++i)
+  {
+    const StageStats &st = g_prof.stats(i);
+    if (st.count == 0)
+      continue;
+    Serial.printf("⏱ [Prof] %-9s %5lu %6.0f %6.0f %6.0f    |", PROF_STAGE_NAMES[i], (unsigned long)st.count,
+                  g_prof.minUs(i), g_prof.avgUs(i), g_prof.maxUs(i));
+    for (uint8_t b = 0; b < g_prof.bins(); ++b)
+      Serial.printf(" %lu", (unsigned long)g_prof.bin(i, b));
+    Serial.println();
+  }
+#if ESA_PROFILE_OVERLAY
+  drawProfileOverlay();
+#endif
+  g_prof.reset();
+}
+#endif
+
+// ==== LINK: RSSI of ESP-NOW frames. ESP-NOW rides on 802.11 action frames, so a management-frame
+// promiscuous callback sees the same packet with its rx_ctrl; addr2 (offset 10) is the sender.
+static void linkSnifferCallback(void *buf, wifi_promiscuous_pkt_type_t type)
+{
+  if (type != WIFI_PKT_MGMT)
+    return;
+  const wifi_promiscuous_pkt_t *pkt = (const wifi_promiscuous_pkt_t *)buf;
+  if (pkt->rx_ctrl.sig_len < 24 || pkt->payload[0] != 0xD0) // action frame header
+    return;
+  g_link.onRssi(pkt->payload + 10, (int8_t)pkt->rx_ctrl.rssi);
+}
+
+// ==== LINK: watchdog fired, let loop() decide whether to show "No Signal"
+static void staleTimerCallback(void *)
+{
+  xTaskNotify(g_mainTask, EVT_LINK_STALE, eSetBits);
+}
+
+static bool parseMacAddress(const char *str, uint8_t *mac)
+{
+  unsigned v[6];
+  if (sscanf(str, "%x:%x:%x:%x:%x:%x", &v[0], &v[1], &v[2], &v[3], &v[4], &v[5]) != 6)
+    return false;
+  for (uint8_t i = 0; i < 6; ++i)
+    mac[i] = (uint8_t)v[i];
+  return true;
+}
+
+// ==== LINK: packets handed from the ESP-NOW (WiFi) task to loop()
+// receiveCallback() only copies the frame into this ring and sets EVT_PACKET. loop() does the
+// estimators, drawing, blink timer and panel power, so tft and the display state (linkLost,
+// g_shownKind, g_blinkTimerRunning, ...) are only ever touched by the loop() task.
+constexpr uint8_t RX_RING_LEN = 4; // packets come at ~4 Hz; loop() empties the ring on every wakeup
+struct RxPacket
+{
+  uint8_t mac[6];
+  uint32_t ms; // receive time
+  uint8_t len; // bytes in data (older senders send no seq)
+  uint8_t data[sizeof(struct_message)];
+};
+static RxPacket g_rxRing[RX_RING_LEN];
+static uint8_t g_rxHead = 0;
+static uint8_t g_rxCount = 0;
+static uint32_t g_rxDropped = 0; // oldest packets overwritten because loop() fell behind
+static portMUX_TYPE g_rxMux = portMUX_INITIALIZER_UNLOCKED;
+
 // Callback function that you want executed when data is received
 // The arguments of the callback function are fixed to be this three.
 void receiveCallback(const uint8_t *macAddr, const uint8_t *incomingData, int dataLen)
 {
   // Only allow a maximum of 250 characters in the message
-  if (dataLen > ESP_NOW_MAX_DATA_LEN)
+  if (dataLen > ESP_NOW_MAX_DATA_LEN || dataLen <= 0)
   {
     return;
   }
 
+  const uint32_t now = millis();
+  portENTER_CRITICAL(&g_rxMux);
+  if (g_rxCount == RX_RING_LEN)
+  {
+    g_rxHead = (g_rxHead + 1) % RX_RING_LEN; // keep the newest
+    g_rxCount--;
+    g_rxDropped++;
+  }
+  RxPacket &rx = g_rxRing[(g_rxHead + g_rxCount) % RX_RING_LEN];
+  memcpy(rx.mac, macAddr, sizeof(rx.mac));
+  rx.ms = now;
+  rx.len = (uint8_t)min((size_t)dataLen, sizeof(rx.data));
+  memcpy(rx.data, incomingData, rx.len);
+  g_rxCount++;
+  portEXIT_CRITICAL(&g_rxMux);
+  xTaskNotify(g_mainTask, EVT_PACKET, eSetBits);
+}
+
+// Runs in loop() for every packet receiveCallback() queued
+static void handlePacket(const RxPacket &rx)
+{
+#if ESA_PROFILE
+  debugPrintProfile(); // before this packet's own stage starts, so the report is not timed
+#endif
+  PROF_SCOPE(PROF_CALLBACK);
+
+  // Drop senders we do not know before doing any other work
+  const int8_t peer = g_link.accept(rx.mac);
+  if (peer < 0)
+  {
+    return;
+  }
+
+  PackState &pk = g_packs[peer];
+
   char macStr[18];
-  formatMacAddress(macAddr, macStr, 18);
+  formatMacAddress(rx.mac, macStr, 18);
   // Send Debug log message to the serial port
   Serial.println("----------------------------------------------------");
-  Serial.printf("Received message from: %s\n", macStr);
-
-  memcpy(&BMSData, incomingData, sizeof(BMSData));
+  Serial.printf("Received message from: %s (pack %d)\n", macStr, peer + 1);
+
+  memset(&BMSData, 0, sizeof(BMSData));
+  memcpy(&BMSData, rx.data, rx.len); // older senders send no seq
+  const bool hasSeq = (size_t)rx.len >= offsetof(struct_message, seq) + sizeof(BMSData.seq);
+  g_link.onPacket(peer, rx.ms, hasSeq, BMSData.seq);
+  g_link.checkStale(millis()); // another pack keeps the watchdog fed, so a quiet one is caught here
+  if (g_staleTimer)
+  {
+    esp_timer_stop(g_staleTimer); // watchdog: fires only if the next packet does not come in time
+    esp_timer_start_once(g_staleTimer, LINK_STALE_MS * 1000ULL);
+  }
+  linkLost = false; // renderPage() replaces "No Signal" with the dashboard
+  debugPrintLinkStats();
   Serial.print("Data received: ");
-  Serial.println(dataLen);
+  Serial.println(rx.len);
   Serial.print("BMS Status Received: ");
   Serial.println(BMSData.bms_status);
   Serial.print("BMS SoC Received: ");
@@ -1169,40 +1861,43 @@ void receiveCallback(const uint8_t *macAddr, const uint8_t *incomingData, int da
   Serial.println(BMSData.resmAh);
   Serial.println();
 
-  if (BMSData.bms_status == 1 && crcFailCnt == 0)
+  pk.bmsOk = (BMSData.bms_status == 1);
+  if (BMSData.bms_status == 1 && pk.crcFailCnt == 0)
   {
-    if (crcFailed == true)
-    {
-      crcFailed = false;
-      tft.fillScreen(BLACK);
-    }
+    pk.crcFailed = false;
+    packPersistUpdate(pk, (uint8_t)peer, millis()); // restore after boot / save when due
 
-    input_soc = constrain((int)ceilf(BMSData.soc), 0, 100);
+    pk.soc = constrain((int)ceilf(BMSData.soc), 0, 100);
 
     // Build a robust current for state logic (median + clamp small +ve to 0)
-    float I_med_all = median5_ring(BMSData.I); // you already have median5_ring(...)
+    float I_med_all = pk.currentMedian5.update(BMSData.I); // once per sample, reused by the top strip
+    pk.I_med = I_med_all;
     float I_chg_robust = I_med_all;
     if (I_chg_robust > 0.0f && I_chg_robust < POSITIVE_CLAMP_A)
       I_chg_robust = 0.0f; // ignore tiny +ve blips (regen/back-EMF trickle)
 
-    // Update stable charging state and derive input_chg from it
-    updateChargingState(I_chg_robust);
-    input_chg = g_chargingStable ? 1 : 0;
+    // Update stable charging state and derive the pack's charge state from it
+    pk.chargeState.update(I_chg_robust, millis());
+    pk.chg = pk.chargeState.state() ? 1 : 0;
 
-    statusMessage(input_soc, input_chg); // Updates current_status_message
-    input_I = BMSData.I;                 // +A charge, -A discharge
-    input_resmAh = max(0.0f, BMSData.resmAh);
+    pk.statusMsg = statusMessage(pk.soc, pk.chg);
+    pk.I = BMSData.I; // +A charge, -A discharge
+    pk.resmAh = max(0.0f, BMSData.resmAh);
+    pk.socKf.update(BMSData.I, pk.resmAh, BMSData.soc, millis()); // fuse into the remaining-charge estimate
 
     Serial.print("Current SoC: ");
-    Serial.println(input_soc);
+    Serial.println(pk.soc);
     Serial.print("Current Charge Status: ");
-    Serial.println(input_chg);
+    Serial.println(pk.chg);
     Serial.print("Current Status Message: ");
-    Serial.println(current_status_msg);
+    Serial.println(pk.statusMsg);
     Serial.print("Current: ");
-    Serial.println(input_I);
+    Serial.println(pk.I);
     Serial.print("Remaining Capacity (mAh): ");
-    Serial.println(input_resmAh);
+    Serial.println(pk.resmAh);
+    Serial.printf("Kalman remaining: %.0f +/- %.0f mAh of %.0f +/- %.0f mAh\n",
+                  pk.socKf.remainingMah(), pk.socKf.remainingSigmaMah(),
+                  pk.socKf.capacityMah(), pk.socKf.capacitySigmaMah());
 
     Serial.print("Previous SoC: ");
     Serial.println(previous_soc);
@@ -1212,40 +1907,72 @@ void receiveCallback(const uint8_t *macAddr, const uint8_t *incomingData, int da
     Serial.println(previous_status_msg);
 
     //!
-    debugPrintTTEHist();
+    debugPrintTTEHist(pk);
     //!
 
-    updateScreenAndSpeaker();
+    packUpdateTopLine(pk); // every pack keeps learning, whichever page is up
 
-    // Update previous values
-    previous_soc = input_soc;
-    previous_chg = input_chg;
-    previous_status_msg = current_status_msg;
+    PackView all;
+    allPacksView(all);
+    if (all.kind == VIEW_DASHBOARD)
+      updateSpeaker(all.soc, all.chg, all.statusMsg);
   }
-  else if (BMSData.bms_status == 1 && crcFailCnt > 0)
+  else if (BMSData.bms_status == 1 && pk.crcFailCnt > 0)
   {
-    crcFailCnt--;
+    pk.crcFailCnt--;
     Serial.println("!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!");
     Serial.print("CRC failure count: ");
-    Serial.println(crcFailCnt);
+    Serial.println(pk.crcFailCnt);
     Serial.println("!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!");
-    LoadingDataText();
   }
   else if (BMSData.bms_status == 0)
   {
-    crcFailCnt++;
+    pk.crcFailCnt++;
     Serial.println();
     Serial.println("!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!");
     Serial.print("CRC failure count: ");
-    Serial.println(crcFailCnt);
+    Serial.println(pk.crcFailCnt);
     Serial.println("!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!");
     Serial.println();
-    if (crcFailCnt > 5)
+    if (pk.crcFailCnt > 5)
     {
-      noDataText();
-      crcFailCnt = 6;
-      crcFailed = true;
+      pk.crcFailCnt = 6;
+      pk.crcFailed = true;
+    }
+  }
+
+  renderPage();       // "Loading Data" / "No Data" are page contents now
+  updateBlinkTimer(); // SoC, charge state or CRC state may have changed
+  panelPowerUpdate();
+}
+
+// EVT_PACKET: take the queued packets one at a time, oldest first
+static void drainPackets()
+{
+  static uint32_t reportedDrops = 0;
+  for (;;)
+  {
+    RxPacket rx;
+    bool have = false;
+    uint32_t dropped;
+    portENTER_CRITICAL(&g_rxMux);
+    if (g_rxCount > 0)
+    {
+      rx = g_rxRing[g_rxHead];
+      g_rxHead = (g_rxHead + 1) % RX_RING_LEN;
+      g_rxCount--;
+      have = true;
+    }
+    dropped = g_rxDropped;
+    portEXIT_CRITICAL(&g_rxMux);
+    if (dropped != reportedDrops)
+    {
+      Serial.printf("📶 [Link] loop() fell behind, %lu packets dropped so far\n", (unsigned long)dropped);
+      reportedDrops = dropped;
     }
+    if (!have)
+      return;
+    handlePacket(rx);
   }
 }
 
@@ -1257,10 +1984,130 @@ void IRAM_ATTR onButtonISR()
   if (now - g_lastButtonIsrUs >= BUTTON_DEBOUNCE_US)
   {
     g_lastButtonIsrUs = now;
-    g_buttonEvent = true; // signal main loop
+    BaseType_t woken = pdFALSE;
+    xTaskNotifyFromISR(g_mainTask, EVT_BUTTON, eSetBits, &woken); // wake loop()
+    if (woken)
+      portYIELD_FROM_ISR();
   }
 }
 
+// ==== EVENTS: 1 Hz blink timer, only running while the low-battery blink is wanted
+static void blinkTimerCallback(void *)
+{
+  xTaskNotify(g_mainTask, EVT_BLINK, eSetBits);
+}
+
+static inline bool blinkWanted()
+{
+  // Blinking behaviour for low battery (< = 20) and not charging
+  return g_shownKind == VIEW_DASHBOARD && !input_chg && input_soc <= 20 && linkLost == false;
+}
+
+// Start / stop the blink timer to match blinkWanted(). Called from loop() after every packet.
+void updateBlinkTimer()
+{
+  if (!g_blinkTimer)
+    return;
+  const bool want = blinkWanted();
+  if (want && !g_blinkTimerRunning)
+  {
+    esp_timer_start_periodic(g_blinkTimer, BLINK_PERIOD_MS * 1000ULL);
+    g_blinkTimerRunning = true;
+    xTaskNotify(g_mainTask, EVT_BLINK, eSetBits); // first toggle straight away, as the old millis() check did
+  }
+  else if (!want && g_blinkTimerRunning)
+  {
+    esp_timer_stop(g_blinkTimer); // un-inverting is left to the redraw paths, as before
+    g_blinkTimerRunning = false;
+  }
+}
+
+// ==== PANEL POWER: state and transitions
+enum PanelPower : uint8_t
+{
+  PANEL_ON,
+  PANEL_DIM,
+  PANEL_SLEEP
+};
+static PanelPower g_panelPower = PANEL_ON;
+static uint32_t g_panelActiveMs = 0; // last wake event
+static uint32_t g_panelParkedMs = 0; // last time any pack was discharging or charging
+static int g_panelLastSoc = -1;
+static int g_panelLastChg = -1;
+
+static inline void backlightWrite(uint8_t duty)
+{
+  if (TFT_BL_PIN >= 0)
+    ledcWrite(BL_LEDC_CHANNEL, duty);
+}
+
+void setPanelPower(PanelPower p)
+{
+  if (p == g_panelPower)
+    return;
+  if (g_panelPower == PANEL_SLEEP)
+  {
+    tft.writecommand(PANEL_CMD_SLPOUT);
+    delay(5);
+    tft.writecommand(PANEL_CMD_DISPON);
+  }
+  if (p == PANEL_SLEEP)
+  {
+    backlightWrite(0);
+    tft.writecommand(PANEL_CMD_DISPOFF);
+    tft.writecommand(PANEL_CMD_SLPIN);
+  }
+  else
+  {
+    backlightWrite(p == PANEL_DIM ? BL_DUTY_DIM : BL_DUTY_ON);
+  }
+  g_panelPower = p;
+  Serial.printf("🔆 [Panel] %s at %lu ms\n", p == PANEL_ON ? "ON" : (p == PANEL_DIM ? "DIM" : "SLEEP"), (unsigned long)millis());
+}
+
+// Wake event: full brightness now, and restart the dim countdown. True if the panel was dimmed
+// or asleep, so the event that woke it can be swallowed.
+bool panelWake()
+{
+  g_panelActiveMs = millis();
+  const bool woke = (g_panelPower != PANEL_ON);
+  setPanelPower(PANEL_ON);
+  return woke;
+}
+
+// Idle policy, run by loop() after every received packet
+void panelPowerUpdate()
+{
+  if (TFT_BL_PIN < 0)
+    return; // no backlight control: stays ON
+  const uint32_t now = millis();
+  PackView all;
+  allPacksView(all);
+
+  bool moving = false;
+  for (uint8_t i = 0; i < g_link.capacity(); ++i)
+    if (g_link.inUse(i) && !g_link.stats(i).stale && g_packs[i].dischargeState.state())
+      moving = true;
+
+  const bool alarm = linkLost || g_shownKind != VIEW_DASHBOARD || blinkWanted();
+  const bool chargeStart = (all.chg == 1 && g_panelLastChg != 1);
+  const bool socChanged = (all.soc != g_panelLastSoc);
+  g_panelLastSoc = all.soc;
+  g_panelLastChg = all.chg;
+  if (moving || all.chg == 1)
+    g_panelParkedMs = now;
+  if (alarm || chargeStart || socChanged)
+  {
+    panelWake();
+    return;
+  }
+
+  PanelPower want = PANEL_ON;
+  if (now - g_panelActiveMs >= PANEL_DIM_AFTER_MS)
+    want = (now - g_panelParkedMs >= PANEL_SLEEP_AFTER_MS) ? PANEL_SLEEP : PANEL_DIM;
+  setPanelPower(want);
+}
+
 // ==== BUTTON ISR: helper to toggle MOSFET (called from loop, not from ISR)
 void handleButtonToggle()
 {
@@ -1273,6 +2120,7 @@ void handleButtonToggle()
   audio_module_on = (audio_module_on == true) ? false : true;
   if (audio_module_on == false)
   {
+    audioSchedulerStop(); // drop queued cues before holding the silent pattern
     digitalWrite(DYSV8F_IO0, HIGH);
     digitalWrite(DYSV8F_IO1, HIGH);
     digitalWrite(DYSV8F_IO2, LOW);
@@ -1296,6 +2144,23 @@ void setup()
   Serial.begin(115200);
   delay(50);
 
+  g_mainTask = xTaskGetCurrentTaskHandle(); // loop() runs in this task; the ISR and timers notify it
+  esp_timer_create_args_t blinkArgs = {};
+  blinkArgs.callback = &blinkTimerCallback;
+  blinkArgs.dispatch_method = ESP_TIMER_TASK;
+  blinkArgs.name = "blink";
+  esp_timer_create(&blinkArgs, &g_blinkTimer);
+
+#if CONFIG_PM_ENABLE
+  esp_pm_config_esp32_t pm = {};
+  pm.max_freq_mhz = ESA_PM_MAX_MHZ;
+  pm.min_freq_mhz = ESA_PM_MIN_MHZ;
+#if CONFIG_FREERTOS_USE_TICKLESS_IDLE
+  pm.light_sleep_enable = ESA_PM_LIGHT_SLEEP;
+#endif
+  esp_pm_configure(&pm);
+#endif
+
   pinMode(BUTTON, INPUT_PULLDOWN);
   pinMode(MOSFET_GATE, OUTPUT);
   digitalWrite(MOSFET_GATE, HIGH); // Switch on load initially
@@ -1308,6 +2173,12 @@ void setup()
   tft.init();
   tft.setRotation(ROTATION);
   tft.fillScreen(BACKGROUND_COLOUR);
+  if (TFT_BL_PIN >= 0)
+  {
+    ledcSetup(BL_LEDC_CHANNEL, BL_PWM_HZ, BL_PWM_BITS);
+    ledcAttachPin(TFT_BL_PIN, BL_LEDC_CHANNEL);
+    backlightWrite(BL_DUTY_ON);
+  }
 
   pinMode(DYSV8F_IO0, OUTPUT);
   pinMode(DYSV8F_IO1, OUTPUT);
@@ -1315,6 +2186,7 @@ void setup()
   digitalWrite(DYSV8F_IO0, HIGH);
   digitalWrite(DYSV8F_IO1, HIGH);
   digitalWrite(DYSV8F_IO2, HIGH);
+  audioSchedulerBegin();
 
 #define LCD_SELFTEST 1 // Note - Sanity check
 #ifdef LCD_SELFTEST
@@ -1341,6 +2213,8 @@ void setup()
   if (esp_now_init() == ESP_OK)
   {
     Serial.println("ESP-NOW Init Success");
+    if (LINK_ALLOWED_PEERS[0] == nullptr)
+      Serial.println("ESP-NOW learn mode: the first Battery Box heard is kept until reboot");
     esp_now_register_recv_cb(receiveCallback);
   }
   else
@@ -1349,34 +2223,65 @@ void setup()
     delay(3000);
     ESP.restart();
   }
+
+  // Link monitor: allowed senders, RSSI sniffer and the stale watchdog
+  for (uint8_t i = 0; LINK_ALLOWED_PEERS[i] != nullptr; ++i)
+  {
+    uint8_t mac[6];
+    if (parseMacAddress(LINK_ALLOWED_PEERS[i], mac))
+      g_link.addPeer(mac);
+  }
+#if LINK_RSSI_SNIFF
+  wifi_promiscuous_filter_t filter = {};
+  filter.filter_mask = WIFI_PROMIS_FILTER_MASK_MGMT;
+  esp_wifi_set_promiscuous_filter(&filter);
+  esp_wifi_set_promiscuous_rx_cb(&linkSnifferCallback);
+  esp_wifi_set_promiscuous(true);
+#endif
+  esp_timer_create_args_t staleArgs = {};
+  staleArgs.callback = &staleTimerCallback;
+  staleArgs.dispatch_method = ESP_TIMER_TASK;
+  staleArgs.name = "link";
+  esp_timer_create(&staleArgs, &g_staleTimer);
+  esp_timer_start_once(g_staleTimer, LINK_STALE_MS * 1000ULL); // "No Signal" if nobody is heard at all
 }
 
 void loop()
 {
-  delay(10);
+  // Block until a packet, the button ISR or a timer has something for us (no polling)
+  uint32_t events = 0;
+  xTaskNotifyWait(0, UINT32_MAX, &events, portMAX_DELAY);
 
-  // ==== BUTTON ISR: consume edge events without blocking
-  if (g_buttonEvent)
+  // Before the stale check, so a packet that arrived with the watchdog is not shown as "No Signal"
+  if (events & EVT_PACKET)
+    drainPackets();
+
+  if (events & EVT_BUTTON)
   {
-    // clear atomically
-    portENTER_CRITICAL(&g_isrMux);
-    bool evt = g_buttonEvent;
-    g_buttonEvent = false;
-    portEXIT_CRITICAL(&g_isrMux);
+    // A press that only wakes the panel must not switch the load
+    if (!panelWake())
+      handleButtonToggle(); // no blocking; no wait-for-release loops
+  }
 
-    if (evt)
+  // No packet for LINK_STALE_MS: replace the last (now untrue) SoC / TTE with "No Signal"
+  if (events & EVT_LINK_STALE)
+  {
+    g_link.checkStale(millis());
+    if (!g_link.anyFresh() && !linkLost)
     {
-      handleButtonToggle(); // no blocking; no wait-for-release loops
+      linkLost = true;
+      noSignalText();
+      g_shownKind = VIEW_NO_SIGNAL; // the next good packet redraws the page from scratch
+      updateBlinkTimer();
+      panelWake(); // losing the Battery Box is an alarm
     }
   }
 
   // Blinking behaviour for low battery (< = 20) and not charging
-  uint32_t now = millis();
-  if (!input_chg && input_soc <= 20 && now - lastBlinkMs >= 1000 && crcFailed == false)
+  if ((events & EVT_BLINK) && blinkWanted())
   {
     tft.invertDisplay(!lowBlinkState);
     lowBlinkState = !lowBlinkState;
-    lastBlinkMs = now;
   }
 
   // // Note - Sanity Check
@@ -0,0 +1,133 @@
+// Host benchmark: historical TTE trimmed mean, old sorted-copy vs CurrentHistory
+//
+// Runs on the PC, not the ESP32. Build and run from this folder:
+//   g++ -O2 -std=c++11 -I"../../lib/esa-estimators" 20_Hist_TrimmedMean_Benchmark_Main_Code.cpp -o hist_bench && ./hist_bench
+//
+// Each "callback" pushes one discharge sample (as histPushDischarge() does at 1 Hz) and then
+// asks for the 40%/5% trimmed mean (as the historical TTE path does on every receive).
+// Reports time per callback for both versions and the largest difference between them.
+
+#include <CurrentHistory.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+#include <chrono>
+
+constexpr uint16_t HIST_CAP = 900; // 15 min at 1 Hz, same as main.cpp
+constexpr uint16_t HIST_BINS = 401;
+constexpr float HIST_TRIM_LOW_FRAC = 0.40f;
+constexpr float HIST_TRIM_HIGH_FRAC = 0.05f;
+constexpr uint32_t CALLBACKS = 20000;
+
+// ---- Old implementation (copied from main.cpp before the histogram) ----
+static float g_histBuf[HIST_CAP];
+static uint16_t g_histCount = 0, g_histHead = 0;
+
+static inline void insertionSort(float *a, int n)
+{
+  for (int i = 1; i < n; ++i)
+  {
+    float key = a[i];
+    int j = i - 1;
+    while (j >= 0 && a[j] > key)
+    {
+      a[j + 1] = a[j];
+      --j;
+    }
+    a[j + 1] = key;
+  }
+}
+
+static void oldPush(float Idis)
+{
+  g_histBuf[g_histHead] = Idis;
+  g_histHead = (g_histHead + 1) % HIST_CAP;
+  if (g_histCount < HIST_CAP)
+    ++g_histCount;
+}
+
+static float oldTrimmedMean()
+{
+  static float tmp[HIST_CAP];
+  uint16_t n = g_histCount;
+  uint16_t idx = (g_histHead + HIST_CAP - g_histCount) % HIST_CAP;
+  for (uint16_t i = 0; i < n; ++i)
+  {
+    tmp[i] = g_histBuf[idx];
+    idx = (idx + 1) % HIST_CAP;
+  }
+  insertionSort(tmp, n);
+  uint16_t lo = (uint16_t)floorf(n * HIST_TRIM_LOW_FRAC);
+  uint16_t hi = n - (uint16_t)ceilf(n * HIST_TRIM_HIGH_FRAC);
+  if (hi <= lo)
+    return tmp[n / 2];
+  double sum = 0.0;
+  uint16_t cnt = 0;
+  for (uint16_t i = lo; i < hi; ++i)
+  {
+    sum += tmp[i];
+    ++cnt;
+  }
+  return (cnt ? (float)(sum / cnt) : tmp[n / 2]);
+}
+
+// Ride-like discharge profile: cruising around 6 A with hills, stops and bursts, 0.1 A resolution like the BMS
+static float sampleA(uint32_t i)
+{
+  float base = 6.0f + 3.0f * sinf(i / 120.0f);
+  float noise = (rand() % 400) / 100.0f - 2.0f;
+  if (rand() % 20 == 0)
+    base += 10.0f; // acceleration burst
+  float a = fmaxf(1.0f, base + noise);
+  return roundf(a * 10.0f) / 10.0f;
+}
+
+int main()
+{
+  static const HistWindowSpec windows[1] = {{HIST_CAP, 1}};
+  static CurrentHistory<1, HIST_CAP, HIST_BINS> hist(windows);
+  srand(1234);
+
+  static float samples[CALLBACKS];
+  for (uint32_t i = 0; i < CALLBACKS; ++i)
+    samples[i] = sampleA(i);
+
+  volatile float sink = 0.0f;
+  float maxDiff = 0.0f;
+
+  auto t0 = std::chrono::steady_clock::now();
+  for (uint32_t i = 0; i < CALLBACKS; ++i)
+  {
+    oldPush(samples[i]);
+    sink = oldTrimmedMean();
+  }
+  auto t1 = std::chrono::steady_clock::now();
+  for (uint32_t i = 0; i < CALLBACKS; ++i)
+  {
+    hist.push(samples[i]);
+    sink = hist.window(0).trimmedMean(HIST_TRIM_LOW_FRAC, HIST_TRIM_HIGH_FRAC);
+  }
+  auto t2 = std::chrono::steady_clock::now();
+
+  // Agreement check on a fresh pass (every callback, full and partially filled windows)
+  g_histCount = g_histHead = 0;
+  hist.clear();
+  for (uint32_t i = 0; i < CALLBACKS; ++i)
+  {
+    oldPush(samples[i]);
+    hist.push(samples[i]);
+    float d = fabsf(oldTrimmedMean() - hist.window(0).trimmedMean(HIST_TRIM_LOW_FRAC, HIST_TRIM_HIGH_FRAC));
+    if (d > maxDiff)
+      maxDiff = d;
+  }
+  (void)sink;
+
+  const double oldUs = std::chrono::duration<double, std::micro>(t1 - t0).count() / CALLBACKS;
+  const double newUs = std::chrono::duration<double, std::micro>(t2 - t1).count() / CALLBACKS;
+  printf("callbacks:            %u (window %u samples)\n", (unsigned)CALLBACKS, (unsigned)HIST_CAP);
+  printf("sorted copy:          %.3f us/callback, %u bytes\n", oldUs, (unsigned)(2 * sizeof(g_histBuf)));
+  printf("CurrentHistory:       %.3f us/callback, %u bytes\n", newUs, (unsigned)hist.footprintBytes());
+  printf("speed-up:             %.1fx\n", oldUs / newUs);
+  printf("max |difference| (A): %.4f\n", maxDiff);
+  return maxDiff < 0.01f ? 0 : 1;
+}
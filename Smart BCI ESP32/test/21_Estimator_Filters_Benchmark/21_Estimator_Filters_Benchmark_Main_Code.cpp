@@ -0,0 +1,192 @@
+// Host benchmark: ESA signal-chain filters, old static-state functions vs EstimatorFilters.h
+//
+// Runs on the PC, not the ESP32. Build and run from this folder:
+//   g++ -O2 -std=c++11 -I"../../lib/esa-estimators" 21_Estimator_Filters_Benchmark_Main_Code.cpp -o filters_bench && ./filters_bench
+//
+// Feeds the same synthetic current / TTE stream (4 Hz, jittered like ESP-NOW arrivals) through the
+// old expf()-per-call implementations copied from main.cpp and through the library instances.
+// Reports time per sample and the largest difference between the two outputs.
+
+#include <EstimatorFilters.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+#include <chrono>
+
+constexpr uint32_t SAMPLES = 200000;
+constexpr float BMS_QUERY_S = 0.25f;
+
+// ---- Old implementations (from main.cpp before EstimatorFilters.h) ----
+// Same code as the old function-local statics, moved into a struct so a fresh copy can be made
+// for the agreement pass. Time is passed in instead of calling millis().
+struct OldChain
+{
+  bool emaInit = false, tteInit = false, stable = false;
+  float ema = 0.0f, disp = NAN;
+  uint32_t emaLastMs = 0, tteLastMs = 0, since = 0;
+  float ring[5] = {0, 0, 0, 0, 0};
+  int idx = 0, count = 0;
+
+  float filteredCurrentA(float x, uint32_t now)
+  {
+    float dt = (emaLastMs == 0) ? BMS_QUERY_S : (now - emaLastMs) / 1000.0f;
+    emaLastMs = now;
+    float alpha = 1.0f - expf(-dt / 3.0f);
+    if (!emaInit)
+    {
+      ema = x;
+      emaInit = true;
+    }
+    else
+      ema += alpha * (x - ema);
+    return ema;
+  }
+
+  float smoothQuantizedTTE(float raw, uint32_t now)
+  {
+    const float dt = (tteLastMs == 0) ? BMS_QUERY_S : (now - tteLastMs) / 1000.0f;
+    tteLastMs = now;
+    const bool raw_ok = (raw == raw) && (raw > 0.0f);
+    if (!tteInit && raw_ok)
+    {
+      disp = raw;
+      tteInit = true;
+    }
+    else if (tteInit && raw_ok)
+    {
+      const float tau = (raw < disp) ? 5.0f : 18.0f;
+      disp += (1.0f - expf(-dt / tau)) * (raw - disp);
+    }
+    if (!tteInit || !(disp == disp) || disp <= 0.0f)
+      return NAN;
+    float minutes = roundf(disp * 60.0f / 10) * 10;
+    return minutes / 60.0f;
+  }
+
+  float median5(float x)
+  {
+    ring[idx] = x;
+    idx = (idx + 1) % 5;
+    if (count < 5)
+      count++;
+    float tmp[5];
+    for (int i = 0; i < count; i++)
+      tmp[i] = ring[i];
+    for (int i = 1; i < count; ++i)
+    {
+      float key = tmp[i];
+      int j = i - 1;
+      while (j >= 0 && tmp[j] > key)
+      {
+        tmp[j + 1] = tmp[j];
+        --j;
+      }
+      tmp[j + 1] = key;
+    }
+    return tmp[count / 2];
+  }
+
+  bool discharging(float I, uint32_t now)
+  {
+    const bool want = stable ? (I >= -1.0f) : (I <= -1.0f);
+    if (want)
+    {
+      if (since == 0)
+        since = now;
+      if (now - since >= 2000)
+      {
+        stable = !stable;
+        since = now;
+      }
+    }
+    else
+      since = 0;
+    return stable;
+  }
+};
+
+// ---- Same chain on EstimatorFilters.h ----
+struct NewChain
+{
+  esa::Ema<3000> ema;
+  esa::Pipeline<esa::AttackReleaseEma<5000, 18000>, esa::StepQuantizer> tte;
+  esa::MedianN<5> med;
+  esa::HysteresisDwell<esa::HystDir::BELOW, 2000> disch{-1.0f, -1.0f};
+};
+
+int main()
+{
+  static float I[SAMPLES], tte[SAMPLES];
+  static uint32_t t[SAMPLES];
+  srand(42);
+  uint32_t now = 1000;
+  for (uint32_t i = 0; i < SAMPLES; ++i)
+  {
+    now += 200 + rand() % 100; // ~4 Hz with jitter
+    t[i] = now;
+    const float base = (i / 400) % 3 == 0 ? 0.2f : -(6.0f + 4.0f * sinf(i / 50.0f)); // idle / riding phases
+    I[i] = roundf((base + (rand() % 200) / 100.0f - 1.0f) * 10.0f) / 10.0f;
+    tte[i] = (I[i] < -1.0f) ? 20.0f / -I[i] : NAN;
+  }
+
+  static OldChain oldChain;
+  static NewChain newChain;
+  volatile float sink = 0.0f;
+
+  auto t0 = std::chrono::steady_clock::now();
+  for (uint32_t i = 0; i < SAMPLES; ++i)
+  {
+    const float a = oldChain.filteredCurrentA(I[i], t[i]);
+    const float b = oldChain.smoothQuantizedTTE(tte[i], t[i]);
+    const float c = oldChain.median5(I[i]);
+    const bool d = oldChain.discharging(c, t[i]);
+    sink = a + b + c + d;
+  }
+  auto t1 = std::chrono::steady_clock::now();
+  for (uint32_t i = 0; i < SAMPLES; ++i)
+  {
+    const float a = newChain.ema.update(I[i], t[i]);
+    const float b = newChain.tte.update(tte[i], t[i]);
+    const float c = newChain.med.update(I[i]);
+    const bool d = newChain.disch.update(c, t[i]);
+    sink = a + b + c + d;
+  }
+  auto t2 = std::chrono::steady_clock::now();
+  (void)sink;
+
+  // Agreement check on fresh copies of both chains
+  static OldChain o;
+  static NewChain n;
+  float dEma = 0.0f, dTte = 0.0f, dMed = 0.0f;
+  uint32_t tteSteps = 0, stateMismatch = 0;
+  for (uint32_t i = 0; i < SAMPLES; ++i)
+  {
+    dEma = fmaxf(dEma, fabsf(n.ema.update(I[i], t[i]) - o.filteredCurrentA(I[i], t[i])));
+    const float bOld = o.smoothQuantizedTTE(tte[i], t[i]);
+    const float bNew = n.tte.update(tte[i], t[i]);
+    if ((bOld == bOld) != (bNew == bNew))
+      ++tteSteps;
+    else if (bOld == bOld && fabsf(bOld - bNew) > 1e-4f)
+    {
+      ++tteSteps; // landed on the other side of a 10-min rounding edge
+      dTte = fmaxf(dTte, fabsf(bOld - bNew));
+    }
+    const float cOld = o.median5(I[i]);
+    const float cNew = n.med.update(I[i]);
+    dMed = fmaxf(dMed, fabsf(cOld - cNew));
+    if (o.discharging(cOld, t[i]) != n.disch.update(cNew, t[i]))
+      ++stateMismatch;
+  }
+
+  const double oldUs = std::chrono::duration<double, std::micro>(t1 - t0).count() / SAMPLES;
+  const double newUs = std::chrono::duration<double, std::micro>(t2 - t1).count() / SAMPLES;
+  printf("samples:                      %u\n", (unsigned)SAMPLES);
+  printf("old (expf, statics):          %.4f us/sample\n", oldUs);
+  printf("EstimatorFilters.h:           %.4f us/sample\n", newUs);
+  printf("speed-up:                     %.1fx\n", oldUs / newUs);
+  printf("max |EMA difference| (A):     %.6f\n", dEma);
+  printf("TTE display differences:       %u samples, max %.4f h (one 10-min step = 0.1667 h)\n", (unsigned)tteSteps, dTte);
+  printf("max |median difference| (A):  %.6f\n", dMed);
+  printf("discharge state mismatches:   %u\n", (unsigned)stateMismatch);
+  return (dEma < 1e-3f && dMed == 0.0f && stateMismatch == 0 && tteSteps < SAMPLES / 1000) ? 0 : 1;
+}
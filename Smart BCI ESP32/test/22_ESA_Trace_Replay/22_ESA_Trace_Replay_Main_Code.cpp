@@ -0,0 +1,389 @@
+// Host trace replay: ESA TTE/TTF accuracy, display churn and CPU time
+//
+// Runs on the PC, not the ESP32. Compiles the real src/main.cpp against host_stubs/ (TFT, audio
+// pins, ESP-NOW and Serial do nothing) and feeds a recorded trace through receiveCallback() and
+// loop(), the same path a Battery Box packet takes. Build and run from this folder:
+//   g++ -O2 -std=gnu++11 -Ihost_stubs -I"../../lib/esa-estimators" -I"../../lib/esa-link" -I"../../lib/esa-profiler" 22_ESA_Trace_Replay_Main_Code.cpp host_stubs/HostStubs.cpp -o trace_replay
+//   ./trace_replay ride.csv            replay a recorded trace
+//   ./trace_replay                     replay the built-in synthetic ride (ride, rest, charge)
+//   ./trace_replay --dump synth.csv    also write the synthetic trace out
+//
+// Trace format, one packet per line (header / comment lines are skipped):
+//   t_ms,soc,I,resmAh,status
+// t_ms = receive time in ms, soc in %, I in A (+ charge / - discharge), status = bms_status (1 ok, 0 CRC fail).
+//
+// Ground truth is what the trace actually did afterwards:
+//   TTE: riding time the sample's resmAh lasts at the mean discharge current realised over the rest of
+//        that discharge (samples at <= -DISCH_MIN_ABS_A until the next charge or the end of the trace)
+//   TTF: time until SoC reached 100 % in the same charge; if the charge stopped early, the missing mAh
+//        at the mean charge current realised over the rest of that charge
+// Samples with less than TRUTH_MIN_FUTURE_S of future riding / charging have no truth and are not scored.
+//
+// Reports per displayed kind: samples scored, mean / 90th percentile absolute error and bias (min),
+// top-strip text changes and displayed-time changes per hour, and receiveCallback() + loop() time per packet
+// (host CPU, so only useful for comparing versions of the logic, not as an ESP32 figure).
+
+#include "../../src/main.cpp"
+
+#include <stdlib.h>
+#include <algorithm>
+#include <chrono>
+#include <vector>
+
+const GFXfont FreeSansBold12pt7b = {};
+const GFXfont FreeSansBold24pt7b = {};
+
+struct TraceSample
+{
+  uint32_t tMs;
+  float soc;
+  float I;
+  float resmAh;
+  int status;
+};
+
+constexpr float TRUTH_MIN_FUTURE_S = 60.0f; // need at least 1 min of realised future to score a sample
+constexpr float CHARGE_START_A = I_CHG_ENTER_A;
+constexpr uint32_t CHARGE_START_MS = 10000; // a charge starts after 10 s above CHARGE_START_A (not regen)
+
+// ---- Trace input ----
+static bool loadTrace(const char *path, std::vector<TraceSample> &out)
+{
+  FILE *f = fopen(path, "r");
+  if (!f)
+    return false;
+  char line[128];
+  while (fgets(line, sizeof(line), f))
+  {
+    TraceSample s;
+    if (sscanf(line, "%u,%f,%f,%f,%d", &s.tMs, &s.soc, &s.I, &s.resmAh, &s.status) == 5)
+      out.push_back(s);
+  }
+  fclose(f);
+  return !out.empty();
+}
+
+static float frand(float lo, float hi) { return lo + (hi - lo) * (rand() / (float)RAND_MAX); }
+
+// Synthetic 11 Ah pack: ride from 90 % with stops and regen blips, rest, then CC/CV charge.
+// BMS-like quantisation (0.1 %, 0.1 A, 1 mAh), jittered ~4 Hz packets, odd CRC failures and drops.
+static void synthTrace(std::vector<TraceSample> &out)
+{
+  const float capMah = 11000.0f;
+  float q = 0.90f * capMah;
+  float bmsOffsetMah = 0.0f; // BMS resmAh drifts and is recalibrated now and then
+  uint32_t t = 1000;
+  srand(2024);
+
+  enum Phase
+  {
+    RIDE,
+    STOP,
+    REST,
+    CHARGE
+  } phase = RIDE;
+  float phaseLeftS = frand(60, 300);
+  float rideA = frand(4, 10);
+  float regenLeftS = 0.0f;
+
+  while (true)
+  {
+    const uint32_t dtMs = 200 + rand() % 100;
+    t += dtMs;
+    const float dtS = dtMs / 1000.0f;
+
+    float I = 0.0f;
+    switch (phase)
+    {
+    case RIDE:
+      if (regenLeftS > 0.0f)
+      {
+        I = frand(0.5f, 3.0f);
+        regenLeftS -= dtS;
+      }
+      else
+      {
+        I = -(rideA + frand(-1.5f, 1.5f));
+        if (rand() % 400 == 0)
+          regenLeftS = frand(1, 2.5f);
+        if (rand() % 200 == 0)
+          rideA = fminf(14.0f, fmaxf(3.0f, rideA + frand(-3, 3))); // hills / speed changes
+      }
+      if ((phaseLeftS -= dtS) <= 0.0f)
+      {
+        phase = STOP;
+        phaseLeftS = frand(10, 90);
+      }
+      if (q / capMah <= 0.15f)
+      {
+        phase = REST;
+        phaseLeftS = 300;
+      }
+      break;
+    case STOP:
+      I = -frand(0.0f, 0.3f); // controller idle
+      if ((phaseLeftS -= dtS) <= 0.0f)
+      {
+        phase = RIDE;
+        phaseLeftS = frand(60, 300);
+        rideA = frand(4, 10);
+      }
+      break;
+    case REST:
+      I = -0.1f;
+      if ((phaseLeftS -= dtS) <= 0.0f)
+        phase = CHARGE;
+      break;
+    case CHARGE:
+    {
+      const float soc = q / capMah;
+      I = (soc < 0.90f) ? 5.0f : 5.0f * (1.0f - soc) / 0.10f + 0.2f; // CV taper
+      I += frand(-0.1f, 0.1f);
+      break;
+    }
+    }
+
+    q = fminf(capMah, fmaxf(0.0f, q + I * 1000.0f * dtS / 3600.0f));
+    bmsOffsetMah += frand(-0.5f, 0.55f);
+    if (rand() % 6000 == 0)
+      bmsOffsetMah = 0.0f; // recalibration step
+
+    if (rand() % 100 == 0)
+      continue; // dropped packet
+    TraceSample s;
+    s.tMs = t;
+    s.resmAh = roundf(fmaxf(0.0f, q + bmsOffsetMah));
+    s.soc = roundf(1000.0f * s.resmAh / capMah) / 10.0f;
+    s.I = roundf(I * 10.0f) / 10.0f;
+    s.status = (rand() % 500 == 0) ? 0 : 1;
+    out.push_back(s);
+
+    if (phase == CHARGE && q >= capMah - 1.0f)
+      break;
+  }
+}
+
+static void dumpTrace(const char *path, const std::vector<TraceSample> &tr)
+{
+  FILE *f = fopen(path, "w");
+  if (!f)
+    return;
+  fprintf(f, "t_ms,soc,I,resmAh,status\n");
+  for (const TraceSample &s : tr)
+    fprintf(f, "%u,%.1f,%.1f,%.0f,%d\n", s.tMs, s.soc, s.I, s.resmAh, s.status);
+  fclose(f);
+}
+
+// ---- Ground truth from the rest of the trace ----
+static void buildTruth(const std::vector<TraceSample> &tr, std::vector<float> &tteTrue, std::vector<float> &ttfTrue)
+{
+  const size_t n = tr.size();
+  tteTrue.assign(n, NAN);
+  ttfTrue.assign(n, NAN);
+
+  // Mark charging samples: sustained current above CHARGE_START_A, until it falls to I_CHG_EXIT_A
+  std::vector<bool> charging(n, false);
+  for (size_t i = 0; i < n;)
+  {
+    if (tr[i].status == 1 && tr[i].I >= CHARGE_START_A)
+    {
+      size_t j = i;
+      while (j < n && tr[j].I >= CHARGE_START_A)
+        ++j;
+      const bool sustained = (j < n ? tr[j].tMs : tr[n - 1].tMs) - tr[i].tMs >= CHARGE_START_MS;
+      if (sustained)
+      {
+        while (j < n && tr[j].I > I_CHG_EXIT_A)
+          ++j;
+        for (size_t k = i; k < j; ++k)
+          charging[k] = true;
+      }
+      i = j;
+    }
+    else
+      ++i;
+  }
+
+  // Backward pass: integrals over the rest of the current discharge / charge
+  double dischAs = 0.0, dischS = 0.0; // riding charge (A*s) and riding time (s) ahead
+  double chgAs = 0.0, chgS = 0.0;
+  int64_t fullAtMs = -1; // when the current charge reached 100 %
+  for (size_t ii = n; ii-- > 0;)
+  {
+    const TraceSample &s = tr[ii];
+    const float dtS = (ii + 1 < n) ? (tr[ii + 1].tMs - s.tMs) / 1000.0f : 0.0f;
+    if (charging[ii])
+    {
+      if (ii + 1 < n && !charging[ii + 1])
+      {
+        chgAs = chgS = 0.0; // a new (earlier) charge begins here going backwards
+        fullAtMs = -1;
+      }
+      if (s.soc >= 100.0f)
+        fullAtMs = s.tMs;
+      chgAs += s.I * dtS;
+      chgS += dtS;
+      dischAs = dischS = 0.0; // discharge truth never looks across a charge
+      if (s.status != 1 || s.soc <= 0.5f || chgS < TRUTH_MIN_FUTURE_S)
+        continue;
+      if (fullAtMs >= 0)
+        ttfTrue[ii] = (fullAtMs - (int64_t)s.tMs) / 3600000.0f;
+      else
+      {
+        const float missingMah = s.resmAh * 100.0f / s.soc - s.resmAh;
+        ttfTrue[ii] = (missingMah / 1000.0f) / (float)(chgAs / chgS);
+      }
+    }
+    else
+    {
+      if (s.I <= -DISCH_MIN_ABS_A)
+      {
+        dischAs += -s.I * dtS;
+        dischS += dtS;
+      }
+      if (s.status == 1 && dischS >= TRUTH_MIN_FUTURE_S)
+        tteTrue[ii] = (s.resmAh / 1000.0f) / (float)(dischAs / dischS);
+    }
+  }
+}
+
+// ---- What the top strip shows ----
+enum ShownKind
+{
+  SHOWN_NONE,
+  SHOWN_TTE,
+  SHOWN_TTF
+};
+
+static ShownKind parseTopLine(const char *line, float &hours)
+{
+  hours = NAN;
+  ShownKind kind = SHOWN_NONE;
+  if (!strncmp(line, "Travel time left", 16))
+    kind = SHOWN_TTE;
+  else if (!strncmp(line, "BATTERY CHARGING - ", 19))
+    kind = SHOWN_TTF;
+  else
+    return SHOWN_NONE;
+  const char *p = strrchr(line, (kind == SHOWN_TTE) ? ':' : '-');
+  unsigned h = 0, m = 0;
+  if (p && sscanf(p + 1, " %uh %um", &h, &m) == 2)
+    hours = h + m / 60.0f;
+  return kind;
+}
+
+struct ErrorStats
+{
+  std::vector<float> absMin;
+  double biasSum = 0.0;
+  void add(float shownH, float trueH)
+  {
+    const float e = (shownH - trueH) * 60.0f;
+    absMin.push_back(fabsf(e));
+    biasSum += e;
+  }
+  void print(const char *name)
+  {
+    if (absMin.empty())
+    {
+      printf("%s: no scored samples\n", name);
+      return;
+    }
+    std::sort(absMin.begin(), absMin.end());
+    double sum = 0.0;
+    for (float e : absMin)
+      sum += e;
+    printf("%s: %zu samples, mean |err| %.1f min, p90 |err| %.1f min, bias %+.1f min\n", name, absMin.size(),
+           sum / absMin.size(), absMin[absMin.size() * 9 / 10], biasSum / absMin.size());
+  }
+};
+
+int main(int argc, char **argv)
+{
+  std::vector<TraceSample> trace;
+  const char *tracePath = nullptr;
+  const char *dumpPath = nullptr;
+  for (int a = 1; a < argc; ++a)
+  {
+    if (!strcmp(argv[a], "--dump") && a + 1 < argc)
+      dumpPath = argv[++a];
+    else
+      tracePath = argv[a];
+  }
+  if (tracePath)
+  {
+    if (!loadTrace(tracePath, trace))
+    {
+      fprintf(stderr, "could not read trace %s\n", tracePath);
+      return 1;
+    }
+  }
+  else
+  {
+    synthTrace(trace);
+    if (dumpPath)
+      dumpTrace(dumpPath, trace);
+  }
+
+  std::vector<float> tteTrue, ttfTrue;
+  buildTruth(trace, tteTrue, ttfTrue);
+
+  ErrorStats tteErr, ttfErr;
+  uint32_t lineChanges = 0, timeChanges = 0;
+  char prevLine[sizeof(lastTopLine)] = "";
+  float prevShownH = NAN;
+  ShownKind prevKind = SHOWN_NONE;
+  std::vector<double> callUs;
+  callUs.reserve(trace.size());
+  const uint8_t mac[6] = {0x24, 0x6f, 0x28, 0x00, 0x00, 0x01};
+
+  for (size_t i = 0; i < trace.size(); ++i)
+  {
+    const TraceSample &s = trace[i];
+    g_hostMillis = s.tMs;
+    struct_message pkt{};
+    pkt.bms_status = (s.status == 1);
+    pkt.soc = s.soc;
+    pkt.I = s.I;
+    pkt.resmAh = s.resmAh;
+    pkt.seq = (uint16_t)i; // one packet per trace line, none lost
+
+    auto t0 = std::chrono::steady_clock::now();
+    receiveCallback(mac, (const uint8_t *)&pkt, sizeof(pkt));
+    loop(); // EVT_PACKET: the estimators and the page run here, as on the ESP32
+    auto t1 = std::chrono::steady_clock::now();
+    callUs.push_back(std::chrono::duration<double, std::micro>(t1 - t0).count());
+
+    if (strcmp(lastTopLine, prevLine) != 0)
+    {
+      ++lineChanges;
+      strcpy(prevLine, lastTopLine);
+    }
+    float shownH;
+    const ShownKind kind = parseTopLine(lastTopLine, shownH);
+    if (kind != SHOWN_NONE && kind == prevKind && shownH != prevShownH)
+      ++timeChanges;
+    prevKind = kind;
+    prevShownH = shownH;
+
+    if (kind == SHOWN_TTE && shownH == shownH && tteTrue[i] == tteTrue[i])
+      tteErr.add(shownH, tteTrue[i]);
+    else if (kind == SHOWN_TTF && shownH == shownH && ttfTrue[i] == ttfTrue[i])
+      ttfErr.add(shownH, ttfTrue[i]);
+  }
+
+  const float hours = (trace.back().tMs - trace.front().tMs) / 3600000.0f;
+  std::sort(callUs.begin(), callUs.end());
+  double usSum = 0.0;
+  for (double u : callUs)
+    usSum += u;
+
+  printf("trace:                 %s, %zu packets over %.2f h\n", tracePath ? tracePath : "synthetic", trace.size(), hours);
+  tteErr.print("TTE");
+  ttfErr.print("TTF");
+  printf("top strip changes:     %u (%.1f per hour)\n", lineChanges, lineChanges / hours);
+  printf("displayed time steps:  %u (%.1f per hour)\n", timeChanges, timeChanges / hours);
+  printf("packet handling (host): mean %.2f us, p99 %.2f us, max %.2f us\n", usSum / callUs.size(),
+         callUs[callUs.size() * 99 / 100], callUs.back());
+  return 0;
+}
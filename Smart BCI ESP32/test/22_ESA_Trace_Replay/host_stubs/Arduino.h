@@ -0,0 +1,66 @@
+// Host stand-in for the parts of the Arduino-ESP32 core that the ESA's main.cpp uses.
+// Only enough to compile and replay the estimator logic on a PC; I/O calls do nothing.
+#pragma once
+#include <stdint.h>
+#include <stddef.h>
+#include <string.h>
+#include <stdio.h>
+#include <math.h>
+#include <algorithm>
+using std::max;
+using std::min;
+
+#define IRAM_ATTR
+#define HIGH 1
+#define LOW 0
+#define OUTPUT 1
+#define INPUT 0
+#define INPUT_PULLDOWN 2
+#define INPUT_PULLUP 3
+#define RISING 1
+#define FALLING 2
+#define CHANGE 3
+#define F(x) x
+#define constrain(a, l, h) ((a) < (l) ? (l) : ((a) > (h) ? (h) : (a)))
+typedef bool boolean;
+typedef uint8_t byte;
+
+// Simulated clock: the replay sets g_hostMillis to each trace sample's timestamp
+extern uint32_t g_hostMillis;
+uint32_t millis();
+uint32_t micros();
+void delay(uint32_t ms);
+
+void digitalWrite(int pin, int val);
+int digitalRead(int pin);
+void pinMode(int pin, int mode);
+int digitalPinToInterrupt(int pin);
+void attachInterrupt(int irq, void (*isr)(), int mode);
+void ledcSetup(int ch, int freq, int bits);
+void ledcAttachPin(int pin, int ch);
+void ledcWrite(int ch, int duty);
+uint32_t getCpuFrequencyMhz();
+
+// Serial output is swallowed so CPU timings measure the logic, not printing
+struct Print
+{
+  template <class T> size_t print(T) { return 0; }
+  template <class T> size_t print(T, int) { return 0; }
+  template <class T> size_t println(T) { return 0; }
+  template <class T> size_t println(T, int) { return 0; }
+  size_t println() { return 0; }
+  size_t printf(const char *, ...) { return 0; }
+  void begin(long) {}
+  int available() { return 0; }
+  int read() { return -1; }
+  size_t write(uint8_t) { return 0; }
+};
+extern Print Serial;
+
+struct EspClass
+{
+  void restart() {}
+  uint32_t getFreeHeap() { return 0; }
+  uint32_t getCycleCount() { return 0; }
+};
+extern EspClass ESP;
@@ -0,0 +1,66 @@
+// Definitions behind the host stand-in headers. Hardware calls do nothing; time is whatever
+// the replay last put in g_hostMillis.
+#include <Arduino.h>
+#include <WiFi.h>
+#include <esp_now.h>
+#include <esp_wifi.h>
+#include "freertos/task.h"
+#include <esp_timer.h>
+
+uint32_t g_hostMillis = 0;
+uint32_t millis() { return g_hostMillis; }
+uint32_t micros() { return g_hostMillis * 1000u; }
+void delay(uint32_t) {} // blocking waits (audio pulses, self-test) do not advance trace time
+
+void digitalWrite(int, int) {}
+int digitalRead(int) { return LOW; }
+void pinMode(int, int) {}
+int digitalPinToInterrupt(int pin) { return pin; }
+void attachInterrupt(int, void (*)(), int) {}
+void ledcSetup(int, int, int) {}
+void ledcAttachPin(int, int) {}
+void ledcWrite(int, int) {}
+uint32_t getCpuFrequencyMhz() { return 240; }
+
+Print Serial;
+EspClass ESP;
+WiFiClass WiFi;
+
+esp_err_t esp_now_init() { return ESP_OK; }
+esp_err_t esp_now_register_recv_cb(void (*)(const uint8_t *, const uint8_t *, int)) { return ESP_OK; }
+esp_err_t esp_wifi_set_promiscuous(bool) { return ESP_OK; }
+esp_err_t esp_wifi_set_promiscuous_rx_cb(wifi_promiscuous_cb_t) { return ESP_OK; }
+esp_err_t esp_wifi_set_promiscuous_filter(const wifi_promiscuous_filter_t *) { return ESP_OK; }
+
+// One task: notification bits collect here until the replay runs loop(), which takes them all
+static uint32_t g_hostNotified = 0;
+TaskHandle_t xTaskGetCurrentTaskHandle() { return nullptr; }
+uint32_t ulTaskNotifyTake(BaseType_t, TickType_t) { return 0; }
+void vTaskNotifyGiveFromISR(TaskHandle_t, BaseType_t *) {}
+BaseType_t xTaskNotify(TaskHandle_t, uint32_t value, eNotifyAction)
+{
+  g_hostNotified |= value;
+  return pdPASS;
+}
+BaseType_t xTaskNotifyFromISR(TaskHandle_t task, uint32_t value, eNotifyAction action, BaseType_t *)
+{
+  return xTaskNotify(task, value, action);
+}
+BaseType_t xTaskNotifyWait(uint32_t, uint32_t, uint32_t *value, TickType_t)
+{
+  *value = g_hostNotified;
+  g_hostNotified = 0;
+  return *value ? pdTRUE : pdFALSE;
+}
+void vTaskDelay(TickType_t) {}
+
+static int g_hostTimerToken;
+esp_err_t esp_timer_create(const esp_timer_create_args_t *, esp_timer_handle_t *out)
+{
+  *out = (esp_timer_handle_t)&g_hostTimerToken;
+  return ESP_OK;
+}
+esp_err_t esp_timer_start_once(esp_timer_handle_t, uint64_t) { return ESP_OK; }
+esp_err_t esp_timer_start_periodic(esp_timer_handle_t, uint64_t) { return ESP_OK; }
+esp_err_t esp_timer_stop(esp_timer_handle_t) { return ESP_OK; }
+int64_t esp_timer_get_time() { return (int64_t)g_hostMillis * 1000; }
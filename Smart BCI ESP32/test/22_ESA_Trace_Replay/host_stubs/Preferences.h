@@ -0,0 +1,57 @@
+#pragma once
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+#include <map>
+#include <string>
+#include <vector>
+// NVS in host memory, empty at start: every replay starts from a fresh boot with nothing learned.
+// hostNvs() maps "namespace/key" to the stored bytes, for tests that look at what was saved or carry
+// it over a simulated reboot. Like the ESP32, a read-only begin() fails until the namespace exists.
+inline std::map<std::string, std::vector<uint8_t>> &hostNvs()
+{
+  static std::map<std::string, std::vector<uint8_t>> nvs;
+  return nvs;
+}
+
+class Preferences
+{
+public:
+  bool begin(const char *name, bool readOnly = false)
+  {
+    ns_ = std::string(name) + "/";
+    const auto it = hostNvs().lower_bound(ns_);
+    if (readOnly && (it == hostNvs().end() || it->first.compare(0, ns_.size(), ns_) != 0))
+      return false;
+    open_ = true;
+    readOnly_ = readOnly;
+    return true;
+  }
+  void end() { open_ = false; }
+  size_t getBytesLength(const char *key)
+  {
+    const auto it = hostNvs().find(ns_ + key);
+    return (open_ && it != hostNvs().end()) ? it->second.size() : 0;
+  }
+  size_t getBytes(const char *key, void *buf, size_t maxLen)
+  {
+    const size_t len = getBytesLength(key);
+    if (len == 0 || len > maxLen)
+      return 0;
+    memcpy(buf, hostNvs()[ns_ + key].data(), len);
+    return len;
+  }
+  size_t putBytes(const char *key, const void *value, size_t len)
+  {
+    if (!open_ || readOnly_)
+      return 0;
+    const uint8_t *p = (const uint8_t *)value;
+    hostNvs()[ns_ + key].assign(p, p + len);
+    return len;
+  }
+
+private:
+  std::string ns_;
+  bool open_ = false;
+  bool readOnly_ = true;
+};
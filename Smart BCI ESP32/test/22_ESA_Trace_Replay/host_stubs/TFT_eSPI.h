@@ -0,0 +1,48 @@
+// Host stand-in for TFT_eSPI: every drawing call is a no-op.
+#pragma once
+#include <Arduino.h>
+
+struct GFXfont
+{
+};
+
+#define TL_DATUM 0
+#define TC_DATUM 1
+#define TR_DATUM 2
+#define ML_DATUM 3
+#define MC_DATUM 4
+#define MR_DATUM 5
+#define BL_DATUM 6
+#define BC_DATUM 7
+#define BR_DATUM 8
+
+struct TFT_eSPI : Print
+{
+  void init() {}
+  void setRotation(uint8_t) {}
+  void fillScreen(uint32_t) {}
+  void fillRect(int32_t, int32_t, int32_t, int32_t, uint32_t) {}
+  void drawRect(int32_t, int32_t, int32_t, int32_t, uint32_t) {}
+  void drawLine(int32_t, int32_t, int32_t, int32_t, uint32_t) {}
+  void fillTriangle(int32_t, int32_t, int32_t, int32_t, int32_t, int32_t, uint32_t) {}
+  int16_t width() { return 480; }
+  int16_t height() { return 320; }
+  void setTextFont(uint8_t) {}
+  void setTextSize(uint8_t) {}
+  void setTextColor(uint16_t, uint16_t) {}
+  void setTextColor(uint16_t) {}
+  void setTextDatum(uint8_t) {}
+  void setFreeFont(const GFXfont *) {}
+  int16_t fontHeight() { return 26; }
+  int16_t drawString(const char *, int32_t, int32_t) { return 0; }
+  void setCursor(int16_t, int16_t) {}
+  void invertDisplay(bool) {}
+  void writecommand(uint8_t) {}
+  void pushImage(int32_t, int32_t, int32_t, int32_t, const uint16_t *) {}
+  void startWrite() {}
+  void endWrite() {}
+  void setAddrWindow(int32_t, int32_t, int32_t, int32_t) {}
+  void pushColors(uint16_t *, uint32_t, bool = true) {}
+  void pushPixels(const void *, uint32_t) {}
+  int16_t textWidth(const char *) { return 0; }
+};
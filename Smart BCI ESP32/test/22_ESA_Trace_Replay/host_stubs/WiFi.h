@@ -0,0 +1,10 @@
+#pragma once
+#include <Arduino.h>
+#define WIFI_STA 1
+struct WiFiClass
+{
+  void mode(int) {}
+  const char *macAddress() { return "00:00:00:00:00:00"; }
+  void disconnect() {}
+};
+extern WiFiClass WiFi;
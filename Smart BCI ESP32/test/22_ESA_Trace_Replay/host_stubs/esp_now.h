@@ -0,0 +1,7 @@
+#pragma once
+#include <stdint.h>
+#define ESP_NOW_MAX_DATA_LEN 250
+#define ESP_OK 0
+typedef int esp_err_t;
+esp_err_t esp_now_init();
+esp_err_t esp_now_register_recv_cb(void (*cb)(const uint8_t *, const uint8_t *, int));
@@ -0,0 +1,227 @@
+// On-device benchmark: what the TFT_eSPI primitives the ESA draws with cost on our panel and SPI clock
+//
+// Runs on the ESA's ESP32 with the Waveshare ILI9486 shield. Either copy this file over src/main.cpp
+// and upload, or let run_tft_benchmark.py build and flash it once per SPI clock (TFT_eSPI fixes
+// SPI_FREQUENCY at compile time) and merge the output:
+//   python run_tft_benchmark.py --port COM5 --spi 10000000 16000000 20000000 27000000 -o tft_bench.csv
+//
+// Prints one CSV row per primitive / size / bit depth, then "# done":
+//   spi_hz,primitive,variant,w,h,bpp,reps,us_per_call,cpu_us_per_call,mpix_per_s
+// us_per_call runs until the pixels are on the panel (DMA waited for); cpu_us_per_call until the
+// call returned, which only differs for pushImageDMA. Lines starting with '#' are comments.
+
+#include <SPI.h>
+#include <TFT_eSPI.h>
+#include <esp_timer.h>
+#include <esp_heap_caps.h>
+TFT_eSPI tft; // uses pins/driver from User_Setup.h
+extern const GFXfont FreeSansBold12pt7b;
+extern const GFXfont FreeSansBold24pt7b;
+
+constexpr uint8_t ROTATION = 1;           // landscape, same as the ESA
+constexpr uint32_t MIN_REPS = 5;          // every case runs at least this often...
+constexpr int64_t MIN_TIME_US = 200000;   // ...and for at least 200 ms
+constexpr int16_t IMG_MAX_W = 160;        // largest pushImage case
+constexpr int16_t IMG_MAX_H = 100;
+
+static uint16_t *g_img16 = nullptr; // DMA-capable, IMG_MAX_W x IMG_MAX_H
+static uint8_t *g_img8 = nullptr;   // 8 bpp (RGB332), also reused for the 4 bpp and 1 bpp cases
+static uint16_t g_cmap4[16];
+static bool g_dmaOk = false;
+
+// Time draw(rep) until MIN_REPS and MIN_TIME_US are both reached, then print the CSV row
+template <typename F>
+static void bench(const char *primitive, const char *variant, int32_t w, int32_t h, uint8_t bpp, F draw, bool dma = false)
+{
+  if (dma)
+    tft.startWrite(); // DMA needs the bus held, and endWrite() would wait for it, so hold it throughout
+  draw(0);            // warm-up: first call pays for font lookups, window setup, cache misses
+  if (dma)
+    tft.dmaWait();
+
+  uint32_t reps = 0;
+  int64_t cpuUs = 0;
+  const int64_t t0 = esp_timer_get_time();
+  int64_t now = t0;
+  while (reps < MIN_REPS || now - t0 < MIN_TIME_US)
+  {
+    const int64_t c0 = esp_timer_get_time();
+    draw(reps);
+    cpuUs += esp_timer_get_time() - c0;
+    if (dma)
+      tft.dmaWait();
+    ++reps;
+    now = esp_timer_get_time();
+  }
+  if (dma)
+    tft.endWrite();
+
+  const float us = (float)(now - t0) / reps;
+  const float mpix = (us > 0.0f) ? (w * h) / us : 0.0f; // pixels per us = Mpixel/s
+  Serial.printf("%lu,%s,%s,%ld,%ld,%u,%lu,%.2f,%.2f,%.3f\n", (unsigned long)SPI_FREQUENCY, primitive, variant,
+                (long)w, (long)h, bpp, (unsigned long)reps, us, (float)cpuUs / reps, mpix);
+}
+
+// Solid fills: from a small glyph cell to the whole screen (drawBorder, drawPercentage clears, fillScreen)
+static void benchFillRect()
+{
+  static const int16_t sizes[][2] = {{8, 8}, {32, 32}, {100, 50}, {240, 160}, {464, 62}, {480, 320}};
+  for (const auto &s : sizes)
+  {
+    char variant[16];
+    snprintf(variant, sizeof(variant), "%dx%d", s[0], s[1]);
+    bench("fillRect", variant, s[0], s[1], 16, [&](uint32_t rep)
+          { tft.fillRect(0, 0, s[0], s[1], (rep & 1) ? TFT_NAVY : TFT_DARKGREEN); });
+  }
+}
+
+// Free-font strings as the top strip and the message screens draw them. These are opaque (text
+// colour and background), so with GLYPH_CACHE in the user setup they go through the glyph cache
+static void benchFreeFont()
+{
+  struct Case
+  {
+    const char *variant;
+    const GFXfont *font;
+    const char *text;
+  };
+  static const Case cases[] = {
+      {"12pt_short", &FreeSansBold12pt7b, "BATTERY FULL!"},
+      {"12pt_long", &FreeSansBold12pt7b, "Travel time left (historical): 1h 20m"},
+      {"24pt_msg", &FreeSansBold24pt7b, "No Signal"},
+  };
+  for (const auto &c : cases)
+  {
+    tft.setFreeFont(c.font);
+    tft.setTextColor(TFT_WHITE, TFT_BLACK);
+    tft.setTextDatum(MC_DATUM);
+    const int32_t w = tft.textWidth(c.text);
+    const int32_t h = tft.fontHeight();
+    bench("drawString", c.variant, w, h, 1, [&](uint32_t)
+          { tft.drawString(c.text, tft.width() / 2, tft.height() / 2); });
+#ifdef GLYPH_CACHE
+    // Same string with every glyph decoded again, as on its first draw
+    char cold[24];
+    snprintf(cold, sizeof(cold), "%s_cold", c.variant);
+    bench("drawString", cold, w, h, 1, [&](uint32_t)
+          { tft.glyphCacheClear(); tft.drawString(c.text, tft.width() / 2, tft.height() / 2); });
+#endif
+  }
+  tft.setFreeFont(nullptr);
+  tft.setTextDatum(TL_DATUM);
+}
+
+// Font 4 scaled up, as drawPercentage() does with PERCENTAGE_SIZE
+static void benchFont4Scaled()
+{
+  for (uint8_t size = 1; size <= 3; ++size)
+  {
+    tft.setTextFont(4);
+    tft.setTextSize(size);
+    tft.setTextColor(TFT_WHITE, TFT_BLACK);
+    tft.setTextDatum(MC_DATUM);
+    const int32_t w = tft.textWidth("100%");
+    const int32_t h = tft.fontHeight();
+    char variant[16];
+    snprintf(variant, sizeof(variant), "font4_x%u", size);
+    bench("drawString", variant, w, h, 1, [&](uint32_t)
+          { tft.drawString("100%", tft.width() / 2, tft.height() / 2); });
+  }
+  tft.setTextSize(1);
+  tft.setTextFont(1);
+  tft.setTextDatum(TL_DATUM);
+}
+
+// Triangles: one half of a drawThickLine() segment of the lightning bolt, and two solid ones
+static void benchFillTriangle()
+{
+  struct Case
+  {
+    const char *variant;
+    int16_t x0, y0, x1, y1, x2, y2;
+  };
+  static const Case cases[] = {
+      {"thick_line_120x6", 0, 0, 120, 0, 120, 6},
+      {"50x50", 0, 0, 50, 0, 0, 50},
+      {"200x150", 0, 0, 200, 75, 0, 150},
+  };
+  for (const auto &c : cases)
+  {
+    const int32_t w = max(max(c.x0, c.x1), c.x2) + 1;
+    const int32_t h = max(max(c.y0, c.y1), c.y2) + 1;
+    bench("fillTriangle", c.variant, w, h, 16, [&](uint32_t rep)
+          { tft.fillTriangle(c.x0, c.y0, c.x1, c.y1, c.x2, c.y2, (rep & 1) ? TFT_YELLOW : TFT_ORANGE); });
+  }
+}
+
+// Images at every depth pushImage() takes, then the same 16 bpp data through DMA
+static void benchPushImage()
+{
+  static const int16_t sizes[][2] = {{32, 32}, {64, 64}, {IMG_MAX_W, IMG_MAX_H}};
+  for (const auto &s : sizes)
+  {
+    const int16_t w = s[0], h = s[1];
+    char variant[16];
+    snprintf(variant, sizeof(variant), "%dx%d", w, h);
+    bench("pushImage", variant, w, h, 16, [&](uint32_t)
+          { tft.pushImage(0, 0, w, h, g_img16); });
+    bench("pushImage", variant, w, h, 8, [&](uint32_t)
+          { tft.pushImage(0, 0, w, h, g_img8, true); });
+    bench("pushImage", variant, w, h, 4, [&](uint32_t)
+          { tft.pushImage(0, 0, w, h, g_img8, false, g_cmap4); });
+    bench("pushImage", variant, w, h, 1, [&](uint32_t)
+          { tft.pushImage(0, 0, w, h, g_img8, false); });
+    if (g_dmaOk)
+    {
+      bench("pushImageDMA", variant, w, h, 16, [&](uint32_t)
+            { tft.pushImageDMA(0, 0, w, h, g_img16); }, true);
+    }
+  }
+}
+
+void setup()
+{
+  Serial.begin(115200);
+  delay(500);
+
+  tft.init();
+  tft.setRotation(ROTATION);
+  tft.fillScreen(TFT_BLACK);
+
+  // Pseudo-random content, so colour-change shortcuts inside pushImage() get no free ride
+  g_img16 = (uint16_t *)heap_caps_malloc(IMG_MAX_W * IMG_MAX_H * sizeof(uint16_t), MALLOC_CAP_DMA);
+  g_img8 = (uint8_t *)malloc(IMG_MAX_W * IMG_MAX_H);
+  if (!g_img16 || !g_img8)
+  {
+    Serial.println("# out of memory for the image buffers");
+    return;
+  }
+  uint32_t x = 0x12345678;
+  for (uint32_t i = 0; i < (uint32_t)IMG_MAX_W * IMG_MAX_H; ++i)
+  {
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    g_img16[i] = (uint16_t)x;
+    g_img8[i] = (uint8_t)(x >> 16);
+  }
+  for (uint8_t i = 0; i < 16; ++i)
+    g_cmap4[i] = (uint16_t)(i * 0x1111);
+  g_dmaOk = tft.initDMA();
+
+  Serial.printf("# TFT_eSPI %s, ILI9486 (RPi shield), SPI_FREQUENCY=%lu, DMA %s, CPU %lu MHz\n",
+                TFT_ESPI_VERSION, (unsigned long)SPI_FREQUENCY, g_dmaOk ? "yes" : "no",
+                (unsigned long)getCpuFrequencyMhz());
+  Serial.println("spi_hz,primitive,variant,w,h,bpp,reps,us_per_call,cpu_us_per_call,mpix_per_s");
+  benchFillRect();
+  benchFreeFont();
+  benchFont4Scaled();
+  benchFillTriangle();
+  benchPushImage();
+  Serial.println("# done");
+  tft.fillScreen(TFT_BLACK);
+}
+
+void loop()
+{
+}
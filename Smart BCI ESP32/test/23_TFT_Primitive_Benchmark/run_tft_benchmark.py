@@ -0,0 +1,93 @@
+#!/usr/bin/env python3
+"""Runner for 23_TFT_Primitive_Benchmark: build and flash the sketch once per SPI clock, collect the
+CSV it prints over serial and write all runs into one file.
+
+Needs PlatformIO ("pio" on PATH) and pyserial (PlatformIO's own Python has it). It builds with the
+[env:nodemcu-32s] of the project's platformio.ini, with src_dir pointed at this folder. Run from anywhere:
+  python run_tft_benchmark.py --port COM5 --spi 10000000 16000000 20000000 27000000 -o tft_bench.csv
+
+Without --spi it only reads one run from a board that already has the sketch on it.
+The ILI9486 shield is specified for 20 MHz; faster clocks may corrupt the picture, and the numbers
+for such a run only mean something if the screen looked right.
+"""
+
+import argparse
+import os
+import subprocess
+import sys
+import time
+
+import serial
+
+HERE = os.path.dirname(os.path.abspath(__file__))
+PROJECT = os.path.abspath(os.path.join(HERE, "..", ".."))
+
+
+def flash(env, spi_hz, port):
+    """Build this folder instead of src/ with SPI_FREQUENCY overridden, and upload it."""
+    run_env = dict(os.environ)
+    run_env["PLATFORMIO_SRC_DIR"] = HERE
+    run_env["PLATFORMIO_BUILD_FLAGS"] = "-DSPI_FREQUENCY=%d" % spi_hz
+    cmd = ["pio", "run", "-d", PROJECT, "-e", env, "-t", "upload"]
+    if port:
+        cmd += ["--upload-port", port]
+    subprocess.run(cmd, env=run_env, check=True, stdout=sys.stderr)
+
+
+def collect(port, baud, timeout_s):
+    """Reset the board and read CSV rows until '# done'. Returns (header, rows)."""
+    header, rows = None, []
+    with serial.Serial(port, baud, timeout=1) as ser:
+        ser.dtr = False  # EN pulse through the auto-reset circuit
+        ser.rts = True
+        time.sleep(0.1)
+        ser.rts = False
+        deadline = time.time() + timeout_s
+        while time.time() < deadline:
+            line = ser.readline().decode("utf-8", "replace").strip()
+            if not line:
+                continue
+            if line.startswith("# done"):
+                return header, rows
+            if line.startswith("spi_hz,"):
+                header = line
+            elif line[0].isdigit() and "," in line:
+                rows.append(line)
+            else:
+                print(line, file=sys.stderr)  # comments and boot messages
+    raise RuntimeError("no '# done' from %s within %d s" % (port, timeout_s))
+
+
+def main():
+    ap = argparse.ArgumentParser(description=__doc__.split("\n\n")[0])
+    ap.add_argument("--port", required=True, help="serial port of the ESA, e.g. COM5 or /dev/ttyUSB0")
+    ap.add_argument("--baud", type=int, default=115200)
+    ap.add_argument("--env", default="nodemcu-32s", help="PlatformIO environment")
+    ap.add_argument("--spi", type=int, nargs="*", default=[], help="SPI clocks (Hz) to build and run")
+    ap.add_argument("--timeout", type=int, default=180, help="seconds to wait for one run")
+    ap.add_argument("-o", "--output", help="CSV file (default: stdout)")
+    args = ap.parse_args()
+
+    header, rows = None, []
+    for spi_hz in args.spi or [None]:
+        if spi_hz is not None:
+            print("== SPI %d Hz: build and flash" % spi_hz, file=sys.stderr)
+            flash(args.env, spi_hz, args.port)
+            time.sleep(2)  # let the port come back after the upload
+        h, r = collect(args.port, args.baud, args.timeout)
+        header = header or h
+        rows += r
+        print("== %d rows" % len(r), file=sys.stderr)
+
+    out = open(args.output, "w", newline="") if args.output else sys.stdout
+    try:
+        out.write((header or "") + "\n")
+        for row in rows:
+            out.write(row + "\n")
+    finally:
+        if out is not sys.stdout:
+            out.close()
+
+
+if __name__ == "__main__":
+    main()
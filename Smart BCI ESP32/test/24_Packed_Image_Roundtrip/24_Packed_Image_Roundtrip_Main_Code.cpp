@@ -0,0 +1,177 @@
+// Host check: PackedImage.h decodes src/icons_packed.cpp back to exactly the raw arrays in assets/icons.c
+//
+// Runs on the PC, not the ESP32. Build and run from this folder after pack_icons.py has written src/icons_packed.*:
+//   g++ -O2 -std=gnu++11 -Wall -Wextra -I"../../lib/esa-assets" 24_Packed_Image_Roundtrip_Main_Code.cpp -o packed_roundtrip && ./packed_roundtrip
+//
+// For every icon: decode in chunks of several sizes and compare with the raw pixels (byte-swapped,
+// since packed pixels are in panel order), draw it with drawPackedImage() into a fake TFT by DMA and
+// by pushImage(), decode truncated data, and time the decoder. Exits non-zero on any mismatch.
+// The line buffers are shrunk to 32 pixels so the 40 px icons go through the row-slice path and the
+// 32 px one through the whole-row path.
+
+#define PACKED_IMAGE_LINE_PIXELS 32
+#include <PackedImage.h>
+#include <stdio.h>
+#include <chrono>
+#include <vector>
+
+#include "../../src/icons_packed.cpp"
+
+// Same names as the packed images, so keep the raw arrays apart.
+// icons.c only needs PROGMEM from Arduino.h; its ESP32 branch defines it empty.
+namespace raw
+{
+#define ESP32 1
+#include "../../assets/icons.c"
+#undef ESP32
+}
+
+struct Icon
+{
+  const char *name;
+  const unsigned char *raw;
+  const PackedImage &packed;
+};
+static const Icon ICONS[] = {
+    {"penguin", raw::penguin, penguin},
+    {"icon_40x40", raw::icon_40x40, icon_40x40},
+    {"wifi_full", raw::wifi_full, wifi_full},
+};
+
+// Records what drawPackedImage() sends, as a framebuffer in panel byte order
+struct FakeTft
+{
+  static constexpr int32_t W = 480, H = 320;
+  std::vector<uint16_t> fb = std::vector<uint16_t>(W * H, 0);
+  bool DMA_Enabled = true;
+  bool swap = true;
+  bool inWrite = false;
+  const uint16_t *dmaBusyBuf = nullptr; // buffer of the transfer "in flight"
+  uint32_t blocks = 0, reusedBusy = 0;
+
+  bool getSwapBytes() { return swap; }
+  void setSwapBytes(bool s) { swap = s; }
+  void startWrite() { inWrite = true; }
+  void endWrite() { inWrite = false; }
+  void dmaWait() { dmaBusyBuf = nullptr; }
+
+  void blit(int32_t x, int32_t y, int32_t w, int32_t h, const uint16_t *p)
+  {
+    for (int32_t r = 0; r < h; ++r)
+      for (int32_t c = 0; c < w; ++c)
+      {
+        const uint16_t v = p[r * w + c];
+        fb[(y + r) * W + x + c] = swap ? (uint16_t)(v << 8 | v >> 8) : v;
+      }
+    ++blocks;
+  }
+  void pushImageDMA(int32_t x, int32_t y, int32_t w, int32_t h, const uint16_t *p)
+  {
+    reusedBusy += p == dmaBusyBuf; // decoded into the buffer still being sent
+    dmaWait();                     // as TFT_eSPI does before queueing the next transfer
+    blit(x, y, w, h, p);
+    dmaBusyBuf = p;
+  }
+  void pushImage(int32_t x, int32_t y, int32_t w, int32_t h, uint16_t *p) { blit(x, y, w, h, p); }
+};
+
+static uint16_t expectedPixel(const unsigned char *raw, uint32_t i)
+{
+  // raw: low byte first. Panel order in memory: high byte first
+  uint16_t v;
+  const uint8_t b[2] = {raw[2 * i + 1], raw[2 * i]};
+  memcpy(&v, b, 2);
+  return v;
+}
+
+static int checkIcon(const Icon &ic)
+{
+  int fails = 0;
+  const PackedImage &img = ic.packed;
+  const uint32_t n = (uint32_t)img.width * img.height;
+  std::vector<uint16_t> out(n + 8);
+
+  // 1) Chunked decode, chunk sizes that do and do not line up with rows and tokens
+  static const uint32_t chunks[] = {1, 7, 32, 40, 333, 100000};
+  for (uint32_t chunk : chunks)
+  {
+    PackedImageDecoder dec(img);
+    uint32_t got = 0;
+    while (got < n)
+    {
+      const uint32_t k = dec.read(&out[got], chunk);
+      if (k == 0)
+        break;
+      got += k;
+    }
+    uint32_t bad = 0;
+    for (uint32_t i = 0; i < n; ++i)
+      bad += out[i] != expectedPixel(ic.raw, i);
+    if (got != n || bad || dec.remaining() != 0)
+    {
+      printf("FAIL %s chunk %u: %u/%u pixels, %u wrong\n", ic.name, chunk, got, n, bad);
+      ++fails;
+    }
+  }
+
+  // 2) drawPackedImage() through DMA and through pushImage()
+  for (int dma = 1; dma >= 0; --dma)
+  {
+    FakeTft tft;
+    const int32_t x0 = 100, y0 = 50;
+    drawPackedImage(tft, x0, y0, img, dma != 0);
+    uint32_t bad = 0;
+    for (uint32_t i = 0; i < n; ++i)
+      bad += tft.fb[(y0 + i / img.width) * FakeTft::W + x0 + i % img.width] != expectedPixel(ic.raw, i);
+    if (bad || !tft.swap || tft.inWrite || tft.dmaBusyBuf || tft.reusedBusy)
+    {
+      printf("FAIL %s draw (%s): %u wrong, swap %d, inWrite %d, dma pending %d, busy buffer reused %u\n", ic.name,
+             dma ? "DMA" : "pushImage", bad, tft.swap, tft.inWrite, tft.dmaBusyBuf != nullptr, tft.reusedBusy);
+      ++fails;
+    }
+    else if (dma)
+      printf("  %-10s %ux%u drawn in %u blocks\n", ic.name, img.width, img.height, tft.blocks);
+  }
+
+  // 3) Truncated data must stop early, not read past the end
+  PackedImage cut = img;
+  cut.size = img.size / 3;
+  PackedImageDecoder dec(cut);
+  const uint32_t got = dec.read(&out[0], n);
+  if (got >= n || dec.remaining() != 0)
+  {
+    printf("FAIL %s truncated: decoded %u of %u\n", ic.name, got, n);
+    ++fails;
+  }
+
+  // 4) Decoder speed (host, so only relative)
+  const int REPS = 20000;
+  volatile uint16_t sink = 0;
+  const auto t0 = std::chrono::steady_clock::now();
+  for (int r = 0; r < REPS; ++r)
+  {
+    PackedImageDecoder d(img);
+    uint16_t line[40];
+    while (d.remaining())
+      d.read(line, img.width);
+    sink = sink + line[0];
+  }
+  const double us = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - t0).count() / REPS;
+  printf("  %-10s %5u -> %5u bytes (%3.0f%%), decode %.2f us (%.0f Mpixel/s)\n", ic.name, 2 * n, img.size,
+         100.0 * img.size / (2 * n), us, n / us);
+  return fails;
+}
+
+int main()
+{
+  int fails = 0;
+  uint32_t raw = 0, packed = 0;
+  for (const Icon &ic : ICONS)
+  {
+    fails += checkIcon(ic);
+    raw += 2u * ic.packed.width * ic.packed.height;
+    packed += ic.packed.size;
+  }
+  printf("total %u -> %u bytes (%.0f%%), %s\n", raw, packed, 100.0 * packed / raw, fails ? "FAILED" : "all round trips OK");
+  return fails ? 1 : 0;
+}
@@ -0,0 +1,186 @@
+// Host check: two Battery Boxes each get their learned state saved to NVS and restored after a reboot
+//
+// Runs on the PC, not the ESP32. Compiles the real src/main.cpp with room for two packs against the
+// trace replay's host_stubs/, whose Preferences.h keeps NVS in memory. Build and run from this folder:
+//   g++ -O2 -std=gnu++11 -Wall -DESA_PACKS=2 -I../22_ESA_Trace_Replay/host_stubs -I"../../lib/esa-estimators" -I"../../lib/esa-link" -I"../../lib/esa-profiler" 25_ESA_Persist_Two_Packs_Main_Code.cpp ../22_ESA_Trace_Replay/host_stubs/HostStubs.cpp -o persist_two_packs
+//   ./persist_two_packs
+//
+// First run: packs A (10 A) and B (4 A) send interleaved at 4 Hz for 25 min of riding; both must
+// be saved under their own MAC, A's saves must not hold up B's and neither may save more often than
+// PERSIST_MIN_GAP_MS allows. The NVS contents then go to a file and the program runs itself again
+// ("reboot") with them: B is heard first this time, so it gets A's old link slot. Each pack must come
+// back with its own history and tteHist EMA on its first packet, before the other pack is heard.
+// Exits non-zero on any failure.
+
+#include "../../src/main.cpp"
+
+#include <unistd.h>
+
+const GFXfont FreeSansBold12pt7b = {};
+const GFXfont FreeSansBold24pt7b = {};
+
+static const uint8_t MAC_A[6] = {0x24, 0x6f, 0x28, 0x00, 0x00, 0x0a};
+static const uint8_t MAC_B[6] = {0x24, 0x6f, 0x28, 0x00, 0x00, 0x0b};
+static const char KEY_A[] = "esa/p246f2800000a";
+static const char KEY_B[] = "esa/p246f2800000b";
+constexpr float I_A = 10.0f;
+constexpr float I_B = 4.0f;
+constexpr uint32_t RIDE_MS = 25 * 60 * 1000UL;
+constexpr uint32_t PACKET_MS = 250;
+
+static int fails = 0;
+#define CHECK(c)                                    \
+  do                                                \
+  {                                                 \
+    if (!(c))                                       \
+    {                                               \
+      printf("  FAIL line %d: %s\n", __LINE__, #c); \
+      fails++;                                      \
+    }                                               \
+  } while (0)
+
+static void send(const uint8_t *mac, float I, float soc, uint16_t seq)
+{
+  struct_message pkt{};
+  pkt.bms_status = 1;
+  pkt.soc = soc;
+  pkt.I = -I;
+  pkt.resmAh = soc * 200.0f;
+  pkt.seq = seq;
+  receiveCallback(mac, (const uint8_t *)&pkt, sizeof(pkt));
+  loop();
+}
+
+static bool saveNvs(const char *path)
+{
+  FILE *f = fopen(path, "wb");
+  if (!f)
+    return false;
+  for (const auto &kv : hostNvs())
+  {
+    const uint32_t keyLen = kv.first.size(), len = kv.second.size();
+    fwrite(&keyLen, sizeof(keyLen), 1, f);
+    fwrite(kv.first.data(), 1, keyLen, f);
+    fwrite(&len, sizeof(len), 1, f);
+    fwrite(kv.second.data(), 1, len, f);
+  }
+  return fclose(f) == 0;
+}
+
+static bool loadNvs(const char *path)
+{
+  FILE *f = fopen(path, "rb");
+  if (!f)
+    return false;
+  uint32_t keyLen, len;
+  while (fread(&keyLen, sizeof(keyLen), 1, f) == 1)
+  {
+    std::string key(keyLen, '\0');
+    std::vector<uint8_t> value;
+    if (fread(&key[0], 1, keyLen, f) != keyLen || fread(&len, sizeof(len), 1, f) != 1)
+      break;
+    value.resize(len);
+    if (fread(value.data(), 1, len, f) != len)
+      break;
+    hostNvs()[key] = value;
+  }
+  fclose(f);
+  return true;
+}
+
+// Counts a save whenever a pack's stored bytes change
+struct SaveLog
+{
+  std::vector<uint8_t> last;
+  uint32_t saves = 0;
+  uint32_t firstMs = 0;
+  uint32_t minGapMs = UINT32_MAX;
+  uint32_t lastMs = 0;
+
+  void check(const char *key)
+  {
+    const auto it = hostNvs().find(key);
+    if (it == hostNvs().end() || it->second == last)
+      return;
+    last = it->second;
+    if (saves++ == 0)
+      firstMs = millis();
+    else if (millis() - lastMs < minGapMs)
+      minGapMs = millis() - lastMs;
+    lastMs = millis();
+  }
+};
+
+static void firstBoot(const char *self)
+{
+  SaveLog a, b;
+  uint16_t seq = 0;
+  for (uint32_t t = 1000; t <= RIDE_MS; t += PACKET_MS, ++seq)
+  {
+    const float soc = 90.0f - 30.0f * t / RIDE_MS;
+    g_hostMillis = t;
+    send(MAC_A, I_A, soc, seq);
+    a.check(KEY_A);
+    g_hostMillis = t + PACKET_MS / 2;
+    send(MAC_B, I_B, soc + 5.0f, seq);
+    b.check(KEY_B);
+  }
+  printf("first boot: pack A %u saves (first at %u s), pack B %u saves (first at %u s)\n", a.saves,
+         a.firstMs / 1000, b.saves, b.firstMs / 1000);
+  CHECK(g_link.count() == 2);
+  CHECK(a.saves >= 2 && b.saves >= 2);
+  CHECK(a.saves <= RIDE_MS / PERSIST_MIN_GAP_MS && b.saves <= RIDE_MS / PERSIST_MIN_GAP_MS);
+  CHECK(a.minGapMs >= PERSIST_MIN_GAP_MS && b.minGapMs >= PERSIST_MIN_GAP_MS);
+  CHECK(b.firstMs - a.firstMs < 60000); // B is not queued behind A
+  CHECK(hostNvs().size() == 2);
+
+  const char *path = "persist_two_packs.nvs";
+  CHECK(saveNvs(path));
+  if (fails)
+    return;
+  fflush(stdout);
+  execl(self, self, "--reboot", path, (char *)nullptr);
+  printf("  FAIL: could not run %s again\n", self);
+  fails++;
+}
+
+static bool restored(const PackState &pk, float I)
+{
+  return pk.hist.window(0).count() > 0 && pk.tteHist.valid() && fabsf(pk.tteHist.value() - I) < 0.5f &&
+         pk.histReady.state();
+}
+
+static void reboot(const char *path)
+{
+  CHECK(loadNvs(path));
+  remove(path);
+  g_hostMillis = 1000;
+  send(MAC_B, I_B, 60.0f, 0);
+  CHECK(g_link.find(MAC_B) == 0);
+  CHECK(restored(g_packs[0], I_B));
+  CHECK(!g_packs[1].tteHist.valid()); // A not heard yet
+  printf("reboot: pack B back on its first packet in slot 0, tteHist %.2f A, %u s of history\n",
+         g_packs[0].tteHist.value(), (unsigned)g_packs[0].hist.window(0).spanSec());
+
+  g_hostMillis = 1250;
+  send(MAC_A, I_A, 55.0f, 0);
+  CHECK(g_link.find(MAC_A) == 1);
+  CHECK(restored(g_packs[1], I_A));
+  printf("reboot: pack A back on its first packet in slot 1, tteHist %.2f A, %u s of history\n",
+         g_packs[1].tteHist.value(), (unsigned)g_packs[1].hist.window(0).spanSec());
+}
+
+int main(int argc, char **argv)
+{
+  if (argc == 3 && !strcmp(argv[1], "--reboot"))
+  {
+    reboot(argv[2]);
+    printf(fails ? "FAILED\n" : "persist OK\n");
+  }
+  else
+  {
+    firstBoot(argv[0]);
+    printf("FAILED\n");
+  }
+  return fails;
+}